@@ -115,6 +115,10 @@ public:
     
     static void output(const std::string& msg);
     ///< Logger calls this method to write a line.
+    ///< While AsyncStreamOutput is running the line is handed to it instead of being written here.
+
+    static void write(const std::string& msg);
+    ///< Write and flush a line from the calling thread.
     
     static void setStream(FILE *stream_p = NULL)
       { logStream_mp = (stream_p) ? stream_p : stdout; }
@@ -125,7 +129,60 @@ private:
     ///< The stream to use for output.  This may be assigned to at runtime.
 };
 
+/// counters for AsyncStreamOutput:
+struct AsyncStreamStats {
+    unsigned long long lines;       ///< lines queued by callers
+    unsigned long long waits;       ///< times a caller found the queue full and had to wait
+    unsigned long long writes;      ///< buffered writes to the stream
+    unsigned long long flushes;     ///< flushes of the stream
+};
+
+class AsyncStreamOutput {
+///< AsyncStreamOutput is an OutputPolicy which hands each line to a background writer thread.
+///< The caller only copies the line into a lock-free queue.  The writer thread sleeps until lines arrive,
+///<  gathers them into a large buffer which it writes to StreamOutput::stream() when it fills, and flushes
+///<  the stream when it has caught up with the queue or every flush interval while lines keep arriving.
+///< Anything still queued is written out by stop() and at exit.
+public:
+    enum {
+        DEFAULT_QUEUE_SIZE = 4096,      ///< lines which may wait for the writer thread.  Rounded up to a power of 2.
+        DEFAULT_FLUSH_INTERVAL = 100,   ///< ms between flushes while lines are arriving
+        DEFAULT_FLUSH_SIZE = 65536      ///< bytes to gather before writing to the stream
+    };
+
+    static bool start(unsigned queueSize = DEFAULT_QUEUE_SIZE,
+                      unsigned flushInterval = DEFAULT_FLUSH_INTERVAL,
+                      unsigned flushSize = DEFAULT_FLUSH_SIZE);
+    ///< Start the writer thread.  While it runs, StreamOutput and StreamLogger send their lines here.
+    ///< Returns false if it is already running or the thread could not be created.
+
+    static void stop();
+    ///< Write out everything queued, flush the stream and stop the writer thread.
+    ///< Call this before closing or replacing the stream.
+
+    static bool running();
+    ///< True while the writer thread is running.
+
+    static void output(const std::string& msg);
+    ///< Logger calls this method to queue a line.  If the writer is not running the line is written directly.
+    ///< If the queue is full the caller blocks until the writer frees space, so no lines are lost.
+
+    static void flush();
+    ///< Write out everything queued and flush the stream from the calling thread.
+    ///< Call this from a crash handler running in normal thread context, such as one for ExcHndl, to keep the last lines.
+
+    static void getStats(AsyncStreamStats &target);
+    ///< Get the counters since start().
+};
+
 inline void StreamOutput::output(const std::string& msg) {
+    if (AsyncStreamOutput::running())
+        AsyncStreamOutput::output(msg);
+    else
+        write(msg);
+}
+
+inline void StreamOutput::write(const std::string& msg) {
     // get and check that the target stream is valid:
     FILE *logStream = stream();
     if (!logStream)
@@ -1,4 +1,11 @@
 #include "logger.h"
+#include "portable.h"
+#include <pthread.h>
+#include <sched.h>
+#include <atomic>
+#include <chrono>
+#include <semaphore.h>
+#include <cstdlib>
 
 FILE *StreamOutput::logStream_mp = stdout;
 
@@ -35,6 +42,254 @@ std::ostringstream& Logger<OutputPolicy>::get(logLevel level, const Time *TS) {
 //explicit instantiation of the logger methods:
 template class Logger<StreamOutput>;
 
+namespace {
+    // State for AsyncStreamOutput.  The queue is a ring of cells.  Like AmbQueue, the freeSlots semaphore counts
+    //  the cells available to callers, so a caller blocks when the queue is full.  The consumer is whichever
+    //  thread holds writerLock.  A cell's seq is equal to pos when it is free for the caller at pos,
+    //  and pos + 1 once it holds that line.
+    // The writer thread sleeps on wakeWriter.  Callers only post it when the writer is idle or the queue is full,
+    //  so that while lines are arriving the writer wakes once per flush interval rather than once per line.
 
+    struct AsyncCell {
+        std::atomic<size_t> seq;
+        std::string msg;
+    };
 
+    AsyncCell *cells_p = NULL;                  // the queue
+    size_t cellMask = 0;                        // queue size - 1
+    std::atomic<size_t> enqueuePos(0);          // next position for a caller
+    size_t dequeuePos = 0;                      // next position for the consumer.  Guarded by writerLock.
+    sem_t freeSlots;                            // cells available to callers
+    sem_t wakeWriter;                           // wakes the writer thread
+    std::atomic<bool> writerIdle(false);        // the writer is waiting for lines with nothing gathered
+    std::string writeBuffer;                    // lines gathered for the next write.  Guarded by writerLock.
+    pthread_mutex_t writerLock = PTHREAD_MUTEX_INITIALIZER;
 
+    std::atomic<bool> asyncRunning(false);      // callers may queue lines
+    std::atomic<bool> asyncStopping(false);     // the writer thread should finish
+    std::atomic<int> asyncCallers(0);           // callers inside AsyncStreamOutput::output()
+    pthread_t writerThread;
+    unsigned flushInterval = AsyncStreamOutput::DEFAULT_FLUSH_INTERVAL;
+    size_t flushSize = AsyncStreamOutput::DEFAULT_FLUSH_SIZE;
+    bool atExitRegistered = false;
+
+    std::atomic<unsigned long long> statLines(0), statWaits(0), statWrites(0), statFlushes(0);
+
+    // Write out the gathered lines and optionally flush.  Caller holds writerLock.
+    void writeGathered(bool doFlush) {
+        FILE *logStream = StreamOutput::stream();
+        if (!writeBuffer.empty()) {
+            if (logStream)
+                fwrite(writeBuffer.data(), 1, writeBuffer.size(), logStream);
+            writeBuffer.clear();
+            ++statWrites;
+        }
+        if (doFlush && logStream) {
+            fflush(logStream);
+            ++statFlushes;
+        }
+    }
+
+    // True if the next line is ready for the consumer.  Caller holds writerLock.
+    bool lineReady() {
+        return cells_p && cells_p[dequeuePos & cellMask].seq.load(std::memory_order_acquire) == dequeuePos + 1;
+    }
+
+    // Move the lines which are ready into writeBuffer, writing whenever it reaches flushSize.  Caller holds writerLock.
+    // Returns the number of lines taken.
+    size_t drainQueue() {
+        size_t count = 0;
+        while (lineReady()) {
+            AsyncCell &cell = cells_p[dequeuePos & cellMask];
+            writeBuffer.append(cell.msg);
+            cell.msg.clear();
+            cell.seq.store(dequeuePos + cellMask + 1, std::memory_order_release);
+            ++dequeuePos;
+            ++count;
+            sem_post(&freeSlots);
+            if (writeBuffer.size() >= flushSize)
+                writeGathered(false);
+        }
+        return count;
+    }
+
+    // At exit, write out everything queued.  The writer thread may already have been terminated
+    // while holding writerLock, so only wait a short time for it.
+    void atExitHandler() {
+        if (!asyncRunning.load())
+            return;
+        int tries = 0;
+        while (pthread_mutex_trylock(&writerLock) != 0) {
+            if (++tries > 100)
+                return;
+            SLEEP(1);
+        }
+        drainQueue();
+        writeGathered(true);
+        pthread_mutex_unlock(&writerLock);
+    }
+
+    void *writerMain(void *) {
+        typedef std::chrono::system_clock clock;
+        clock::time_point flushDue;
+        bool pending = false;   // lines taken since the last flush
+
+        for (;;) {
+            // read before draining: once set, no more lines are coming.
+            bool stopping = asyncStopping.load();
+
+            pthread_mutex_lock(&writerLock);
+            if (drainQueue() && !pending) {
+                pending = true;
+                flushDue = clock::now() + std::chrono::milliseconds(flushInterval);
+            }
+            if (stopping || (pending && clock::now() >= flushDue)) {
+                writeGathered(true);
+                pending = false;
+            }
+            bool idle = false;
+            if (!pending && !stopping) {
+                // about to wait for lines.  Tell callers, then check for one which arrived meanwhile:
+                writerIdle.store(true);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                idle = !lineReady();
+                if (!idle)
+                    writerIdle.store(false);
+            }
+            pthread_mutex_unlock(&writerLock);
+
+            if (stopping)
+                break;
+            if (idle) {
+                // wait for a caller or stop() to wake us:
+                while (sem_wait(&wakeWriter) != 0)
+                    ;
+            } else if (pending) {
+                // gather lines until the flush is due, unless a full queue or stop() wakes us:
+                std::chrono::nanoseconds due = flushDue.time_since_epoch();
+                struct timespec abstime;
+                abstime.tv_sec = (time_t) std::chrono::duration_cast<std::chrono::seconds>(due).count();
+                abstime.tv_nsec = (long) (due.count() % 1000000000LL);
+                sem_timedwait(&wakeWriter, &abstime);
+            }
+        }
+        pthread_exit(NULL);
+        return NULL;
+    }
+}
+
+bool AsyncStreamOutput::start(unsigned queueSize, unsigned interval, unsigned size) {
+    if (asyncRunning.load())
+        return false;
+
+    size_t cells = 2;
+    while (cells < queueSize)
+        cells <<= 1;
+
+    pthread_mutex_lock(&writerLock);
+    cells_p = new AsyncCell[cells];
+    for (size_t index = 0; index < cells; ++index)
+        cells_p[index].seq.store(index, std::memory_order_relaxed);
+    cellMask = cells - 1;
+    enqueuePos.store(0);
+    dequeuePos = 0;
+    sem_init(&freeSlots, 0, cells);
+    sem_init(&wakeWriter, 0, 0);
+    writerIdle.store(false);
+    flushInterval = interval;
+    flushSize = size ? size : 1;
+    writeBuffer.clear();
+    writeBuffer.reserve(flushSize + 1024);
+    pthread_mutex_unlock(&writerLock);
+
+    statLines = statWaits = statWrites = statFlushes = 0;
+    asyncStopping.store(false);
+
+    if (pthread_create(&writerThread, NULL, writerMain, NULL) != 0) {
+        pthread_mutex_lock(&writerLock);
+        delete[] cells_p;
+        cells_p = NULL;
+        sem_destroy(&freeSlots);
+        sem_destroy(&wakeWriter);
+        pthread_mutex_unlock(&writerLock);
+        return false;
+    }
+
+    if (!atExitRegistered) {
+        atexit(atExitHandler);
+        atExitRegistered = true;
+    }
+    asyncRunning.store(true);
+    return true;
+}
+
+void AsyncStreamOutput::stop() {
+    if (!asyncRunning.exchange(false))
+        return;
+    // wait for callers which saw asyncRunning before it was cleared.  They are at most one line away:
+    while (asyncCallers.load() > 0)
+        sched_yield();
+    // wake the writer thread to finish:
+    asyncStopping.store(true);
+    sem_post(&wakeWriter);
+    pthread_join(writerThread, NULL);
+
+    pthread_mutex_lock(&writerLock);
+    delete[] cells_p;
+    cells_p = NULL;
+    sem_destroy(&freeSlots);
+    sem_destroy(&wakeWriter);
+    std::string().swap(writeBuffer);
+    pthread_mutex_unlock(&writerLock);
+}
+
+bool AsyncStreamOutput::running() {
+    return asyncRunning.load(std::memory_order_acquire);
+}
+
+void AsyncStreamOutput::output(const std::string& msg) {
+    ++asyncCallers;
+    if (!asyncRunning.load()) {
+        --asyncCallers;
+        StreamOutput::write(msg);
+        return;
+    }
+    // Reserve a cell, blocking if the queue is full:
+    if (sem_trywait(&freeSlots) != 0) {
+        // wake the writer to make room:
+        ++statWaits;
+        sem_post(&wakeWriter);
+        while (sem_wait(&freeSlots) != 0)
+            ;
+    }
+    size_t pos = enqueuePos.fetch_add(1, std::memory_order_relaxed);
+    AsyncCell &cell = cells_p[pos & cellMask];
+    cell.msg.assign(msg);
+    cell.seq.store(pos + 1, std::memory_order_release);
+    // wake the writer if it is waiting for lines:
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writerIdle.load(std::memory_order_relaxed) && writerIdle.exchange(false))
+        sem_post(&wakeWriter);
+    ++statLines;
+    --asyncCallers;
+}
+
+void AsyncStreamOutput::flush() {
+    if (!asyncRunning.load()) {
+        FILE *logStream = StreamOutput::stream();
+        if (logStream)
+            fflush(logStream);
+        return;
+    }
+    pthread_mutex_lock(&writerLock);
+    drainQueue();
+    writeGathered(true);
+    pthread_mutex_unlock(&writerLock);
+}
+
+void AsyncStreamOutput::getStats(AsyncStreamStats &target) {
+    target.lines = statLines.load();
+    target.waits = statWaits.load();
+    target.writes = statWrites.load();
+    target.flushes = statFlushes.load();
+}
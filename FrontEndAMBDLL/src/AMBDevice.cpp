@@ -20,7 +20,10 @@
 */
 
 #include "AMBDevice.h"
+#include "FrontEndAMB/ambCompletion.h"
+#include "FrontEndAMB/ambInterface.h"
 #include <iomanip>
+#include <vector>
 
 AmbErrorCode_t AMBDevice::command(AmbNodeAddr nodeAddr,
                                   AmbRelativeAddr RCA,
@@ -35,14 +38,12 @@ AmbErrorCode_t AMBDevice::command(AmbNodeAddr nodeAddr,
     AmbErrorCode_t status(AMBERR_NOERR);
     Time timestamp;
     // send command with a semaphore:
-    sem_t synchLock;
-    sem_init(&synchLock, 0, 0);
+    sem_t &synchLock(*ambThreadSynchLock());
     AmbDeviceInt::command(RCA, dataLength, data, &synchLock, &timestamp, &status);
     // restore the previous node address:
     AmbDeviceInt::m_nodeAddress = tempNodeAddr;
     // wait on the semaphore:
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     return status;
 }
 
@@ -59,14 +60,12 @@ AmbErrorCode_t AMBDevice::monitor(AmbNodeAddr nodeAddr,
     AmbErrorCode_t status(AMBERR_NOERR);
     Time timestamp;
     // send monitor request with the semaphore:
-    sem_t synchLock;
-    sem_init(&synchLock, 0, 0);
+    sem_t &synchLock(*ambThreadSynchLock());
     AmbDeviceInt::monitor(RCA, dataLength, data, &synchLock, &timestamp, &status);
     // restore the previous node address:
     AmbDeviceInt::m_nodeAddress = tempNodeAddr;
     // wait on the semaphore:
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     // check for errors and return result:
     if (status != AMBERR_NOERR) {
         errorCount_m++;
@@ -76,7 +75,55 @@ AmbErrorCode_t AMBDevice::monitor(AmbNodeAddr nodeAddr,
     return status;
 }
 
+unsigned AMBDevice::sequence(AmbNodeAddr nodeAddr,
+                             Step *steps,
+                             unsigned long count)
+{
+    if (!count)
+        return 0;
+
+    // Build every message first so that they are queued together and stay in order:
+    std::vector<AmbMessage_t> messages(count);
+    sem_t &synchLock(*ambThreadSynchLock());
+    AmbCompletionLatch latch(synchLock);
+    latch.add(count);
 
+    for (unsigned long index = 0; index < count; ++index) {
+        Step &step = steps[index];
+        bool isCommand = (*step.dataLength != 0);
+        step.status = AMBERR_PENDING;
 
+        AmbCompletion_t *completion = AmbCompletionPool::allocate();
+        completion -> dataLength_p = isCommand ? NULL : step.dataLength;
+        completion -> data_p = isCommand ? NULL : step.data;
+        completion -> timestamp_p = step.timestamp;
+        completion -> status_p = &step.status;
+        completion -> latch_p = &latch;
 
+        AmbMessage_t &message = messages[index];
+        message.requestType = isCommand ? AMB_CONTROL : AMB_MONITOR;
+        message.channel = m_channel;
+        message.address = createAMBAddr(nodeAddr, step.RCA);
+        message.dataLen = isCommand ? *step.dataLength : 0;
+        if (isCommand)
+            memcpy(message.data, step.data, message.dataLen);
+        message.completion_p = completion;
+        message.targetTE = 0;
+        message.priority = ambThreadPriority();
+        message.deadline = 0;   // a sequence is never partly dropped
+    }
+    interface_mp -> sendMessages(&messages[0], count);
+    latch.wait();
 
+    // check for errors:
+    unsigned errors = 0;
+    for (unsigned long index = 0; index < count; ++index) {
+        if (steps[index].status != AMBERR_NOERR) {
+            ++errors;
+            errorCount_m++;
+            if (logAmbErrors_m)
+                LOG(LM_ERROR) << "FEHardwareDevice(0x" << std::uppercase << std::hex << nodeAddr << "): AMB error=" << std::dec << steps[index].status << " RCA=" << " 0x" << std::uppercase << std::hex << std::setw(6) << std::setfill('0') << steps[index].RCA << std::endl;
+        }
+    }
+    return errors;
+}
@@ -49,6 +49,21 @@ public:
                            AmbDataLength_t &dataLength,
                            AmbDataMem_t *data);
 
+    /// One command or monitor request in a sequence.
+    struct Step {
+        AmbRelativeAddr RCA;
+        AmbDataLength_t *dataLength;    ///< command payload length, or 0 for a monitor.  Returns the response length.
+        AmbDataMem_t *data;             ///< command payload, or monitor response buffer of AMB_DATA_MSG_SIZE.
+        Time *timestamp;                ///< returns the time the step completed.
+        AmbErrorCode_t status;          ///< returns the status of the step.
+    };
+
+    unsigned sequence(AmbNodeAddr nodeAddr,
+                      Step *steps,
+                      unsigned long count);
+    ///< Queue all the steps on the bus at once, in order, and wait for the last to complete.
+    ///< Returns the number of steps which failed.
+
 private:
     AMBDevice(const AMBDevice &other);
     ///< forbid copy construct.
@@ -32,6 +32,7 @@
 #include "stringConvert.h"
 #include "exchndl.h"
 #include <string>
+#include <vector>
 #include <cstring>
 #include <string.h>
 #include <windows.h>
@@ -58,9 +59,19 @@ namespace FrontEndAMBDLL {
     AmbChannel CANChannel = 0;          ///< Which CAN channel to use
     AmbNodeAddr nodeAddress = 0x13;     ///< The default node address
     bool isValid = false;
+
+    // Crash handling:
+    LPTOP_LEVEL_EXCEPTION_FILTER excHndlFilter = NULL; ///< the filter installed by ExcHndlInit()
+    LONG WINAPI crashFlushFilter(EXCEPTION_POINTERS *exceptionInfo);
 };
 using namespace FrontEndAMBDLL;
 
+/// Unhandled exception filter: write out the queued log lines, then let ExcHndl report the crash.
+LONG WINAPI FrontEndAMBDLL::crashFlushFilter(EXCEPTION_POINTERS *exceptionInfo) {
+    AsyncStreamOutput::flush();
+    return (excHndlFilter) ? excHndlFilter(exceptionInfo) : EXCEPTION_CONTINUE_SEARCH;
+}
+
 
 extern "C" BOOL WINAPI DllMain (
     HINSTANCE const instance,  // handle to DLL module
@@ -115,6 +126,11 @@ int DLL_CALL ambInitialize() {
     // initialize exception handling library:
     ExcHndlInit();
 
+    // flush the asynchronous log before ExcHndl reports a crash:
+    LPTOP_LEVEL_EXCEPTION_FILTER previousFilter = SetUnhandledExceptionFilter(crashFlushFilter);
+    if (previousFilter != crashFlushFilter)
+        excHndlFilter = previousFilter;
+
     // initialize logDir to the Windows temporary path:
     TCHAR lpTempPathBuffer[MAX_PATH];
     DWORD dwRetVal = GetTempPath(MAX_PATH, lpTempPathBuffer);
@@ -139,6 +155,12 @@ int DLL_CALL ambInitialize() {
         if (!temp.empty())
             reportingLevel = StreamLogger::levelFromString(temp);
 
+        // asyncLog = if true, log lines are queued for a background thread to write in large batches:
+        bool asyncLog = false;
+        temp = configINI -> GetValue("logger", "asyncLog");
+        if (!temp.empty())
+            asyncLog = from_string<unsigned long>(temp);
+
         // Compose the log file and excHndl file names:
         string logFile("");
         string excHndlFile("");
@@ -154,6 +176,8 @@ int DLL_CALL ambInitialize() {
             logStream = fopen(logFile.c_str(), "w");
             StreamOutput::setStream(logStream);
             StreamLogger::setReportingLevel(reportingLevel);
+            if (asyncLog && logStream)
+                AsyncStreamOutput::start();
 
             excHndlFile = logDir + "ExcHndl-" + tmp  + ".txt";
             ExcHndlSetLogFileNameA(excHndlFile.c_str());
@@ -255,6 +279,7 @@ int DLL_CALL ambShutdown() {
     ambItf = NULL;
     LOG(LM_INFO) << "FrontEndAMB.DLL: AmbInterface destroyed" << endl;
 
+    AsyncStreamOutput::stop();
     if (logStream) {
         fflush(logStream);
         fclose(logStream);
@@ -325,29 +350,41 @@ int DLL_CALL monitor(unsigned char nodeAddr, unsigned long RCA, unsigned short *
 }
 
 int DLL_CALL runSequence(unsigned char nodeAddr, Message *sequence, unsigned long maxLen) {
+    if (!isValid || !sequence) {
+        LOG(LM_ERROR) << "FrontEndAMB.DLL runSequence: bad state or params." << endl;
+        return -1;
+    }
+    // Queue the whole sequence at once.  Each step is time stamped by the bus as it completes:
+    vector<AMBDevice::Step> steps(maxLen);
     for (unsigned long i = 0; i < maxLen; i++) {
-        bool command = false;
-        if (sequence[i].dataLength == 0) {
-            ambDevice -> monitor(nodeAddr, sequence[i].RCA, sequence[i].dataLength, sequence[i].data);
-        } else {
-            command = true;
-            ambDevice -> command(nodeAddr, sequence[i].RCA, sequence[i].dataLength, sequence[i].data);
+        steps[i].RCA = sequence[i].RCA;
+        steps[i].dataLength = &(sequence[i].dataLength);
+        steps[i].data = sequence[i].data;
+        steps[i].timestamp = &(sequence[i].timestamp);
+    }
+    // Note which steps are commands before the monitor responses overwrite dataLength:
+    vector<bool> isCommand(maxLen);
+    for (unsigned long i = 0; i < maxLen; i++)
+        isCommand[i] = (sequence[i].dataLength != 0);
+
+    ambDevice -> sequence(nodeAddr, maxLen ? &steps[0] : NULL, maxLen);
+
+    if (LM_DEBUG <= StreamLogger::reportingLevel()) {
+        for (unsigned long i = 0; i < maxLen; i++) {
+            LOG(LM_DEBUG) << (isCommand[i] ? "command 0x" : "monitor 0x")
+                            << uppercase << hex << setfill('0') << setw(5)
+                            << (unsigned) sequence[i].RCA << " "
+                            << dec << sequence[i].dataLength << ": "
+                            << uppercase << hex << setfill('0')
+                            << setw(2) << unsigned(sequence[i].data[0]) << " "
+                            << setw(2) << unsigned(sequence[i].data[1]) << " "
+                            << setw(2) << unsigned(sequence[i].data[2]) << " "
+                            << setw(2) << unsigned(sequence[i].data[3]) << " "
+                            << setw(2) << unsigned(sequence[i].data[4]) << " "
+                            << setw(2) << unsigned(sequence[i].data[5]) << " "
+                            << setw(2) << unsigned(sequence[i].data[6]) << " "
+                            << setw(2) << unsigned(sequence[i].data[7]) << endl;
         }
-        LOG(LM_DEBUG) << (command ? "command 0x" : "monitor 0x")
-                        << uppercase << hex << setfill('0') << setw(5)
-                        << (unsigned) sequence[i].RCA << " "
-                        << dec << sequence[i].dataLength << ": "
-                        << uppercase << hex << setfill('0')
-                        << setw(2) << unsigned(sequence[i].data[0]) << " "
-                        << setw(2) << unsigned(sequence[i].data[1]) << " "
-                        << setw(2) << unsigned(sequence[i].data[2]) << " "
-                        << setw(2) << unsigned(sequence[i].data[3]) << " "
-                        << setw(2) << unsigned(sequence[i].data[4]) << " "
-                        << setw(2) << unsigned(sequence[i].data[5]) << " "
-                        << setw(2) << unsigned(sequence[i].data[6]) << " "
-                        << setw(2) << unsigned(sequence[i].data[7]) << endl;
-
-        setTimeStamp(&(sequence[i].timestamp));
     }
     return 0;
 }
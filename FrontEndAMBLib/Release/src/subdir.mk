@@ -7,11 +7,18 @@ CPP_SRCS += \
 ../src/CANBusInterface.cpp \
 ../src/ChannelNodeMap.cpp \
 ../src/NICANBusInterface.cpp \
+../src/ReplayBusInterface.cpp \
 ../src/SocketClientBusInterface.cpp \
+../src/ambCoalescer.cpp \
+../src/ambCompletion.cpp \
 ../src/ambDeviceImpl.cpp \
 ../src/ambDeviceInt.cpp \
+../src/ambGovernor.cpp \
 ../src/ambInterface.cpp \
+../src/ambLatency.cpp \
 ../src/ambQueue.cpp \
+../src/ambScheduler.cpp \
+../src/ambTrace.cpp \
 ../src/ds1820.cpp \
 ../src/messagePackUnpack.cpp 
 
@@ -19,11 +26,18 @@ CPP_DEPS += \
 ./src/CANBusInterface.d \
 ./src/ChannelNodeMap.d \
 ./src/NICANBusInterface.d \
+./src/ReplayBusInterface.d \
 ./src/SocketClientBusInterface.d \
+./src/ambCoalescer.d \
+./src/ambCompletion.d \
 ./src/ambDeviceImpl.d \
 ./src/ambDeviceInt.d \
+./src/ambGovernor.d \
 ./src/ambInterface.d \
+./src/ambLatency.d \
 ./src/ambQueue.d \
+./src/ambScheduler.d \
+./src/ambTrace.d \
 ./src/ds1820.d \
 ./src/messagePackUnpack.d 
 
@@ -31,11 +45,18 @@ OBJS += \
 ./src/CANBusInterface.o \
 ./src/ChannelNodeMap.o \
 ./src/NICANBusInterface.o \
+./src/ReplayBusInterface.o \
 ./src/SocketClientBusInterface.o \
+./src/ambCoalescer.o \
+./src/ambCompletion.o \
 ./src/ambDeviceImpl.o \
 ./src/ambDeviceInt.o \
+./src/ambGovernor.o \
 ./src/ambInterface.o \
+./src/ambLatency.o \
 ./src/ambQueue.o \
+./src/ambScheduler.o \
+./src/ambTrace.o \
 ./src/ds1820.o \
 ./src/messagePackUnpack.o 
 
@@ -52,7 +73,7 @@ src/%.o: ../src/%.cpp src/subdir.mk
 clean: clean-src
 
 clean-src:
-	-$(RM) ./src/CANBusInterface.d ./src/CANBusInterface.o ./src/ChannelNodeMap.d ./src/ChannelNodeMap.o ./src/NICANBusInterface.d ./src/NICANBusInterface.o ./src/SocketClientBusInterface.d ./src/SocketClientBusInterface.o ./src/ambDeviceImpl.d ./src/ambDeviceImpl.o ./src/ambDeviceInt.d ./src/ambDeviceInt.o ./src/ambInterface.d ./src/ambInterface.o ./src/ambQueue.d ./src/ambQueue.o ./src/ds1820.d ./src/ds1820.o ./src/messagePackUnpack.d ./src/messagePackUnpack.o
+	-$(RM) ./src/CANBusInterface.d ./src/CANBusInterface.o ./src/ChannelNodeMap.d ./src/ChannelNodeMap.o ./src/NICANBusInterface.d ./src/NICANBusInterface.o ./src/ReplayBusInterface.d ./src/ReplayBusInterface.o ./src/SocketClientBusInterface.d ./src/SocketClientBusInterface.o ./src/ambCoalescer.d ./src/ambCoalescer.o ./src/ambCompletion.d ./src/ambCompletion.o ./src/ambDeviceImpl.d ./src/ambDeviceImpl.o ./src/ambDeviceInt.d ./src/ambDeviceInt.o ./src/ambGovernor.d ./src/ambGovernor.o ./src/ambInterface.d ./src/ambInterface.o ./src/ambLatency.d ./src/ambLatency.o ./src/ambQueue.d ./src/ambQueue.o ./src/ambScheduler.d ./src/ambScheduler.o ./src/ambTrace.d ./src/ambTrace.o ./src/ds1820.d ./src/ds1820.o ./src/messagePackUnpack.d ./src/messagePackUnpack.o
 
 .PHONY: clean-src
 
@@ -22,10 +22,14 @@
 
 #include "ambInterface.h"
 #include "ambQueue.h"
+#include "ambScheduler.h"
+#include "ambLatency.h"
+#include "ambTrace.h"
 #include "ChannelNodeMap.h"
+#include <atomic>
 #include <vector>
 
-/// This class implements the abstract AmbInterfaceBus, providing a worker thread and policy
+/// This class implements the abstract AmbInterfaceBus, providing a worker thread per channel and policy
 /// for queueing of messages, and a data structure for tracking CAN channels and nodes.
 /// Further derived classes must implement the particulars of bus opening, closing, and communication.
 class CANBusInterface : public AmbInterfaceBus {
@@ -37,7 +41,8 @@ public:
     ///< Enables debug logging of CAN traffic to stdout.  Default is false.
 
     static bool measureLatency_m;
-    ///< Enables logging of CAN/network round-trip stats.  Default is false.
+    ///< Enables logging of the queueing and latency stats at shutdown.  Default is false.
+    ///< The latency histograms are always kept.
 
     static bool enableDebugLifecycle_m;
     ///< Enables debug logging of startup/shutdown to stdout.  Default is false.
@@ -60,15 +65,68 @@ public:
 
     virtual void sendMessage(const AmbMessage_t &msg);
     ///< Send a message on the CAN bus.  Opens the msg.channel if necessary.
+    ///< If msg.targetTE is in the future the message is held and queued at that time.
     ///< Implementation of method required by AmbInterfaceBus.
     
+    virtual void sendMessages(const AmbMessage_t *msgs, unsigned count);
+    ///< Send a batch of messages.  If they are all for one channel and none has a targetTE, 
+    ///< they are queued together in one step.
+
     virtual void shutdown();
     ///< Shut down and disconenct the bus.  Implementation of method required by AmbInterfaceBus.
 
+    void getQueueStats(AmbPriority_t priority, AmbQueueStats &target) const;
+    ///< Get the queueing counters for a priority class, summed over all channels.
+
+    void resetQueueStats();
+    ///< Zero the queueing counters on all channels.
+
+    void getSchedulerStats(AmbSchedulerStats &target) const
+      { scheduler_m.getStats(target); }
+    ///< Get the counters and jitter statistics for messages sent at a targetTE.
+
+    void getLatency(int channel, long node, int subsystem,
+                    AmbLatencyHistogram &queueDelay, AmbLatencyHistogram &roundTrip) const
+      { latency_m.merge(channel, node, subsystem, queueDelay, roundTrip); }
+    ///< Accumulate the queueing delay and round-trip histograms for the given channel, node and subsystem
+    ///< into the targets.  Pass AmbLatencyTable::ANY for any argument to include all values of it.
+
+    void getLatencyKeys(std::vector<AmbLatencyKey> &target) const
+      { latency_m.getKeys(target); }
+    ///< Get the channel, node and subsystem combinations seen so far.
+
+    void setTrace(AmbTraceWriter *trace)
+      { trace_mp = trace; }
+    ///< Record every transaction to a trace file.  NULL to stop.  The writer must outlive the bus or be unset first.
+
+    void resetLatency()
+      { latency_m.reset(); }
+    ///< Zero the latency histograms.
+
 protected:
     ChannelNodeMap channelNodeMap_m;
     ///< The map of channels to nodes and the state of which channels are open. Shared with derived bus classes. 
 
+    virtual void dispatchMessage(unsigned long handle, AmbMessage_t &msg);
+    ///< Called by worker thread for each message taken from the queue.
+    ///< The default calls monitorImpl() or commandImpl() and then completeMessage().
+    ///< A derived bus may override this to complete messages later from another thread.
+
+    static void completeMessage(AmbMessage_t &msg);
+    ///< Time stamp the message, signal the caller that it is done, and recycle its completion block.
+
+    bool getNextQueued(AmbChannel channel, AmbMessage_t &msg);
+    ///< Take the next message from the channel's queue without waiting.  Returns false if none.
+    ///< For use by dispatchMessage() to coalesce messages which are already waiting.
+
+    void recordRoundTrip(const AmbMessage_t &msg, unsigned long us);
+    ///< Count the round-trip time of a transaction which has been answered, and write it to the trace if any.
+    ///< Call before completeMessage(), while the response is still in msg.completion_p.
+    ///< The default dispatchMessage() does this.  A derived bus which overrides it must do so.
+
+    AmbLatencyTable latency_m;
+    ///< Latency histograms.  The queueing delay is recorded as each message is taken from its queue.
+
 private:    
     virtual bool openChannel(AmbChannel channel) = 0;
     ///< derived bus class must initialize a CAN interface channel.
@@ -89,13 +147,45 @@ private:
     CANBusInterface(const CANBusInterface &other);
     CANBusInterface &operator =(const CANBusInterface &other);
     
-    static void *queueHandlerThread(CANBusInterface *owner);
-    ///< The function which the worker thread runs.
+    /// Each channel has its own queue and worker thread, so that a slow transaction or timeout 
+    /// on one channel does not hold up the others.  Messages on a channel are sent in priority order,
+    /// and in FIFO order within each priority class.
+    struct ChannelWorker {
+        CANBusInterface *owner_p;   ///< The bus which owns this worker.
+        AmbChannel channel;         ///< The channel serviced.
+        AmbQueue queue;             ///< The message queue.
+        pthread_t thread;           ///< handle for the worker thread.
+        std::atomic<bool> started;  ///< True once the worker thread has been created, until it has been joined.
+                                    ///< Read without the lock by getWorker(), so thread is valid once it is seen true.
+    };
+
+    bool readyToSend(AmbChannel channel);
+    ///< Check that the bus is not shutting down and the channel is in range and open.  Opens it if needed.
+
+    static void rejectMessage(const AmbMessage_t &msg);
+    ///< Signal the caller that a message could not be sent.
+
+    ChannelWorker *getWorker(AmbChannel channel);
+    ///< Get the worker for a channel, starting its thread if needed.  NULL if channel out of range.
+
+    void appendToQueue(ChannelWorker *worker, const AmbMessage_t *msgs, unsigned count);
+    ///< Queue messages for a worker.  If the workers were stopped meanwhile, flush them with AMBERR_FLUSHED.
+
+    void stopWorkers();
+    ///< Wake and join the worker threads, then flush their queues.  Requires dieNow to be set.
+
+    static void *queueHandlerThread(ChannelWorker *worker);
+    ///< The function which each worker thread runs.
+
+    void logQueueStats() const;
+    ///< Print the queueing and scheduler counters and the latency percentiles.  Called at shutdown if measureLatency_m.
     
-    AmbQueue queue_m;       ///< The message queue.
-    pthread_t thread_m;     ///< handle for the worker thread.   
-    bool dieNow;            ///< True signals the worker thread to die.
-    bool deadNow;           ///< True when death complete.
+    std::vector<ChannelWorker *> workers_m; ///< The workers, indexed by channel.
+    AmbScheduler scheduler_m;               ///< Holds messages until their targetTE.
+    AmbTraceWriter *trace_mp;               ///< Transactions are recorded here if not NULL.
+    pthread_mutex_t workersMutex_m;         ///< Serializes starting worker threads and flushing their queues once stopped.
+    std::atomic<bool> dieNow;               ///< True signals the worker threads to die.
+    std::atomic<bool> workersStopped_m;     ///< True once the worker threads have been joined.  Nothing takes from the queues after that.
 };
 
 
@@ -0,0 +1,108 @@
+#ifndef REPLAYBUSINTERFACE_H_
+#define REPLAYBUSINTERFACE_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2006
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ * class ReplayBusInterface implements the command and monitor protocol
+ * by serving the responses from a trace recorded by AmbTraceWriter, so
+ * that a recorded session can be rerun without hardware.
+ *
+ *----------------------------------------------------------------------
+ */
+
+#include "CANBusInterface.h"
+#include "ambTrace.h"
+#include <map>
+#include <atomic>
+
+/// ReplayBusInterface answers each monitor request with the next response recorded for that channel
+/// and address, in the order they were recorded.  Once those run out the last one is repeated.
+/// Commands return their recorded status.  Anything never recorded times out.
+///
+/// Each transaction takes its recorded round-trip time divided by the speedup.  The wait is spent in the
+/// channel worker thread, like a real bus transaction, so queuing and pipelining behave as they would.
+class ReplayBusInterface : public CANBusInterface {
+public:
+    ReplayBusInterface(double speedup = 1.0);
+    ///< speedup = 1 for the recorded timing, 10 to run ten times faster, 0 for no waiting at all.
+    virtual ~ReplayBusInterface();
+
+    bool load(const std::string &fileName);
+    ///< Read a trace.  Returns false if it can't be read.  Must be called before sending.
+
+    virtual const nodeList_t* findNodes(AmbChannel channel);
+    ///< Report the nodes which appear in the trace on the specified channel.  Opens the channel if necessary.
+
+    unsigned long getNumRecords() const
+      { return records_m.size(); }
+    ///< the number of transactions in the trace.
+
+    unsigned long getMatched() const
+      { return matched_m; }
+    ///< the number of requests answered from the trace.
+
+    unsigned long getUnmatched() const
+      { return unmatched_m; }
+    ///< the number of requests with no recorded transaction for their channel and address.
+
+private:
+    // forbid copy construct, assignment:
+    ReplayBusInterface(const ReplayBusInterface &other);
+    ReplayBusInterface &operator =(const ReplayBusInterface &other);
+
+    virtual bool openChannel(AmbChannel channel);
+    // mark the channel open.  Always succeeds.
+
+    virtual void closeChannel(AmbChannel channel);
+    // mark the channel closed.
+
+    virtual void monitorImpl(unsigned long handle, AmbMessage_t &msg);
+    // Called by worker thread.  Waits out the recorded transaction time and answers with the recorded response.
+
+    virtual void commandImpl(unsigned long handle, AmbMessage_t &msg);
+    // Called by worker thread.  Waits out the recorded transaction time and returns the recorded status.
+
+    const AmbTraceRecord *next(const AmbMessage_t &msg);
+    // the recorded transaction to play for msg, or NULL if there is none.
+
+    void wait(unsigned long us);
+    // wait for a recorded time scaled by the speedup.  The bulk of a long wait is slept.
+
+    typedef unsigned long long Key;
+    static Key makeKey(AmbChannel channel, AmbAddr address, bool monitor)
+      { return ((Key) monitor << 40) | ((Key) channel << 32) | address; }
+
+    /// The recorded transactions for one channel, address and direction.
+    struct Point {
+        std::vector<unsigned> records;      ///< indexes into records_m, in the order recorded.
+        unsigned next;                      ///< the next one to play.
+    };
+
+    double speedup_m;                       ///< recorded times are divided by this.  0 = don't wait.
+    std::vector<AmbTraceRecord> records_m;  ///< the whole trace.
+    std::map<Key, Point> points_m;          ///< recorded transactions by channel, address and direction.
+    unsigned long timeout_m;                ///< time taken by a monitor with no recorded response, us.
+    pthread_mutex_t mutex_m;                ///< protects Point::next.
+    std::atomic<unsigned long> matched_m;   ///< count of requests answered from the trace.
+    std::atomic<unsigned long> unmatched_m; ///< count of requests not in the trace.
+};
+
+#endif /*REPLAYBUSINTERFACE_H_*/
@@ -27,27 +27,48 @@
  */
 
 #include <boost/asio.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <string>
+#include <vector>
 #include "CANBusInterface.h"
 
 class SocketServerResponse;
 
 class SocketClientBusInterface : public CANBusInterface {
 public:
+    static int pipelineDepth_m;
+    ///< Max number of requests in flight on the socket.  Default is 1, stop-and-wait:
+    ///<  each request waits for the previous response.  Greater than 1 enables pipelined mode:
+    ///<  queued requests are written together and a reader thread matches responses in FIFO order.
+    ///< Takes effect when the interface is constructed.
+
     SocketClientBusInterface(const std::string& host, int port);
 
     virtual ~SocketClientBusInterface();
     
+    virtual void shutdown();
+    ///< Shut down the bus.  In pipelined mode also waits for requests in flight and stops the reader thread.
+
     virtual const nodeList_t* findNodes(AmbChannel channel) {
         return NULL;   //TODO: implement
     }
     ///< Find all nodes on the specified channel.  Opens the channel if necessary.
     ///< Returns NULL if the channel could not be opened.
 
+protected:
+    virtual void dispatchMessage(unsigned long handle, AmbMessage_t &msg);
+    ///< In pipelined mode, writes msg plus any other queued messages which fit in the window
+    ///< with a single vectored write and leaves their completion to the reader thread.
+
 private:
     void openSocket();
     void closeSocket();
 
+    bool openReadSocket();
+    // in pipelined mode, duplicate the connected socket's handle into readSock_mp.
+
     virtual bool openChannel(AmbChannel channel);
     // initialize a CAN interface channel.
     
@@ -73,9 +94,54 @@ private:
     // This blocks the channel, trashes any pending responses, and takes time so use sparingly.
     // fails if channel is closed.
     
+    void startReader();
+    // start the pipelined mode response reader thread.
+
+    void stopReader();
+    // wait for requests in flight, then stop the reader thread.
+
+    static void *readerThread(SocketClientBusInterface *owner);
+    // the function which the reader thread runs.
+
+    void failInFlight(AmbErrorCode_t status);
+    // complete every request in flight with zero data and the given status and free their window slots.
+
+    void resyncSocket();
+    // after a read error, fail anything written since and reconnect so that responses line up with requests again.
+
+    void lockWindow();
+    void unlockWindow();
+    // in pipelined mode, take or give back all window slots for exclusive use of the socket.
+
     boost::asio::io_context io_m;
     boost::asio::ip::tcp::resolver::results_type endpoints_m;
     boost::asio::ip::tcp::socket *sock_mp;
+    pthread_mutex_t socketMutex_m;          ///< serializes use of the socket by the channel workers.
+    boost::asio::ip::tcp::socket *readSock_mp;
+    ///< in pipelined mode, a second handle on the same connection which only the reader thread reads from,
+    ///< so that it never shares a socket object with the workers writing requests.
+
+    /// A request which has been written to the socket and is waiting for its response:
+    struct InFlightRequest {
+        AmbMessage_t msg;                                       ///< the original message
+        std::chrono::steady_clock::time_point sent;             ///< when it was written
+    };
+
+    bool pipelined_m;                       ///< true if pipelined mode is in use.
+    int windowSize_m;                       ///< max requests in flight in pipelined mode.
+    std::vector<InFlightRequest> inFlight_m;///< ring of requests in flight, oldest first.
+    unsigned inFlightHead_m;                ///< index of the oldest request in flight.
+    unsigned inFlightCount_m;               ///< number of requests in flight.
+    pthread_mutex_t inFlightMutex_m;        ///< protects inFlight_m, head, and count.
+    pthread_cond_t inFlightEmpty_m;         ///< signalled when the last request in flight is completed.
+    sem_t windowSlots_m;                    ///< counts free slots in the window.
+    sem_t responsesPending_m;               ///< counts responses the reader thread should read.
+    std::vector<AmbMessage_t> batch_m;      ///< messages collected for one vectored write.
+    std::vector<std::array<char, 18> > batchBytes_m;            ///< packed requests for one vectored write.
+    std::vector<boost::asio::const_buffer> batchBuffers_m;     ///< buffer sequence for one vectored write.
+    pthread_t readerThread_m;               ///< handle for the reader thread.
+    std::atomic<bool> readerStop_m;         ///< true signals the reader thread to stop when idle.
+    bool readerDead_m;                      ///< true when there is no reader thread to join.
 };
 
 #endif
@@ -0,0 +1,128 @@
+#ifndef AMBCOALESCER_H_
+#define AMBCOALESCER_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2003
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+#include "ambInterface.h"
+#include <chrono>
+#include <map>
+#include <vector>
+#include <pthread.h>
+
+/// Counters kept by AmbCoalescer.
+struct AmbCoalescerStats {
+    unsigned long monitors;         ///< monitor requests seen which were eligible to coalesce.
+    unsigned long sent;             ///< of those, requests actually sent to the bus.
+    unsigned long coalesced;        ///< requests which joined one already in flight.
+    unsigned long cacheHits;        ///< requests answered from the freshness cache.
+    unsigned long invalidated;      ///< cached or in flight results dropped because of a command.
+
+    AmbCoalescerStats()
+      : monitors(0), sent(0), coalesced(0), cacheHits(0), invalidated(0)
+      {}
+};
+
+/// AmbCoalescer sits in front of another AmbInterfaceBus and merges identical monitor requests.
+/// When a monitor request arrives for a channel and address which already has a request queued
+/// or in flight, it is attached to that one rather than sent again.  When the response arrives
+/// every waiter gets a copy of the same data, status and timestamp.
+///
+/// If freshness is nonzero, the last good response for each point is also kept that many us and
+/// requests arriving within that window are answered immediately from it.
+///
+/// Only plain AMB_MONITOR requests with no targetTE are merged; everything else is passed through.
+/// A command to a node drops its cached results and stops new monitors from joining requests
+/// to that node which were sent before the command, so a readback never predates the command.
+class AmbCoalescer : public AmbInterfaceBus {
+public:
+    AmbCoalescer(AmbInterfaceBus &bus, unsigned long freshness = 0);
+    ///< construct in front of bus.  freshness is the cache window in us.  0 = don't cache.
+    virtual ~AmbCoalescer();
+
+    virtual void sendMessage(const AmbMessage_t &msg);
+    ///< Answer, join, or forward a single message.
+
+    virtual void sendMessages(const AmbMessage_t *msgs, unsigned count);
+    ///< Answer or join what can be and forward the rest to the bus as one batch.
+
+    virtual void shutdown();
+    ///< Shut down the bus.  It completes or flushes whatever is in flight.
+
+    void setFreshness(unsigned long freshness);
+    ///< change the cache window, us.  0 disables the cache and forgets what is in it.
+
+    unsigned long getFreshness() const
+      { return freshness_m; }
+    ///< the cache window, us.
+
+    void getStats(AmbCoalescerStats &target) const;
+    ///< get a copy of the counters.
+
+    void resetStats();
+    ///< zero the counters.
+
+private:
+    // forbid copy construct, assignment:
+    AmbCoalescer(const AmbCoalescer &other);
+    AmbCoalescer &operator =(const AmbCoalescer &other);
+
+    typedef unsigned long long Key;
+    static Key makeKey(AmbChannel channel, AmbAddr address)
+      { return ((Key) channel << 32) | address; }
+    ///< channel and address of a monitor point.  Keys for one node are contiguous.
+
+    /// Everything known about one monitor point.
+    struct Point {
+        AmbCoalescer *owner_p;                  ///< for the completion callback.
+        Key key;
+        bool pending;                           ///< a request is queued or in flight.
+        bool detached;                          ///< removed from points_m while in flight.  Deleted on completion.
+        std::vector<AmbCompletion_t*> waiters;  ///< completions to fill in when the response arrives.
+        AmbDataLength_t dataLength;             ///< the response, written by the bus:
+        AmbDataMem_t data[AMB_DATA_MSG_SIZE];
+        AmbChannel channel;
+        AmbAddr address;
+        Time timestamp;
+        AmbErrorCode_t status;
+        bool cached;                            ///< the response is good and may be reused.
+        std::chrono::steady_clock::time_point completed;    ///< when the response arrived.
+    };
+
+    bool accept(const AmbMessage_t &msg, AmbMessage_t &forward);
+    ///< Answer msg from the cache or attach it to a pending request and return false,
+    ///< or else fill in forward with the message to send to the bus and return true.
+
+    void invalidate(Key first, Key last);
+    ///< drop the cached results and detach the pending requests for keys in [first, last).  Mutex held.
+
+    static void completed(void *context);
+    ///< callback for the requests we send.  Fans the response out to the waiters.
+
+    static void copyResult(const Point &point, AmbCompletion_t *waiter);
+    ///< copy the response into a waiter's completion and signal it.
+
+    AmbInterfaceBus &bus_m;                     ///< where requests are sent.
+    unsigned long freshness_m;                  ///< cache window, us.  0 = don't cache.
+    std::map<Key, Point*> points_m;             ///< monitor points seen so far.
+    AmbCoalescerStats stats_m;                  ///< counters.
+    mutable pthread_mutex_t mutex_m;            ///< protects all of the above.
+};
+
+#endif /*AMBCOALESCER_H_*/
@@ -0,0 +1,253 @@
+#ifndef AMBCODEC_H_
+#define AMBCODEC_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2007
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ * Header-only pack/unpack between CAN payloads and data types.
+ *
+ * FEMC monitor payloads are big-endian values of a fixed size, optionally
+ * followed by one FEMC_ERROR status byte.  AmbCodec<T> is specialized for
+ * each type with its wire layout, so that the whole conversion can be
+ * inlined where it is used.  MessagePackUnpack is implemented with these.
+ *----------------------------------------------------------------------
+ */
+
+#include "ambDefs.h"
+#include "femcDefs.h"
+#include <stdint.h>
+#include <string.h>
+
+/// Byte order helpers for big-endian CAN payloads.
+struct AmbWire {
+    static inline uint16_t get16(const AmbDataMem_t *data)
+      { return (uint16_t) ((data[0] << 8) | data[1]); }
+
+    static inline uint32_t get32(const AmbDataMem_t *data)
+      { return ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint32_t) data[2] << 8) | data[3]; }
+
+    static inline void put16(uint16_t value, AmbDataMem_t *data)
+      { data[0] = (AmbDataMem_t) (value >> 8); data[1] = (AmbDataMem_t) value; }
+
+    static inline void put32(uint32_t value, AmbDataMem_t *data) {
+        data[0] = (AmbDataMem_t) (value >> 24);
+        data[1] = (AmbDataMem_t) (value >> 16);
+        data[2] = (AmbDataMem_t) (value >> 8);
+        data[3] = (AmbDataMem_t) value;
+    }
+
+    static inline FEMC_ERROR status(AmbDataMem_t byte)
+      { return (FEMC_ERROR) ((signed char) byte); }
+    ///< interpret a trailing status byte.
+};
+
+/// The layout of a value of PAYLOAD bytes followed by an optional status byte.
+template<unsigned PAYLOAD>
+struct AmbWireLayout {
+    enum {
+        SIZE = PAYLOAD,                     ///< bytes of value.
+        SIZE_WITH_STATUS = PAYLOAD + 1      ///< bytes of value plus the FEMC status byte.
+    };
+
+    static inline FEMC_ERROR check(AmbDataLength_t &dataLength, const AmbDataMem_t *data) {
+        FEMC_ERROR ret(FEMC_NO_ERROR);
+        // A payload of just the status byte, or the value plus status:
+        if (dataLength == 1 || dataLength == SIZE_WITH_STATUS)
+            ret = AmbWire::status(data[--dataLength]);
+        if (dataLength < SIZE)
+            ret = FEMC_UNPACK_ERROR;
+        return ret;
+    }
+    ///< Strip the status byte, if any, from dataLength and return it.
+    ///< Returns FEMC_UNPACK_ERROR if what is left is too short for the value.
+};
+
+/// AmbCodec<T> packs and unpacks one type.  The primary template is for types with no codec;
+/// the specializations below set SPECIALIZED and provide:
+///     static FEMC_ERROR unpack(T &target, AmbDataLength_t dataLength, const AmbDataMem_t *data);
+///     static void pack(T value, AmbDataLength_t &dataLength, AmbDataMem_t *data);
+template<typename T>
+struct AmbCodec {
+    enum { SPECIALIZED = 0 };
+};
+
+template<>
+struct AmbCodec<unsigned long> {
+    enum { SPECIALIZED = 1 };
+    typedef AmbWireLayout<4> Layout;
+
+    static inline FEMC_ERROR unpack(unsigned long &target, AmbDataLength_t dataLength, const AmbDataMem_t *data) {
+        FEMC_ERROR ret = Layout::check(dataLength, data);
+        target = (ret == FEMC_UNPACK_ERROR) ? 0 : AmbWire::get32(data);
+        return ret;
+    }
+
+    static inline void pack(unsigned long value, AmbDataLength_t &dataLength, AmbDataMem_t *data) {
+        dataLength = Layout::SIZE;
+        AmbWire::put32((uint32_t) value, data);
+    }
+};
+
+template<>
+struct AmbCodec<unsigned short> {
+    enum { SPECIALIZED = 1 };
+    typedef AmbWireLayout<2> Layout;
+
+    static inline FEMC_ERROR unpack(unsigned short &target, AmbDataLength_t dataLength, const AmbDataMem_t *data) {
+        FEMC_ERROR ret = Layout::check(dataLength, data);
+        target = (ret == FEMC_UNPACK_ERROR) ? 0 : AmbWire::get16(data);
+        return ret;
+    }
+
+    static inline void pack(unsigned short value, AmbDataLength_t &dataLength, AmbDataMem_t *data) {
+        dataLength = Layout::SIZE;
+        AmbWire::put16(value, data);
+    }
+};
+
+template<>
+struct AmbCodec<short> {
+    enum { SPECIALIZED = 1 };
+    typedef AmbWireLayout<2> Layout;
+
+    static inline FEMC_ERROR unpack(short &target, AmbDataLength_t dataLength, const AmbDataMem_t *data) {
+        FEMC_ERROR ret = Layout::check(dataLength, data);
+        // 2s complement on the wire, as here:
+        target = (ret == FEMC_UNPACK_ERROR) ? 0 : (short) AmbWire::get16(data);
+        return ret;
+    }
+
+    static inline void pack(short value, AmbDataLength_t &dataLength, AmbDataMem_t *data) {
+        dataLength = Layout::SIZE;
+        AmbWire::put16((uint16_t) value, data);
+    }
+};
+
+template<>
+struct AmbCodec<unsigned char> {
+    enum { SPECIALIZED = 1 };
+    typedef AmbWireLayout<1> Layout;
+
+    static inline FEMC_ERROR unpack(unsigned char &target, AmbDataLength_t dataLength, const AmbDataMem_t *data) {
+        target = 0;
+        if (dataLength == 1) {
+            // Ambiguous whether this is just the requested data or just the status byte.
+            // Treat it as a status byte if it matches the range of FEMC_ERROR, otherwise as data:
+            signed char retC((signed char) data[0]);
+            if (retC < 0 && retC >= FEMC_LAST_ERROR_CODE)
+                return (FEMC_ERROR) retC;
+            target = data[0];
+            return FEMC_NO_ERROR;
+        }
+        if (dataLength == Layout::SIZE_WITH_STATUS) {
+            FEMC_ERROR ret = AmbWire::status(data[1]);
+            if (ret == FEMC_NO_ERROR)
+                target = data[0];
+            return ret;
+        }
+        return FEMC_UNPACK_ERROR;
+    }
+
+    static inline void pack(unsigned char value, AmbDataLength_t &dataLength, AmbDataMem_t *data) {
+        dataLength = Layout::SIZE;
+        data[0] = value;
+    }
+};
+
+template<>
+struct AmbCodec<bool> {
+    enum { SPECIALIZED = 1 };
+
+    static inline FEMC_ERROR unpack(bool &target, AmbDataLength_t dataLength, const AmbDataMem_t *data) {
+        unsigned char tmp;
+        FEMC_ERROR ret = AmbCodec<unsigned char>::unpack(tmp, dataLength, data);
+        target = (tmp) ? true : false;
+        return ret;
+    }
+
+    static inline void pack(bool value, AmbDataLength_t &dataLength, AmbDataMem_t *data)
+      { AmbCodec<unsigned char>::pack((unsigned char) ((value) ? 1 : 0), dataLength, data); }
+};
+
+template<>
+struct AmbCodec<float> {
+    enum { SPECIALIZED = 1 };
+    typedef AmbWireLayout<4> Layout;
+
+    static inline float fromWire(const AmbDataMem_t *data) {
+        uint32_t word = AmbWire::get32(data);
+        float value;
+        memcpy(&value, &word, sizeof(value));
+        return value;
+    }
+    ///< the float in the first four bytes of a payload.
+
+    static inline FEMC_ERROR unpack(float &target, AmbDataLength_t dataLength, const AmbDataMem_t *data) {
+        FEMC_ERROR ret = Layout::check(dataLength, data);
+        target = (ret == FEMC_UNPACK_ERROR) ? 0.0 : fromWire(data);
+        return ret;
+    }
+
+    static inline void pack(float value, AmbDataLength_t &dataLength, AmbDataMem_t *data) {
+        uint32_t word;
+        memcpy(&word, &value, sizeof(word));
+        dataLength = Layout::SIZE;
+        AmbWire::put32(word, data);
+    }
+};
+
+/// Decode many float monitor responses at once into separate arrays of values and statuses.
+/// Each gets the same value and status that AmbCodec<float>::unpack() would give, but the loops
+/// have no data-dependent branches, so that the compiler can vectorize the byte swapping.
+struct AmbCodecBatch {
+    static inline void unpackFloats(unsigned count, const AmbDataMem_t *payloads, const AmbDataLength_t *lengths,
+                                    float *values, FEMC_ERROR *status)
+    {
+        for (unsigned index = 0; index < count; ++index) {
+            // Byte swap every payload, whether or not it is valid, then select:
+            const AmbDataMem_t *data = payloads + index * AMB_DATA_MSG_SIZE;
+            AmbDataLength_t length = lengths[index];
+            float value = AmbCodec<float>::fromWire(data);
+            bool valid = (length >= AmbCodec<float>::Layout::SIZE);
+            FEMC_ERROR femcStatus = AmbWire::status(data[AmbCodec<float>::Layout::SIZE]);
+            status[index] = (length == AmbCodec<float>::Layout::SIZE_WITH_STATUS) ? femcStatus
+                          : (valid ? FEMC_NO_ERROR : FEMC_UNPACK_ERROR);
+            values[index] = valid ? value : 0.0f;
+        }
+    }
+    ///< payloads holds count payloads of AMB_DATA_MSG_SIZE bytes, back to back, with their lengths in lengths.
+
+    static inline void unpackFloats(unsigned count, const AmbMonitorResult_t *results, float *values, FEMC_ERROR *status) {
+        for (unsigned index = 0; index < count; ++index) {
+            const AmbMonitorResult_t &result = results[index];
+            bool valid = (result.dataLength >= AmbCodec<float>::Layout::SIZE);
+            float value = AmbCodec<float>::fromWire(result.data);
+            FEMC_ERROR femcStatus = AmbWire::status(result.data[AmbCodec<float>::Layout::SIZE]);
+            femcStatus = (result.dataLength == AmbCodec<float>::Layout::SIZE_WITH_STATUS) ? femcStatus
+                       : (valid ? FEMC_NO_ERROR : FEMC_UNPACK_ERROR);
+            bool ok = (result.status == AMBERR_NOERR);
+            status[index] = ok ? femcStatus : FEMC_AMB_ERROR;
+            values[index] = (ok && valid) ? value : 0.0f;
+        }
+    }
+    ///< decode the results of a batch monitor.  Requests which failed on the bus get FEMC_AMB_ERROR.
+};
+
+#endif /*AMBCODEC_H_*/
@@ -0,0 +1,117 @@
+#ifndef AMBCOMPLETION_H_
+#define AMBCOMPLETION_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2026
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+#include "ambDefs.h"
+#include <atomic>
+
+/// AmbCompletionPool is a slab/free-list allocator for AmbCompletion_t blocks.
+/// Every monitor and command needs a completion block which the bus worker thread destroys 
+/// when the transaction is done.  Rather than new and delete for each one, blocks are carved
+/// from slabs which are kept for the life of the program and recycled through a free list.
+class AmbCompletionPool {
+public:
+    enum { SLAB_SIZE = 64 };
+    ///< Number of completion blocks allocated at once when the free list is empty.
+
+    static AmbCompletion_t *allocate();
+    ///< Get a completion block from the pool.  All pointer members are initialized to NULL.
+
+    static void release(AmbCompletion_t *completion);
+    ///< Return a completion block to the pool.  NULL is ignored.
+
+    static void complete(AmbCompletion_t *completion);
+    ///< Signal the caller that its request is done and return the block to the pool.
+    ///< If the block has a callback_p it is called with context_p; otherwise if it has a latch_p
+    ///< that is counted down; otherwise synchLock_p is posted.
+    ///< Called by the bus when a message has been completed, flushed, or rejected.
+
+    static unsigned long getNumAllocated();
+    ///< Total number of blocks carved from slabs so far.
+
+    static unsigned long getNumFree();
+    ///< Number of blocks currently available in the free list.
+
+private:
+    AmbCompletionPool();
+    ///< all static; forbid construction.
+
+    /// A completion block plus the link used while it is in the free list.
+    /// The completion must be the first member so that the two can be converted by pointer cast.
+    struct Node {
+        AmbCompletion_t completion;
+        Node *next_p;
+    };
+
+    static void allocateSlab();
+    ///< add SLAB_SIZE new blocks to the free list.  Called with the mutex locked.
+
+    static pthread_mutex_t mutex_m;         ///< protects the free list.
+    static Node *freeList_mp;               ///< head of the free list.
+    static unsigned long numAllocated_m;    ///< count of blocks carved from slabs.
+    static unsigned long numFree_m;         ///< count of blocks in the free list.
+};
+
+/// AmbCompletionLatch signals a semaphore once when a whole batch of requests has completed.
+/// Set AmbCompletion_t::latch_p to point to it in every request in the batch.
+/// add() must be called for the whole batch before the first request is sent.
+class AmbCompletionLatch {
+public:
+    AmbCompletionLatch(sem_t &synchLock)
+      : count_m(0),
+        synchLock_m(synchLock)
+      {}
+    ///< construct with the semaphore to post when the count reaches zero.
+
+    void add(unsigned count)
+      { count_m.fetch_add(count); }
+    ///< add requests to the batch.
+
+    void countDown()
+      { if (count_m.fetch_sub(1) == 1) sem_post(&synchLock_m); }
+    ///< called by AmbCompletionPool::complete() as each request is done.
+
+    void wait()
+      { sem_wait(&synchLock_m); }
+    ///< block until every request added has completed.
+
+private:
+    std::atomic<int> count_m;       ///< requests not yet completed.
+    sem_t &synchLock_m;             ///< posted when count_m reaches zero.
+};
+
+sem_t *ambThreadSynchLock();
+///< Get the calling thread's reusable completion semaphore.
+///< It is created the first time each thread calls this and destroyed when the thread exits.
+///< Every request sent with it must be waited on before the thread sends another, so that the
+///< count is always zero between synchronous transactions.
+
+void ambSetThreadPriority(AmbPriority_t priority, unsigned long deadline = 0);
+///< Set the queueing class and monitor deadline in us given to messages sent by the calling thread.
+///< Threads which never call this send AMB_PRIORITY_CONTROL messages with no deadline.
+
+AmbPriority_t ambThreadPriority();
+///< Get the queueing class for messages sent by the calling thread.
+
+unsigned long ambThreadDeadline();
+///< Get the monitor deadline for messages sent by the calling thread, us.  0 = no deadline.
+
+#endif /*AMBCOMPLETION_H_*/
@@ -87,9 +87,19 @@ typedef enum {
     AMBERR_RESPFIFO,  // not able to put received AMB message in response fifo
     AMBERR_NOMEM,     // Unable to allocate memory to receive message
     AMBERR_PENDING,   // Designats that the value has not been filled yet
-    AMBERR_ADDRERR    // There was an error in the address.
+    AMBERR_ADDRERR,   // There was an error in the address.
+    AMBERR_EXPIRED,   // Dropped unsent because its deadline passed while queued
+    AMBERR_BREAKER_OPEN // Not sent because the device's circuit breaker is open
 } AmbErrorCode_t;
 
+/* Queueing classes for messages waiting to be sent.  Lower values are sent first. */
+typedef enum {
+    AMB_PRIORITY_CONTROL,       // Interactive commands and monitors.  The default.
+    AMB_PRIORITY_MEASUREMENT,   // Transactions made by measurement sweeps and optimizers
+    AMB_PRIORITY_BACKGROUND,    // Periodic polling by the device monitor threads
+    AMB_NUM_PRIORITIES
+} AmbPriority_t;
+
 /* Node types that may be in a CAN bus */
 typedef enum {
     UNKNOWN_NODE_TYPE = 0,	// Older correlator firmware and AMB do not support node types
@@ -104,6 +114,10 @@ typedef enum {
     MAX_NODE_TYPE   = 0x17  // Non-inclusive upper bound of slave types
 } AmbNodeType_t;
 
+class AmbCompletionLatch;   // see ambCompletion.h
+
+typedef void (*AmbCompletionCallback)(void* context);   // called on the bus thread when a request completes
+
   /**
    * This is a structure which stores the memory location to load the
    * data into when a message completes.  Not used by kernel module but
@@ -119,8 +133,21 @@ typedef struct {
     AmbErrorCode_t*  status_p;     // Status Value
     sem_t*           synchLock_p;  // Semaphore for blocking processes
     sem_t*           contLock_p;   // Semaphore for Extended read
+    AmbCompletionLatch* latch_p;   // Counted down instead of posting synchLock_p, if set
+    AmbCompletionCallback callback_p; // Called instead of either of the above, if set
+    void*            context_p;    // Passed to callback_p
 } AmbCompletion_t;
 
+  /**
+   * Storage for the result of one monitor request in a batch
+   */
+typedef struct {
+    AmbDataLength_t  dataLength;   // Length of returned data
+    AmbDataMem_t     data[AMB_DATA_MSG_SIZE];  // Returned Data
+    Time             timestamp;    // Time monitor was executed
+    AmbErrorCode_t   status;       // Status Value
+} AmbMonitorResult_t;
+
   /**
    * This is passed back to the users space process when a
    * operation has completed
@@ -150,6 +177,8 @@ typedef struct {
     AmbDataMem_t       data[AMB_DATA_MSG_SIZE];      //  Data to transmit
     AmbCompletion_t*   completion_p; //  Response Address
     Time               targetTE;     // Requested execution time
+    AmbPriority_t      priority;     // Queueing class
+    unsigned long      deadline;     // Max time to wait in the queue, us.  0 = no deadline
 } AmbMessage_t;
 
 #endif /*!AMBDEFS_H*/
@@ -127,6 +127,22 @@ class AmbDeviceInt {
 			     ACS::Time*                 timestamp,
 			     AmbErrorCode_t*            status);
 
+  virtual void monitorBatch(unsigned               count,
+			    const AmbRelativeAddr* RCAs,
+			    AmbMonitorResult_t*    results,
+			    AmbCompletionLatch*    latch);
+  // Not in the Linux version:  send monitor requests for count RCAs in one step.
+  // Each result is filled in as it completes.  The latch is counted up by count
+  // here and signaled once when all have completed.
+
+  virtual void monitorAsync(AmbRelativeAddr       RCA,
+			    AmbMonitorResult_t*   result,
+			    AmbCompletionCallback callback,
+			    void*                 context);
+  // Not in the Linux version:  send a monitor request which calls back instead of
+  // posting a semaphore.  result is filled in before callback(context) is called
+  // on the bus thread.  The callback must not block.
+
   virtual void flushNode(ACS::Time                      TimeEvent,
              ACS::Time*                     timestamp,
              AmbErrorCode_t*                status);
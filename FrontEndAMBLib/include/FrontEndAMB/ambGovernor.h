@@ -0,0 +1,186 @@
+#ifndef AMBGOVERNOR_H_
+#define AMBGOVERNOR_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2003
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+#include "ambInterface.h"
+#include <atomic>
+#include <chrono>
+#include <pthread.h>
+
+typedef unsigned (*AmbDeviceClassifier)(AmbRelativeAddr RCA);
+///< Maps an RCA to the device number 0 to AmbGovernor::MAX_DEVICES - 1 which it belongs to.
+///< Device 0 is the infrastructure shared by all cartridges.
+
+/// Allocation and usage of one AmbGovernor budget or device.
+struct AmbGovernorStats {
+    double share;                   ///< configured share of the bus, percent.
+    double allocated;               ///< transactions per second guaranteed by the share.
+    double rate;                    ///< transactions per second measured over the last window.
+    double utilization;             ///< rate / allocated, percent.  Over 100 when using reclaimed share.
+    unsigned long transactions;     ///< messages sent.
+    unsigned long borrowed;         ///< of those, sent using share reclaimed from other budgets.
+    unsigned long throttled;        ///< messages which had to wait for a token.
+    double totalWait;               ///< sum of the time throttled messages waited, ms.
+
+    AmbGovernorStats()
+      : share(0), allocated(0), rate(0), utilization(0), transactions(0), borrowed(0), throttled(0), totalWait(0)
+      {}
+};
+
+/// AmbGovernor sits in front of another AmbInterfaceBus and limits the transactions per second sent
+/// through it, dividing them between three budgets:  the observing cartridge, the other cartridges,
+/// and the infrastructure.  Each budget is a token bucket filled at its share of the total rate.
+/// Tokens which overflow a full bucket go to a spare bucket which any budget may draw on, so that
+/// share left unused by one budget is reclaimed by the others.
+///
+/// The budget for a message is found from its RCA by the classifier and from the observing and
+/// powered devices, which are set by the front end as cartridges change state.  These are kept
+/// statically since there is only one front end, like the AmbLatencyTable classifier.
+///
+/// A sender with no token waits in sendMessage() until one is available, but for no longer than the
+/// message's deadline.  AMB_PRIORITY_CONTROL messages never wait:  they are charged to their budget,
+/// which may go into debt, so that the monitoring which shares it waits instead.  Messages released
+/// by the bus's own AmbScheduler for a targetTE don't pass through here and are not counted.
+class AmbGovernor : public AmbInterfaceBus {
+public:
+    enum Budget {
+        OBSERVING,                  ///< the cartridge selected for observing.
+        CARTRIDGE,                  ///< all other cartridges.
+        INFRASTRUCTURE,             ///< device 0:  cryostat, LPR, IF switch, power distribution, FEMC.
+        NUM_BUDGETS
+    };
+
+    enum {
+        MAX_DEVICES = 16,           ///< devices which can be told apart.  Cartridges are 1-10.
+        WINDOW_MS = 1000,           ///< length of the window over which rates are measured, ms.
+        BURST_MS = 50               ///< bucket sizes, as ms of their fill rates.
+    };
+
+    AmbGovernor(AmbInterfaceBus &bus, double maxRate,
+                double observingShare = 50, double cartridgeShare = 30, double infrastructureShare = 20);
+    ///< construct in front of bus.  maxRate is the total transactions per second.  0 = no limit.
+    ///< The shares are relative weights, normally percent.
+    virtual ~AmbGovernor();
+
+    virtual void sendMessage(const AmbMessage_t &msg);
+    ///< Wait for a token and forward a single message.
+
+    virtual void sendMessages(const AmbMessage_t *msgs, unsigned count);
+    ///< Wait for a token for each message and forward them as one batch.
+
+    virtual void shutdown();
+    ///< Release any waiting senders and shut down the bus.
+
+    void configure(double maxRate, double observingShare, double cartridgeShare, double infrastructureShare);
+    ///< change the total rate and the shares.  The buckets start full.
+
+    double getMaxRate() const
+      { return maxRate_m; }
+    ///< the total transactions per second.  0 = no limit.
+
+    void getStats(Budget budget, AmbGovernorStats &target);
+    ///< get the allocation and usage of a budget.
+
+    void getDeviceStats(unsigned device, AmbGovernorStats &target);
+    ///< get the usage of a device, with its allocation as an equal part of its budget.
+
+    double getUtilization();
+    ///< measured rate of all messages as a percent of maxRate.  0 if no limit.
+
+    void resetStats();
+    ///< zero the counters.
+
+    static void setClassifier(AmbDeviceClassifier classifier)
+      { classifier_mp.store(classifier); }
+    ///< Set the function used to find the device of an RCA.  If none, all messages are infrastructure.
+
+    static void setObserving(unsigned device)
+      { observing_m.store((device < MAX_DEVICES) ? device : 0); }
+    ///< Set the device which is observing.  0 = none.  Safe to call from any thread.
+
+    static unsigned getObserving()
+      { return observing_m.load(); }
+
+    static void setPowered(unsigned device, bool powered);
+    ///< Record whether a cartridge is powered.  Used for dividing the CARTRIDGE budget among devices.
+    ///< Safe to call from any thread.
+
+    static Budget budgetFor(unsigned device);
+    ///< the budget which a device currently draws from.
+
+    static const char *budgetName(Budget budget);
+    ///< "observing", "cartridge", or "infrastructure".
+
+private:
+    // forbid copy construct, assignment:
+    AmbGovernor(const AmbGovernor &other);
+    AmbGovernor &operator =(const AmbGovernor &other);
+
+    typedef std::chrono::steady_clock Clock;
+
+    /// A token bucket and the counters for one budget.
+    struct Bucket {
+        double share;               ///< normalized share of maxRate_m, 0 to 1.
+        double fillRate;            ///< tokens per ms.
+        double capacity;            ///< maximum tokens.
+        double tokens;              ///< tokens available.
+    };
+
+    /// Counters for one budget or device.
+    struct Usage {
+        unsigned long transactions;
+        unsigned long windowStart;  ///< transactions at the start of the current window.
+        double rate;                ///< transactions per second over the last full window.
+        unsigned long borrowed;
+        unsigned long throttled;
+        double totalWait;           ///< ms.
+    };
+
+    void acquire(const AmbMessage_t &msg);
+    ///< wait until msg may be sent and count it.
+
+    void refill(Clock::time_point now);
+    ///< add the tokens earned since the last refill and close the rate window if it has ended.  Mutex locked.
+
+    void fill(const Usage &source, AmbGovernorStats &target) const;
+    ///< copy counters into stats.  Mutex locked.
+
+    static unsigned deviceFor(const AmbMessage_t &msg);
+    ///< the device a message belongs to, from its RCA.
+
+    AmbInterfaceBus &bus_m;                 ///< where messages are sent.
+    double maxRate_m;                       ///< total transactions per second.  0 = no limit.
+    Bucket buckets_m[NUM_BUDGETS];          ///< one per budget.
+    Bucket spare_m;                         ///< tokens overflowing the budgets' buckets.
+    Usage budgetUsage_m[NUM_BUDGETS];       ///< counters per budget.
+    Usage deviceUsage_m[MAX_DEVICES];       ///< counters per device.
+    Usage totalUsage_m;                     ///< counters for all messages.
+    Clock::time_point lastRefill_m;         ///< when tokens were last added.
+    Clock::time_point windowStart_m;        ///< start of the current rate window.
+    bool stop_m;                            ///< true once shut down:  senders no longer wait.
+    mutable pthread_mutex_t mutex_m;        ///< protects all of the above.
+
+    static std::atomic<AmbDeviceClassifier> classifier_mp; ///< maps RCA to device.  May be NULL.
+    static std::atomic<unsigned> observing_m;   ///< the observing device.  0 = none.
+    static std::atomic<unsigned> powered_m;     ///< bit n set if device n is powered.
+};
+
+#endif /*AMBGOVERNOR_H_*/
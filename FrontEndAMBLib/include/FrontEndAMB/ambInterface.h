@@ -39,6 +39,10 @@ public:
       {}
 
     virtual void sendMessage(const AmbMessage_t &msg) = 0;
+
+    virtual void sendMessages(const AmbMessage_t *msgs, unsigned count)
+      { for (unsigned index = 0; index < count; ++index) sendMessage(msgs[index]); }
+    // Send a batch of messages.  A bus may override this to queue them all in one step.
     
     virtual void shutdown() = 0;
 };
@@ -53,6 +57,8 @@ public:
 
     void sendMessage(const AmbMessage_t& msg) const;
 
+    void sendMessages(const AmbMessage_t* msgs, unsigned count) const;
+
     AmbErrorCode_t findSN(unsigned char   serialNumber[],
                           AmbChannel      channel,
                           AmbNodeAddr     nodeAddress,
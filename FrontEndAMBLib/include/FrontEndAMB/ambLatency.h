@@ -0,0 +1,171 @@
+#ifndef AMBLATENCY_H_
+#define AMBLATENCY_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2003
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+#include "ambDefs.h"
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <pthread.h>
+
+void ambWaitUntil(std::chrono::steady_clock::time_point due);
+///< Wait until due, more precisely than the system sleep allows:  sleep through all but the last
+///< millisecond, then yield the processor until the time has come.  Returns at once if due has passed.
+
+/// AmbLatencyHistogram counts latencies in microseconds in log-linear buckets, after HdrHistogram:
+/// values below SUB_BUCKETS are counted exactly, and each power of two above that is split into
+/// SUB_BUCKETS linear buckets, so any value is resolved to within 1/SUB_BUCKETS, about 3%.
+/// Recording is a few relaxed atomic adds and is safe from any number of threads.
+class AmbLatencyHistogram {
+public:
+    enum {
+        SUB_BITS = 5,                               ///< log2 of the buckets per power of two.
+        SUB_BUCKETS = 1 << SUB_BITS,                ///< buckets per power of two.
+        MAX_BITS = 32,                              ///< values up to 2^32 - 1 us, about 71 minutes.
+        BUCKETS = SUB_BUCKETS * (MAX_BITS - SUB_BITS + 1)
+    };
+
+    AmbLatencyHistogram()
+      { reset(); }
+
+    void record(unsigned long us);
+    ///< count one latency.
+
+    void add(const AmbLatencyHistogram &other);
+    ///< accumulate the counts from another histogram.
+
+    void reset();
+    ///< zero all counts.
+
+    unsigned long count() const
+      { return count_m.load(std::memory_order_relaxed); }
+    ///< number of latencies recorded.
+
+    unsigned long maxValue() const
+      { return max_m.load(std::memory_order_relaxed); }
+    ///< largest latency recorded, us.
+
+    double mean() const;
+    ///< mean latency, us.
+
+    unsigned long percentile(double percent) const;
+    ///< the latency which percent of those recorded are at or below, us.
+    ///< Reported as the upper edge of its bucket, but never more than maxValue().
+
+    static unsigned bucketIndex(unsigned long us);
+    ///< the bucket which counts a value.
+
+    static unsigned long bucketUpperEdge(unsigned index);
+    ///< the largest value counted by a bucket.
+
+private:
+    // forbid copy construct, assignment:
+    AmbLatencyHistogram(const AmbLatencyHistogram &other);
+    AmbLatencyHistogram &operator =(const AmbLatencyHistogram &other);
+
+    std::atomic<unsigned long> buckets_m[BUCKETS];  ///< counts per bucket.
+    std::atomic<unsigned long> count_m;             ///< total count.
+    std::atomic<unsigned long long> sum_m;          ///< sum of values recorded, us.
+    std::atomic<unsigned long> max_m;               ///< largest value recorded, us.
+};
+
+/// Identifies the messages counted by one AmbLatencyTable entry.
+struct AmbLatencyKey {
+    AmbChannel channel;
+    AmbNodeAddr node;
+    unsigned subsystem;         ///< as given by the AmbSubsystemClassifier.
+};
+
+typedef unsigned (*AmbSubsystemClassifier)(AmbRelativeAddr RCA);
+///< Maps an RCA to a subsystem number 0-255 for grouping latency statistics.
+
+/// AmbLatencyTable keeps a pair of AmbLatencyHistogram for queueing delay and bus round-trip time
+/// for each channel, node and subsystem seen.  The subsystem is found from the RCA by the
+/// classifier, if one is set, otherwise it is the RCA's 4K block.
+///
+/// Entries are found by lock-free lookup in a fixed-size open addressed table.  A mutex is only
+/// taken the first time a key is seen.  Entries are never removed, so a pointer to one stays valid.
+/// If the table fills, further keys are counted together in an overflow entry.
+class AmbLatencyTable {
+public:
+    enum {
+        SLOTS = 256,                ///< maximum number of distinct keys.
+        ANY = -1                    ///< wildcard for merge().
+    };
+
+    struct Entry {
+        AmbLatencyKey key;
+        AmbLatencyHistogram queueDelay;     ///< time spent waiting in the channel queue.
+        AmbLatencyHistogram roundTrip;      ///< time from sending to the response or send completed.
+    };
+
+    AmbLatencyTable();
+    ~AmbLatencyTable();
+
+    static void setClassifier(AmbSubsystemClassifier classifier)
+      { classifier_mp = classifier; }
+    ///< Set the function used to find the subsystem of an RCA.
+
+    void recordQueueDelay(const AmbMessage_t &msg, unsigned long us)
+      { find(msg).queueDelay.record(us); }
+    ///< count the time msg waited in the queue.
+
+    void recordRoundTrip(const AmbMessage_t &msg, unsigned long us)
+      { find(msg).roundTrip.record(us); }
+    ///< count the time msg took on the bus.
+
+    void merge(int channel, long node, int subsystem,
+               AmbLatencyHistogram &queueDelay, AmbLatencyHistogram &roundTrip) const;
+    ///< Accumulate all entries which match into the target histograms.  Pass ANY to match all values.
+
+    void getKeys(std::vector<AmbLatencyKey> &target) const;
+    ///< Get the keys seen so far.
+
+    void reset();
+    ///< Zero all counts.  Keys seen are kept.
+
+private:
+    // forbid copy construct, assignment:
+    AmbLatencyTable(const AmbLatencyTable &other);
+    AmbLatencyTable &operator =(const AmbLatencyTable &other);
+
+    Entry &find(const AmbMessage_t &msg);
+    ///< the entry for the message's channel, node and subsystem.  Creates it if needed.
+
+    Entry &insert(unsigned packed, const AmbLatencyKey &key);
+    ///< create an entry under the mutex.
+
+    static unsigned hash(unsigned packed)
+      { return (packed * 2654435761U) >> 24; }
+    ///< initial slot for a packed key.
+
+    static bool matches(const AmbLatencyKey &key, int channel, long node, int subsystem);
+    ///< true if the key matches the arguments to merge().
+
+    std::atomic<unsigned> packed_m[SLOTS];  ///< packed key for each slot.  0 = empty.
+    Entry *entries_m[SLOTS];                ///< entry for each slot.  Written before the key is published.
+    Entry overflow_m;                       ///< counts keys which didn't fit.
+    pthread_mutex_t insertMutex_m;          ///< serializes inserting entries.
+
+    static AmbSubsystemClassifier classifier_mp;    ///< maps RCA to subsystem.  May be NULL.
+};
+
+#endif /*AMBLATENCY_H_*/
@@ -21,30 +21,139 @@
 */
 
 #include "ambDefs.h"
-#include <list>
+#include <atomic>
+#include <chrono>
 
-/// declare an STL base class for the queue:
-typedef std::list<AmbMessage_t> AmbQueue_t;
+/// Counters kept by AmbQueue for each priority class.
+struct AmbQueueStats {
+    unsigned long enqueued;         ///< messages appended.
+    unsigned long sent;             ///< messages taken for sending.
+    unsigned long dropped;          ///< messages dropped unsent because their deadline passed.
+    double totalDelay;              ///< sum of the time spent queued by sent and dropped messages, us.
+    unsigned long maxDelay;         ///< longest time spent queued, us.
 
-/// AmbQueue is a thread-safe list of messages waiting to be sent on the CAN bus.
+    AmbQueueStats()
+      : enqueued(0), sent(0), dropped(0), totalDelay(0), maxDelay(0)
+      {}
+
+    double averageDelay() const
+      { return (sent + dropped) ? totalDelay / (sent + dropped) : 0.0; }
+    ///< mean time spent queued, us.
+
+    void add(const AmbQueueStats &other);
+    ///< accumulate the counters from another queue.
+};
+
+/// AmbQueue is a thread-safe queue of messages waiting to be sent on the CAN bus.
 /// It stands in for the FIFOs used by the AmbServer and AmbInterface classes in the real ABM. 
-class AmbQueue : public AmbQueue_t {
+///
+/// It holds a bounded ring of AmbMessage_t slots for each AmbPriority_t class, which many threads 
+/// may append to while a single worker thread removes from.  The worker always takes from the 
+/// highest priority ring which has a message, so within a class messages stay in FIFO order.
+/// The rings themselves are lock-free: each slot carries a sequence number which tells producers 
+/// and the consumer whether it is free or filled.  Counting semaphores track the free slots in each 
+/// ring and the filled slots in all rings so that the worker can block until a message arrives and a
+/// producer blocks only if its ring is full.  No memory is allocated per message.
+///
+/// A message with a non-zero deadline which has waited longer than that when it reaches the
+/// head of the queue is not returned but dropped, signaling the caller with AMBERR_EXPIRED.
+class AmbQueue {
 
 public:
-    AmbQueue()
-      { pthread_mutex_init(&mutex, NULL); }
-    ~AmbQueue()
-      { flush();
-        pthread_mutex_destroy(&mutex); }    
+    enum { DEFAULT_CAPACITY = 256 };
+    ///< Default number of slots per priority class.  Always rounded up to a power of two.
+
+    AmbQueue(unsigned capacity = DEFAULT_CAPACITY);
+    ~AmbQueue();
 
     void flush();
-        
+    ///< Remove all pending messages, signaling each caller with AMBERR_FLUSHED.
+
     void append(const AmbMessage_t& msg);
-    
-    bool getNext(AmbMessage_t& msg);    
-    
+    ///< Add a message to the queue for its priority class.  Blocks only if that class is full.
+
+    void append(const AmbMessage_t *msgs, unsigned count);
+    ///< Add several messages, making them visible to the consumer together.
+
+    bool getNext(AmbMessage_t& msg);
+    ///< Remove the next message without waiting.  Returns false if the queue is empty.
+
+    bool waitNext(AmbMessage_t& msg);
+    ///< Block until a message is available or wake() is called.
+    ///< Returns false if woken with no message available.
+
+    void wake();
+    ///< Release a thread blocked in waitNext().  Used at shutdown.
+
+    bool empty() const;
+    ///< True if there are no messages waiting.
+
+    unsigned capacity() const
+      { return mask_m + 1; }
+    ///< Number of slots per priority class.
+
+    void getStats(AmbPriority_t priority, AmbQueueStats &target) const;
+    ///< Get the counters for a priority class.
+
+    void resetStats();
+    ///< Zero the counters for all classes.
+
+    unsigned long lastDelay() const
+      { return lastDelay_m; }
+    ///< Time the message last returned by getNext() or waitNext() spent queued, us.  For the consumer thread.
+
 private:
-    pthread_mutex_t mutex;  // Mutex to protect shared data.
+    // forbid copy construct, assignment:
+    AmbQueue(const AmbQueue &other);
+    AmbQueue &operator =(const AmbQueue &other);
+
+    typedef std::chrono::steady_clock Clock;
+
+    enum TakeResult {
+        TAKE_MESSAGE,                       ///< a message was taken.
+        TAKE_EXPIRED,                       ///< a message was taken but dropped for its deadline.
+        TAKE_WOKEN                          ///< the count was posted by wake().
+    };
+
+    struct Ring;
+
+    Ring &ringFor(const AmbMessage_t& msg)
+      { return rings_m[(msg.priority < AMB_NUM_PRIORITIES) ? msg.priority : AMB_PRIORITY_BACKGROUND]; }
+    ///< the ring for the message's priority class.
+
+    TakeResult take(AmbMessage_t& msg);
+    ///< remove the next message after a count has been taken from filledSlots_m.
+
+    struct Slot {
+        std::atomic<unsigned> sequence;     ///< slot state relative to the enqueue/dequeue positions.
+        AmbMessage_t msg;                   ///< message storage.
+        Clock::time_point queued;           ///< when the message was appended.
+    };
+
+    /// One lock-free ring per priority class, plus its counters.
+    struct Ring {
+        Slot *slots_p;                          ///< the ring buffer.
+        std::atomic<unsigned> enqueuePos;       ///< next position for producers to fill.
+        std::atomic<unsigned> dequeuePos;       ///< next position for the consumer to empty.
+        sem_t freeSlots;                        ///< counts free slots available to producers.
+        std::atomic<unsigned long> enqueued;    ///< counters reported by getStats():
+        std::atomic<unsigned long> sent;
+        std::atomic<unsigned long> dropped;
+        std::atomic<unsigned long long> totalDelay;
+        std::atomic<unsigned long> maxDelay;
+    };
+
+    bool push(Ring &ring, const AmbMessage_t& msg);
+    ///< lock-free insert into a ring.  Returns false if full.
+
+    bool pop(Ring &ring, AmbMessage_t& msg, Clock::time_point &queued);
+    ///< lock-free removal from a ring.  Returns false if empty.
+
+    Ring rings_m[AMB_NUM_PRIORITIES];       ///< the rings, in priority order.
+    unsigned mask_m;                        ///< capacity - 1, for wrapping positions.
+    std::atomic<int> wakeCount_m;           ///< number of pending wake() calls.
+    sem_t filledSlots_m;                    ///< counts messages ready for the consumer, plus wakes.
+    unsigned long lastDelay_m;              ///< queueing delay of the last message taken.  Consumer only.
 };
 
 #endif /*AMBQUEUE_H_*/
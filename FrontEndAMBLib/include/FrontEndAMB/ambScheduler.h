@@ -0,0 +1,131 @@
+#ifndef AMBSCHEDULER_H_
+#define AMBSCHEDULER_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2003
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+#include "ambInterface.h"
+#include <chrono>
+
+/// Counters kept by AmbScheduler.
+struct AmbSchedulerStats {
+    unsigned long scheduled;        ///< messages held for a future targetTE.
+    unsigned long released;         ///< messages released to the bus at their targetTE.
+    unsigned long immediate;        ///< messages whose targetTE had already arrived, sent at once.
+    unsigned long pending;          ///< messages currently held.
+    double totalLate;               ///< sum of release time minus targetTE, us.
+    double totalLateSquared;        ///< sum of squares of the same, us^2.
+    unsigned long maxLate;          ///< largest release time minus targetTE, us.
+
+    AmbSchedulerStats()
+      : scheduled(0), released(0), immediate(0), pending(0), totalLate(0), totalLateSquared(0), maxLate(0)
+      {}
+
+    double averageLate() const
+      { return released ? totalLate / released : 0.0; }
+    ///< mean lateness of released messages, us.
+
+    double jitter() const;
+    ///< standard deviation of the lateness of released messages, us.
+};
+
+/// AmbScheduler holds messages which have a targetTE in the future and gives them back to the
+/// bus's sendMessage() when that time arrives.  It is how monitorTE() and commandTE() are honored,
+/// so that a caller can queue a whole time-stamped sequence up front rather than sleeping between
+/// synchronous calls.
+///
+/// Held messages are kept in a hierarchical timer wheel with 1 ms ticks: LEVELS wheels of SLOTS
+/// each, where a slot on level n spans SLOTS^n ticks.  Inserting and expiring are constant time;
+/// entries on the upper levels are moved down a level each time their slot comes around.
+/// A single thread, started when the first message is scheduled, advances the wheel.
+///
+/// targetTE is in the 100 ns units of setTimeStamp().  It is converted to a steady clock time
+/// when the message is scheduled so that system clock changes don't move messages already held.
+class AmbScheduler {
+public:
+    enum {
+        LEVELS = 4,             ///< number of wheels.
+        SLOT_BITS = 6,          ///< log2 of the slots per wheel.
+        SLOTS = 1 << SLOT_BITS  ///< slots per wheel.  The wheels span 2^24 ms, about 4.6 hours.
+    };
+
+    AmbScheduler(AmbInterfaceBus &bus);
+    ///< construct with the bus which will send the messages when released.
+
+    ~AmbScheduler();
+
+    bool schedule(const AmbMessage_t &msg);
+    ///< Hold the message until its targetTE.
+    ///< Returns false without holding it if targetTE is zero or less than one tick away.
+
+    void shutdown();
+    ///< Stop the scheduler thread and flush all held messages, signaling each caller with AMBERR_FLUSHED.
+
+    void getStats(AmbSchedulerStats &target) const;
+    ///< Get the counters.
+
+    void resetStats();
+    ///< Zero the counters.
+
+private:
+    // forbid copy construct, assignment:
+    AmbScheduler(const AmbScheduler &other);
+    AmbScheduler &operator =(const AmbScheduler &other);
+
+    typedef std::chrono::steady_clock Clock;
+
+    struct Entry {
+        AmbMessage_t msg;               ///< the held message.
+        Clock::time_point due;          ///< when to release it.
+        unsigned long long tick;        ///< due, as a tick count since start_m.
+        Entry *next_p;                  ///< link within a slot or the free list.
+    };
+
+    unsigned long long currentTick() const;
+    ///< ticks elapsed since start_m.
+
+    void insert(Entry *entry, Entry *&ready);
+    ///< place an entry in the wheel or, if its tick has arrived, onto the ready list.  Mutex locked.
+
+    void advance(unsigned long long toTick, Entry *&ready);
+    ///< move the wheel forward, collecting entries which are due on the ready list.  Mutex locked.
+
+    bool dueSoon() const;
+    ///< true if anything is due on the next tick.  Mutex locked.
+
+    void release(Entry *ready);
+    ///< send each ready entry to the bus and recycle it.  Mutex NOT locked.
+
+    static void *schedulerThread(AmbScheduler *owner);
+    ///< The function which the scheduler thread runs.
+
+    AmbInterfaceBus &bus_m;                 ///< where released messages are sent.
+    Clock::time_point start_m;              ///< time of tick zero.
+    unsigned long long tick_m;              ///< the tick the wheel has been advanced to.
+    Entry *wheel_m[LEVELS][SLOTS];          ///< the wheels.  Each slot is a singly-linked list.
+    Entry *freeList_mp;                     ///< recycled entries.
+    AmbSchedulerStats stats_m;              ///< counters.  pending is the count of entries in the wheel.
+    mutable pthread_mutex_t mutex_m;        ///< protects all of the above.
+    sem_t wake_m;                           ///< posted to wake the thread when the wheel was empty.
+    pthread_t thread_m;                     ///< handle for the scheduler thread.
+    bool started_m;                         ///< true while the thread has been created and not yet joined.
+    bool stop_m;                            ///< true tells the thread to exit.
+};
+
+#endif /*AMBSCHEDULER_H_*/
@@ -0,0 +1,102 @@
+#ifndef AMBTRACE_H_
+#define AMBTRACE_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2003
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ * Binary trace files of CAN transactions, for capture and replay.
+ *
+ * A trace is an AmbTraceHeader followed by one AmbTraceRecord per transaction,
+ * in the order the transactions completed.  All fields are little-endian.
+ *----------------------------------------------------------------------
+ */
+
+#include "ambDefs.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <pthread.h>
+
+/// The start of a trace file.
+struct AmbTraceHeader {
+    char magic[8];              ///< "AMBTRACE"
+    uint32_t version;           ///< AmbTraceWriter::VERSION
+    uint32_t recordSize;        ///< sizeof(AmbTraceRecord) when written.
+    uint64_t startTime;         ///< when the trace was opened, in the 100 ns units of setTimeStamp().
+};
+
+/// One transaction in a trace file.
+struct AmbTraceRecord {
+    uint64_t sent;              ///< when the transaction started, us after AmbTraceHeader::startTime.
+    uint64_t timestamp;         ///< when it completed, in the 100 ns units of setTimeStamp().
+    uint32_t address;           ///< AMB address: node and RCA.
+    uint32_t latency;           ///< bus round-trip time, us.  Does not include time spent queued.
+    uint8_t channel;
+    uint8_t requestType;        ///< AmbTransaction_t
+    uint8_t status;             ///< AmbErrorCode_t
+    uint8_t requestLength;      ///< payload length of a command.
+    uint8_t responseLength;     ///< payload length of a monitor response.
+    uint8_t reserved[3];
+    uint8_t request[AMB_DATA_MSG_SIZE];
+    uint8_t response[AMB_DATA_MSG_SIZE];
+};
+
+/// AmbTraceWriter appends transactions to a trace file.  A bus records each transaction as it completes,
+/// from whichever thread completes it.  Writes are buffered and serialized by a mutex.
+class AmbTraceWriter {
+public:
+    enum { VERSION = 1 };
+
+    AmbTraceWriter();
+    ~AmbTraceWriter();
+
+    bool open(const std::string &fileName);
+    ///< Create the file and write the header.  Returns false if it can't be created.
+
+    void close();
+    ///< Flush and close the file.
+
+    bool isOpen() const
+      { return file_mp != NULL; }
+
+    void record(const AmbMessage_t &msg, unsigned long latency);
+    ///< Append a transaction which has been answered but not yet completed.
+    ///< The response is read from msg.completion_p.  latency is the round-trip time in us.
+
+    unsigned long getCount() const;
+    ///< the number of records written.
+
+private:
+    // forbid copy construct, assignment:
+    AmbTraceWriter(const AmbTraceWriter &other);
+    AmbTraceWriter &operator =(const AmbTraceWriter &other);
+
+    FILE *file_mp;                                  ///< the trace.  NULL if not open.
+    std::chrono::steady_clock::time_point start_m;  ///< when it was opened.
+    unsigned long count_m;                          ///< records written.
+    mutable pthread_mutex_t mutex_m;                ///< serializes writes.
+};
+
+bool readAmbTrace(const std::string &fileName, AmbTraceHeader &header, std::vector<AmbTraceRecord> &records);
+///< Read a whole trace file.  Returns false if it can't be read or is not a trace of this version.
+
+#endif /*AMBTRACE_H_*/
@@ -23,6 +23,8 @@
 // pack/unpack support between CAN payloads and data types:
 #include "ambDefs.h"
 #include "femcDefs.h"
+#include "ambCodec.h"
+#include <string>
 
 class MessagePackUnpack {
 public:
@@ -71,4 +73,23 @@ public:
     virtual FEMC_ERROR unpack(AmbDataMem_t *target, AmbDataLength_t dataLength, const AmbDataMem_t *data);
     ///< copy a CAN payload into an array of bytes.  Returns FEMC_UNPACK_ERROR on error, else FEMC_NO_ERROR.
 };
+
+/// Unpack through AmbCodec where T has one, so that the conversion is inlined at compile time.
+/// Other types go through the MessagePackUnpack virtual interface.
+template<typename T, bool SPECIALIZED = AmbCodec<T>::SPECIALIZED>
+struct AmbCodecSelect {
+    static inline FEMC_ERROR unpack(MessagePackUnpack &packer, T &target, AmbDataLength_t dataLength, const AmbDataMem_t *data)
+      { return packer.unpack(target, dataLength, data); }
+    static inline void pack(MessagePackUnpack &packer, T value, AmbDataLength_t &dataLength, AmbDataMem_t *data)
+      { packer.pack(value, dataLength, data); }
+};
+
+template<typename T>
+struct AmbCodecSelect<T, true> {
+    static inline FEMC_ERROR unpack(MessagePackUnpack &, T &target, AmbDataLength_t dataLength, const AmbDataMem_t *data)
+      { return AmbCodec<T>::unpack(target, dataLength, data); }
+    static inline void pack(MessagePackUnpack &, T value, AmbDataLength_t &dataLength, AmbDataMem_t *data)
+      { AmbCodec<T>::pack(value, dataLength, data); }
+};
+
 #endif /* INCLUDE_FRONTENDAMB_MESSAGEPACKUNPACK_H_ */
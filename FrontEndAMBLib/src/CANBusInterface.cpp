@@ -19,8 +19,10 @@
 */
 
 #include "CANBusInterface.h"
+#include "ambCompletion.h"
 #include "setTimeStamp.h"
 #include <stdio.h>
+#include <string.h>
 using namespace std;
 
 int CANBusInterface::maxChannels_m = 6;
@@ -30,7 +32,7 @@ bool CANBusInterface::enableDebug_m = false;
 // Enables debug logging of CAN traffic to stdout.
 
 bool CANBusInterface::measureLatency_m = false;
-///< Enables logging of CAN/network round-trip stats.  Default is false.
+///< Enables logging of the queueing and latency stats at shutdown.  Default is false.
 
 bool CANBusInterface::enableDebugLifecycle_m = false;
 ///< Enables debug logging of startup/shutdown to stdout.  Default is false.
@@ -44,65 +46,88 @@ int CANBusInterface::monitorTimeout_m = 2;
 
 CANBusInterface::CANBusInterface()
   : channelNodeMap_m(maxChannels_m),
+    workers_m(maxChannels_m),
+    scheduler_m(*this),
+    trace_mp(NULL),
     dieNow(false),
-    deadNow(false)
+    workersStopped_m(false)
 {
     if (enableDebugLifecycle_m)
         printf("Creating CANBusInterface\n");
-    // Create the worker thread, passing this as the thread argument:
-    pthread_create(&thread_m, NULL, reinterpret_cast<void*(*)(void*)> (queueHandlerThread), this);
-    pthread_detach(thread_m);
+    pthread_mutex_init(&workersMutex_m, NULL);
+    // Create the per-channel queues.  Worker threads are started when a channel is first used:
+    for (unsigned channel = 0; channel < workers_m.size(); ++channel) {
+        ChannelWorker *worker = new ChannelWorker;
+        worker -> owner_p = this;
+        worker -> channel = channel;
+        worker -> started.store(false, std::memory_order_release);
+        workers_m[channel] = worker;
+    }
 }
 
 CANBusInterface::~CANBusInterface() {
     if (enableDebugLifecycle_m)
         printf("Destroying CANBusInterface\n");
+    // Normally shutdown() has stopped the workers.  If not, stop them now so that none is left running:
+    if (!workersStopped_m) {
+        dieNow = true;
+        stopWorkers();
+    }
+    for (unsigned channel = 0; channel < workers_m.size(); ++channel)
+        delete workers_m[channel];
+    pthread_mutex_destroy(&workersMutex_m);
 }
 
 void CANBusInterface::sendMessage(const AmbMessage_t& msg) {
-    bool doSend = true;
-    // Before enqueueing the message, check whether we are shutting down:    
-    if (dieNow) {
-        printf("CANBusInterface::sendMessage no send in shutting down state\n");
-        doSend = false;
+    // If not able to send, reject the message:
+    if (!readyToSend(msg.channel)) {
+        rejectMessage(msg);
+        return;
     }
-    
-    // Not shutting down.  Is the channel open?
-    else if (!channelNodeMap_m.isOpenChannel(msg.channel))
-        // no. Try opening the channel:
-        if (!openChannel(msg.channel)) {
-            doSend = false; // Opening channel failed.
-            printf("CANBusInterface::sendMessage cannot open channel to send\n");
-        }
-    
-    // If not sending...
-    if (!doSend) {
-        // Reject the command and signal the caller that we're done with the message:
-        if (msg.completion_p -> status_p)
-            *(msg.completion_p -> status_p) = AMBERR_INITFAILED;    // TODO: is this the right error code?
-        if (msg.completion_p -> synchLock_p)                    
-            sem_post(msg.completion_p -> synchLock_p);
-        // Destroy the caller's completion structure:
-        delete msg.completion_p;
+    // Hold it if it is to be sent at a future time:
+    if (scheduler_m.schedule(msg))
+        return;
+    // At this point it's safe to queue the command for sending on its channel:
+    appendToQueue(getWorker(msg.channel), &msg, 1);
+}
+
+void CANBusInterface::sendMessages(const AmbMessage_t *msgs, unsigned count) {
+    if (!count)
+        return;
+    // Batches are normally for one channel and untimed.  If not, send them one at a time:
+    bool together = true;
+    for (unsigned index = 0; together && index < count; ++index) {
+        if (msgs[index].channel != msgs[0].channel || msgs[index].targetTE)
+            together = false;
+    }
+    if (!together) {
+        for (unsigned index = 0; index < count; ++index)
+            sendMessage(msgs[index]);
+        return;
+    }
+    if (!readyToSend(msgs[0].channel)) {
+        for (unsigned index = 0; index < count; ++index)
+            rejectMessage(msgs[index]);
         return;
     }
-    // At this point it's safe to queue the command for sending:
-    queue_m.append(msg);
+    appendToQueue(getWorker(msgs[0].channel), msgs, count);
 }
 
 void CANBusInterface::shutdown() {
     if (enableDebugLifecycle_m)
         printf("CANBusInterface::shutdown()...\n");
 
-    // Tell the worker thread to die:
+    // Refuse new messages and tell the worker threads to die:
     dieNow = true;
 
-    // Spin until the thread sets deadNow to true:
-    while (!deadNow)
-        SLEEP(20);
+    if (measureLatency_m)
+        logQueueStats();
 
-    // Flush the message queue:
-    queue_m.flush();
+    // Stop releasing timed messages and flush those still held:
+    scheduler_m.shutdown();
+
+    // Wake the threads and wait for them to exit, then flush their message queues:
+    stopWorkers();
     
     // Close all open channels:
     AmbChannel channel;
@@ -114,69 +139,228 @@ void CANBusInterface::shutdown() {
 
 }
 
+void CANBusInterface::getQueueStats(AmbPriority_t priority, AmbQueueStats &target) const {
+    target = AmbQueueStats();
+    for (unsigned channel = 0; channel < workers_m.size(); ++channel) {
+        AmbQueueStats stats;
+        workers_m[channel] -> queue.getStats(priority, stats);
+        target.add(stats);
+    }
+}
+
+void CANBusInterface::resetQueueStats() {
+    for (unsigned channel = 0; channel < workers_m.size(); ++channel)
+        workers_m[channel] -> queue.resetStats();
+}
+
+// --------------------------------------------------------------------------
+//protected:
+
+void CANBusInterface::dispatchMessage(unsigned long handle, AmbMessage_t &msg) {
+    if (!noTransmit_m) {            
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (msg.requestType == AMB_MONITOR || msg.requestType == AMB_MONITOR_NEXT) 
+            monitorImpl(handle, msg);
+        else if (msg.requestType == AMB_CONTROL || msg.requestType == AMB_CONTROL_NEXT)
+            commandImpl(handle, msg);
+        recordRoundTrip(msg, (unsigned long) std::chrono::duration_cast<std::chrono::microseconds>
+                                 (std::chrono::steady_clock::now() - start).count());
+    } else {
+        // Debugging code to treat all commands as timed out:
+        if (msg.completion_p -> dataLength_p)
+            *(msg.completion_p -> dataLength_p) = 0;
+        if (msg.completion_p -> data_p)
+            memset(msg.completion_p -> data_p, 0, AMB_DATA_MSG_SIZE);
+        if (msg.completion_p -> status_p)
+            *(msg.completion_p -> status_p) = AMBERR_TIMEOUT;
+    }
+    completeMessage(msg);
+}
+
+void CANBusInterface::completeMessage(AmbMessage_t &msg) {
+    // Set the time stamp completed:
+    setTimeStamp(msg.completion_p -> timestamp_p);
+    // Signal the caller that the request completed and recycle the completion structure:
+    AmbCompletionPool::complete(msg.completion_p);
+}
+
+void CANBusInterface::recordRoundTrip(const AmbMessage_t &msg, unsigned long us) {
+    latency_m.recordRoundTrip(msg, us);
+    AmbTraceWriter *trace = trace_mp;
+    if (trace)
+        trace -> record(msg, us);
+}
+
+bool CANBusInterface::getNextQueued(AmbChannel channel, AmbMessage_t &msg) {
+    if (channel >= workers_m.size())
+        return false;
+    AmbQueue &queue = workers_m[channel] -> queue;
+    if (!queue.getNext(msg))
+        return false;
+    latency_m.recordQueueDelay(msg, queue.lastDelay());
+    return true;
+}
+
 // --------------------------------------------------------------------------
 //private:
 
-// The worker thread function pulls commands out of the queue and dispatches them:                                        
-void *CANBusInterface::queueHandlerThread(CANBusInterface *owner) {
-    if (!owner)
+bool CANBusInterface::readyToSend(AmbChannel channel) {
+    // Before enqueueing, check whether we are shutting down:    
+    if (dieNow) {
+        printf("CANBusInterface::sendMessage no send in shutting down state\n");
+        return false;
+    }
+    
+    // Not shutting down.  Is the channel in range?
+    if (channel >= workers_m.size()) {
+        printf("CANBusInterface::sendMessage channel %u out of range\n", (unsigned) channel);
+        return false;
+    }
+
+    // Is the channel open?
+    if (!channelNodeMap_m.isOpenChannel(channel)) {
+        // no. Try opening the channel:
+        if (!openChannel(channel)) {
+            printf("CANBusInterface::sendMessage cannot open channel to send\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+void CANBusInterface::rejectMessage(const AmbMessage_t &msg) {
+    // Reject the command and signal the caller that we're done with the message:
+    if (msg.completion_p -> status_p)
+        *(msg.completion_p -> status_p) = AMBERR_INITFAILED;    // TODO: is this the right error code?
+    // Recycle the caller's completion structure:
+    AmbCompletionPool::complete(msg.completion_p);
+}
+
+CANBusInterface::ChannelWorker *CANBusInterface::getWorker(AmbChannel channel) {
+    if (channel >= workers_m.size())
         return NULL;
+    ChannelWorker *worker = workers_m[channel];
+    if (!worker -> started.load(std::memory_order_acquire)) {
+        pthread_mutex_lock(&workersMutex_m);
+        // Check again now that we hold the lock:
+        if (!worker -> started.load(std::memory_order_acquire) && !dieNow) {
+            // Create the worker thread, passing the worker as the thread argument:
+            pthread_create(&worker -> thread, NULL, reinterpret_cast<void*(*)(void*)> (queueHandlerThread), worker);
+            worker -> started.store(true, std::memory_order_release);
+        }
+        pthread_mutex_unlock(&workersMutex_m);
+    }
+    return worker;
+}
+
+void CANBusInterface::appendToQueue(ChannelWorker *worker, const AmbMessage_t *msgs, unsigned count) {
+    if (count == 1)
+        worker -> queue.append(*msgs);
+    else
+        worker -> queue.append(msgs, count);
+    // readyToSend() passed, but shutdown may have stopped the workers since.  If so nothing will take
+    // these from the queue, so flush them.  Either we see workersStopped_m or stopWorkers() sees our messages:
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (workersStopped_m) {
+        pthread_mutex_lock(&workersMutex_m);
+        worker -> queue.flush();
+        pthread_mutex_unlock(&workersMutex_m);
+    }
+}
+
+void CANBusInterface::stopWorkers() {
+    pthread_mutex_lock(&workersMutex_m);
+    for (unsigned channel = 0; channel < workers_m.size(); ++channel) {
+        if (workers_m[channel] -> started.load(std::memory_order_acquire))
+            workers_m[channel] -> queue.wake();
+    }
+    pthread_mutex_unlock(&workersMutex_m);
+
+    // No new threads are started once dieNow is set, so join the ones there are without the lock:
+    for (unsigned channel = 0; channel < workers_m.size(); ++channel) {
+        ChannelWorker *worker = workers_m[channel];
+        if (worker -> started.load(std::memory_order_acquire)) {
+            pthread_join(worker -> thread, NULL);
+            worker -> started.store(false, std::memory_order_release);
+        }
+    }
+
+    // From here on the queues have no consumer.  The lock serializes flushing with appendToQueue():
+    pthread_mutex_lock(&workersMutex_m);
+    workersStopped_m = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (unsigned channel = 0; channel < workers_m.size(); ++channel)
+        workers_m[channel] -> queue.flush();
+    pthread_mutex_unlock(&workersMutex_m);
+}
+
+void CANBusInterface::logQueueStats() const {
+    static const char *className[AMB_NUM_PRIORITIES] = { "control", "measurement", "background" };
+    for (int priority = 0; priority < AMB_NUM_PRIORITIES; ++priority) {
+        AmbQueueStats stats;
+        getQueueStats((AmbPriority_t) priority, stats);
+        printf("CANBusInterface queue %s: enqueued=%lu sent=%lu dropped=%lu avg delay=%.0f us max delay=%lu us\n",
+               className[priority], stats.enqueued, stats.sent, stats.dropped, stats.averageDelay(), stats.maxDelay);
+    }
+    AmbSchedulerStats stats;
+    scheduler_m.getStats(stats);
+    printf("CANBusInterface scheduler: scheduled=%lu released=%lu immediate=%lu avg late=%.0f us jitter=%.0f us max late=%lu us\n",
+           stats.scheduled, stats.released, stats.immediate, stats.averageLate(), stats.jitter(), stats.maxLate);
+
+    // Latency per channel, node, and subsystem:
+    std::vector<AmbLatencyKey> keys;
+    latency_m.getKeys(keys);
+    for (unsigned index = 0; index < keys.size(); ++index) {
+        const AmbLatencyKey &key = keys[index];
+        AmbLatencyHistogram queueDelay, roundTrip;
+        latency_m.merge(key.channel, key.node, key.subsystem, queueDelay, roundTrip);
+        printf("CANBusInterface latency ch=%u node=0x%lX subsys=0x%02X: N=%lu queue p50=%lu p99=%lu us, "
+               "round-trip p50=%lu p99=%lu p99.9=%lu max=%lu us\n",
+               (unsigned) key.channel, (unsigned long) key.node, key.subsystem, roundTrip.count(),
+               queueDelay.percentile(50), queueDelay.percentile(99),
+               roundTrip.percentile(50), roundTrip.percentile(99), roundTrip.percentile(99.9), roundTrip.maxValue());
+    }
+}
+
+// The worker thread function pulls commands out of its channel's queue and dispatches them:                                        
+void *CANBusInterface::queueHandlerThread(ChannelWorker *worker) {
+    if (!worker || !worker -> owner_p)
+        return NULL;
+
+    CANBusInterface *owner = worker -> owner_p;
 
     if (enableDebugLifecycle_m)
-        printf("CANBusInterface queueHandlerThread started\n");
+        printf("CANBusInterface queueHandlerThread started for channel %u\n", (unsigned) worker -> channel);
 
     AmbMessage_t msg;               // place to copy the next queue item.
     unsigned long channelHandle;    // handle to the channel to use.
-    bool handleItem;                // flag to indicate a message was pulled from queue.
     
     // Infinite loop until the thread is told to die:
     while (true) {
 
-        handleItem = false;
-        channelHandle = 0;
-        
+        // Block until there is something in the queue or we are woken for shutdown:
+        bool handleItem = worker -> queue.waitNext(msg);
+
         // Check whether the thread has been told to die:
         if (owner -> dieNow) {
             if (enableDebugLifecycle_m)
                 printf("CANBusInterface queueHandlerThread stopping\n");
-            // Signal that we're dead now and exit:
-            owner -> deadNow = true;
-            pthread_exit(NULL);
-        }
-        // Oh goody, we're still alive.  See if there's anything in the queue:
-        handleItem = owner -> queue_m.getNext(msg);
-        if (handleItem)
-            channelHandle = owner -> channelNodeMap_m.getHandle(msg.channel);    
-        
-        // If nothing to do, sleep a millisecond:   
-        if (!handleItem) {
-            // Might be a bit much for "real time" but it will do for Windows.
-            SLEEP(1);
-        
-        // Dispatch the message:
-        } else {        
-            if (!noTransmit_m) {            
-                if (msg.requestType == AMB_MONITOR || msg.requestType == AMB_MONITOR_NEXT) 
-                    owner -> monitorImpl(channelHandle, msg);
-                else if (msg.requestType == AMB_CONTROL || msg.requestType == AMB_CONTROL_NEXT)
-                    owner -> commandImpl(channelHandle, msg);
-            } else {
-                // Debugging code to treat all commands as timed out:
-                if (msg.completion_p -> dataLength_p)
-                    *(msg.completion_p -> dataLength_p) = 0;
-                if (msg.completion_p -> data_p)
-                    memset(msg.completion_p -> data_p, 0, AMB_DATA_MSG_SIZE);
+            // Flush any message we just took, same as shutdown() will do for the rest of the queue:
+            if (handleItem) {
                 if (msg.completion_p -> status_p)
-                    *(msg.completion_p -> status_p) = AMBERR_TIMEOUT;
+                    *(msg.completion_p -> status_p) = AMBERR_FLUSHED;
+                AmbCompletionPool::complete(msg.completion_p);
             }
-                
-            // Set the time stamp completed:
-            setTimeStamp(msg.completion_p -> timestamp_p);
-            // Signal the caller that the request completed:
-            if (msg.completion_p -> synchLock_p)
-                sem_post(msg.completion_p -> synchLock_p);
-            // Destroy the caller's completion structure:
-            delete msg.completion_p;
+            // Exit.  shutdown() joins this thread:
+            pthread_exit(NULL);
         }
+
+        if (!handleItem)
+            continue;
+        owner -> latency_m.recordQueueDelay(msg, worker -> queue.lastDelay());
+
+        // Dispatch the message:
+        channelHandle = owner -> channelNodeMap_m.getHandle(msg.channel);    
+        owner -> dispatchMessage(channelHandle, msg);
     }
 }
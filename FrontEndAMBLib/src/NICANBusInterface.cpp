@@ -22,9 +22,6 @@
 #include <iostream>
 #include <stdio.h>
 #include <nican.h>
-#include <chrono>
-#include "delayStats.h"
-#include "logger.h"
 
 // --------------------------------------------------------------------------
 //private:
@@ -122,11 +119,6 @@ void NICANBusInterface::closeChannel(AmbChannel channel) {
 // and waiting for a reply before returning.
 void NICANBusInterface::monitorImpl(unsigned long _handle, AmbMessage_t &msg)
 {
-    // values used for measuring response time.  Enabled by measureLatency_m.
-    static delayStats<unsigned long> calc_response_time;
-    static std::vector<unsigned long> monitorTimes;
-    static unsigned int N = 1000;
-    
     NCTYPE_OBJH handle = _handle;        
     // Read and discard any stale data in the read buffer:
     flushReadBuffer(handle);
@@ -144,9 +136,6 @@ void NICANBusInterface::monitorImpl(unsigned long _handle, AmbMessage_t &msg)
     memset(request.Data, 0, AMB_DATA_MSG_SIZE);
     status = ncWrite(handle, sizeof(NCTYPE_CAN_FRAME), &request);
 
-    // start the timer after write:
-    unsigned long start = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-
     bool success = false;
     bool timeout = false;
     while (!success && !timeout) {
@@ -158,18 +147,6 @@ void NICANBusInterface::monitorImpl(unsigned long _handle, AmbMessage_t &msg)
         }
         if (status >= 0) {
             status = ncRead(handle, sizeof(NCTYPE_CAN_STRUCT), &response);
-
-            if (measureLatency_m) {
-                // collect stats on microseconds elapsed since after write:
-                unsigned long now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-                monitorTimes.push_back(now - start);
-                if (monitorTimes.size() == N) {
-                    calc_response_time.calculate(monitorTimes);
-                    LOG(LM_INFO) << "monitor elapsed N=" << N << ", mean=" << calc_response_time.mean_m 
-                                 << ", stdev=" << calc_response_time.std_m << ", max=" << calc_response_time.max_m << " us" << std::endl;
-                    monitorTimes.clear();
-                }
-            }
         
             if (enableDebug_m) {        
                 printf("monitorImpl: %x -> %x [ ", (unsigned) request.ArbitrationId, (unsigned) response.ArbitrationId);
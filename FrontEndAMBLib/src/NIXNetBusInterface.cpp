@@ -165,19 +165,6 @@ void NIXNetBusInterface::monitorImpl(unsigned long _handle, AmbMessage_t &msg)
     request.DataLength = 0;
     memset(request.Data, 0, AMB_DATA_MSG_SIZE);
 
-#ifdef MEASURE_CAN_LATENCY
-    static bool firstTime(true);
-    static LARGE_INTEGER sum, freq, start, end;
-    sum.QuadPart = 0;
-    static int count = 0;
-    static const int averagingSize = 1000;
-    if (firstTime) {
-    	firstTime = false;
-    	QueryPerformanceFrequency(&freq);
-    	printf("NIXNetBusInterface::monitorImpl:Ticks\nN\tStart\tEnd\tSum\tAvg\tFreq\n");
-    }
-    QueryPerformanceCounter(&start);
-#endif
     status = ncWrite(handle, sizeof(NCTYPE_CAN_FRAME), &request);
 
     bool success = false;
@@ -190,23 +177,6 @@ void NIXNetBusInterface::monitorImpl(unsigned long _handle, AmbMessage_t &msg)
             status = -1;
         }
         if (status >= 0) {
-
-#ifdef MEASURE_CAN_LATENCY
-        	QueryPerformanceCounter(&end);
-        	sum.QuadPart += (end.QuadPart - start.QuadPart);
-        	if (++count == averagingSize) {
-        		double avgTicks(double(sum.QuadPart) / count);
-        		printf("%d\t%f\t%f\t%f\t%f\t%f\n",
-        				count,
-						double(start.QuadPart),
-						double(end.QuadPart),
-						double(sum.QuadPart),
-						avgTicks,
-						double(freq.QuadPart));
-        		sum.QuadPart = 0;
-        		count = 0;
-        	}
-#endif
             status = ncRead(handle, sizeof(NCTYPE_CAN_STRUCT), &response);
         
             if (enableDebug_m) {        
@@ -0,0 +1,142 @@
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2006
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ *----------------------------------------------------------------------
+ */
+
+#include "ReplayBusInterface.h"
+#include <string.h>
+using namespace std::chrono;
+
+ReplayBusInterface::ReplayBusInterface(double speedup)
+  : speedup_m(speedup),
+    timeout_m(monitorTimeout_m * 1000),
+    matched_m(0),
+    unmatched_m(0)
+{
+    pthread_mutex_init(&mutex_m, NULL);
+}
+
+ReplayBusInterface::~ReplayBusInterface() {
+    shutdown();
+    pthread_mutex_destroy(&mutex_m);
+}
+
+bool ReplayBusInterface::load(const std::string &fileName) {
+    AmbTraceHeader header;
+    points_m.clear();
+    if (!readAmbTrace(fileName, header, records_m))
+        return false;
+    for (unsigned index = 0; index < records_m.size(); ++index) {
+        const AmbTraceRecord &record = records_m[index];
+        bool monitor = (record.requestType == AMB_MONITOR || record.requestType == AMB_MONITOR_NEXT);
+        Point &point = points_m[makeKey(record.channel, record.address, monitor)];
+        point.records.push_back(index);
+        point.next = 0;
+    }
+    return true;
+}
+
+const nodeList_t* ReplayBusInterface::findNodes(AmbChannel channel) {
+    if (!channelNodeMap_m.isOpenChannel(channel))
+        openChannel(channel);
+    channelNodeMap_m.clearNodes(channel);
+    // Every node addressed on the channel, with its serial number if it was read:
+    std::map<AmbNodeAddr, const AmbTraceRecord *> nodes;
+    for (unsigned index = 0; index < records_m.size(); ++index) {
+        const AmbTraceRecord &record = records_m[index];
+        if (record.channel != channel)
+            continue;
+        AmbNodeAddr node = (record.address >> 18) - 1;
+        const AmbTraceRecord *&serial = nodes[node];
+        if (!serial && (record.address & 0x3FFFF) == 0 && record.status == AMBERR_NOERR && record.responseLength == 8)
+            serial = &record;
+    }
+    for (std::map<AmbNodeAddr, const AmbTraceRecord *>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        unsigned char serialNumber[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        if (it -> second)
+            memcpy(serialNumber, it -> second -> response, 8);
+        channelNodeMap_m.addNode(channel, it -> first, serialNumber);
+    }
+    return &(channelNodeMap_m.getNodes(channel));
+}
+
+bool ReplayBusInterface::openChannel(AmbChannel channel) {
+    channelNodeMap_m.setHandle(channel, 0);
+    channelNodeMap_m.openChannel(channel);
+    return true;
+}
+
+void ReplayBusInterface::closeChannel(AmbChannel channel) {
+    if (channelNodeMap_m.isOpenChannel(channel))
+        channelNodeMap_m.closeChannel(channel);
+}
+
+void ReplayBusInterface::monitorImpl(unsigned long handle, AmbMessage_t &msg) {
+    const AmbTraceRecord *record = next(msg);
+    wait(record ? record -> latency : timeout_m);
+
+    if (msg.completion_p -> dataLength_p)
+        *(msg.completion_p -> dataLength_p) = record ? record -> responseLength : 0;
+    if (msg.completion_p -> data_p) {
+        if (record)
+            memcpy(msg.completion_p -> data_p, record -> response, AMB_DATA_MSG_SIZE);
+        else
+            memset(msg.completion_p -> data_p, 0, AMB_DATA_MSG_SIZE);
+    }
+    if (msg.completion_p -> status_p)
+        *(msg.completion_p -> status_p) = record ? (AmbErrorCode_t) record -> status : AMBERR_TIMEOUT;
+}
+
+void ReplayBusInterface::commandImpl(unsigned long handle, AmbMessage_t &msg) {
+    const AmbTraceRecord *record = next(msg);
+    wait(record ? record -> latency : 0);
+
+    // An unrecorded command goes out like any other.  It is not acknowledged:
+    if (msg.completion_p -> status_p)
+        *(msg.completion_p -> status_p) = record ? (AmbErrorCode_t) record -> status : AMBERR_NOERR;
+}
+
+const AmbTraceRecord *ReplayBusInterface::next(const AmbMessage_t &msg) {
+    bool monitor = (msg.requestType == AMB_MONITOR || msg.requestType == AMB_MONITOR_NEXT);
+    std::map<Key, Point>::iterator it = points_m.find(makeKey(msg.channel, msg.address, monitor));
+    if (it == points_m.end()) {
+        ++unmatched_m;
+        return NULL;
+    }
+    ++matched_m;
+    Point &point = it -> second;
+    pthread_mutex_lock(&mutex_m);
+    unsigned index = point.records[point.next];
+    if (point.next + 1 < point.records.size())
+        ++point.next;
+    pthread_mutex_unlock(&mutex_m);
+    return &records_m[index];
+}
+
+void ReplayBusInterface::wait(unsigned long us) {
+    if (speedup_m <= 0.0 || !us)
+        return;
+    unsigned long delay = (unsigned long) (us / speedup_m);
+    if (!delay)
+        return;
+    ambWaitUntil(steady_clock::now() + microseconds(delay));
+}
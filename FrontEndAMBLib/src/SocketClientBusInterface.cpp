@@ -28,15 +28,20 @@
 #include <array>
 #include <iostream>
 #include <chrono>
-#include <vector>
+#include <errno.h>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 #include "string.h"
 #include "stringConvert.h"
-#include "delayStats.h"
 #include "logger.h"
 using namespace std;
 
 const size_t REQUEST_LEN(18);
 
+int SocketClientBusInterface::pipelineDepth_m = 1;
+// Max number of requests in flight on the socket.  1 is stop-and-wait.
+
 struct SocketServerRequest {
     // The Request Structure consists of 18 bytes (Byte Numbers 0-17)
     short resourceId;   // Byte[0,1] are the Resource identifier. Valid values are -1 to 64 inclusive
@@ -130,15 +135,48 @@ void SocketServerNode::unpack(std::array<char, NODE_LEN> &source) {
 
 SocketClientBusInterface::SocketClientBusInterface(const std::string& host, int port)
   : io_m(),
-    sock_mp(NULL)
+    sock_mp(NULL),
+    readSock_mp(NULL),
+    pipelined_m(pipelineDepth_m > 1),
+    windowSize_m(pipelineDepth_m > 1 ? pipelineDepth_m : 1),
+    inFlight_m(windowSize_m),
+    inFlightHead_m(0),
+    inFlightCount_m(0),
+    batch_m(windowSize_m),
+    batchBytes_m(windowSize_m),
+    batchBuffers_m(),
+    readerStop_m(false),
+    readerDead_m(true)
 {
+    pthread_mutex_init(&socketMutex_m, NULL);
+    pthread_mutex_init(&inFlightMutex_m, NULL);
+    pthread_cond_init(&inFlightEmpty_m, NULL);
+    sem_init(&windowSlots_m, 0, windowSize_m);
+    sem_init(&responsesPending_m, 0, 0);
+    batchBuffers_m.reserve(windowSize_m);
+
     boost::asio::ip::tcp::resolver resolver(io_m);
     endpoints_m = resolver.resolve(host, to_string(port));
     openSocket();
+    if (pipelined_m && sock_mp) {
+        LOG(LM_INFO) << "SocketClientBusInterface pipelined mode with " << windowSize_m << " requests in flight" << endl;
+        startReader();
+    }
 }
 
 SocketClientBusInterface::~SocketClientBusInterface() {
+    stopReader();
     closeSocket();
+    sem_destroy(&windowSlots_m);
+    sem_destroy(&responsesPending_m);
+    pthread_cond_destroy(&inFlightEmpty_m);
+    pthread_mutex_destroy(&inFlightMutex_m);
+    pthread_mutex_destroy(&socketMutex_m);
+}
+
+void SocketClientBusInterface::shutdown() {
+    CANBusInterface::shutdown();
+    stopReader();
 }
 
 void SocketClientBusInterface::openSocket() {
@@ -149,24 +187,69 @@ void SocketClientBusInterface::openSocket() {
     sock_mp = new boost::asio::ip::tcp::socket(io_m);
     try {
         boost::asio::connect(*sock_mp, endpoints_m);
+        // Send each request as soon as it is written rather than waiting to fill a segment:
+        (*sock_mp).set_option(boost::asio::ip::tcp::no_delay(true));
     }
     catch (boost::system::system_error &e) {
         LOG(LM_ERROR) << "SocketClientBusInterface::openSocket connect error:\n" << e.what() << endl;
         delete sock_mp;
         sock_mp = NULL;
+        return;
     }
+    if (pipelined_m && !openReadSocket())
+        closeSocket();
 }
 
-void SocketClientBusInterface::closeSocket() {
-    if (!sock_mp)
-        return;
-    try {
-        (*sock_mp).close();
+bool SocketClientBusInterface::openReadSocket() {
+    // A socket object is not safe to use from two threads at once, even to read on one and write on the other.
+    // Give the reader thread its own handle on the connection:
+    boost::system::error_code sock_error;
+#if defined(_WIN32)
+    WSAPROTOCOL_INFOW info;
+    SOCKET handle = INVALID_SOCKET;
+    if (WSADuplicateSocketW((*sock_mp).native_handle(), GetCurrentProcessId(), &info) == 0)
+        handle = WSASocketW(FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, &info, 0, WSA_FLAG_OVERLAPPED);
+    if (handle == INVALID_SOCKET) {
+        LOG(LM_ERROR) << "SocketClientBusInterface::openReadSocket duplicate error " << WSAGetLastError() << endl;
+        return false;
     }
-    catch (boost::system::system_error &e) {
-        LOG(LM_ERROR) << "SocketClientBusInterface::closeSocket close error:\n" << e.what() << endl;
+#else
+    int handle = ::dup((*sock_mp).native_handle());
+    if (handle < 0) {
+        LOG(LM_ERROR) << "SocketClientBusInterface::openReadSocket duplicate error " << errno << endl;
+        return false;
     }
-    delete sock_mp;
+#endif
+    readSock_mp = new boost::asio::ip::tcp::socket(io_m);
+    (*readSock_mp).assign((*sock_mp).local_endpoint(sock_error).protocol(), handle, sock_error);
+    if (sock_error) {
+        LOG(LM_ERROR) << "SocketClientBusInterface::openReadSocket assign error " << sock_error.value() << endl;
+#if defined(_WIN32)
+        closesocket(handle);
+#else
+        ::close(handle);
+#endif
+        delete readSock_mp;
+        readSock_mp = NULL;
+        return false;
+    }
+    return true;
+}
+
+void SocketClientBusInterface::closeSocket() {
+    boost::asio::ip::tcp::socket *sockets[2] = { readSock_mp, sock_mp };
+    for (int index = 0; index < 2; ++index) {
+        if (!sockets[index])
+            continue;
+        try {
+            (*sockets[index]).close();
+        }
+        catch (boost::system::system_error &e) {
+            LOG(LM_ERROR) << "SocketClientBusInterface::closeSocket close error:\n" << e.what() << endl;
+        }
+        delete sockets[index];
+    }
+    readSock_mp = NULL;
     sock_mp = NULL;
 }
 
@@ -199,6 +282,9 @@ void SocketClientBusInterface::monitorImpl(unsigned long _handle, AmbMessage_t &
         return;
     }
 
+    // The socket is shared by the workers for all channels:
+    pthread_mutex_lock(&socketMutex_m);
+
     flushRead();
 
     bool error = false;      
@@ -228,6 +314,8 @@ void SocketClientBusInterface::monitorImpl(unsigned long _handle, AmbMessage_t &
     catch (std::exception& e) {
         LOG(LM_ERROR) << "SocketClientBusInterface::monitorImpl:\n" << e.what() << endl;
     }
+    pthread_mutex_unlock(&socketMutex_m);
+
     if (!error) {
         // Save the received data length into the caller's pointer:
         if (msg.completion_p -> dataLength_p)
@@ -258,6 +346,9 @@ void SocketClientBusInterface::commandImpl(unsigned long _handle, AmbMessage_t &
     }
     AmbErrorCode_t status = AMBERR_NOERR;
 
+    // The socket is shared by the workers for all channels:
+    pthread_mutex_lock(&socketMutex_m);
+
     flushRead();
     
     // Pack and send the command:
@@ -286,6 +377,8 @@ void SocketClientBusInterface::commandImpl(unsigned long _handle, AmbMessage_t &
         LOG(LM_ERROR) << "SocketClientBusInterface::commandImpl:\n" << e.what() << endl;
         status = AMBERR_WRITEERR;
     }
+    pthread_mutex_unlock(&socketMutex_m);
+
     if (msg.completion_p -> status_p) {
        *(msg.completion_p -> status_p) = status;
     }
@@ -308,13 +401,6 @@ void SocketClientBusInterface::flushRead() {
 
 
 bool SocketClientBusInterface::readResponse(boost::asio::ip::tcp::socket &sock, SocketServerResponse &target) {
-    // values used for measuring response time.  Enabed by measureLatency_m:
-    static delayStats<unsigned long> calc_response_time;
-    static std::vector<unsigned long> monitorTimes;
-    static unsigned int N = 1000;
-    auto start = std::chrono::steady_clock::now();
-    unsigned long elapsed;
-
     std::array<char, RESPONSE_LEN> buf;
     boost::system::error_code sock_error;
 
@@ -331,16 +417,6 @@ bool SocketClientBusInterface::readResponse(boost::asio::ip::tcp::socket &sock,
         error = true;
     }
     if (!error) {
-        if (measureLatency_m) {
-            elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
-            monitorTimes.push_back(elapsed);
-            if (monitorTimes.size() == N) {
-                calc_response_time.calculate(monitorTimes);
-                LOG(LM_INFO) << "monitor elapsed N=" << N << ", mean=" << calc_response_time.mean_m 
-                             << ", stdev=" << calc_response_time.std_m << ", max=" << calc_response_time.max_m << " us" << endl;
-                monitorTimes.clear();
-            }
-        }
         if (enableDebug_m) {
             printf("response: [ ");
             for (unsigned index = 0; index < RESPONSE_LEN; ++index)
@@ -367,6 +443,10 @@ void SocketClientBusInterface::findChannelNodes(AmbChannel channel) {
     // Drop all known nodes:
     channelNodeMap_m.clearNodes(channel);
 
+    // The nodes query must not be interleaved with other requests, including any in flight:
+    pthread_mutex_lock(&socketMutex_m);
+    lockWindow();
+
     bool success = false;
 
     SocketServerRequest req(2);
@@ -415,8 +495,277 @@ void SocketClientBusInterface::findChannelNodes(AmbChannel channel) {
     }
     catch (std::exception& e) {
         LOG(LM_ERROR) << "SocketClientBusInterface::findChannelNodes: " << e.what() << endl;
+    }
+    unlockWindow();
+    pthread_mutex_unlock(&socketMutex_m);
+}
+
+void SocketClientBusInterface::dispatchMessage(unsigned long handle, AmbMessage_t &msg) {
+    if (!pipelined_m || noTransmit_m || !sock_mp) {
+        CANBusInterface::dispatchMessage(handle, msg);
+        return;
+    }
+    
+    // The socket and the batch buffers are shared by the workers for all channels:
+    pthread_mutex_lock(&socketMutex_m);
+
+    // The reader thread may have failed to reconnect while we were waiting for the lock:
+    if (!sock_mp) {
+        pthread_mutex_unlock(&socketMutex_m);
+        CANBusInterface::dispatchMessage(handle, msg);
         return;
     }
+
+    // Wait for room in the window for this message:
+    sem_wait(&windowSlots_m);
+    batch_m[0] = msg;
+    int count = 1;
+
+    // Add any other queued messages for which there is room, without waiting:
+    while (count < windowSize_m && sem_trywait(&windowSlots_m) == 0) {
+        if (getNextQueued(msg.channel, batch_m[count]))
+            ++count;
+        else {
+            sem_post(&windowSlots_m);
+            break;
+        }
+    }
+
+    // Pack the requests and collect them into a buffer sequence:
+    batchBuffers_m.clear();
+    for (int index = 0; index < count; ++index) {
+        AmbMessage_t &next = batch_m[index];
+        bool isMonitor = (next.requestType == AMB_MONITOR || next.requestType == AMB_MONITOR_NEXT);
+        SocketServerRequest req(isMonitor ? 0 : 1, next.address, next.dataLen, next.data);
+        req.pack(batchBytes_m[index]);
+        batchBuffers_m.push_back(boost::asio::buffer(batchBytes_m[index]));
+        if (enableDebug_m) {
+            printf("%s: %X [ ", isMonitor ? "monitor" : "command", (unsigned) req.address);
+            for (unsigned byte = 0; byte < REQUEST_LEN; ++byte)
+                printf("%02X ", (unsigned char) batchBytes_m[index][byte]);
+            printf("]\n");
+            fflush(NULL);
+        }
+    }
+
+    // Write them all at once:
+    bool error = false;
+    try {
+        boost::system::error_code sock_error;
+        boost::asio::write(*sock_mp, batchBuffers_m, sock_error);
+        if (sock_error) {
+            LOG(LM_ERROR) << "SocketClientBusInterface::dispatchMessage write error: " << sock_error.value() << endl;
+            error = true;
+        }
+    }
+    catch (std::exception& e) {
+        LOG(LM_ERROR) << "SocketClientBusInterface::dispatchMessage:\n" << e.what() << endl;
+        error = true;
+    }
+
+    if (error) {
+        // Nothing will come back for these.  Complete them now:
+        for (int index = 0; index < count; ++index) {
+            AmbMessage_t &next = batch_m[index];
+            if (next.completion_p -> dataLength_p)
+                *(next.completion_p -> dataLength_p) = 0;
+            if (next.completion_p -> data_p)
+                memset(next.completion_p -> data_p, 0, AMB_DATA_MSG_SIZE);
+            if (next.completion_p -> status_p)
+                *(next.completion_p -> status_p) = AMBERR_WRITEERR;
+            completeMessage(next);
+            sem_post(&windowSlots_m);
+        }
+        pthread_mutex_unlock(&socketMutex_m);
+        return;
+    }
+
+    // Hand them to the reader thread in the order written.  It is safe to do this after the write
+    // because the reader does not read until it has been told to expect a response:
+    std::chrono::steady_clock::time_point sent = std::chrono::steady_clock::now();
+    pthread_mutex_lock(&inFlightMutex_m);
+    for (int index = 0; index < count; ++index) {
+        InFlightRequest &slot = inFlight_m[(inFlightHead_m + inFlightCount_m) % windowSize_m];
+        slot.msg = batch_m[index];
+        slot.sent = sent;
+        ++inFlightCount_m;
+    }
+    pthread_mutex_unlock(&inFlightMutex_m);
+    for (int index = 0; index < count; ++index)
+        sem_post(&responsesPending_m);
+    pthread_mutex_unlock(&socketMutex_m);
+}
+
+void SocketClientBusInterface::startReader() {
+    readerStop_m = false;
+    readerDead_m = false;
+    pthread_create(&readerThread_m, NULL, reinterpret_cast<void*(*)(void*)> (readerThread), this);
+}
+
+void SocketClientBusInterface::stopReader() {
+    if (readerDead_m)
+        return;
+
+    // Give requests in flight up to one second to complete:
+    std::chrono::nanoseconds due = (std::chrono::system_clock::now() + std::chrono::seconds(1)).time_since_epoch();
+    struct timespec abstime;
+    abstime.tv_sec = (time_t) std::chrono::duration_cast<std::chrono::seconds>(due).count();
+    abstime.tv_nsec = (long) (due.count() % 1000000000LL);
+    pthread_mutex_lock(&inFlightMutex_m);
+    while (inFlightCount_m > 0) {
+        if (pthread_cond_timedwait(&inFlightEmpty_m, &inFlightMutex_m, &abstime) == ETIMEDOUT)
+            break;
+    }
+    pthread_mutex_unlock(&inFlightMutex_m);
+
+    // Tell the reader thread to stop and unblock any read in progress.  Shutting down the connection through
+    // the workers' handle also ends the read on the reader's handle.
+    // The lock keeps the reader from replacing the socket while we shut it down:
+    readerStop_m = true;
+    pthread_mutex_lock(&socketMutex_m);
+    if (sock_mp) {
+        boost::system::error_code sock_error;
+        (*sock_mp).shutdown(boost::asio::ip::tcp::socket::shutdown_both, sock_error);
+    }
+    pthread_mutex_unlock(&socketMutex_m);
+    sem_post(&responsesPending_m);
+
+    pthread_join(readerThread_m, NULL);
+    readerDead_m = true;
+}
+
+void SocketClientBusInterface::failInFlight(AmbErrorCode_t status) {
+    AmbMessage_t msg;
+    while (true) {
+        pthread_mutex_lock(&inFlightMutex_m);
+        bool haveRequest = (inFlightCount_m > 0);
+        if (haveRequest) {
+            msg = inFlight_m[inFlightHead_m].msg;
+            inFlightHead_m = (inFlightHead_m + 1) % windowSize_m;
+            if (--inFlightCount_m == 0)
+                pthread_cond_broadcast(&inFlightEmpty_m);
+        }
+        pthread_mutex_unlock(&inFlightMutex_m);
+        if (!haveRequest)
+            break;
+        if (msg.completion_p -> dataLength_p)
+            *(msg.completion_p -> dataLength_p) = 0;
+        if (msg.completion_p -> data_p)
+            memset(msg.completion_p -> data_p, 0, AMB_DATA_MSG_SIZE);
+        if (msg.completion_p -> status_p)
+            *(msg.completion_p -> status_p) = status;
+        completeMessage(msg);
+        sem_post(&windowSlots_m);
+    }
+    // Their posts to responsesPending_m are left behind.  The reader thread skips those when it finds nothing in flight.
+}
+
+void SocketClientBusInterface::resyncSocket() {
+    // The window slots must be free before taking the socket lock, because dispatchMessage() waits for a slot while holding it:
+    failInFlight(AMBERR_READERR);
+
+    pthread_mutex_lock(&socketMutex_m);
+    // Anything written while we waited for the lock went to the same broken stream:
+    failInFlight(AMBERR_READERR);
+    if (!readerStop_m) {
+        LOG(LM_WARNING) << "SocketClientBusInterface::resyncSocket reconnecting" << endl;
+        closeSocket();
+        openSocket();
+    }
+    pthread_mutex_unlock(&socketMutex_m);
+}
+
+void SocketClientBusInterface::lockWindow() {
+    if (!pipelined_m)
+        return;
+    for (int index = 0; index < windowSize_m; ++index)
+        sem_wait(&windowSlots_m);
+}
+
+void SocketClientBusInterface::unlockWindow() {
+    if (!pipelined_m)
+        return;
+    for (int index = 0; index < windowSize_m; ++index)
+        sem_post(&windowSlots_m);
+}
+
+// The reader thread function reads responses and completes the requests in flight in FIFO order:
+void *SocketClientBusInterface::readerThread(SocketClientBusInterface *owner) {
+    if (!owner)
+        return NULL;
+
+    if (enableDebugLifecycle_m)
+        printf("SocketClientBusInterface readerThread started\n");
+
+    InFlightRequest request;
+    SocketServerResponse resp;
+
+    while (true) {
+        // Wait until there is a response to read or we are told to stop:
+        sem_wait(&owner -> responsesPending_m);
+
+        pthread_mutex_lock(&owner -> inFlightMutex_m);
+        bool haveRequest = (owner -> inFlightCount_m > 0);
+        if (haveRequest)
+            request = owner -> inFlight_m[owner -> inFlightHead_m];
+        pthread_mutex_unlock(&owner -> inFlightMutex_m);
+
+        if (!haveRequest) {
+            if (owner -> readerStop_m)
+                break;
+            continue;
+        }
+
+        // Only this thread replaces readSock_mp, in resyncSocket():
+        bool error = (owner -> readSock_mp == NULL) || !owner -> readResponse(*owner -> readSock_mp, resp);
+
+        if (error) {
+            // After a failed or short read we no longer know which response goes with which request.
+            // Fail this one and everything behind it, then reconnect:
+            owner -> resyncSocket();
+            continue;
+        }
+
+        // Remove it from the window:
+        pthread_mutex_lock(&owner -> inFlightMutex_m);
+        owner -> inFlightHead_m = (owner -> inFlightHead_m + 1) % owner -> windowSize_m;
+        if (--owner -> inFlightCount_m == 0)
+            pthread_cond_broadcast(&owner -> inFlightEmpty_m);
+        pthread_mutex_unlock(&owner -> inFlightMutex_m);
+
+        AmbMessage_t &msg = request.msg;
+        if (resp.errorCode != 0) {
+            // The server reported an error for this request.  Return zero data:
+            LOG(LM_ERROR) << "SocketClientBusInterface::readerThread error " << resp.errorCode
+                          << " for address " << std::hex << msg.address << std::dec << endl;
+            if (msg.completion_p -> dataLength_p)
+                *(msg.completion_p -> dataLength_p) = 0;
+            if (msg.completion_p -> data_p)
+                memset(msg.completion_p -> data_p, 0, AMB_DATA_MSG_SIZE);
+            if (msg.completion_p -> status_p)
+                *(msg.completion_p -> status_p) = AMBERR_READERR;
+        } else if (msg.requestType == AMB_MONITOR || msg.requestType == AMB_MONITOR_NEXT) {
+            // Save the received data and length into the caller's pointers:
+            if (msg.completion_p -> dataLength_p)
+                *(msg.completion_p -> dataLength_p) = resp.dataLength;
+            if (msg.completion_p -> data_p)
+                memcpy(msg.completion_p -> data_p, resp.data, resp.dataLength);
+            if (msg.completion_p -> status_p)
+                *(msg.completion_p -> status_p) = AMBERR_NOERR;
+        } else {
+            // Commands were written successfully and the server accepted them:
+            if (msg.completion_p -> status_p)
+                *(msg.completion_p -> status_p) = AMBERR_NOERR;
+        }
+        owner -> recordRoundTrip(msg, (unsigned long) std::chrono::duration_cast<std::chrono::microseconds>
+                                         (std::chrono::steady_clock::now() - request.sent).count());
+        completeMessage(msg);
+        sem_post(&owner -> windowSlots_m);
+    }
+
+    if (enableDebugLifecycle_m)
+        printf("SocketClientBusInterface readerThread stopping\n");
+    return NULL;
 }
 
 
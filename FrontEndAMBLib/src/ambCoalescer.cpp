@@ -0,0 +1,232 @@
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2003
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ *----------------------------------------------------------------------
+ */
+
+#include "ambCoalescer.h"
+#include "ambCompletion.h"
+#include <string.h>
+using namespace std::chrono;
+
+AmbCoalescer::AmbCoalescer(AmbInterfaceBus &bus, unsigned long freshness)
+  : bus_m(bus),
+    freshness_m(freshness)
+{
+    pthread_mutex_init(&mutex_m, NULL);
+}
+
+AmbCoalescer::~AmbCoalescer() {
+    // Anything still pending was flushed by the bus shutdown.  Detached points in flight
+    // are deleted by their own completion.
+    pthread_mutex_lock(&mutex_m);
+    for (std::map<Key, Point*>::iterator it = points_m.begin(); it != points_m.end(); ++it)
+        delete it -> second;
+    points_m.clear();
+    pthread_mutex_unlock(&mutex_m);
+    pthread_mutex_destroy(&mutex_m);
+}
+
+void AmbCoalescer::sendMessage(const AmbMessage_t &msg) {
+    AmbMessage_t forward;
+    if (accept(msg, forward))
+        bus_m.sendMessage(forward);
+}
+
+void AmbCoalescer::sendMessages(const AmbMessage_t *msgs, unsigned count) {
+    std::vector<AmbMessage_t> forward(count);
+    unsigned numForward = 0;
+    for (unsigned index = 0; index < count; ++index) {
+        if (accept(msgs[index], forward[numForward]))
+            ++numForward;
+    }
+    if (numForward)
+        bus_m.sendMessages(&forward[0], numForward);
+}
+
+void AmbCoalescer::shutdown() {
+    bus_m.shutdown();
+}
+
+void AmbCoalescer::setFreshness(unsigned long freshness) {
+    pthread_mutex_lock(&mutex_m);
+    freshness_m = freshness;
+    if (!freshness_m) {
+        for (std::map<Key, Point*>::iterator it = points_m.begin(); it != points_m.end(); ++it)
+            it -> second -> cached = false;
+    }
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void AmbCoalescer::getStats(AmbCoalescerStats &target) const {
+    pthread_mutex_lock(&mutex_m);
+    target = stats_m;
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void AmbCoalescer::resetStats() {
+    pthread_mutex_lock(&mutex_m);
+    stats_m = AmbCoalescerStats();
+    pthread_mutex_unlock(&mutex_m);
+}
+
+// --------------------------------------------------------------------------
+//private:
+
+bool AmbCoalescer::accept(const AmbMessage_t &msg, AmbMessage_t &forward) {
+    if (msg.requestType != AMB_MONITOR) {
+        // Anything else may change what the monitor points read back.
+        // Commands affect their own node; resets and the rest may affect the whole channel:
+        if (msg.requestType != AMB_MONITOR_NEXT) {
+            pthread_mutex_lock(&mutex_m);
+            if (msg.requestType == AMB_CONTROL || msg.requestType == AMB_CONTROL_NEXT) {
+                AmbAddr node = msg.address & ~0x3FFFFUL;
+                invalidate(makeKey(msg.channel, node), makeKey(msg.channel, node + 0x40000));
+            } else
+                invalidate(makeKey(msg.channel, 0), makeKey(msg.channel + 1, 0));
+            pthread_mutex_unlock(&mutex_m);
+        }
+        forward = msg;
+        return true;
+    }
+    // Timed, extended, and unanswerable requests go straight through:
+    if (msg.targetTE || !msg.completion_p || msg.completion_p -> contLock_p) {
+        forward = msg;
+        return true;
+    }
+
+    Key key = makeKey(msg.channel, msg.address);
+    pthread_mutex_lock(&mutex_m);
+    ++stats_m.monitors;
+    Point *point;
+    std::map<Key, Point*>::iterator it = points_m.find(key);
+    if (it != points_m.end())
+        point = it -> second;
+    else {
+        point = new Point;
+        point -> owner_p = this;
+        point -> key = key;
+        point -> pending = false;
+        point -> detached = false;
+        point -> cached = false;
+        points_m[key] = point;
+    }
+
+    if (point -> pending) {
+        // Join the request already on its way:
+        point -> waiters.push_back(msg.completion_p);
+        ++stats_m.coalesced;
+        pthread_mutex_unlock(&mutex_m);
+        return false;
+    }
+
+    if (point -> cached && freshness_m &&
+        duration_cast<microseconds>(steady_clock::now() - point -> completed).count() < (long long) freshness_m)
+    {
+        // Answer from the cache:
+        ++stats_m.cacheHits;
+        copyResult(*point, msg.completion_p);
+        pthread_mutex_unlock(&mutex_m);
+        AmbCompletionPool::complete(msg.completion_p);
+        return false;
+    }
+
+    // Send a request of our own which will fill in the point and call us back:
+    point -> pending = true;
+    point -> cached = false;
+    point -> waiters.push_back(msg.completion_p);
+    // The bus may not write every field.  Start from what the waiters would have seen:
+    point -> dataLength = 0;
+    point -> channel = msg.channel;
+    point -> address = msg.address;
+    point -> timestamp = 0;
+    point -> status = AMBERR_PENDING;
+    ++stats_m.sent;
+    pthread_mutex_unlock(&mutex_m);
+
+    forward = msg;
+    forward.completion_p = AmbCompletionPool::allocate();
+    forward.completion_p -> dataLength_p = &point -> dataLength;
+    forward.completion_p -> data_p = point -> data;
+    forward.completion_p -> channel_p = &point -> channel;
+    forward.completion_p -> address_p = &point -> address;
+    forward.completion_p -> timestamp_p = &point -> timestamp;
+    forward.completion_p -> status_p = &point -> status;
+    forward.completion_p -> callback_p = completed;
+    forward.completion_p -> context_p = point;
+    return true;
+}
+
+void AmbCoalescer::invalidate(Key first, Key last) {
+    std::map<Key, Point*>::iterator it = points_m.lower_bound(first);
+    while (it != points_m.end() && it -> first < last) {
+        Point *point = it -> second;
+        if (point -> pending) {
+            // Let it complete for the waiters it has, but don't let anyone else join it:
+            point -> detached = true;
+            points_m.erase(it++);
+            ++stats_m.invalidated;
+        } else {
+            if (point -> cached)
+                ++stats_m.invalidated;
+            point -> cached = false;
+            ++it;
+        }
+    }
+}
+
+void AmbCoalescer::completed(void *context) {
+    Point *point = static_cast<Point *>(context);
+    AmbCoalescer *owner = point -> owner_p;
+    std::vector<AmbCompletion_t*> waiters;
+
+    pthread_mutex_lock(&owner -> mutex_m);
+    waiters.swap(point -> waiters);
+    for (unsigned index = 0; index < waiters.size(); ++index)
+        copyResult(*point, waiters[index]);
+    point -> pending = false;
+    if (point -> status == AMBERR_NOERR && owner -> freshness_m && !point -> detached) {
+        point -> cached = true;
+        point -> completed = steady_clock::now();
+    }
+    bool detached = point -> detached;
+    pthread_mutex_unlock(&owner -> mutex_m);
+
+    if (detached)
+        delete point;
+    for (unsigned index = 0; index < waiters.size(); ++index)
+        AmbCompletionPool::complete(waiters[index]);
+}
+
+void AmbCoalescer::copyResult(const Point &point, AmbCompletion_t *waiter) {
+    if (waiter -> dataLength_p)
+        *(waiter -> dataLength_p) = point.dataLength;
+    if (waiter -> data_p && point.dataLength)
+        memcpy(waiter -> data_p, point.data, point.dataLength);
+    if (waiter -> channel_p)
+        *(waiter -> channel_p) = point.channel;
+    if (waiter -> address_p)
+        *(waiter -> address_p) = point.address;
+    if (waiter -> timestamp_p)
+        *(waiter -> timestamp_p) = point.timestamp;
+    if (waiter -> status_p)
+        *(waiter -> status_p) = point.status;
+}
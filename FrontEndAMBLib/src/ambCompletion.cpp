@@ -0,0 +1,166 @@
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2026 
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+#include "ambCompletion.h"
+#include <string.h>
+
+pthread_mutex_t AmbCompletionPool::mutex_m = PTHREAD_MUTEX_INITIALIZER;
+AmbCompletionPool::Node *AmbCompletionPool::freeList_mp = NULL;
+unsigned long AmbCompletionPool::numAllocated_m = 0;
+unsigned long AmbCompletionPool::numFree_m = 0;
+
+AmbCompletion_t *AmbCompletionPool::allocate() {
+    pthread_mutex_lock(&mutex_m);
+    if (!freeList_mp)
+        allocateSlab();
+    Node *node = freeList_mp;
+    freeList_mp = node -> next_p;
+    --numFree_m;
+    pthread_mutex_unlock(&mutex_m);
+
+    memset(&(node -> completion), 0, sizeof(AmbCompletion_t));
+    return &(node -> completion);
+}
+
+void AmbCompletionPool::release(AmbCompletion_t *completion) {
+    if (!completion)
+        return;
+    Node *node = reinterpret_cast<Node *>(completion);
+    pthread_mutex_lock(&mutex_m);
+    node -> next_p = freeList_mp;
+    freeList_mp = node;
+    ++numFree_m;
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void AmbCompletionPool::complete(AmbCompletion_t *completion) {
+    if (!completion)
+        return;
+    // Release before signaling because the latch or context may be gone as soon as it is signaled:
+    AmbCompletionCallback callback = completion -> callback_p;
+    void *context = completion -> context_p;
+    AmbCompletionLatch *latch = completion -> latch_p;
+    sem_t *synchLock = completion -> synchLock_p;
+    release(completion);
+    if (callback)
+        callback(context);
+    else if (latch)
+        latch -> countDown();
+    else if (synchLock)
+        sem_post(synchLock);
+}
+
+unsigned long AmbCompletionPool::getNumAllocated() {
+    pthread_mutex_lock(&mutex_m);
+    unsigned long ret = numAllocated_m;
+    pthread_mutex_unlock(&mutex_m);
+    return ret;
+}
+
+unsigned long AmbCompletionPool::getNumFree() {
+    pthread_mutex_lock(&mutex_m);
+    unsigned long ret = numFree_m;
+    pthread_mutex_unlock(&mutex_m);
+    return ret;
+}
+
+void AmbCompletionPool::allocateSlab() {
+    // Slabs are never freed.  The pool only grows to the largest number of requests ever in flight.
+    Node *slab = new Node[SLAB_SIZE];
+    for (int index = 0; index < SLAB_SIZE; ++index) {
+        slab[index].next_p = freeList_mp;
+        freeList_mp = &slab[index];
+    }
+    numAllocated_m += SLAB_SIZE;
+    numFree_m += SLAB_SIZE;
+}
+
+// --------------------------------------------------------------------------
+// per-thread completion semaphore:
+
+static pthread_key_t threadSynchLockKey;
+static pthread_once_t threadSynchLockOnce = PTHREAD_ONCE_INIT;
+
+static void destroyThreadSynchLock(void *value) {
+    sem_t *synchLock = static_cast<sem_t *>(value);
+    if (synchLock) {
+        sem_destroy(synchLock);
+        delete synchLock;
+    }
+}
+
+static void createThreadSynchLockKey() {
+    pthread_key_create(&threadSynchLockKey, destroyThreadSynchLock);
+}
+
+sem_t *ambThreadSynchLock() {
+    pthread_once(&threadSynchLockOnce, createThreadSynchLockKey);
+    sem_t *synchLock = static_cast<sem_t *>(pthread_getspecific(threadSynchLockKey));
+    if (!synchLock) {
+        synchLock = new sem_t;
+        sem_init(synchLock, 0, 0);
+        pthread_setspecific(threadSynchLockKey, synchLock);
+    }
+    return synchLock;
+}
+
+// --------------------------------------------------------------------------
+// per-thread message queueing class:
+
+struct ThreadPriority {
+    AmbPriority_t priority;
+    unsigned long deadline;
+};
+
+static pthread_key_t threadPriorityKey;
+static pthread_once_t threadPriorityOnce = PTHREAD_ONCE_INIT;
+
+static void destroyThreadPriority(void *value) {
+    delete static_cast<ThreadPriority *>(value);
+}
+
+static void createThreadPriorityKey() {
+    pthread_key_create(&threadPriorityKey, destroyThreadPriority);
+}
+
+static ThreadPriority *getThreadPriority() {
+    pthread_once(&threadPriorityOnce, createThreadPriorityKey);
+    return static_cast<ThreadPriority *>(pthread_getspecific(threadPriorityKey));
+}
+
+void ambSetThreadPriority(AmbPriority_t priority, unsigned long deadline) {
+    ThreadPriority *current = getThreadPriority();
+    if (!current) {
+        current = new ThreadPriority;
+        pthread_setspecific(threadPriorityKey, current);
+    }
+    current -> priority = priority;
+    current -> deadline = deadline;
+}
+
+AmbPriority_t ambThreadPriority() {
+    ThreadPriority *current = getThreadPriority();
+    return current ? current -> priority : AMB_PRIORITY_CONTROL;
+}
+
+unsigned long ambThreadDeadline() {
+    ThreadPriority *current = getThreadPriority();
+    return current ? current -> deadline : 0;
+}
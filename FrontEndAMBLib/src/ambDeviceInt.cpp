@@ -32,10 +32,14 @@
 
 #include "ambDeviceInt.h"
 #include "ambInterface.h"
+#include "ambCompletion.h"
 
 static const char *rcsId="@(#) $Id: ambDeviceInt.cpp,v 1.7 2005/07/19 20:23:11 jkern Exp $";
 static void *use_rcsId = ((void)&use_rcsId,(void *) &rcsId);
 
+/* Batches up to this size are built on the stack.  Same as FEMON_MAX_BATCH */
+static const unsigned stackBatchSize = 8;
+
 AmbDeviceInt::AmbDeviceInt(){
   interface_mp = AmbInterface::getInstance();
 }
@@ -71,7 +75,7 @@ void AmbDeviceInt::monitorTE(ACS::Time        TimeEvent,
                  AmbErrorCode_t*  status){
 
   /* Call to get a monitor point at a specific time*/
-  AmbCompletion_t* completion = new AmbCompletion_t;
+  AmbCompletion_t* completion = AmbCompletionPool::allocate();
   AmbMessage_t     message;
 
   /* Build the completion block */
@@ -92,6 +96,8 @@ void AmbDeviceInt::monitorTE(ACS::Time        TimeEvent,
   message.dataLen      = 0;
   message.completion_p = completion;
   message.targetTE     = TimeEvent;
+  message.priority     = ambThreadPriority();
+  message.deadline     = ambThreadDeadline();
 
   /* Send the message and wait for a return */
   interface_mp->sendMessage(message);
@@ -105,7 +111,7 @@ void AmbDeviceInt::commandTE(ACS::Time           TimeEvent,
                  Time*               timestamp,
                  AmbErrorCode_t*     status){
 
-  AmbCompletion_t* completion = new AmbCompletion_t;
+  AmbCompletion_t* completion = AmbCompletionPool::allocate();
   AmbMessage_t     message;
 
   /* Build the completion block */
@@ -128,6 +134,8 @@ void AmbDeviceInt::commandTE(ACS::Time           TimeEvent,
     message.data[idx] = data[idx];
   message.completion_p = completion;
   message.targetTE     = TimeEvent;
+  message.priority     = ambThreadPriority();
+  message.deadline     = 0;     // commands are never dropped
 
   /* Send the message and wait for a return */
   interface_mp->sendMessage(message);
@@ -142,7 +150,7 @@ void AmbDeviceInt::monitorNextTE(AmbRelativeAddr     RCA,
 
 
   /* Call to get a monitor point at a specific time*/
-  AmbCompletion_t* completion = new AmbCompletion_t;
+  AmbCompletion_t* completion = AmbCompletionPool::allocate();
   AmbMessage_t     message;
 
   /* Build the completion block */
@@ -163,6 +171,8 @@ void AmbDeviceInt::monitorNextTE(AmbRelativeAddr     RCA,
   message.dataLen      = 0;
   message.completion_p = completion;
   message.targetTE     = 0;
+  message.priority     = ambThreadPriority();
+  message.deadline     = ambThreadDeadline();
 
   /* Send the message and wait for a return */
   interface_mp->sendMessage(message);
@@ -174,7 +184,7 @@ void  AmbDeviceInt::commandNextTE(AmbRelativeAddr RCA,
                   sem_t*                     synchLock,
                   ACS::Time*                 timestamp,
                   AmbErrorCode_t*            status){
-  AmbCompletion_t* completion = new AmbCompletion_t;
+  AmbCompletion_t* completion = AmbCompletionPool::allocate();
   AmbMessage_t     message;
 
   /* Build the completion block */
@@ -198,11 +208,100 @@ void  AmbDeviceInt::commandNextTE(AmbRelativeAddr RCA,
 
   message.completion_p = completion;
   message.targetTE     = 0;
+  message.priority     = ambThreadPriority();
+  message.deadline     = 0;     // commands are never dropped
 
   /* Send the message and wait for a return */
   interface_mp->sendMessage(message);
 }
 
+void AmbDeviceInt::monitorBatch(unsigned               count,
+                 const AmbRelativeAddr* RCAs,
+                 AmbMonitorResult_t*    results,
+                 AmbCompletionLatch*    latch){
+
+  if (!count)
+    return;
+
+  AmbMessage_t stackMessages[stackBatchSize];
+  AmbMessage_t* messages = (count <= stackBatchSize) ? stackMessages : new AmbMessage_t[count];
+
+  /* Count up the latch for the whole batch before any can complete */
+  latch->add(count);
+
+  for (unsigned idx = 0; idx < count; idx++) {
+    AmbCompletion_t* completion = AmbCompletionPool::allocate();
+    AmbMonitorResult_t& result = results[idx];
+    result.dataLength = 0;
+    result.status     = AMBERR_PENDING;
+
+    /* Build the completion block */
+    completion->dataLength_p = &result.dataLength;
+    completion->data_p       = result.data;
+    completion->channel_p    = NULL;
+    completion->address_p    = NULL;
+    completion->timestamp_p  = &result.timestamp;
+    completion->status_p     = &result.status;
+    completion->synchLock_p  = NULL;
+    completion->contLock_p   = NULL;
+    completion->type_p       = NULL;
+    completion->latch_p      = latch;
+
+    /* Build the message block */
+    AmbMessage_t& message = messages[idx];
+    message.requestType  = AMB_MONITOR;
+    message.channel      = m_channel;
+    message.address      = createAMBAddr(m_nodeAddress, RCAs[idx]);
+    message.dataLen      = 0;
+    message.completion_p = completion;
+    message.targetTE     = 0;
+    message.priority     = ambThreadPriority();
+    message.deadline     = ambThreadDeadline();
+  }
+
+  /* Send them all; the caller waits on the latch */
+  interface_mp->sendMessages(messages, count);
+  if (messages != stackMessages)
+    delete[] messages;
+}
+
+void AmbDeviceInt::monitorAsync(AmbRelativeAddr       RCA,
+                 AmbMonitorResult_t*   result,
+                 AmbCompletionCallback callback,
+                 void*                 context){
+
+  AmbCompletion_t* completion = AmbCompletionPool::allocate();
+  AmbMessage_t     message;
+  result->dataLength = 0;
+  result->status     = AMBERR_PENDING;
+
+  /* Build the completion block */
+  completion->dataLength_p = &result->dataLength;
+  completion->data_p       = result->data;
+  completion->channel_p    = NULL;
+  completion->address_p    = NULL;
+  completion->timestamp_p  = &result->timestamp;
+  completion->status_p     = &result->status;
+  completion->synchLock_p  = NULL;
+  completion->contLock_p   = NULL;
+  completion->type_p       = NULL;
+  completion->callback_p   = callback;
+  completion->context_p    = context;
+
+  /* Build the message block */
+  message.requestType  = AMB_MONITOR;
+  message.channel      = m_channel;
+  message.address      = createAMBAddr(m_nodeAddress,RCA);
+  message.dataLen      = 0;
+  message.completion_p = completion;
+  message.targetTE     = 0;
+  message.priority     = ambThreadPriority();
+  message.deadline     = ambThreadDeadline();
+
+  /* Send the message; the callback reports completion */
+  interface_mp->sendMessage(message);
+}
+
 void AmbDeviceInt::flushNode(ACS::Time                      TimeEvent,
                  ACS::Time*                     timestamp,
                  AmbErrorCode_t*                status){
@@ -0,0 +1,285 @@
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2003
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ *----------------------------------------------------------------------
+ */
+
+#include "ambGovernor.h"
+#include "portable.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+using namespace std::chrono;
+
+std::atomic<AmbDeviceClassifier> AmbGovernor::classifier_mp(NULL);
+std::atomic<unsigned> AmbGovernor::observing_m(0);
+std::atomic<unsigned> AmbGovernor::powered_m(0);
+
+AmbGovernor::AmbGovernor(AmbInterfaceBus &bus, double maxRate,
+                         double observingShare, double cartridgeShare, double infrastructureShare)
+  : bus_m(bus),
+    maxRate_m(0),
+    stop_m(false)
+{
+    pthread_mutex_init(&mutex_m, NULL);
+    memset(budgetUsage_m, 0, sizeof(budgetUsage_m));
+    memset(deviceUsage_m, 0, sizeof(deviceUsage_m));
+    memset(&totalUsage_m, 0, sizeof(totalUsage_m));
+    lastRefill_m = windowStart_m = Clock::now();
+    configure(maxRate, observingShare, cartridgeShare, infrastructureShare);
+}
+
+AmbGovernor::~AmbGovernor() {
+    pthread_mutex_destroy(&mutex_m);
+}
+
+void AmbGovernor::sendMessage(const AmbMessage_t &msg) {
+    acquire(msg);
+    bus_m.sendMessage(msg);
+}
+
+void AmbGovernor::sendMessages(const AmbMessage_t *msgs, unsigned count) {
+    for (unsigned index = 0; index < count; ++index)
+        acquire(msgs[index]);
+    bus_m.sendMessages(msgs, count);
+}
+
+void AmbGovernor::shutdown() {
+    pthread_mutex_lock(&mutex_m);
+    stop_m = true;
+    pthread_mutex_unlock(&mutex_m);
+    bus_m.shutdown();
+}
+
+void AmbGovernor::configure(double maxRate, double observingShare, double cartridgeShare, double infrastructureShare) {
+    double shares[NUM_BUDGETS] = { observingShare, cartridgeShare, infrastructureShare };
+    double sum = 0;
+    for (int budget = 0; budget < NUM_BUDGETS; ++budget) {
+        if (shares[budget] < 0)
+            shares[budget] = 0;
+        sum += shares[budget];
+    }
+    pthread_mutex_lock(&mutex_m);
+    refill(Clock::now());
+    maxRate_m = (maxRate > 0) ? maxRate : 0;
+    for (int budget = 0; budget < NUM_BUDGETS; ++budget) {
+        Bucket &bucket = buckets_m[budget];
+        bucket.share = (sum > 0) ? shares[budget] / sum : 1.0 / NUM_BUDGETS;
+        bucket.fillRate = maxRate_m * bucket.share / 1000.0;
+        bucket.capacity = std::max(1.0, bucket.fillRate * BURST_MS);
+        bucket.tokens = bucket.capacity;
+    }
+    spare_m.share = 1.0;
+    spare_m.fillRate = 0;
+    spare_m.capacity = std::max(1.0, maxRate_m * BURST_MS / 1000.0);
+    spare_m.tokens = 0;
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void AmbGovernor::getStats(Budget budget, AmbGovernorStats &target) {
+    target = AmbGovernorStats();
+    if (budget < 0 || budget >= NUM_BUDGETS)
+        return;
+    pthread_mutex_lock(&mutex_m);
+    refill(Clock::now());
+    target.share = 100.0 * buckets_m[budget].share;
+    target.allocated = maxRate_m * buckets_m[budget].share;
+    fill(budgetUsage_m[budget], target);
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void AmbGovernor::getDeviceStats(unsigned device, AmbGovernorStats &target) {
+    target = AmbGovernorStats();
+    if (device >= MAX_DEVICES)
+        return;
+    // Devices sharing the same budget each get an equal part of it:
+    Budget budget = budgetFor(device);
+    unsigned sharing = 1;
+    if (budget == CARTRIDGE) {
+        unsigned powered = powered_m.load() & ~(1U << observing_m.load()) & ~1U;
+        sharing = 0;
+        for (; powered; powered &= powered - 1)
+            ++sharing;
+        if (!sharing)
+            sharing = 1;
+    }
+    pthread_mutex_lock(&mutex_m);
+    refill(Clock::now());
+    target.share = 100.0 * buckets_m[budget].share / sharing;
+    target.allocated = maxRate_m * buckets_m[budget].share / sharing;
+    fill(deviceUsage_m[device], target);
+    pthread_mutex_unlock(&mutex_m);
+}
+
+double AmbGovernor::getUtilization() {
+    pthread_mutex_lock(&mutex_m);
+    refill(Clock::now());
+    double ret = (maxRate_m > 0) ? 100.0 * totalUsage_m.rate / maxRate_m : 0.0;
+    pthread_mutex_unlock(&mutex_m);
+    return ret;
+}
+
+void AmbGovernor::resetStats() {
+    pthread_mutex_lock(&mutex_m);
+    memset(budgetUsage_m, 0, sizeof(budgetUsage_m));
+    memset(deviceUsage_m, 0, sizeof(deviceUsage_m));
+    memset(&totalUsage_m, 0, sizeof(totalUsage_m));
+    windowStart_m = Clock::now();
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void AmbGovernor::setPowered(unsigned device, bool powered) {
+    if (device >= MAX_DEVICES)
+        return;
+    if (powered)
+        powered_m.fetch_or(1U << device);
+    else
+        powered_m.fetch_and(~(1U << device));
+}
+
+AmbGovernor::Budget AmbGovernor::budgetFor(unsigned device) {
+    if (device == 0 || device >= MAX_DEVICES)
+        return INFRASTRUCTURE;
+    if (device == observing_m.load())
+        return OBSERVING;
+    return CARTRIDGE;
+}
+
+const char *AmbGovernor::budgetName(Budget budget) {
+    switch (budget) {
+        case OBSERVING:
+            return "observing";
+        case CARTRIDGE:
+            return "cartridge";
+        case INFRASTRUCTURE:
+            return "infrastructure";
+        default:
+            return "unknown";
+    }
+}
+
+//private:
+
+void AmbGovernor::acquire(const AmbMessage_t &msg) {
+    unsigned device = deviceFor(msg);
+    Budget budget = budgetFor(device);
+    bool borrowed = false;
+    bool waited = false;
+    Clock::time_point waitStart;
+
+    pthread_mutex_lock(&mutex_m);
+    for (;;) {
+        Clock::time_point now = Clock::now();
+        refill(now);
+        if (maxRate_m <= 0 || stop_m)
+            break;
+        Bucket &bucket = buckets_m[budget];
+        if (bucket.tokens >= 1.0) {
+            bucket.tokens -= 1.0;
+            break;
+        }
+        // Use share left unused by the other budgets:
+        if (spare_m.tokens >= 1.0) {
+            spare_m.tokens -= 1.0;
+            borrowed = true;
+            break;
+        }
+        // Control messages don't wait, nor does any message past its deadline.  Charge the budget instead:
+        bool late = waited && msg.deadline && duration_cast<microseconds>(now - waitStart).count() >= (long long) msg.deadline;
+        if (msg.priority == AMB_PRIORITY_CONTROL || late) {
+            // but not beyond one bucket's worth of debt:
+            bucket.tokens = std::max(bucket.tokens - 1.0, -bucket.capacity);
+            break;
+        }
+        if (!waited) {
+            waited = true;
+            waitStart = now;
+        }
+        // Sleep until our own bucket will have a token, but look at the spare tokens at least every few ms:
+        double wait = (bucket.fillRate > 0) ? (1.0 - bucket.tokens) / bucket.fillRate : 1.0;
+        unsigned long ms = (unsigned long) ceil(wait);
+        if (ms < 1)
+            ms = 1;
+        else if (ms > 10)
+            ms = 10;
+        pthread_mutex_unlock(&mutex_m);
+        SLEEP(ms);
+        pthread_mutex_lock(&mutex_m);
+    }
+    double waitMs = waited ? duration<double, std::milli>(Clock::now() - waitStart).count() : 0.0;
+    Usage *usages[3] = { &budgetUsage_m[budget], &deviceUsage_m[device], &totalUsage_m };
+    for (int index = 0; index < 3; ++index) {
+        Usage &usage = *usages[index];
+        ++usage.transactions;
+        if (borrowed)
+            ++usage.borrowed;
+        if (waited) {
+            ++usage.throttled;
+            usage.totalWait += waitMs;
+        }
+    }
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void AmbGovernor::refill(Clock::time_point now) {
+    double elapsed = duration<double, std::milli>(now - lastRefill_m).count();
+    lastRefill_m = now;
+    if (maxRate_m > 0) {
+        for (int budget = 0; budget < NUM_BUDGETS; ++budget) {
+            Bucket &bucket = buckets_m[budget];
+            bucket.tokens += bucket.fillRate * elapsed;
+            // A full bucket's share is going unused.  Make it available to the others:
+            if (bucket.tokens > bucket.capacity) {
+                spare_m.tokens += bucket.tokens - bucket.capacity;
+                bucket.tokens = bucket.capacity;
+            }
+        }
+        if (spare_m.tokens > spare_m.capacity)
+            spare_m.tokens = spare_m.capacity;
+    }
+    double window = duration<double, std::milli>(now - windowStart_m).count();
+    if (window >= WINDOW_MS) {
+        windowStart_m = now;
+        for (int index = 0; index < NUM_BUDGETS + MAX_DEVICES + 1; ++index) {
+            Usage &usage = (index < NUM_BUDGETS) ? budgetUsage_m[index]
+                         : (index < NUM_BUDGETS + MAX_DEVICES) ? deviceUsage_m[index - NUM_BUDGETS] : totalUsage_m;
+            usage.rate = (usage.transactions - usage.windowStart) * 1000.0 / window;
+            usage.windowStart = usage.transactions;
+        }
+    }
+}
+
+void AmbGovernor::fill(const Usage &source, AmbGovernorStats &target) const {
+    target.rate = source.rate;
+    target.utilization = (target.allocated > 0) ? 100.0 * target.rate / target.allocated : 0.0;
+    target.transactions = source.transactions;
+    target.borrowed = source.borrowed;
+    target.throttled = source.throttled;
+    target.totalWait = source.totalWait;
+}
+
+unsigned AmbGovernor::deviceFor(const AmbMessage_t &msg) {
+    AmbDeviceClassifier classifier = classifier_mp.load();
+    if (!classifier)
+        return 0;
+    unsigned device = (*classifier)(msg.address & 0x3FFFF);
+    return (device < MAX_DEVICES) ? device : 0;
+}
@@ -32,6 +32,7 @@
 */
 
 #include "ambInterface.h"
+#include "ambCompletion.h"
 #include <pthread.h>
 #include <set>
 #include <stdio.h>
@@ -126,13 +127,12 @@ AmbErrorCode_t AmbInterface::findSN(AmbDataMem_t serialNumber[],
                                     AmbNodeAddr nodeAddress,
                                     Time& timestamp) const 
 {
-  AmbCompletion_t* completion_p = new AmbCompletion_t;
+  AmbCompletion_t* completion_p = AmbCompletionPool::allocate();
   AmbMessage_t     message;
 
   AmbDataLength_t  dataLength;
   AmbErrorCode_t   status;
-  sem_t            synchLock;
-  sem_init(&synchLock, 0, 0);
+  sem_t*           synchLock = ambThreadSynchLock();
 
   /* Build the completion block */
   completion_p->dataLength_p = &dataLength;
@@ -141,7 +141,7 @@ AmbErrorCode_t AmbInterface::findSN(AmbDataMem_t serialNumber[],
   completion_p->address_p    = NULL;
   completion_p->timestamp_p  = &timestamp;
   completion_p->status_p     = &status;
-  completion_p->synchLock_p  = &synchLock;
+  completion_p->synchLock_p  = synchLock;
   completion_p->contLock_p   = NULL;
   completion_p->type_p       = NULL;
 
@@ -152,11 +152,12 @@ AmbErrorCode_t AmbInterface::findSN(AmbDataMem_t serialNumber[],
   message.dataLen      = 0;
   message.completion_p = completion_p;
   message.targetTE     = 0;
+  message.priority     = AMB_PRIORITY_CONTROL;
+  message.deadline     = 0;
 
   /* Send the message and wait for a return */
   sendMessage(message);
-  sem_wait(&synchLock);
-  sem_destroy(&synchLock);
+  sem_wait(synchLock);
 
   return status;
 }
@@ -166,4 +167,9 @@ void AmbInterface::sendMessage(const AmbMessage_t& msg) const {
         canBus_mp -> sendMessage(msg);
 }
 
+void AmbInterface::sendMessages(const AmbMessage_t* msgs, unsigned count) const {
+    if (canBus_mp) 
+        canBus_mp -> sendMessages(msgs, count);
+}
+
 
@@ -0,0 +1,238 @@
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2003
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ *----------------------------------------------------------------------
+ */
+
+#include "ambLatency.h"
+#include "portable.h"
+#include <sched.h>
+using namespace std::chrono;
+
+AmbSubsystemClassifier AmbLatencyTable::classifier_mp = NULL;
+
+void ambWaitUntil(steady_clock::time_point due) {
+    steady_clock::time_point now = steady_clock::now();
+    if (now >= due)
+        return;
+    // Sleep through whole milliseconds but one, then spin for the remainder:
+    unsigned long ms = (unsigned long) duration_cast<milliseconds>(due - now).count();
+    if (ms > 1)
+        SLEEP((ms - 1));
+    while (steady_clock::now() < due)
+        sched_yield();
+}
+
+// --------------------------------------------------------------------------
+// AmbLatencyHistogram:
+
+unsigned AmbLatencyHistogram::bucketIndex(unsigned long us) {
+    if (us < SUB_BUCKETS)
+        return us;
+    // Find the most significant bit:
+    unsigned msb = SUB_BITS;
+    while (msb < MAX_BITS - 1 && (us >> (msb + 1)))
+        ++msb;
+    if (us >> (msb + 1))
+        // Beyond the range.  Count it in the last bucket:
+        return BUCKETS - 1;
+    // Keep the top SUB_BITS + 1 bits.  The leading one selects the power of two:
+    unsigned shift = msb - SUB_BITS;
+    return SUB_BUCKETS * shift + (unsigned) (us >> shift);
+}
+
+unsigned long AmbLatencyHistogram::bucketUpperEdge(unsigned index) {
+    if (index < SUB_BUCKETS)
+        return index;
+    unsigned shift = index / SUB_BUCKETS - 1;
+    unsigned long sub = index - SUB_BUCKETS * shift;
+    return ((sub + 1) << shift) - 1;
+}
+
+void AmbLatencyHistogram::record(unsigned long us) {
+    buckets_m[bucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+    count_m.fetch_add(1, std::memory_order_relaxed);
+    sum_m.fetch_add(us, std::memory_order_relaxed);
+    unsigned long prevMax = max_m.load(std::memory_order_relaxed);
+    while (us > prevMax && !max_m.compare_exchange_weak(prevMax, us, std::memory_order_relaxed))
+        ;
+}
+
+void AmbLatencyHistogram::add(const AmbLatencyHistogram &other) {
+    for (unsigned index = 0; index < BUCKETS; ++index) {
+        unsigned long count = other.buckets_m[index].load(std::memory_order_relaxed);
+        if (count)
+            buckets_m[index].fetch_add(count, std::memory_order_relaxed);
+    }
+    count_m.fetch_add(other.count_m.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    sum_m.fetch_add(other.sum_m.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    unsigned long otherMax = other.max_m.load(std::memory_order_relaxed);
+    if (otherMax > max_m.load(std::memory_order_relaxed))
+        max_m.store(otherMax, std::memory_order_relaxed);
+}
+
+void AmbLatencyHistogram::reset() {
+    for (unsigned index = 0; index < BUCKETS; ++index)
+        buckets_m[index].store(0, std::memory_order_relaxed);
+    count_m.store(0, std::memory_order_relaxed);
+    sum_m.store(0, std::memory_order_relaxed);
+    max_m.store(0, std::memory_order_relaxed);
+}
+
+double AmbLatencyHistogram::mean() const {
+    unsigned long count = count_m.load(std::memory_order_relaxed);
+    return count ? (double) sum_m.load(std::memory_order_relaxed) / count : 0.0;
+}
+
+unsigned long AmbLatencyHistogram::percentile(double percent) const {
+    // The buckets may be counting while we read them.  Use their own total:
+    unsigned long long total = 0;
+    for (unsigned index = 0; index < BUCKETS; ++index)
+        total += buckets_m[index].load(std::memory_order_relaxed);
+    if (!total)
+        return 0;
+    unsigned long long target = (unsigned long long) (percent / 100.0 * total + 0.5);
+    if (target < 1)
+        target = 1;
+    unsigned long long seen = 0;
+    unsigned long maxValue = max_m.load(std::memory_order_relaxed);
+    for (unsigned index = 0; index < BUCKETS; ++index) {
+        seen += buckets_m[index].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            unsigned long edge = bucketUpperEdge(index);
+            return (edge < maxValue) ? edge : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+// --------------------------------------------------------------------------
+// AmbLatencyTable:
+
+AmbLatencyTable::AmbLatencyTable() {
+    for (unsigned slot = 0; slot < SLOTS; ++slot) {
+        packed_m[slot].store(0);
+        entries_m[slot] = NULL;
+    }
+    overflow_m.key.channel = (AmbChannel) -1;
+    overflow_m.key.node = (AmbNodeAddr) -1;
+    overflow_m.key.subsystem = (unsigned) -1;
+    pthread_mutex_init(&insertMutex_m, NULL);
+}
+
+AmbLatencyTable::~AmbLatencyTable() {
+    for (unsigned slot = 0; slot < SLOTS; ++slot)
+        delete entries_m[slot];
+    pthread_mutex_destroy(&insertMutex_m);
+}
+
+void AmbLatencyTable::merge(int channel, long node, int subsystem,
+                            AmbLatencyHistogram &queueDelay, AmbLatencyHistogram &roundTrip) const
+{
+    for (unsigned slot = 0; slot < SLOTS; ++slot) {
+        if (packed_m[slot].load(std::memory_order_acquire)) {
+            const Entry *entry = entries_m[slot];
+            if (matches(entry -> key, channel, node, subsystem)) {
+                queueDelay.add(entry -> queueDelay);
+                roundTrip.add(entry -> roundTrip);
+            }
+        }
+    }
+    if (channel == ANY && node == ANY && subsystem == ANY) {
+        queueDelay.add(overflow_m.queueDelay);
+        roundTrip.add(overflow_m.roundTrip);
+    }
+}
+
+void AmbLatencyTable::getKeys(std::vector<AmbLatencyKey> &target) const {
+    target.clear();
+    for (unsigned slot = 0; slot < SLOTS; ++slot) {
+        if (packed_m[slot].load(std::memory_order_acquire))
+            target.push_back(entries_m[slot] -> key);
+    }
+}
+
+void AmbLatencyTable::reset() {
+    for (unsigned slot = 0; slot < SLOTS; ++slot) {
+        if (packed_m[slot].load(std::memory_order_acquire)) {
+            entries_m[slot] -> queueDelay.reset();
+            entries_m[slot] -> roundTrip.reset();
+        }
+    }
+    overflow_m.queueDelay.reset();
+    overflow_m.roundTrip.reset();
+}
+
+// --------------------------------------------------------------------------
+//private:
+
+AmbLatencyTable::Entry &AmbLatencyTable::find(const AmbMessage_t &msg) {
+    AmbLatencyKey key;
+    key.channel = msg.channel;
+    key.node = (msg.address >> 18) - 1;
+    AmbRelativeAddr RCA = msg.address & 0x3FFFF;
+    key.subsystem = (classifier_mp ? (*classifier_mp)(RCA) : (RCA >> 12)) & 0xFF;
+
+    // Pack into 31 bits with the top bit set, so that a packed key is never 0:
+    unsigned packed = 0x80000000U | ((key.channel & 0xFF) << 20) | ((key.node & 0xFFF) << 8) | key.subsystem;
+
+    unsigned slot = hash(packed);
+    for (unsigned probe = 0; probe < SLOTS; ++probe) {
+        unsigned found = packed_m[slot].load(std::memory_order_acquire);
+        if (found == packed)
+            return *entries_m[slot];
+        if (!found)
+            return insert(packed, key);
+        slot = (slot + 1) & (SLOTS - 1);
+    }
+    return overflow_m;
+}
+
+AmbLatencyTable::Entry &AmbLatencyTable::insert(unsigned packed, const AmbLatencyKey &key) {
+    pthread_mutex_lock(&insertMutex_m);
+    // Search again now that we hold the lock.  Another thread may have inserted it:
+    Entry *entry = &overflow_m;
+    unsigned slot = hash(packed);
+    for (unsigned probe = 0; probe < SLOTS; ++probe) {
+        unsigned found = packed_m[slot].load(std::memory_order_acquire);
+        if (found == packed) {
+            entry = entries_m[slot];
+            break;
+        }
+        if (!found) {
+            entry = new Entry;
+            entry -> key = key;
+            entries_m[slot] = entry;
+            // Publish the key only once the entry is in place:
+            packed_m[slot].store(packed, std::memory_order_release);
+            break;
+        }
+        slot = (slot + 1) & (SLOTS - 1);
+    }
+    pthread_mutex_unlock(&insertMutex_m);
+    return *entry;
+}
+
+bool AmbLatencyTable::matches(const AmbLatencyKey &key, int channel, long node, int subsystem) {
+    return (channel == ANY || key.channel == (AmbChannel) channel)
+        && (node == ANY || key.node == (AmbNodeAddr) node)
+        && (subsystem == ANY || key.subsystem == (unsigned) subsystem);
+}
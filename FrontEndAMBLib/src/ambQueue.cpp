@@ -23,40 +23,229 @@
  */
  
 #include "ambQueue.h"
+#include "ambCompletion.h"
+
+void AmbQueueStats::add(const AmbQueueStats &other) {
+    enqueued += other.enqueued;
+    sent += other.sent;
+    dropped += other.dropped;
+    totalDelay += other.totalDelay;
+    if (maxDelay < other.maxDelay)
+        maxDelay = other.maxDelay;
+}
+
+AmbQueue::AmbQueue(unsigned capacity)
+  : mask_m(0),
+    wakeCount_m(0),
+    lastDelay_m(0)
+{
+    // Round the capacity up to a power of two so positions can be wrapped with a mask:
+    unsigned size = 2;
+    while (size < capacity)
+        size <<= 1;
+    mask_m = size - 1;
+    for (int priority = 0; priority < AMB_NUM_PRIORITIES; ++priority) {
+        Ring &ring = rings_m[priority];
+        ring.slots_p = new Slot[size];
+        for (unsigned index = 0; index < size; ++index)
+            ring.slots_p[index].sequence.store(index, std::memory_order_relaxed);
+        ring.enqueuePos.store(0);
+        ring.dequeuePos.store(0);
+        sem_init(&ring.freeSlots, 0, size);
+    }
+    resetStats();
+    sem_init(&filledSlots_m, 0, 0);
+}
+
+AmbQueue::~AmbQueue() {
+    flush();
+    sem_destroy(&filledSlots_m);
+    for (int priority = 0; priority < AMB_NUM_PRIORITIES; ++priority) {
+        sem_destroy(&rings_m[priority].freeSlots);
+        delete[] rings_m[priority].slots_p;
+    }
+}
 
 void AmbQueue::flush() {
-    pthread_mutex_lock(&mutex);
     AmbMessage_t msg;
-    while (!empty()) {
-        // Pop each command off the queue and ignore:
-        msg = front();
-        pop_front();
+    while (getNext(msg)) {
         // Signal the caller that the command is flushed:
         if (msg.completion_p -> status_p)
             *(msg.completion_p -> status_p) = AMBERR_FLUSHED;   // TODO: is this the right error code?
-        if (msg.completion_p -> synchLock_p)
-            sem_post(msg.completion_p -> synchLock_p);
-        // Destroy the caller's completion structure since at this point nobody else will:
-        delete msg.completion_p;
+        // Recycle the caller's completion structure since at this point nobody else will:
+        AmbCompletionPool::complete(msg.completion_p);
     }
-    pthread_mutex_unlock(&mutex);
 }    
 
 void AmbQueue::append(const AmbMessage_t& msg) {
-    pthread_mutex_lock(&mutex);
-    push_back(msg);
-    pthread_mutex_unlock(&mutex);
+    Ring &ring = ringFor(msg);
+    // Reserve a slot, waiting if the ring is full:
+    sem_wait(&ring.freeSlots);
+    // The reservation guarantees there is room, but retry if a slot is still being released:
+    while (!push(ring, msg))
+        sched_yield();
+    ring.enqueued.fetch_add(1, std::memory_order_relaxed);
+    // Wake the consumer:
+    sem_post(&filledSlots_m);
+}
+
+void AmbQueue::append(const AmbMessage_t *msgs, unsigned count) {
+    unsigned unposted = 0;
+    for (unsigned index = 0; index < count; ++index) {
+        Ring &ring = ringFor(msgs[index]);
+        // Reserve a slot.  If the ring is full, let the consumer have what we've added so far:
+        if (sem_trywait(&ring.freeSlots) != 0) {
+            for (; unposted; --unposted)
+                sem_post(&filledSlots_m);
+            sem_wait(&ring.freeSlots);
+        }
+        while (!push(ring, msgs[index]))
+            sched_yield();
+        ring.enqueued.fetch_add(1, std::memory_order_relaxed);
+        ++unposted;
+    }
+    // Wake the consumer:
+    for (; unposted; --unposted)
+        sem_post(&filledSlots_m);
 }
 
 bool AmbQueue::getNext(AmbMessage_t& msg) {
-    bool ret = false;
-    pthread_mutex_lock(&mutex);
-    if (!empty()) {
-        msg = front();
-        pop_front();
-        ret = true;
+    while (true) {
+        if (sem_trywait(&filledSlots_m) != 0)
+            return false;
+        TakeResult result = take(msg);
+        if (result != TAKE_EXPIRED)
+            return (result == TAKE_MESSAGE);
+    }
+}
+
+bool AmbQueue::waitNext(AmbMessage_t& msg) {
+    while (true) {
+        while (sem_wait(&filledSlots_m) != 0) {
+            // interrupted; try again.
+        }
+        TakeResult result = take(msg);
+        if (result != TAKE_EXPIRED)
+            return (result == TAKE_MESSAGE);
+    }
+}
+
+void AmbQueue::wake() {
+    wakeCount_m.fetch_add(1);
+    sem_post(&filledSlots_m);
+}
+
+bool AmbQueue::empty() const {
+    for (int priority = 0; priority < AMB_NUM_PRIORITIES; ++priority) {
+        const Ring &ring = rings_m[priority];
+        unsigned pos = ring.dequeuePos.load(std::memory_order_relaxed);
+        if (ring.slots_p[pos & mask_m].sequence.load(std::memory_order_acquire) == pos + 1)
+            return false;
+    }
+    return true;
+}
+
+void AmbQueue::getStats(AmbPriority_t priority, AmbQueueStats &target) const {
+    target = AmbQueueStats();
+    if (priority >= AMB_NUM_PRIORITIES)
+        return;
+    const Ring &ring = rings_m[priority];
+    target.enqueued = ring.enqueued.load(std::memory_order_relaxed);
+    target.sent = ring.sent.load(std::memory_order_relaxed);
+    target.dropped = ring.dropped.load(std::memory_order_relaxed);
+    target.totalDelay = (double) ring.totalDelay.load(std::memory_order_relaxed);
+    target.maxDelay = ring.maxDelay.load(std::memory_order_relaxed);
+}
+
+void AmbQueue::resetStats() {
+    for (int priority = 0; priority < AMB_NUM_PRIORITIES; ++priority) {
+        Ring &ring = rings_m[priority];
+        ring.enqueued.store(0);
+        ring.sent.store(0);
+        ring.dropped.store(0);
+        ring.totalDelay.store(0);
+        ring.maxDelay.store(0);
+    }
+}
+
+// --------------------------------------------------------------------------
+//private:
+
+AmbQueue::TakeResult AmbQueue::take(AmbMessage_t& msg) {
+    // We hold one count from filledSlots_m.  It was posted either by wake() or by a producer.
+    // A producer may post before an earlier producer has finished filling its slot, so when
+    // no ring has a message ready yet wait briefly for it rather than dropping the count:
+    Ring *ring = NULL;
+    Clock::time_point queued;
+    while (!ring) {
+        for (int priority = 0; !ring && priority < AMB_NUM_PRIORITIES; ++priority) {
+            if (pop(rings_m[priority], msg, queued))
+                ring = &rings_m[priority];
+        }
+        if (!ring) {
+            int wakes = wakeCount_m.load();
+            if (wakes > 0 && wakeCount_m.compare_exchange_weak(wakes, wakes - 1))
+                return TAKE_WOKEN;
+            sched_yield();
+        }
+    }
+    sem_post(&ring -> freeSlots);
+
+    // Only this thread updates the delay counters so plain load/store is enough:
+    unsigned long delay = (unsigned long) std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - queued).count();
+    ring -> totalDelay.store(ring -> totalDelay.load(std::memory_order_relaxed) + delay, std::memory_order_relaxed);
+    if (delay > ring -> maxDelay.load(std::memory_order_relaxed))
+        ring -> maxDelay.store(delay, std::memory_order_relaxed);
+    lastDelay_m = delay;
+
+    if (msg.deadline && delay > msg.deadline) {
+        // Too stale to be worth sending.  Signal the caller that it was dropped:
+        ring -> dropped.fetch_add(1, std::memory_order_relaxed);
+        if (msg.completion_p -> status_p)
+            *(msg.completion_p -> status_p) = AMBERR_EXPIRED;
+        AmbCompletionPool::complete(msg.completion_p);
+        return TAKE_EXPIRED;
     }
-    pthread_mutex_unlock(&mutex);
-    return ret;
+    ring -> sent.fetch_add(1, std::memory_order_relaxed);
+    return TAKE_MESSAGE;
 }
 
+bool AmbQueue::push(Ring &ring, const AmbMessage_t& msg) {
+    unsigned pos = ring.enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        Slot &slot = ring.slots_p[pos & mask_m];
+        unsigned seq = slot.sequence.load(std::memory_order_acquire);
+        int diff = (int) seq - (int) pos;
+        if (diff == 0) {
+            // The slot is free.  Try to claim it:
+            if (ring.enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.msg = msg;
+                slot.queued = Clock::now();
+                // Publish it to the consumer:
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+            // Another producer got it first and pos has been reloaded.
+        } else if (diff < 0) {
+            // The slot has not been emptied yet; full.
+            return false;
+        } else
+            // Another producer moved ahead; reload.
+            pos = ring.enqueuePos.load(std::memory_order_relaxed);
+    }
+}
+
+bool AmbQueue::pop(Ring &ring, AmbMessage_t& msg, Clock::time_point &queued) {
+    // Single consumer, so no CAS is needed on the dequeue position:
+    unsigned pos = ring.dequeuePos.load(std::memory_order_relaxed);
+    Slot &slot = ring.slots_p[pos & mask_m];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+        // Nothing published yet:
+        return false;
+    msg = slot.msg;
+    queued = slot.queued;
+    ring.dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    // Release the slot for reuse one lap later:
+    slot.sequence.store(pos + mask_m + 1, std::memory_order_release);
+    return true;
+}
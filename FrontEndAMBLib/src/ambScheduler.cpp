@@ -0,0 +1,301 @@
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2003
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ *----------------------------------------------------------------------
+ */
+
+#include "ambScheduler.h"
+#include "ambCompletion.h"
+#include "ambLatency.h"
+#include "setTimeStamp.h"
+#include "portable.h"
+#include <math.h>
+using namespace std::chrono;
+
+double AmbSchedulerStats::jitter() const {
+    if (released < 2)
+        return 0.0;
+    double mean = totalLate / released;
+    double variance = totalLateSquared / released - mean * mean;
+    return (variance > 0.0) ? sqrt(variance) : 0.0;
+}
+
+AmbScheduler::AmbScheduler(AmbInterfaceBus &bus)
+  : bus_m(bus),
+    start_m(Clock::now()),
+    tick_m(0),
+    freeList_mp(NULL),
+    started_m(false),
+    stop_m(false)
+{
+    for (int level = 0; level < LEVELS; ++level)
+        for (int slot = 0; slot < SLOTS; ++slot)
+            wheel_m[level][slot] = NULL;
+    pthread_mutex_init(&mutex_m, NULL);
+    sem_init(&wake_m, 0, 0);
+}
+
+AmbScheduler::~AmbScheduler() {
+    shutdown();
+    while (freeList_mp) {
+        Entry *next = freeList_mp -> next_p;
+        delete freeList_mp;
+        freeList_mp = next;
+    }
+    sem_destroy(&wake_m);
+    pthread_mutex_destroy(&mutex_m);
+}
+
+bool AmbScheduler::schedule(const AmbMessage_t &msg) {
+    if (!msg.targetTE)
+        return false;
+
+    // How far in the future is it?  Time is in 100 ns units:
+    Time now;
+    setTimeStamp(&now);
+    if (msg.targetTE <= now + 10000) {
+        pthread_mutex_lock(&mutex_m);
+        ++stats_m.immediate;
+        pthread_mutex_unlock(&mutex_m);
+        return false;
+    }
+    Clock::time_point due = Clock::now() + microseconds((msg.targetTE - now) / 10);
+
+    pthread_mutex_lock(&mutex_m);
+    if (stop_m) {
+        pthread_mutex_unlock(&mutex_m);
+        return false;
+    }
+    Entry *entry = freeList_mp;
+    if (entry)
+        freeList_mp = entry -> next_p;
+    else
+        entry = new Entry;
+    entry -> msg = msg;
+    entry -> due = due;
+    // The tick during which it is due.  release() waits out the remainder:
+    entry -> tick = duration_cast<milliseconds>(due - start_m).count();
+
+    bool wasEmpty = (stats_m.pending == 0);
+    // The thread doesn't advance the wheel while it is empty.  Catch up before placing the entry:
+    if (wasEmpty)
+        tick_m = currentTick();
+    Entry *ready = NULL;
+    insert(entry, ready);
+    ++stats_m.scheduled;
+
+    if (!started_m) {
+        pthread_create(&thread_m, NULL, reinterpret_cast<void*(*)(void*)>(schedulerThread), this);
+        started_m = true;
+    }
+    pthread_mutex_unlock(&mutex_m);
+
+    // The thread sleeps while the wheel is empty:
+    if (wasEmpty)
+        sem_post(&wake_m);
+    // In case the tick arrived while we were inserting:
+    release(ready);
+    return true;
+}
+
+void AmbScheduler::shutdown() {
+    pthread_mutex_lock(&mutex_m);
+    bool started = started_m;
+    started_m = false;
+    stop_m = true;
+    pthread_mutex_unlock(&mutex_m);
+
+    // Wake the thread and wait for it to exit:
+    if (started) {
+        sem_post(&wake_m);
+        pthread_join(thread_m, NULL);
+    }
+
+    // Flush everything still held:
+    Entry *flushed = NULL;
+    pthread_mutex_lock(&mutex_m);
+    for (int level = 0; level < LEVELS; ++level) {
+        for (int slot = 0; slot < SLOTS; ++slot) {
+            while (Entry *entry = wheel_m[level][slot]) {
+                wheel_m[level][slot] = entry -> next_p;
+                entry -> next_p = flushed;
+                flushed = entry;
+            }
+        }
+    }
+    stats_m.pending = 0;
+    pthread_mutex_unlock(&mutex_m);
+
+    while (flushed) {
+        Entry *entry = flushed;
+        flushed = entry -> next_p;
+        if (entry -> msg.completion_p -> status_p)
+            *(entry -> msg.completion_p -> status_p) = AMBERR_FLUSHED;
+        AmbCompletionPool::complete(entry -> msg.completion_p);
+        pthread_mutex_lock(&mutex_m);
+        entry -> next_p = freeList_mp;
+        freeList_mp = entry;
+        pthread_mutex_unlock(&mutex_m);
+    }
+}
+
+void AmbScheduler::getStats(AmbSchedulerStats &target) const {
+    pthread_mutex_lock(&mutex_m);
+    target = stats_m;
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void AmbScheduler::resetStats() {
+    pthread_mutex_lock(&mutex_m);
+    unsigned long pending = stats_m.pending;
+    stats_m = AmbSchedulerStats();
+    stats_m.pending = pending;
+    pthread_mutex_unlock(&mutex_m);
+}
+
+// --------------------------------------------------------------------------
+//private:
+
+unsigned long long AmbScheduler::currentTick() const {
+    return duration_cast<milliseconds>(Clock::now() - start_m).count();
+}
+
+void AmbScheduler::insert(Entry *entry, Entry *&ready) {
+    if (entry -> tick <= tick_m) {
+        // Due now:
+        entry -> next_p = ready;
+        ready = entry;
+        return;
+    }
+    unsigned long long delta = entry -> tick - tick_m;
+    // Find the lowest level which spans the delay:
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1))))
+        ++level;
+    // Beyond the top level, park it in the farthest slot to be looked at again when that comes around:
+    unsigned long long tick = entry -> tick;
+    if (delta >= (1ULL << (SLOT_BITS * LEVELS)))
+        tick = tick_m + (1ULL << (SLOT_BITS * LEVELS)) - 1;
+    int slot = (int) ((tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+    entry -> next_p = wheel_m[level][slot];
+    wheel_m[level][slot] = entry;
+    ++stats_m.pending;
+}
+
+void AmbScheduler::advance(unsigned long long toTick, Entry *&ready) {
+    while (tick_m < toTick) {
+        ++tick_m;
+        // When a lower wheel wraps, move the next slot of the wheel above down to the lower levels:
+        for (int level = 1; level < LEVELS; ++level) {
+            if (tick_m & ((1ULL << (SLOT_BITS * level)) - 1))
+                break;
+            int slot = (int) ((tick_m >> (SLOT_BITS * level)) & (SLOTS - 1));
+            Entry *entry = wheel_m[level][slot];
+            wheel_m[level][slot] = NULL;
+            while (entry) {
+                Entry *next = entry -> next_p;
+                --stats_m.pending;
+                insert(entry, ready);
+                entry = next;
+            }
+        }
+        // Everything in the current level 0 slot is due:
+        int slot = (int) (tick_m & (SLOTS - 1));
+        Entry *entry = wheel_m[0][slot];
+        wheel_m[0][slot] = NULL;
+        while (entry) {
+            Entry *next = entry -> next_p;
+            --stats_m.pending;
+            entry -> next_p = ready;
+            ready = entry;
+            entry = next;
+        }
+    }
+}
+
+bool AmbScheduler::dueSoon() const {
+    return wheel_m[0][(tick_m + 1) & (SLOTS - 1)] != NULL;
+}
+
+void AmbScheduler::release(Entry *ready) {
+    // The ready list is in reverse order; put it back in order of due time, then FIFO:
+    Entry *ordered = NULL;
+    while (ready) {
+        Entry *next = ready -> next_p;
+        Entry **pos = &ordered;
+        while (*pos && (*pos) -> due <= ready -> due)
+            pos = &((*pos) -> next_p);
+        ready -> next_p = *pos;
+        *pos = ready;
+        ready = next;
+    }
+    while (ordered) {
+        Entry *entry = ordered;
+        ordered = entry -> next_p;
+        // It was released on the tick during which it is due, so normally less than a tick remains:
+        ambWaitUntil(entry -> due);
+        Clock::time_point now = Clock::now();
+        unsigned long late = (now > entry -> due) ? (unsigned long) duration_cast<microseconds>(now - entry -> due).count() : 0;
+
+        // Clear targetTE so the bus sends it immediately:
+        entry -> msg.targetTE = 0;
+        bus_m.sendMessage(entry -> msg);
+
+        pthread_mutex_lock(&mutex_m);
+        ++stats_m.released;
+        stats_m.totalLate += late;
+        stats_m.totalLateSquared += (double) late * late;
+        if (late > stats_m.maxLate)
+            stats_m.maxLate = late;
+        entry -> next_p = freeList_mp;
+        freeList_mp = entry;
+        pthread_mutex_unlock(&mutex_m);
+    }
+}
+
+void *AmbScheduler::schedulerThread(AmbScheduler *owner) {
+    if (!owner)
+        return NULL;
+    while (true) {
+        Entry *ready = NULL;
+        pthread_mutex_lock(&(owner -> mutex_m));
+        bool stop = owner -> stop_m;
+        if (!stop)
+            owner -> advance(owner -> currentTick(), ready);
+        bool empty = (owner -> stats_m.pending == 0);
+        bool soon = !empty && owner -> dueSoon();
+        pthread_mutex_unlock(&(owner -> mutex_m));
+
+        owner -> release(ready);
+
+        if (stop)
+            break;
+        if (empty)
+            // Nothing held.  Sleep until something is scheduled:
+            sem_wait(&(owner -> wake_m));
+        else if (soon)
+            // Something is due on the next tick.  Don't risk oversleeping:
+            sched_yield();
+        else
+            SLEEP(1);
+    }
+    return NULL;
+}
@@ -0,0 +1,140 @@
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2003
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ *----------------------------------------------------------------------
+ */
+
+#include "ambTrace.h"
+#include "setTimeStamp.h"
+#include <string.h>
+using namespace std::chrono;
+
+static const char traceMagic[8] = { 'A', 'M', 'B', 'T', 'R', 'A', 'C', 'E' };
+
+AmbTraceWriter::AmbTraceWriter()
+  : file_mp(NULL),
+    count_m(0)
+{
+    pthread_mutex_init(&mutex_m, NULL);
+}
+
+AmbTraceWriter::~AmbTraceWriter() {
+    close();
+    pthread_mutex_destroy(&mutex_m);
+}
+
+bool AmbTraceWriter::open(const std::string &fileName) {
+    close();
+    FILE *file = fopen(fileName.c_str(), "wb");
+    if (!file)
+        return false;
+    setvbuf(file, NULL, _IOFBF, 64 * 1024);
+
+    AmbTraceHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, traceMagic, sizeof(header.magic));
+    header.version = VERSION;
+    header.recordSize = sizeof(AmbTraceRecord);
+    Time now;
+    setTimeStamp(&now);
+    header.startTime = now;
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        fclose(file);
+        return false;
+    }
+    pthread_mutex_lock(&mutex_m);
+    file_mp = file;
+    start_m = steady_clock::now();
+    count_m = 0;
+    pthread_mutex_unlock(&mutex_m);
+    return true;
+}
+
+void AmbTraceWriter::close() {
+    pthread_mutex_lock(&mutex_m);
+    if (file_mp) {
+        fclose(file_mp);
+        file_mp = NULL;
+    }
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void AmbTraceWriter::record(const AmbMessage_t &msg, unsigned long latency) {
+    steady_clock::time_point now = steady_clock::now();
+    AmbTraceRecord record;
+    memset(&record, 0, sizeof(record));
+    Time timestamp;
+    setTimeStamp(&timestamp);
+    record.timestamp = timestamp;
+    record.address = msg.address;
+    record.latency = latency;
+    record.channel = msg.channel;
+    record.requestType = msg.requestType;
+    record.requestLength = msg.dataLen;
+    if (msg.dataLen)
+        memcpy(record.request, msg.data, msg.dataLen < AMB_DATA_MSG_SIZE ? msg.dataLen : AMB_DATA_MSG_SIZE);
+    const AmbCompletion_t *completion = msg.completion_p;
+    if (completion) {
+        if (completion -> status_p)
+            record.status = *(completion -> status_p);
+        if (completion -> dataLength_p) {
+            record.responseLength = *(completion -> dataLength_p);
+            if (completion -> data_p && record.responseLength)
+                memcpy(record.response, completion -> data_p,
+                       record.responseLength < AMB_DATA_MSG_SIZE ? record.responseLength : AMB_DATA_MSG_SIZE);
+        }
+    }
+
+    pthread_mutex_lock(&mutex_m);
+    if (file_mp) {
+        long long sent = duration_cast<microseconds>(now - start_m).count() - (long long) latency;
+        record.sent = (sent > 0) ? sent : 0;
+        if (fwrite(&record, sizeof(record), 1, file_mp) == 1)
+            ++count_m;
+    }
+    pthread_mutex_unlock(&mutex_m);
+}
+
+unsigned long AmbTraceWriter::getCount() const {
+    pthread_mutex_lock(&mutex_m);
+    unsigned long ret = count_m;
+    pthread_mutex_unlock(&mutex_m);
+    return ret;
+}
+
+bool readAmbTrace(const std::string &fileName, AmbTraceHeader &header, std::vector<AmbTraceRecord> &records) {
+    records.clear();
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if (!file)
+        return false;
+    bool ret = fread(&header, sizeof(header), 1, file) == 1
+            && memcmp(header.magic, traceMagic, sizeof(header.magic)) == 0
+            && header.version == AmbTraceWriter::VERSION
+            && header.recordSize == sizeof(AmbTraceRecord);
+    if (ret) {
+        AmbTraceRecord record;
+        // A trace cut short by a crash may end with a partial record.  It is ignored:
+        while (fread(&record, sizeof(record), 1, file) == 1)
+            records.push_back(record);
+    }
+    fclose(file);
+    return ret;
+}
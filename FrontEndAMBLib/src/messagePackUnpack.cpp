@@ -23,166 +23,63 @@
 #include <iomanip>
 using namespace std;
 
-// Pack and unpack functions for unsigned long:
+// The fixed-size types are implemented by AmbCodec.  These are the out-of-line versions
+// for callers which go through the virtual interface.
 
-typedef union { // A union for unsigned long/can conversion
-    unsigned char chr_val[4];
-    unsigned long long_val;
-} AmbULConv;
+// Pack and unpack functions for unsigned long:
 
 FEMC_ERROR MessagePackUnpack::unpack(unsigned long &target, AmbDataLength_t dataLength, const AmbDataMem_t *data) {
-    FEMC_ERROR ret(FEMC_NO_ERROR);
-    target = 0;
-    if (dataLength == 1 || dataLength == 5)
-        ret = (FEMC_ERROR) ((signed char) data[--dataLength]);
-    if (dataLength < 4)
-        ret = FEMC_UNPACK_ERROR;
-    else {
-        for (int index = 0; index < dataLength; ++index) {
-            target *= 0xFF;
-            target += data[index];
-        }
-    }
-    return ret;
+    return AmbCodec<unsigned long>::unpack(target, dataLength, data);
 }
 
 void MessagePackUnpack::pack(unsigned long value, AmbDataLength_t &dataLength, AmbDataMem_t *data) {
-    AmbULConv conv;
-    conv.long_val = value;
-    dataLength = 4;
-    data[0] = conv.chr_val[3];
-    data[1] = conv.chr_val[2];
-    data[2] = conv.chr_val[1];
-    data[3] = conv.chr_val[0];
+    AmbCodec<unsigned long>::pack(value, dataLength, data);
 }
 
 // Pack and unpack functions for unsigned short:
 
 FEMC_ERROR MessagePackUnpack::unpack(unsigned short &target, AmbDataLength_t dataLength, const AmbDataMem_t *data) {
-    FEMC_ERROR ret(FEMC_NO_ERROR);
-    target = 0;
-    if (dataLength == 1 || dataLength == 3)
-        ret = (FEMC_ERROR) ((signed char) data[--dataLength]);
-    if (dataLength < 2)
-        ret = FEMC_UNPACK_ERROR;
-    else {
-        target = (data[0] & 0xff) << 8;
-        target += data[1];
-    }
-    return ret;
+    return AmbCodec<unsigned short>::unpack(target, dataLength, data);
 }
 
 void MessagePackUnpack::pack(unsigned short value, AmbDataLength_t &dataLength, AmbDataMem_t *data) {
-    dataLength = 2;
-    data[0] = (value >> 8) & 0xff;  //shift and set upper byte
-    data[1] = value & 0xff;         //set lower byte
+    AmbCodec<unsigned short>::pack(value, dataLength, data);
 }
 
 // Pack and unpack functions for signed short:
 
 FEMC_ERROR MessagePackUnpack::unpack(short &target, AmbDataLength_t dataLength, const AmbDataMem_t *data) {
-    FEMC_ERROR ret(FEMC_NO_ERROR);
-    target = 0;
-    if (dataLength == 1 || dataLength == 3)
-        ret = (FEMC_ERROR) ((signed char) data[--dataLength]);
-    if (dataLength < 2)
-        ret = FEMC_UNPACK_ERROR;
-    else {
-        unsigned short temp = data[0] & 0xFF;
-        temp <<= 8;
-        temp += data[1];
-        if (data[0] & 0x80) {
-            // negative 2s complement number:
-            temp -= 1;
-            temp ^= 0xFFFF;
-            target = (short) -temp;
-        } else
-            target = (short) temp;
+    FEMC_ERROR ret = AmbCodec<short>::unpack(target, dataLength, data);
+    if (ret != FEMC_UNPACK_ERROR) {
         LOG(LM_DEBUG) << "unpack(short &target) data="
                       << uppercase << hex << setw(2) << setfill('0') << (int) data[0] << " " << (int) data[1] << dec << setw(0)
-                      << " temp=" << temp << " target=" << target << endl;
+                      << " target=" << target << endl;
     }
     return ret;
 }
 
 void MessagePackUnpack::pack(short value, AmbDataLength_t &dataLength, AmbDataMem_t *data) {
-    dataLength = 2;
-    unsigned short temp = (unsigned short) (value);
-    if (value < 0) {
-        // Convert to negative 2s compliment:
-        temp = (unsigned short) (-value);
-        temp ^= 0xFFFF;
-        temp += 1;
-    }
-    data[0] = (temp >> 8) & 0xff;  //shift and set upper byte
-    data[1] = temp & 0xff;         //set lower byte
+    AmbCodec<short>::pack(value, dataLength, data);
 }
 
-
 // Pack and unpack functions for unsigned char:
 
 FEMC_ERROR MessagePackUnpack::unpack(unsigned char &target, AmbDataLength_t dataLength, const AmbDataMem_t *data) {
-    FEMC_ERROR ret(FEMC_NO_ERROR);
-    target = 0;
-    if (dataLength == 1) {
-        // Ambiguous whether this is just the requested data or just the status byte.
-        // Treat it as a status byte if it matches the range of FEMC_ERROR, otherwise as data:
-        target = data[0];
-        signed char retC((signed char) target);
-        if (retC < 0 && retC >= FEMC_LAST_ERROR_CODE) {
-            target = 0;
-            ret = (FEMC_ERROR) retC;
-        }
-    } else if (dataLength == 2) {
-        ret = (FEMC_ERROR) ((signed char) data[dataLength - 1]);
-        if (ret == FEMC_NO_ERROR)
-            target = data[0];
-    } else
-        ret = FEMC_UNPACK_ERROR;
-    return ret;
+    return AmbCodec<unsigned char>::unpack(target, dataLength, data);
 }
 
 void MessagePackUnpack::pack(unsigned char value, AmbDataLength_t &dataLength, AmbDataMem_t *data) {
-    dataLength = 1;
-    data[0] = value;
+    AmbCodec<unsigned char>::pack(value, dataLength, data);
 }
 
 // Pack and unpack functions for float:
 
-typedef union { // A union for float/can conversion
-    unsigned char chr_val[4];
-    float flt_val;
-} AmbFloatConv;
-
 FEMC_ERROR MessagePackUnpack::unpack(float &target, AmbDataLength_t dataLength, const AmbDataMem_t *data) {
-    FEMC_ERROR ret(FEMC_NO_ERROR);
-    target = 0.0;
-    if (dataLength == 1 || dataLength == 5)
-        ret = (FEMC_ERROR) ((signed char) data[--dataLength]);
-    if (dataLength < 4)
-        ret = FEMC_UNPACK_ERROR;
-    else {
-        // Convert to float the incoming CAN message:
-        AmbFloatConv conv;
-        conv.chr_val[0] = data[3];
-        conv.chr_val[1] = data[2];
-        conv.chr_val[2] = data[1];
-        conv.chr_val[3] = data[0];
-        target = conv.flt_val;
-    }
-    return ret;
+    return AmbCodec<float>::unpack(target, dataLength, data);
 }
 
 void MessagePackUnpack::pack(float value, AmbDataLength_t &dataLength, AmbDataMem_t *data) {
-    /* Set a float value to the CAN message*/
-    AmbFloatConv conv;
-    conv.flt_val = value;
-
-    dataLength = 4;
-    data[0] = conv.chr_val[3];
-    data[1] = conv.chr_val[2];
-    data[2] = conv.chr_val[1];
-    data[3] = conv.chr_val[0];
+    AmbCodec<float>::pack(value, dataLength, data);
 }
 
 // unpack function for std::string.  No pack is required for this type:
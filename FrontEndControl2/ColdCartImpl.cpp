@@ -39,6 +39,10 @@ using namespace FEConfig;
 #include <vector>
 using namespace std;
 
+// The monitor table is initialized in the class declaration:
+constexpr FEMonitorTableEntry<ColdCartImplBase> ColdCartImpl::monitorTable[];
+constexpr unsigned ColdCartImpl::monitorTableSize;
+
 ColdCartImpl::ColdCartImpl(unsigned long channel, 
                            unsigned long nodeAddress,
                            const std::string &name,
@@ -49,82 +53,19 @@ ColdCartImpl::ColdCartImpl(unsigned long channel,
     band_m(band),
     mixerHeatingdataFile_mp(NULL)
 { 
+    // monitorAction() every 15 ms.  Table points which are due together are read as one batch,
+    //  so each registry point is polled at least as often as it was read one at a time:
+    setMonitorRate(15, 0, FEMonitorScheduler::PRIORITY_HIGH);
+
     reset();
     setESN(ESN);
     ColdCartImplBase::initialize(channel, nodeAddress); 
 
     // Add all the analog monitor points to the registry:
-    // SIS voltage monitoring we override in this class:
-    addMon(&sisPol0Sb1Voltage_value, &ColdCartImpl::sisPol0Sb1Voltage);
-    addMon(&sisPol0Sb2Voltage_value, &ColdCartImpl::sisPol0Sb2Voltage);
-    addMon(&sisPol1Sb1Voltage_value, &ColdCartImpl::sisPol1Sb1Voltage);
-    addMon(&sisPol1Sb2Voltage_value, &ColdCartImpl::sisPol1Sb2Voltage);
-    // SIS current monitoring we average 8 readings:
-    addMon(&sisPol0Sb1Current_value, &ColdCartImpl::avgSisPol0Sb1Currentx8);
-    addMon(&sisPol0Sb2Current_value, &ColdCartImpl::avgSisPol0Sb2Currentx8);
-    addMon(&sisPol1Sb1Current_value, &ColdCartImpl::avgSisPol1Sb1Currentx8);
-    addMon(&sisPol1Sb2Current_value, &ColdCartImpl::avgSisPol1Sb2Currentx8);
-    // SIS magnet monitoring we override in this class:
-    addMon(&sisMagnetPol0Sb1Voltage_value, &ColdCartImpl::sisMagnetPol0Sb1Voltage);
-    addMon(&sisMagnetPol0Sb1Current_value, &ColdCartImpl::sisMagnetPol0Sb1Current);
-    addMon(&sisMagnetPol0Sb2Voltage_value, &ColdCartImpl::sisMagnetPol0Sb2Voltage);
-    addMon(&sisMagnetPol0Sb2Current_value, &ColdCartImpl::sisMagnetPol0Sb2Current);
-    addMon(&sisMagnetPol1Sb1Voltage_value, &ColdCartImpl::sisMagnetPol1Sb1Voltage);
-    addMon(&sisMagnetPol1Sb1Current_value, &ColdCartImpl::sisMagnetPol1Sb1Current);
-    addMon(&sisMagnetPol1Sb2Voltage_value, &ColdCartImpl::sisMagnetPol1Sb2Voltage);
-    addMon(&sisMagnetPol1Sb2Current_value, &ColdCartImpl::sisMagnetPol1Sb2Current);
-    // LNA monitoring handled by base class:
-    addMon(&lnaPol0Sb1St1DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb1St1DrainVoltage);
-    addMon(&lnaPol0Sb1St1DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb1St1DrainCurrent);
-    addMon(&lnaPol0Sb1St1GateVoltage_value, &ColdCartImplBase::lnaPol0Sb1St1GateVoltage);
-    addMon(&lnaPol0Sb1St2DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb1St2DrainVoltage);
-    addMon(&lnaPol0Sb1St2DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb1St2DrainCurrent);
-    addMon(&lnaPol0Sb1St2GateVoltage_value, &ColdCartImplBase::lnaPol0Sb1St2GateVoltage);
-    addMon(&lnaPol0Sb1St3DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb1St3DrainVoltage);
-    addMon(&lnaPol0Sb1St3DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb1St3DrainCurrent);
-    addMon(&lnaPol0Sb1St3GateVoltage_value, &ColdCartImplBase::lnaPol0Sb1St3GateVoltage);
-    // LNA stage monitoring we override in this class:
-    addMon(&lnaPol0Sb2St1DrainVoltage_value, &ColdCartImpl::lnaPol0Sb2St1DrainVoltage);
-    addMon(&lnaPol0Sb2St1DrainCurrent_value, &ColdCartImpl::lnaPol0Sb2St1DrainCurrent);
-    addMon(&lnaPol0Sb2St1GateVoltage_value, &ColdCartImpl::lnaPol0Sb2St1GateVoltage);
-    addMon(&lnaPol0Sb2St2DrainVoltage_value, &ColdCartImpl::lnaPol0Sb2St2DrainVoltage);
-    addMon(&lnaPol0Sb2St2DrainCurrent_value, &ColdCartImpl::lnaPol0Sb2St2DrainCurrent);
-    addMon(&lnaPol0Sb2St2GateVoltage_value, &ColdCartImpl::lnaPol0Sb2St2GateVoltage);
-    addMon(&lnaPol0Sb2St3DrainVoltage_value, &ColdCartImpl::lnaPol0Sb2St3DrainVoltage);
-    addMon(&lnaPol0Sb2St3DrainCurrent_value, &ColdCartImpl::lnaPol0Sb2St3DrainCurrent);
-    addMon(&lnaPol0Sb2St3GateVoltage_value, &ColdCartImpl::lnaPol0Sb2St3GateVoltage);
-
-    addMon(&lnaPol1Sb1St1DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb1St1DrainVoltage);
-    addMon(&lnaPol1Sb1St1DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb1St1DrainCurrent);
-    addMon(&lnaPol1Sb1St1GateVoltage_value, &ColdCartImplBase::lnaPol1Sb1St1GateVoltage);
-    addMon(&lnaPol1Sb1St2DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb1St2DrainVoltage);
-    addMon(&lnaPol1Sb1St2DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb1St2DrainCurrent);
-    addMon(&lnaPol1Sb1St2GateVoltage_value, &ColdCartImplBase::lnaPol1Sb1St2GateVoltage);
-    addMon(&lnaPol1Sb1St3DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb1St3DrainVoltage);
-    addMon(&lnaPol1Sb1St3DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb1St3DrainCurrent);
-    addMon(&lnaPol1Sb1St3GateVoltage_value, &ColdCartImplBase::lnaPol1Sb1St3GateVoltage);
-    // LNA stage monitoring we override in this class:
-    addMon(&lnaPol1Sb2St1DrainVoltage_value, &ColdCartImpl::lnaPol1Sb2St1DrainVoltage);
-    addMon(&lnaPol1Sb2St1DrainCurrent_value, &ColdCartImpl::lnaPol1Sb2St1DrainCurrent);
-    addMon(&lnaPol1Sb2St1GateVoltage_value, &ColdCartImpl::lnaPol1Sb2St1GateVoltage);
-    addMon(&lnaPol1Sb2St2DrainVoltage_value, &ColdCartImpl::lnaPol1Sb2St2DrainVoltage);
-    addMon(&lnaPol1Sb2St2DrainCurrent_value, &ColdCartImpl::lnaPol1Sb2St2DrainCurrent);
-    addMon(&lnaPol1Sb2St2GateVoltage_value, &ColdCartImpl::lnaPol1Sb2St2GateVoltage);
-    addMon(&lnaPol1Sb2St3DrainVoltage_value, &ColdCartImpl::lnaPol1Sb2St3DrainVoltage);
-    addMon(&lnaPol1Sb2St3DrainCurrent_value, &ColdCartImpl::lnaPol1Sb2St3DrainCurrent);
-    addMon(&lnaPol1Sb2St3GateVoltage_value, &ColdCartImpl::lnaPol1Sb2St3GateVoltage);
-    // SIS heater monitoring we override in this class:
-    addMon(&sisHeaterPol0Current_value, &ColdCartImpl::sisHeaterPol0Current);
-    addMon(&sisHeaterPol1Current_value, &ColdCartImpl::sisHeaterPol1Current);
-    // Cartridge temps handled by the base class:
-    addMon(&cartridgeTemperature0_value, &ColdCartImplBase::cartridgeTemperature0);
-    addMon(&cartridgeTemperature1_value, &ColdCartImplBase::cartridgeTemperature1);
-    addMon(&cartridgeTemperature2_value, &ColdCartImplBase::cartridgeTemperature2);
-    addMon(&cartridgeTemperature3_value, &ColdCartImplBase::cartridgeTemperature3);
-    addMon(&cartridgeTemperature4_value, &ColdCartImplBase::cartridgeTemperature4);
-    addMon(&cartridgeTemperature5_value, &ColdCartImplBase::cartridgeTemperature5);
-
-    nextMon = monitorRegistry.begin();
+    addMonTable(monitorTable, monitorTableSize, baseRCA, monitorFeatures());
+    // Read up to three at a time, so that each LNA stage is usually read together:
+    setMonBatch(3);
+    nextMon = 0;
 }
 
 const std::string &ColdCartImpl::getBandText(std::string &toFill) const {
@@ -242,6 +183,8 @@ void ColdCartImpl::setSISVoltage(int pol, int sb, float val, bool sweep) {
     if (sweep && span != 0.0) {
         float neg = (span < 0);
         float step = (neg) ? -0.05 : 0.05;
+        // send the intermediate steps without waiting for their readbacks:
+        deferCommandReadback(true);
         // loop from valNow to the final value:
         bool done = false;
         while (!done) {
@@ -263,8 +206,11 @@ void ColdCartImpl::setSISVoltage(int pol, int sb, float val, bool sweep) {
                 valNow += step;
             }
         }
+        deferCommandReadback(false);
+        // read back the last step now, before the final value supersedes it:
+        verifyCommands();
     }
-    // set the final value:
+    // set the final value, with its readback:
     if (pol == 0) {
         if (sb == 1)
             ColdCartImpl::sisPol0Sb1Voltage(val);
@@ -486,8 +432,14 @@ bool ColdCartImpl::measureIVCurveInnerLoop(XYPlotArray &target, int pol, int sb,
     // Setup timing and averaging
     const int stepSleep = 1;    // ms
     const int step0Sleep = 10;  // ms
-    const int voltAveraging = 3;
-    const int currAveraging = 3;
+    // Averaging drops to quietSamples while the readings are quieter than these, mV and mA:
+    const int maxSamples = 3;
+    const int quietSamples = 2;
+    const double quietVoltage = 0.005;
+    const double quietCurrent = 0.0005;
+    int voltAveraging = maxSamples;
+    int currAveraging = maxSamples;
+    FEMonitorStatistics voltStats, currStats;
 
     // move slowly to the first point:
     float VJset = VJstart;
@@ -509,10 +461,14 @@ bool ColdCartImpl::measureIVCurveInnerLoop(XYPlotArray &target, int pol, int sb,
         setSISVoltage(pol, sb, VJset, false);
         SLEEP(stepSleep);
         // read back the instantaneous voltage and current:
-        VJ = getSISVoltage(pol, sb, voltAveraging);
-        IJ = getSISCurrent(pol, sb, currAveraging) * 1000.0;  // convert mA to uA
+        VJ = getSISVoltageStatistics(pol, sb, voltAveraging, voltStats);
+        IJ = getSISCurrentStatistics(pol, sb, currAveraging, currStats) * 1000.0;  // convert mA to uA
         target.push_back(XYPlotPoint(VJset, VJ, IJ));
 
+        // take fewer samples at the next point if these were quiet:
+        voltAveraging = (voltStats.count > 1 && voltStats.stdDev() < quietVoltage) ? quietSamples : maxSamples;
+        currAveraging = (currStats.count > 1 && currStats.stdDev() < quietCurrent) ? quietSamples : maxSamples;
+
         // increment and loop end condition:
         VJset += VJstep;
 
@@ -583,7 +539,13 @@ float ColdCartImpl::getSISVoltage(int pol, int sb, int average, bool print) {
     if (average < 1)
         return 0;    
     
-    // compute the average:
+    // read all the samples in one batch:
+    if (!print) {
+        FEMonitorStatistics stats;
+        return getSISVoltageStatistics(pol, sb, average, stats);
+    }
+
+    // read and print each sample:
     double sum = 0;
     float val =  0;
     int i;
@@ -637,6 +599,36 @@ float ColdCartImpl::getSISCurrent(int pol, int sb, int average) {
     return 0;
 }
 
+float ColdCartImpl::getSISVoltageStatistics(int pol, int sb, int samples, FEMonitorStatistics &stats) {
+    stats.reset();
+    if (!hasSIS())
+        return 0;
+    if (!checkPolSb(pol, sb)) 
+        return 0;
+    if (sb == 2 && !hasSb2())
+        return 0;
+
+    if (pol == 0)
+        return (sb == 1) ? statsSisPol0Sb1Voltage(samples, stats) : statsSisPol0Sb2Voltage(samples, stats);
+    else
+        return (sb == 1) ? statsSisPol1Sb1Voltage(samples, stats) : statsSisPol1Sb2Voltage(samples, stats);
+}
+
+float ColdCartImpl::getSISCurrentStatistics(int pol, int sb, int samples, FEMonitorStatistics &stats) {
+    stats.reset();
+    if (!hasSIS())
+        return 0;
+    if (!checkPolSb(pol, sb)) 
+        return 0;
+    if (sb == 2 && !hasSb2())
+        return 0;
+
+    if (pol == 0)
+        return (sb == 1) ? statsSisPol0Sb1Current(samples, stats) : statsSisPol0Sb2Current(samples, stats);
+    else
+        return (sb == 1) ? statsSisPol1Sb1Current(samples, stats) : statsSisPol1Sb2Current(samples, stats);
+}
+
 bool ColdCartImpl::setSISEnable(bool val) {
     if (!hasSIS()) {
         if (val == true) {
@@ -706,6 +698,8 @@ void ColdCartImpl::setSISMagnetCurrent(int pol, int sb, float val, bool sweep, f
     if (sweep && span != 0.0) {
         bool neg = (span < 0);
         float step = (neg) ? -sweepStep : sweepStep;
+        // send the intermediate steps without waiting for their readbacks:
+        deferCommandReadback(true);
         // loop from valNow to the final value:
         bool done = false;
         while (!done) {
@@ -724,14 +718,17 @@ void ColdCartImpl::setSISMagnetCurrent(int pol, int sb, float val, bool sweep, f
                     else if (sb == 2)
                         ColdCartImpl::sisMagnetPol1Sb2Current(valNow);
                 }
-                // sleep for the specified dwell time:
+                // the step has been sent.  Sleep for the specified dwell time:
                 SLEEP(sweepDwell);
                 // and move to the next step:
                 valNow += step;
             }
         }
+        deferCommandReadback(false);
+        // read back the last step now, before the final value supersedes it:
+        verifyCommands();
     }
-    // set the final value:
+    // set the final value, with its readback:
     if (pol == 0) {
         if (sb == 1)
             ColdCartImpl::sisMagnetPol0Sb1Current(val);
@@ -1182,148 +1179,302 @@ bool ColdCartImpl::setLNAEnable(int pol, int sb, bool val) {
     return true;
 }
 
-bool ColdCartImpl::getMonitorTemp(CartridgeTemp_t &target) const {
-    memset(&target, 0, sizeof(target));
-    target.cartridgeTemperature0_value = cartridgeTemperature0_value;
-    target.cartridgeTemperature1_value = cartridgeTemperature1_value;
-    target.cartridgeTemperature2_value = cartridgeTemperature2_value;
-    target.cartridgeTemperature3_value = cartridgeTemperature3_value;
-    target.cartridgeTemperature4_value = cartridgeTemperature4_value;
-    target.cartridgeTemperature5_value = cartridgeTemperature5_value;
+bool ColdCartImpl::getMonitorTemp(CartridgeTemp_t &target, Time *timestamp_p, int *status_p) const {
+    if (!tempSnapshot_m.read(target, timestamp_p, status_p)) {
+        // Nothing published yet because monitoring hasn't started.  Return the values as they are:
+        int status;
+        collectTemp(target, status);
+        if (status_p)
+            *status_p = status;
+    }
     return true;
 }
 
-bool ColdCartImpl::getMonitorSIS(int pol, int sb, SIS_t &target) const {
+bool ColdCartImpl::getMonitorSIS(int pol, int sb, SIS_t &target, Time *timestamp_p, int *status_p) const {
     memset(&target, 0, sizeof(target));
     
     // No error if SIS not installed.  Just return zeros:
     if (!hasSIS())
         return true;
 
-    if (pol == 0) {
-        if (sb == 1) {
-            target.sisOpenLoop_value = sisPol0Sb1OpenLoop_value;
-            target.sisVoltage_value = sisPol0Sb1Voltage_value;
-            target.sisCurrent_value = sisPol0Sb1Current_value;
-            target.sisMagnetVoltage_value = sisMagnetPol0Sb1Voltage_value;
-            target.sisMagnetCurrent_value = sisMagnetPol0Sb1Current_value;
-            return true;
-        } else if (sb == 2) {
-            if (hasSb2()) {
-                target.sisOpenLoop_value = sisPol0Sb2OpenLoop_value;
-                target.sisVoltage_value = sisPol0Sb2Voltage_value;
-                target.sisCurrent_value = sisPol0Sb2Current_value;
-                target.sisMagnetVoltage_value = sisMagnetPol0Sb2Voltage_value;
-                target.sisMagnetCurrent_value = sisMagnetPol0Sb2Current_value;
-            }
-            // No error if no sb2.  Just return zeros:
-            return true;
-        }
-    } else if (pol == 1) {
-        if (sb == 1) {
-            target.sisOpenLoop_value = sisPol1Sb1OpenLoop_value;
-            target.sisVoltage_value = sisPol1Sb1Voltage_value;
-            target.sisCurrent_value = sisPol1Sb1Current_value;
-            target.sisMagnetVoltage_value = sisMagnetPol1Sb1Voltage_value;
-            target.sisMagnetCurrent_value = sisMagnetPol1Sb1Current_value;
-            return true;
-        } else if (sb == 2) {
-            if (hasSb2()) {
-                target.sisOpenLoop_value = sisPol1Sb2OpenLoop_value;
-                target.sisVoltage_value = sisPol1Sb2Voltage_value;
-                target.sisCurrent_value = sisPol1Sb2Current_value;
-                target.sisMagnetVoltage_value = sisMagnetPol1Sb2Voltage_value;
-                target.sisMagnetCurrent_value = sisMagnetPol1Sb2Current_value;
-            }
-            // No error if no sb2.  Just return zeros:
-            return true;
-        }
+    if (!checkPolSb(pol, sb))
+        return false;
+
+    // No error if no sb2.  Just return zeros:
+    if (sb == 2 && !hasSb2())
+        return true;
+
+    if (!sisSnapshot_m[polSbIndex(pol, sb)].read(target, timestamp_p, status_p)) {
+        int status;
+        collectSIS(pol, sb, target, status);
+        if (status_p)
+            *status_p = status;
     }
-    return false;
+    return true;
 }
 
-bool ColdCartImpl::getMonitorLNA(int pol, int sb, LNA_t &target) const {
+bool ColdCartImpl::getMonitorLNA(int pol, int sb, LNA_t &target, Time *timestamp_p, int *status_p) const {
     memset(&target, 0, sizeof(target));
 
     if (!hasLNA())
         return false;
 
-    if (pol == 0) {
-        if (sb == 1) {
-            target.lnaEnable_value = lnaPol0Sb1Enable_value;
-            target.lnaSt1DrainVoltage_value = lnaPol0Sb1St1DrainVoltage_value; 
-            target.lnaSt1DrainCurrent_value = lnaPol0Sb1St1DrainCurrent_value;
-            target.lnaSt1GateVoltage_value = lnaPol0Sb1St1GateVoltage_value;
-            target.lnaSt2DrainVoltage_value = lnaPol0Sb1St2DrainVoltage_value;
-            target.lnaSt2DrainCurrent_value = lnaPol0Sb1St2DrainCurrent_value;
-            target.lnaSt2GateVoltage_value = lnaPol0Sb1St2GateVoltage_value;
-            target.lnaSt3DrainVoltage_value = lnaPol0Sb1St3DrainVoltage_value; 
-            target.lnaSt3DrainCurrent_value = lnaPol0Sb1St3DrainCurrent_value;
-            target.lnaSt3GateVoltage_value = lnaPol0Sb1St3GateVoltage_value;
-            return true;
-        } else if (sb == 2 && hasSb2()) {
-            target.lnaEnable_value = lnaPol0Sb2Enable_value;
-            target.lnaSt1DrainVoltage_value = lnaPol0Sb2St1DrainVoltage_value; 
-            target.lnaSt1DrainCurrent_value = lnaPol0Sb2St1DrainCurrent_value;
-            target.lnaSt1GateVoltage_value = lnaPol0Sb2St1GateVoltage_value;
-            target.lnaSt2DrainVoltage_value = lnaPol0Sb2St2DrainVoltage_value;
-            target.lnaSt2DrainCurrent_value = lnaPol0Sb2St2DrainCurrent_value;
-            target.lnaSt2GateVoltage_value = lnaPol0Sb2St2GateVoltage_value;
-            target.lnaSt3DrainVoltage_value = lnaPol0Sb2St3DrainVoltage_value; 
-            target.lnaSt3DrainCurrent_value = lnaPol0Sb2St3DrainCurrent_value;
-            target.lnaSt3GateVoltage_value = lnaPol0Sb2St3GateVoltage_value;
-            return true;
-        }
-    } else if (pol == 1) {
-        if (sb == 1) {
-            target.lnaEnable_value = lnaPol1Sb1Enable_value;
-            target.lnaSt1DrainVoltage_value = lnaPol1Sb1St1DrainVoltage_value; 
-            target.lnaSt1DrainCurrent_value = lnaPol1Sb1St1DrainCurrent_value;
-            target.lnaSt1GateVoltage_value = lnaPol1Sb1St1GateVoltage_value;
-            target.lnaSt2DrainVoltage_value = lnaPol1Sb1St2DrainVoltage_value;
-            target.lnaSt2DrainCurrent_value = lnaPol1Sb1St2DrainCurrent_value;
-            target.lnaSt2GateVoltage_value = lnaPol1Sb1St2GateVoltage_value;
-            target.lnaSt3DrainVoltage_value = lnaPol1Sb1St3DrainVoltage_value; 
-            target.lnaSt3DrainCurrent_value = lnaPol1Sb1St3DrainCurrent_value;
-            target.lnaSt3GateVoltage_value = lnaPol1Sb1St3GateVoltage_value;
-            return true;
-        } else if (sb == 2 && hasSb2()) {
-            target.lnaEnable_value = lnaPol1Sb2Enable_value;
-            target.lnaSt1DrainVoltage_value = lnaPol1Sb2St1DrainVoltage_value; 
-            target.lnaSt1DrainCurrent_value = lnaPol1Sb2St1DrainCurrent_value;
-            target.lnaSt1GateVoltage_value = lnaPol1Sb2St1GateVoltage_value;
-            target.lnaSt2DrainVoltage_value = lnaPol1Sb2St2DrainVoltage_value;
-            target.lnaSt2DrainCurrent_value = lnaPol1Sb2St2DrainCurrent_value;
-            target.lnaSt2GateVoltage_value = lnaPol1Sb2St2GateVoltage_value;
-            target.lnaSt3DrainVoltage_value = lnaPol1Sb2St3DrainVoltage_value; 
-            target.lnaSt3DrainCurrent_value = lnaPol1Sb2St3DrainCurrent_value;
-            target.lnaSt3GateVoltage_value = lnaPol1Sb2St3GateVoltage_value;
-            return true;
-        }
+    if (!checkPolSb(pol, sb) || (sb == 2 && !hasSb2()))
+        return false;
+
+    if (!lnaSnapshot_m[polSbIndex(pol, sb)].read(target, timestamp_p, status_p)) {
+        int status;
+        collectLNA(pol, sb, target, status);
+        if (status_p)
+            *status_p = status;
     }
-    return false;
+    return true;
+}
+
+bool ColdCartImpl::getMonitorAux(int pol, Aux_t &target, Time *timestamp_p, int *status_p) const {
+    memset(&target, 0, sizeof(target));
+    if (pol != 0 && pol != 1)
+        return false;
+
+    if (!auxSnapshot_m[pol].read(target, timestamp_p, status_p)) {
+        int status;
+        collectAux(pol, target, status);
+        if (status_p)
+            *status_p = status;
+    }
+    return true;
+}
+
+void ColdCartImpl::collectTemp(CartridgeTemp_t &target, int &status) const {
+    memset(&target, 0, sizeof(target));
+    target.cartridgeTemperature0_value = cartridgeTemperature0_value;
+    target.cartridgeTemperature1_value = cartridgeTemperature1_value;
+    target.cartridgeTemperature2_value = cartridgeTemperature2_value;
+    target.cartridgeTemperature3_value = cartridgeTemperature3_value;
+    target.cartridgeTemperature4_value = cartridgeTemperature4_value;
+    target.cartridgeTemperature5_value = cartridgeTemperature5_value;
+    status = FEMC_NO_ERROR;
+    status = FEMonitorSnapshot<CartridgeTemp_t>::combineStatus(status, cartridgeTemperature0_status);
+    status = FEMonitorSnapshot<CartridgeTemp_t>::combineStatus(status, cartridgeTemperature1_status);
+    status = FEMonitorSnapshot<CartridgeTemp_t>::combineStatus(status, cartridgeTemperature2_status);
+    status = FEMonitorSnapshot<CartridgeTemp_t>::combineStatus(status, cartridgeTemperature3_status);
+    status = FEMonitorSnapshot<CartridgeTemp_t>::combineStatus(status, cartridgeTemperature4_status);
+    status = FEMonitorSnapshot<CartridgeTemp_t>::combineStatus(status, cartridgeTemperature5_status);
 }
 
-bool ColdCartImpl::getMonitorAux(int pol, Aux_t &target) const {
+void ColdCartImpl::collectSIS(int pol, int sb, SIS_t &target, int &status) const {
     memset(&target, 0, sizeof(target));
+    status = FEMC_NO_ERROR;
+    if (pol == 0 && sb == 1) {
+        target.sisOpenLoop_value = sisPol0Sb1OpenLoop_value;
+        target.sisVoltage_value = sisPol0Sb1Voltage_value;
+        target.sisCurrent_value = sisPol0Sb1Current_value;
+        target.sisMagnetVoltage_value = sisMagnetPol0Sb1Voltage_value;
+        target.sisMagnetCurrent_value = sisMagnetPol0Sb1Current_value;
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisPol0Sb1OpenLoop_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisPol0Sb1Voltage_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisPol0Sb1Current_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisMagnetPol0Sb1Voltage_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisMagnetPol0Sb1Current_status);
+    } else if (pol == 0 && sb == 2) {
+        target.sisOpenLoop_value = sisPol0Sb2OpenLoop_value;
+        target.sisVoltage_value = sisPol0Sb2Voltage_value;
+        target.sisCurrent_value = sisPol0Sb2Current_value;
+        target.sisMagnetVoltage_value = sisMagnetPol0Sb2Voltage_value;
+        target.sisMagnetCurrent_value = sisMagnetPol0Sb2Current_value;
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisPol0Sb2OpenLoop_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisPol0Sb2Voltage_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisPol0Sb2Current_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisMagnetPol0Sb2Voltage_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisMagnetPol0Sb2Current_status);
+    } else if (pol == 1 && sb == 1) {
+        target.sisOpenLoop_value = sisPol1Sb1OpenLoop_value;
+        target.sisVoltage_value = sisPol1Sb1Voltage_value;
+        target.sisCurrent_value = sisPol1Sb1Current_value;
+        target.sisMagnetVoltage_value = sisMagnetPol1Sb1Voltage_value;
+        target.sisMagnetCurrent_value = sisMagnetPol1Sb1Current_value;
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisPol1Sb1OpenLoop_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisPol1Sb1Voltage_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisPol1Sb1Current_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisMagnetPol1Sb1Voltage_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisMagnetPol1Sb1Current_status);
+    } else if (pol == 1 && sb == 2) {
+        target.sisOpenLoop_value = sisPol1Sb2OpenLoop_value;
+        target.sisVoltage_value = sisPol1Sb2Voltage_value;
+        target.sisCurrent_value = sisPol1Sb2Current_value;
+        target.sisMagnetVoltage_value = sisMagnetPol1Sb2Voltage_value;
+        target.sisMagnetCurrent_value = sisMagnetPol1Sb2Current_value;
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisPol1Sb2OpenLoop_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisPol1Sb2Voltage_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisPol1Sb2Current_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisMagnetPol1Sb2Voltage_status);
+        status = FEMonitorSnapshot<SIS_t>::combineStatus(status, sisMagnetPol1Sb2Current_status);
+    }
+}
+
+void ColdCartImpl::collectLNA(int pol, int sb, LNA_t &target, int &status) const {
+    memset(&target, 0, sizeof(target));
+    status = FEMC_NO_ERROR;
+    if (pol == 0 && sb == 1) {
+        target.lnaEnable_value = lnaPol0Sb1Enable_value;
+        target.lnaSt1DrainVoltage_value = lnaPol0Sb1St1DrainVoltage_value;
+        target.lnaSt1DrainCurrent_value = lnaPol0Sb1St1DrainCurrent_value;
+        target.lnaSt1GateVoltage_value = lnaPol0Sb1St1GateVoltage_value;
+        target.lnaSt2DrainVoltage_value = lnaPol0Sb1St2DrainVoltage_value;
+        target.lnaSt2DrainCurrent_value = lnaPol0Sb1St2DrainCurrent_value;
+        target.lnaSt2GateVoltage_value = lnaPol0Sb1St2GateVoltage_value;
+        target.lnaSt3DrainVoltage_value = lnaPol0Sb1St3DrainVoltage_value;
+        target.lnaSt3DrainCurrent_value = lnaPol0Sb1St3DrainCurrent_value;
+        target.lnaSt3GateVoltage_value = lnaPol0Sb1St3GateVoltage_value;
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb1Enable_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb1St1DrainVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb1St1DrainCurrent_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb1St1GateVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb1St2DrainVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb1St2DrainCurrent_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb1St2GateVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb1St3DrainVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb1St3DrainCurrent_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb1St3GateVoltage_status);
+    } else if (pol == 0 && sb == 2) {
+        target.lnaEnable_value = lnaPol0Sb2Enable_value;
+        target.lnaSt1DrainVoltage_value = lnaPol0Sb2St1DrainVoltage_value;
+        target.lnaSt1DrainCurrent_value = lnaPol0Sb2St1DrainCurrent_value;
+        target.lnaSt1GateVoltage_value = lnaPol0Sb2St1GateVoltage_value;
+        target.lnaSt2DrainVoltage_value = lnaPol0Sb2St2DrainVoltage_value;
+        target.lnaSt2DrainCurrent_value = lnaPol0Sb2St2DrainCurrent_value;
+        target.lnaSt2GateVoltage_value = lnaPol0Sb2St2GateVoltage_value;
+        target.lnaSt3DrainVoltage_value = lnaPol0Sb2St3DrainVoltage_value;
+        target.lnaSt3DrainCurrent_value = lnaPol0Sb2St3DrainCurrent_value;
+        target.lnaSt3GateVoltage_value = lnaPol0Sb2St3GateVoltage_value;
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb2Enable_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb2St1DrainVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb2St1DrainCurrent_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb2St1GateVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb2St2DrainVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb2St2DrainCurrent_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb2St2GateVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb2St3DrainVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb2St3DrainCurrent_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol0Sb2St3GateVoltage_status);
+    } else if (pol == 1 && sb == 1) {
+        target.lnaEnable_value = lnaPol1Sb1Enable_value;
+        target.lnaSt1DrainVoltage_value = lnaPol1Sb1St1DrainVoltage_value;
+        target.lnaSt1DrainCurrent_value = lnaPol1Sb1St1DrainCurrent_value;
+        target.lnaSt1GateVoltage_value = lnaPol1Sb1St1GateVoltage_value;
+        target.lnaSt2DrainVoltage_value = lnaPol1Sb1St2DrainVoltage_value;
+        target.lnaSt2DrainCurrent_value = lnaPol1Sb1St2DrainCurrent_value;
+        target.lnaSt2GateVoltage_value = lnaPol1Sb1St2GateVoltage_value;
+        target.lnaSt3DrainVoltage_value = lnaPol1Sb1St3DrainVoltage_value;
+        target.lnaSt3DrainCurrent_value = lnaPol1Sb1St3DrainCurrent_value;
+        target.lnaSt3GateVoltage_value = lnaPol1Sb1St3GateVoltage_value;
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb1Enable_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb1St1DrainVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb1St1DrainCurrent_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb1St1GateVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb1St2DrainVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb1St2DrainCurrent_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb1St2GateVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb1St3DrainVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb1St3DrainCurrent_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb1St3GateVoltage_status);
+    } else if (pol == 1 && sb == 2) {
+        target.lnaEnable_value = lnaPol1Sb2Enable_value;
+        target.lnaSt1DrainVoltage_value = lnaPol1Sb2St1DrainVoltage_value;
+        target.lnaSt1DrainCurrent_value = lnaPol1Sb2St1DrainCurrent_value;
+        target.lnaSt1GateVoltage_value = lnaPol1Sb2St1GateVoltage_value;
+        target.lnaSt2DrainVoltage_value = lnaPol1Sb2St2DrainVoltage_value;
+        target.lnaSt2DrainCurrent_value = lnaPol1Sb2St2DrainCurrent_value;
+        target.lnaSt2GateVoltage_value = lnaPol1Sb2St2GateVoltage_value;
+        target.lnaSt3DrainVoltage_value = lnaPol1Sb2St3DrainVoltage_value;
+        target.lnaSt3DrainCurrent_value = lnaPol1Sb2St3DrainCurrent_value;
+        target.lnaSt3GateVoltage_value = lnaPol1Sb2St3GateVoltage_value;
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb2Enable_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb2St1DrainVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb2St1DrainCurrent_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb2St1GateVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb2St2DrainVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb2St2DrainCurrent_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb2St2GateVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb2St3DrainVoltage_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb2St3DrainCurrent_status);
+        status = FEMonitorSnapshot<LNA_t>::combineStatus(status, lnaPol1Sb2St3GateVoltage_status);
+    }
+}
+
+void ColdCartImpl::collectAux(int pol, Aux_t &target, int &status) const {
+    memset(&target, 0, sizeof(target));
+    status = FEMC_NO_ERROR;
     if (pol == 0) {
-        if (hasLNA() && hasLED())
+        if (hasLNA() && hasLED()) {
             target.lnaLedEnable_value = lnaLedPol0Enable_value;
-        else
-            target.lnaLedEnable_value = false;
-        if (hasSISHeater())
+            status = FEMonitorSnapshot<Aux_t>::combineStatus(status, lnaLedPol0Enable_status);
+        }
+        if (hasSISHeater()) {
             target.sisHeaterCurrent_value = sisHeaterPol0Current_value;
-        return true;
+            status = FEMonitorSnapshot<Aux_t>::combineStatus(status, sisHeaterPol0Current_status);
+        }
     } else if (pol == 1) {
-        if (hasLNA() && hasLED())
+        if (hasLNA() && hasLED()) {
             target.lnaLedEnable_value = lnaLedPol1Enable_value;
-        else
-            target.lnaLedEnable_value = false;
-        if (hasSISHeater())
+            status = FEMonitorSnapshot<Aux_t>::combineStatus(status, lnaLedPol1Enable_status);
+        }
+        if (hasSISHeater()) {
             target.sisHeaterCurrent_value = sisHeaterPol1Current_value;
-        return true;
+            status = FEMonitorSnapshot<Aux_t>::combineStatus(status, sisHeaterPol1Current_status);
+        }
     }
-    return false;
+}
+
+void ColdCartImpl::publishTemp(Time timestamp) {
+    CartridgeTemp_t temp;
+    int status;
+    collectTemp(temp, status);
+    tempSnapshot_m.publish(temp, timestamp, status);
+}
+
+void ColdCartImpl::publishSIS(int pol, int sb, Time timestamp) {
+    SIS_t sis;
+    int status;
+    collectSIS(pol, sb, sis, status);
+    sisSnapshot_m[polSbIndex(pol, sb)].publish(sis, timestamp, status);
+}
+
+void ColdCartImpl::publishLNA(int pol, int sb, Time timestamp) {
+    LNA_t lna;
+    int status;
+    collectLNA(pol, sb, lna, status);
+    lnaSnapshot_m[polSbIndex(pol, sb)].publish(lna, timestamp, status);
+}
+
+void ColdCartImpl::publishAux(int pol, Time timestamp) {
+    Aux_t aux;
+    int status;
+    collectAux(pol, aux, status);
+    auxSnapshot_m[pol].publish(aux, timestamp, status);
+}
+
+void ColdCartImpl::postRecordMonHook(const float *target, const FEMonitorDef *def_p, Time timestamp) {
+    if (!def_p)
+        return;
+    // Find the group of the point just read from its offset in monitorTable:
+    const FEMonitorDef &def = *def_p;
+    if (def.offset >= CARTRIDGE_TEMP) {
+        publishTemp(timestamp);
+        return;
+    }
+    int pol = (def.offset & POL1_OFFSET) ? 1 : 0;
+    AmbRelativeAddr offset = def.offset & ~POL1_OFFSET;
+    if (offset == SIS_HEATER_CURRENT) {
+        publishAux(pol, timestamp);
+        return;
+    }
+    int sb = (offset & SB2_OFFSET) ? 2 : 1;
+    offset &= ~SB2_OFFSET;
+    if (offset < LNA1_DRAIN_VOLTAGE)
+        publishSIS(pol, sb, timestamp);
+    else
+        publishLNA(pol, sb, timestamp);
 }
 
 bool ColdCartImpl::getLastHeaterCurrents(int pol, HeaterCurrents_t &target) const {
@@ -1336,85 +1487,70 @@ bool ColdCartImpl::getLastHeaterCurrents(int pol, HeaterCurrents_t &target) cons
 }
 
 void ColdCartImpl::appendThermalLogHeaderImpl(std::string &target) {
-    target += "\t4K stage\t110K stage\tmixer pol0\tspare\t15K stage\tmixer pol1";
+    appendTableThermalLogHeader(monitorTable, monitorTableSize, target);
 }
 
 void ColdCartImpl::appendThermalLog(std::string &target) const {
-    char buf[20];
-    sprintf(buf, "\t%.2f", cartridgeTemperature0_value);
-    target += buf;
-    sprintf(buf, "\t%.2f", cartridgeTemperature1_value);
-    target += buf;
-    sprintf(buf, "\t%.2f", cartridgeTemperature2_value);
-    target += buf;
-    sprintf(buf, "\t%.2f", cartridgeTemperature3_value);
-    target += buf;
-    sprintf(buf, "\t%.2f", cartridgeTemperature4_value);
-    target += buf;
-    sprintf(buf, "\t%.2f", cartridgeTemperature5_value);
-    target += buf;
+    appendTableThermalLog(*this, monitorTable, monitorTableSize, target);
 }
 
 void ColdCartImpl::appendThermalLogPlaceholder(std::string &target) {
-    target += "\t0\t0\t0\t0\t0\t0";
+    appendTableThermalLogPlaceholder(monitorTable, monitorTableSize, target);
+}
+
+unsigned ColdCartImpl::monitorFeatures() const {
+    unsigned features = 0;
+    if (hasSIS())
+        features |= MON_SIS;
+    if (hasSb2())
+        features |= MON_SB2;
+    if (hasSb2St3())
+        features |= MON_SB2_ST3;
+    if (hasMagnet())
+        features |= MON_MAGNET;
+    if (hasSb2Magnet())
+        features |= MON_SB2_MAGNET;
+    return features;
 }
 
 void ColdCartImpl::monitorAction(Time *timestamp_p) {
     if (!timestamp_p)
         return;
 
-    // constant factor to convert 100 ns ticks to ms:
-    static const Time milliseconds = 10000;
-    static const Time monitorInterval = 15 * milliseconds;
-
-    bool doMonitor = false;
-
     if (lastMonitorTime == 0 && logMonitors_m)
         logMon(true);
 
-    if (lastMonitorTime == 0 || (*timestamp_p - lastMonitorTime >= monitorInterval)) {
-        lastMonitorTime = *timestamp_p;
-        doMonitor = true;
-    }
+    lastMonitorTime = *timestamp_p;
 
-    if (doMonitor) {
-        switch (monitorPhase) {
-            case 0:
-                // Execute the next registered analog monitor transaction:
-                if (!executeNextMon())
-                    monitorPhase = 1;
-                break;
-            case 1:
-                sisPol0Sb1OpenLoop_value = (hasSIS()) ? ColdCartImplBase::sisPol0Sb1OpenLoop() : false;
-                sisPol0Sb2OpenLoop_value = (hasSb2() && hasSIS()) ? ColdCartImplBase::sisPol0Sb2OpenLoop() : false;
-                sisPol1Sb1OpenLoop_value = (hasSIS()) ? ColdCartImplBase::sisPol1Sb1OpenLoop() : false;
-                sisPol1Sb2OpenLoop_value = (hasSb2() && hasSIS()) ? ColdCartImplBase::sisPol1Sb2OpenLoop() : false;
-                monitorPhase = 2;
-                break;
-            case 2:
-                lnaPol0Sb1Enable_value = ColdCartImplBase::lnaPol0Sb1Enable();
-                lnaPol0Sb2Enable_value = (hasSb2()) ? ColdCartImplBase::lnaPol0Sb2Enable() : false;
-                lnaPol1Sb1Enable_value = ColdCartImplBase::lnaPol1Sb1Enable();
-                lnaPol1Sb2Enable_value = (hasSb2()) ? ColdCartImplBase::lnaPol1Sb2Enable() : false;
-                monitorPhase = 3;
-                break;
-            case 3:
-                if (hasLED()) {
-                    lnaLedPol0Enable_value = ColdCartImplBase::lnaLedPol0Enable();
-                    lnaLedPol1Enable_value = ColdCartImplBase::lnaLedPol1Enable();
-                } else {
-                    lnaLedPol0Enable_value = false;
-                    lnaLedPol1Enable_value = false;
+    switch (monitorPhase) {
+        case 0:
+            // Execute the next registered analog monitor transaction:
+            if (!executeNextMon())
+                monitorPhase = 1;
+            break;
+        case 1:
+            // The open loop and enable bits in one batch:
+            monitorStatusBatch(hasSIS(), hasSb2(), hasLED());
+            // Its bits belong to the SIS, LNA and aux groups:
+            {
+                Time timestamp;
+                setTimeStamp(&timestamp);
+                for (int pol = 0; pol < 2; ++pol) {
+                    for (int sb = 1; sb <= 2; ++sb) {
+                        publishSIS(pol, sb, timestamp);
+                        publishLNA(pol, sb, timestamp);
+                    }
+                    publishAux(pol, timestamp);
                 }
-                monitorPhase = 4;
-                break;
-            case 4:
-            default:
-                if (logMonitors_m)
-                    logMon();
-                monitorPhase = 0;
-                break;
-        }
+            }
+            monitorPhase = 2;
+            break;
+        case 2:
+        default:
+            if (logMonitors_m)
+                logMon();
+            monitorPhase = 0;
+            break;
     }
 }
 
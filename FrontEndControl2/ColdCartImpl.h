@@ -29,6 +29,7 @@
 #include "FEBASE/ColdCartImplBase.h"
 #include "OPTIMIZE/ThermalLoggable.h"
 #include "CONFIG/CartConfig.h"
+#include "FEBASE/FEMonitorSnapshot.h"
 #include <string>
 class XYPlotArray;
 
@@ -237,21 +238,18 @@ public:
     float getSISVoltage(int pol, int sb, int average = 1, bool print = false);
     ///< get the SIS voltage monitor for the the specified pol and sb, averaging multiple readings if requested.
 
+    float getSISVoltageStatistics(int pol, int sb, int samples, FEMonitorStatistics &stats);
+    ///< read the SIS voltage monitor samples times in one batch, fill in their statistics, and return the mean.
+
 //-------------------------------------------------------------------------------------------------    
 // SIS current monitoring
     
     float getSISCurrent(int pol, int sb, int average = 1);
     ///< get the SIS current monitor for the specified pol and sb, averaging multiple readings if requested.
 
-    // helpers monitor with averaging:
-    float avgSisPol0Sb1Currentx8()
-      { return (hasSIS()) ? avgSisPol0Sb1Current(8) : 0.0; }
-    float avgSisPol0Sb2Currentx8()
-      { return (hasSb2() && hasSIS()) ? avgSisPol0Sb2Current(8) : 0.0; }
-    float avgSisPol1Sb1Currentx8()
-      { return (hasSIS()) ? avgSisPol1Sb1Current(8) : 0.0; }
-    float avgSisPol1Sb2Currentx8()
-      { return (hasSb2() && hasSIS()) ? avgSisPol1Sb2Current(8) : 0.0; }
+    float getSISCurrentStatistics(int pol, int sb, int samples, FEMonitorStatistics &stats);
+    ///< read the SIS current monitor samples times in one batch, fill in their statistics, and return the mean.
+
 //-------------------------------------------------------------------------------------------------
 // SIS magnet monitor and control
 
@@ -409,103 +407,103 @@ public:
     // override the base class LNA drain voltage and current controls, so we can trigger early monitoring:
     virtual void lnaPol0Sb1St1DrainVoltage(float val) {
         ColdCartImplBase::lnaPol0Sb1St1DrainVoltage(val);
-        addMon(&lnaPol0Sb1St1DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb1St1DrainVoltage, true);
+        addMon(&lnaPol0Sb1St1DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb1St1DrainVoltage, "lnaPol0Sb1St1DrainVoltage", true);
     }
     virtual void lnaPol0Sb1St1DrainCurrent(float val) {
         ColdCartImplBase::lnaPol0Sb1St1DrainCurrent(val);
-        addMon(&lnaPol0Sb1St1DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb1St1DrainCurrent, true);
+        addMon(&lnaPol0Sb1St1DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb1St1DrainCurrent, "lnaPol0Sb1St1DrainCurrent", true);
     }
     virtual void lnaPol0Sb1St2DrainVoltage(float val) {
         ColdCartImplBase::lnaPol0Sb1St2DrainVoltage(val);
-        addMon(&lnaPol0Sb1St2DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb1St2DrainVoltage, true);
+        addMon(&lnaPol0Sb1St2DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb1St2DrainVoltage, "lnaPol0Sb1St2DrainVoltage", true);
     }
     virtual void lnaPol0Sb1St2DrainCurrent(float val) {
         ColdCartImplBase::lnaPol0Sb1St2DrainCurrent(val);
-        addMon(&lnaPol0Sb1St2DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb1St2DrainCurrent, true);
+        addMon(&lnaPol0Sb1St2DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb1St2DrainCurrent, "lnaPol0Sb1St2DrainCurrent", true);
     }
     virtual void lnaPol0Sb1St3DrainVoltage(float val) {
         ColdCartImplBase::lnaPol0Sb1St3DrainVoltage(val);
-        addMon(&lnaPol0Sb1St3DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb1St3DrainVoltage, true);
+        addMon(&lnaPol0Sb1St3DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb1St3DrainVoltage, "lnaPol0Sb1St3DrainVoltage", true);
     }
     virtual void lnaPol0Sb1St3DrainCurrent(float val) {
         ColdCartImplBase::lnaPol0Sb1St3DrainCurrent(val);
-        addMon(&lnaPol0Sb1St3DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb1St3DrainCurrent, true);
+        addMon(&lnaPol0Sb1St3DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb1St3DrainCurrent, "lnaPol0Sb1St3DrainCurrent", true);
     }
     virtual void lnaPol0Sb2St1DrainVoltage(float val) {
         ColdCartImplBase::lnaPol0Sb2St1DrainVoltage(val);
-        addMon(&lnaPol0Sb2St1DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb2St1DrainVoltage, true);
+        addMon(&lnaPol0Sb2St1DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb2St1DrainVoltage, "lnaPol0Sb2St1DrainVoltage", true);
     }
     virtual void lnaPol0Sb2St1DrainCurrent(float val) {
         ColdCartImplBase::lnaPol0Sb2St1DrainCurrent(val);
-        addMon(&lnaPol0Sb2St1DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb2St1DrainCurrent, true);
+        addMon(&lnaPol0Sb2St1DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb2St1DrainCurrent, "lnaPol0Sb2St1DrainCurrent", true);
     }
     virtual void lnaPol0Sb2St2DrainVoltage(float val) {
         ColdCartImplBase::lnaPol0Sb2St2DrainVoltage(val);
-        addMon(&lnaPol0Sb2St2DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb2St2DrainVoltage, true);
+        addMon(&lnaPol0Sb2St2DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb2St2DrainVoltage, "lnaPol0Sb2St2DrainVoltage", true);
     }
     virtual void lnaPol0Sb2St2DrainCurrent(float val) {
         ColdCartImplBase::lnaPol0Sb2St2DrainCurrent(val);
-        addMon(&lnaPol0Sb2St2DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb2St2DrainCurrent, true);
+        addMon(&lnaPol0Sb2St2DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb2St2DrainCurrent, "lnaPol0Sb2St2DrainCurrent", true);
     }
     virtual void lnaPol0Sb2St3DrainVoltage(float val) {
         if (!hasSb2St3()) return;
         ColdCartImplBase::lnaPol0Sb2St3DrainVoltage(val);
-        addMon(&lnaPol0Sb2St3DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb2St3DrainVoltage, true);
+        addMon(&lnaPol0Sb2St3DrainVoltage_value, &ColdCartImplBase::lnaPol0Sb2St3DrainVoltage, "lnaPol0Sb2St3DrainVoltage", true);
     }
     virtual void lnaPol0Sb2St3DrainCurrent(float val) {
         if (!hasSb2St3()) return;
         ColdCartImplBase::lnaPol0Sb2St3DrainCurrent(val);
-        addMon(&lnaPol0Sb2St3DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb2St3DrainCurrent, true);
+        addMon(&lnaPol0Sb2St3DrainCurrent_value, &ColdCartImplBase::lnaPol0Sb2St3DrainCurrent, "lnaPol0Sb2St3DrainCurrent", true);
     }
     virtual void lnaPol1Sb1St1DrainVoltage(float val) {
         ColdCartImplBase::lnaPol1Sb1St1DrainVoltage(val);
-        addMon(&lnaPol1Sb1St1DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb1St1DrainVoltage, true);
+        addMon(&lnaPol1Sb1St1DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb1St1DrainVoltage, "lnaPol1Sb1St1DrainVoltage", true);
     }
     virtual void lnaPol1Sb1St1DrainCurrent(float val) {
         ColdCartImplBase::lnaPol1Sb1St1DrainCurrent(val);
-        addMon(&lnaPol1Sb1St1DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb1St1DrainCurrent, true);
+        addMon(&lnaPol1Sb1St1DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb1St1DrainCurrent, "lnaPol1Sb1St1DrainCurrent", true);
     }
     virtual void lnaPol1Sb1St2DrainVoltage(float val) {
         ColdCartImplBase::lnaPol1Sb1St2DrainVoltage(val);
-        addMon(&lnaPol1Sb1St2DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb1St2DrainVoltage, true);
+        addMon(&lnaPol1Sb1St2DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb1St2DrainVoltage, "lnaPol1Sb1St2DrainVoltage", true);
     }
     virtual void lnaPol1Sb1St2DrainCurrent(float val) {
         ColdCartImplBase::lnaPol1Sb1St2DrainCurrent(val);
-        addMon(&lnaPol1Sb1St2DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb1St2DrainCurrent, true);
+        addMon(&lnaPol1Sb1St2DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb1St2DrainCurrent, "lnaPol1Sb1St2DrainCurrent", true);
     }
     virtual void lnaPol1Sb1St3DrainVoltage(float val) {
         ColdCartImplBase::lnaPol1Sb1St3DrainVoltage(val);
-        addMon(&lnaPol1Sb1St3DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb1St3DrainVoltage, true);
+        addMon(&lnaPol1Sb1St3DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb1St3DrainVoltage, "lnaPol1Sb1St3DrainVoltage", true);
     }
     virtual void lnaPol1Sb1St3DrainCurrent(float val) {
         ColdCartImplBase::lnaPol1Sb1St3DrainCurrent(val);
-        addMon(&lnaPol1Sb1St3DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb1St3DrainCurrent, true);
+        addMon(&lnaPol1Sb1St3DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb1St3DrainCurrent, "lnaPol1Sb1St3DrainCurrent", true);
     }
     virtual void lnaPol1Sb2St1DrainVoltage(float val) {
         ColdCartImplBase::lnaPol1Sb2St1DrainVoltage(val);
-        addMon(&lnaPol1Sb2St1DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb2St1DrainVoltage, true);
+        addMon(&lnaPol1Sb2St1DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb2St1DrainVoltage, "lnaPol1Sb2St1DrainVoltage", true);
     }
     virtual void lnaPol1Sb2St1DrainCurrent(float val) {
         ColdCartImplBase::lnaPol1Sb2St1DrainCurrent(val);
-        addMon(&lnaPol1Sb2St1DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb2St1DrainCurrent, true);
+        addMon(&lnaPol1Sb2St1DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb2St1DrainCurrent, "lnaPol1Sb2St1DrainCurrent", true);
     }
     virtual void lnaPol1Sb2St2DrainVoltage(float val) {
         ColdCartImplBase::lnaPol1Sb2St2DrainVoltage(val);
-        addMon(&lnaPol1Sb2St2DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb2St2DrainVoltage, true);
+        addMon(&lnaPol1Sb2St2DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb2St2DrainVoltage, "lnaPol1Sb2St2DrainVoltage", true);
     }
     virtual void lnaPol1Sb2St2DrainCurrent(float val) {
         ColdCartImplBase::lnaPol1Sb2St2DrainCurrent(val);
-        addMon(&lnaPol1Sb2St2DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb2St2DrainCurrent, true);
+        addMon(&lnaPol1Sb2St2DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb2St2DrainCurrent, "lnaPol1Sb2St2DrainCurrent", true);
     }
     virtual void lnaPol1Sb2St3DrainVoltage(float val) {
         if (!hasSb2St3()) return;
         ColdCartImplBase::lnaPol1Sb2St3DrainVoltage(val);
-        addMon(&lnaPol1Sb2St3DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb2St3DrainVoltage, true);
+        addMon(&lnaPol1Sb2St3DrainVoltage_value, &ColdCartImplBase::lnaPol1Sb2St3DrainVoltage, "lnaPol1Sb2St3DrainVoltage", true);
     }
     virtual void lnaPol1Sb2St3DrainCurrent(float val) {
         if (!hasSb2St3()) return;
         ColdCartImplBase::lnaPol1Sb2St3DrainCurrent(val);
-        addMon(&lnaPol1Sb2St3DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb2St3DrainCurrent, true);
+        addMon(&lnaPol1Sb2St3DrainCurrent_value, &ColdCartImplBase::lnaPol1Sb2St3DrainCurrent, "lnaPol1Sb2St3DrainCurrent", true);
     }
     virtual void lnaLedPol0Enable(bool val) {
         if (hasLED()) {
@@ -549,6 +547,9 @@ public:
 
 //-------------------------------------------------------------------------------------------------
 // retrieve monitor values:
+// Each getMonitorXXX() copies a consistent snapshot published by the monitor thread and never waits for it.
+// If timestamp_p is given it receives the time the snapshot was taken, 0 if monitoring hasn't started.
+// If status_p is given it receives the first FEMC_ERROR seen reading the group, FEMC_NO_ERROR if none.
     struct CartridgeTemp_t {
         float cartridgeTemperature0_value;
         float cartridgeTemperature1_value;
@@ -558,7 +559,7 @@ public:
         float cartridgeTemperature5_value;
     };
     ///< structure for returning cartridge temperature monitor values
-    bool getMonitorTemp(CartridgeTemp_t &target) const;
+    bool getMonitorTemp(CartridgeTemp_t &target, Time *timestamp_p = NULL, int *status_p = NULL) const;
     ///< get the cartridge temperature monitor values.
 
     struct SIS_t {
@@ -569,7 +570,7 @@ public:
         float sisMagnetCurrent_value;
     };
     ///< structure for returning SIS and magnet monitor values
-    bool getMonitorSIS(int pol, int sb, SIS_t &target) const;
+    bool getMonitorSIS(int pol, int sb, SIS_t &target, Time *timestamp_p = NULL, int *status_p = NULL) const;
     ///< get the SIS and magnet monitor values for the given pol and sb.
 
     struct LNA_t {
@@ -585,7 +586,7 @@ public:
         float lnaSt3GateVoltage_value;
     };
     ///< structure for returning LNA monitor values.
-    bool getMonitorLNA(int pol, int sb, LNA_t &target) const;
+    bool getMonitorLNA(int pol, int sb, LNA_t &target, Time *timestamp_p = NULL, int *status_p = NULL) const;
     ///< get the LNA monitor values for the given pol and sb.
 
     struct Aux_t {
@@ -593,7 +594,7 @@ public:
         bool lnaLedEnable_value;
     };
     ///< structure for returning auxiliary monitor values.
-    bool getMonitorAux(int pol, Aux_t &target) const;
+    bool getMonitorAux(int pol, Aux_t &target, Time *timestamp_p = NULL, int *status_p = NULL) const;
     ///< get the auxiliary monitor values for the given pol. 
 
     struct HeaterCurrents_t {
@@ -643,6 +644,115 @@ private:
     HeaterCurrents_t lastHeaterCurrentsPol0_m;
     HeaterCurrents_t lastHeaterCurrentsPol1_m;
 
+    // monitor snapshots for the getMonitorXXX() functions:
+    static int polSbIndex(int pol, int sb)
+      { return pol * 2 + sb - 1; }
+    ///< index into the per pol and sb snapshots.  pol and sb must be valid.
+
+    void collectTemp(CartridgeTemp_t &target, int &status) const;
+    void collectSIS(int pol, int sb, SIS_t &target, int &status) const;
+    void collectLNA(int pol, int sb, LNA_t &target, int &status) const;
+    void collectAux(int pol, Aux_t &target, int &status) const;
+    ///< gather a monitor group and its status from the latest monitored values.
+
+    void publishTemp(Time timestamp);
+    void publishSIS(int pol, int sb, Time timestamp);
+    void publishLNA(int pol, int sb, Time timestamp);
+    void publishAux(int pol, Time timestamp);
+    ///< publish one monitor group, stamped with the time it was acquired.  Called by the monitor thread.
+
+    virtual void postRecordMonHook(const float *target, const FEMonitorDef *def_p, Time timestamp);
+    ///< publish the group of a monitor point as soon as the registry records it.
+
+    FEMonitorSnapshot<CartridgeTemp_t> tempSnapshot_m;  ///< cartridge temperatures.
+    FEMonitorSnapshot<SIS_t> sisSnapshot_m[4];          ///< SIS and magnet, by polSbIndex().
+    FEMonitorSnapshot<LNA_t> lnaSnapshot_m[4];          ///< LNA, by polSbIndex().
+    FEMonitorSnapshot<Aux_t> auxSnapshot_m[2];          ///< heater and LED, by pol.
+
+    /// Cartridge features which monitor points in monitorTable may need.
+    enum MonitorFeature {
+        MON_SIS         = 0x01,     ///< hasSIS()
+        MON_SB2         = 0x02,     ///< hasSb2()
+        MON_SB2_ST3     = 0x04,     ///< hasSb2St3()
+        MON_MAGNET      = 0x08,     ///< hasMagnet()
+        MON_SB2_MAGNET  = 0x10      ///< hasSb2Magnet()
+    };
+
+    unsigned monitorFeatures() const;
+    ///< the MonitorFeature bits this cartridge has.
+
+#define COLDCART_MON(NAME, TEXT, OFFSET, RATE, DEADBAND, FEATURES, AVERAGE, THERMAL) \
+    FEMON_TABLE_ENTRY(ColdCartImpl, NAME, TEXT, OFFSET, FEMON_WIRE_FLOAT, RATE, DEADBAND, FEATURES, AVERAGE, THERMAL)
+    static constexpr FEMonitorTableEntry<ColdCartImplBase> monitorTable[] = {
+        // SIS junctions.  The currents are averaged over 8 readings:
+        COLDCART_MON(sisPol0Sb1Voltage, "SIS_VOLTAGE Po=0 Sb=1", SIS_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SIS, 1, NULL),
+        COLDCART_MON(sisPol0Sb2Voltage, "SIS_VOLTAGE Po=0 Sb=2", SB2_OFFSET + SIS_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SIS | MON_SB2, 1, NULL),
+        COLDCART_MON(sisPol1Sb1Voltage, "SIS_VOLTAGE Po=1 Sb=1", POL1_OFFSET + SIS_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SIS, 1, NULL),
+        COLDCART_MON(sisPol1Sb2Voltage, "SIS_VOLTAGE Po=1 Sb=2", POL1_OFFSET + SB2_OFFSET + SIS_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SIS | MON_SB2, 1, NULL),
+        COLDCART_MON(sisPol0Sb1Current, "SIS_CURRENT Po=0 Sb=1", SIS_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_SIS, 8, NULL),
+        COLDCART_MON(sisPol0Sb2Current, "SIS_CURRENT Po=0 Sb=2", SB2_OFFSET + SIS_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_SIS | MON_SB2, 8, NULL),
+        COLDCART_MON(sisPol1Sb1Current, "SIS_CURRENT Po=1 Sb=1", POL1_OFFSET + SIS_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_SIS, 8, NULL),
+        COLDCART_MON(sisPol1Sb2Current, "SIS_CURRENT Po=1 Sb=2", POL1_OFFSET + SB2_OFFSET + SIS_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_SIS | MON_SB2, 8, NULL),
+        // SIS magnets:
+        COLDCART_MON(sisMagnetPol0Sb1Voltage, "SIS_MAGNET_VOLTAGE Po=0 Sb=1", SIS_MAGNET_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_MAGNET, 1, NULL),
+        COLDCART_MON(sisMagnetPol0Sb1Current, "SIS_MAGNET_CURRENT Po=0 Sb=1", SIS_MAGNET_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_MAGNET, 1, NULL),
+        COLDCART_MON(sisMagnetPol0Sb2Voltage, "SIS_MAGNET_VOLTAGE Po=0 Sb=2", SB2_OFFSET + SIS_MAGNET_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2_MAGNET, 1, NULL),
+        COLDCART_MON(sisMagnetPol0Sb2Current, "SIS_MAGNET_CURRENT Po=0 Sb=2", SB2_OFFSET + SIS_MAGNET_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2_MAGNET, 1, NULL),
+        COLDCART_MON(sisMagnetPol1Sb1Voltage, "SIS_MAGNET_VOLTAGE Po=1 Sb=1", POL1_OFFSET + SIS_MAGNET_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_MAGNET, 1, NULL),
+        COLDCART_MON(sisMagnetPol1Sb1Current, "SIS_MAGNET_CURRENT Po=1 Sb=1", POL1_OFFSET + SIS_MAGNET_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_MAGNET, 1, NULL),
+        COLDCART_MON(sisMagnetPol1Sb2Voltage, "SIS_MAGNET_VOLTAGE Po=1 Sb=2", POL1_OFFSET + SB2_OFFSET + SIS_MAGNET_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2_MAGNET, 1, NULL),
+        COLDCART_MON(sisMagnetPol1Sb2Current, "SIS_MAGNET_CURRENT Po=1 Sb=2", POL1_OFFSET + SB2_OFFSET + SIS_MAGNET_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2_MAGNET, 1, NULL),
+        // LNAs:
+        COLDCART_MON(lnaPol0Sb1St1DrainVoltage, "LNA_DRAIN_VOLTAGE Po=0 Sb=1 St=1", LNA1_DRAIN_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol0Sb1St1DrainCurrent, "LNA_DRAIN_CURRENT Po=0 Sb=1 St=1", LNA1_DRAIN_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol0Sb1St1GateVoltage, "LNA_GATE_VOLTAGE Po=0 Sb=1 St=1", LNA1_GATE_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol0Sb1St2DrainVoltage, "LNA_DRAIN_VOLTAGE Po=0 Sb=1 St=2", LNA2_DRAIN_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol0Sb1St2DrainCurrent, "LNA_DRAIN_CURRENT Po=0 Sb=1 St=2", LNA2_DRAIN_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol0Sb1St2GateVoltage, "LNA_GATE_VOLTAGE Po=0 Sb=1 St=2", LNA2_GATE_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol0Sb1St3DrainVoltage, "LNA_DRAIN_VOLTAGE Po=0 Sb=1 St=3", LNA3_DRAIN_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol0Sb1St3DrainCurrent, "LNA_DRAIN_CURRENT Po=0 Sb=1 St=3", LNA3_DRAIN_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol0Sb1St3GateVoltage, "LNA_GATE_VOLTAGE Po=0 Sb=1 St=3", LNA3_GATE_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol0Sb2St1DrainVoltage, "LNA_DRAIN_VOLTAGE Po=0 Sb=2 St=1", SB2_OFFSET + LNA1_DRAIN_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2, 1, NULL),
+        COLDCART_MON(lnaPol0Sb2St1DrainCurrent, "LNA_DRAIN_CURRENT Po=0 Sb=2 St=1", SB2_OFFSET + LNA1_DRAIN_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2, 1, NULL),
+        COLDCART_MON(lnaPol0Sb2St1GateVoltage, "LNA_GATE_VOLTAGE Po=0 Sb=2 St=1", SB2_OFFSET + LNA1_GATE_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2, 1, NULL),
+        COLDCART_MON(lnaPol0Sb2St2DrainVoltage, "LNA_DRAIN_VOLTAGE Po=0 Sb=2 St=2", SB2_OFFSET + LNA2_DRAIN_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2, 1, NULL),
+        COLDCART_MON(lnaPol0Sb2St2DrainCurrent, "LNA_DRAIN_CURRENT Po=0 Sb=2 St=2", SB2_OFFSET + LNA2_DRAIN_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2, 1, NULL),
+        COLDCART_MON(lnaPol0Sb2St2GateVoltage, "LNA_GATE_VOLTAGE Po=0 Sb=2 St=2", SB2_OFFSET + LNA2_GATE_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2, 1, NULL),
+        COLDCART_MON(lnaPol0Sb2St3DrainVoltage, "LNA_DRAIN_VOLTAGE Po=0 Sb=2 St=3", SB2_OFFSET + LNA3_DRAIN_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2 | MON_SB2_ST3, 1, NULL),
+        COLDCART_MON(lnaPol0Sb2St3DrainCurrent, "LNA_DRAIN_CURRENT Po=0 Sb=2 St=3", SB2_OFFSET + LNA3_DRAIN_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2 | MON_SB2_ST3, 1, NULL),
+        COLDCART_MON(lnaPol0Sb2St3GateVoltage, "LNA_GATE_VOLTAGE Po=0 Sb=2 St=3", SB2_OFFSET + LNA3_GATE_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2 | MON_SB2_ST3, 1, NULL),
+        COLDCART_MON(lnaPol1Sb1St1DrainVoltage, "LNA_DRAIN_VOLTAGE Po=1 Sb=1 St=1", POL1_OFFSET + LNA1_DRAIN_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol1Sb1St1DrainCurrent, "LNA_DRAIN_CURRENT Po=1 Sb=1 St=1", POL1_OFFSET + LNA1_DRAIN_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol1Sb1St1GateVoltage, "LNA_GATE_VOLTAGE Po=1 Sb=1 St=1", POL1_OFFSET + LNA1_GATE_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol1Sb1St2DrainVoltage, "LNA_DRAIN_VOLTAGE Po=1 Sb=1 St=2", POL1_OFFSET + LNA2_DRAIN_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol1Sb1St2DrainCurrent, "LNA_DRAIN_CURRENT Po=1 Sb=1 St=2", POL1_OFFSET + LNA2_DRAIN_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol1Sb1St2GateVoltage, "LNA_GATE_VOLTAGE Po=1 Sb=1 St=2", POL1_OFFSET + LNA2_GATE_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol1Sb1St3DrainVoltage, "LNA_DRAIN_VOLTAGE Po=1 Sb=1 St=3", POL1_OFFSET + LNA3_DRAIN_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol1Sb1St3DrainCurrent, "LNA_DRAIN_CURRENT Po=1 Sb=1 St=3", POL1_OFFSET + LNA3_DRAIN_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol1Sb1St3GateVoltage, "LNA_GATE_VOLTAGE Po=1 Sb=1 St=3", POL1_OFFSET + LNA3_GATE_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL),
+        COLDCART_MON(lnaPol1Sb2St1DrainVoltage, "LNA_DRAIN_VOLTAGE Po=1 Sb=2 St=1", POL1_OFFSET + SB2_OFFSET + LNA1_DRAIN_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2, 1, NULL),
+        COLDCART_MON(lnaPol1Sb2St1DrainCurrent, "LNA_DRAIN_CURRENT Po=1 Sb=2 St=1", POL1_OFFSET + SB2_OFFSET + LNA1_DRAIN_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2, 1, NULL),
+        COLDCART_MON(lnaPol1Sb2St1GateVoltage, "LNA_GATE_VOLTAGE Po=1 Sb=2 St=1", POL1_OFFSET + SB2_OFFSET + LNA1_GATE_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2, 1, NULL),
+        COLDCART_MON(lnaPol1Sb2St2DrainVoltage, "LNA_DRAIN_VOLTAGE Po=1 Sb=2 St=2", POL1_OFFSET + SB2_OFFSET + LNA2_DRAIN_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2, 1, NULL),
+        COLDCART_MON(lnaPol1Sb2St2DrainCurrent, "LNA_DRAIN_CURRENT Po=1 Sb=2 St=2", POL1_OFFSET + SB2_OFFSET + LNA2_DRAIN_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2, 1, NULL),
+        COLDCART_MON(lnaPol1Sb2St2GateVoltage, "LNA_GATE_VOLTAGE Po=1 Sb=2 St=2", POL1_OFFSET + SB2_OFFSET + LNA2_GATE_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2, 1, NULL),
+        COLDCART_MON(lnaPol1Sb2St3DrainVoltage, "LNA_DRAIN_VOLTAGE Po=1 Sb=2 St=3", POL1_OFFSET + SB2_OFFSET + LNA3_DRAIN_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2 | MON_SB2_ST3, 1, NULL),
+        COLDCART_MON(lnaPol1Sb2St3DrainCurrent, "LNA_DRAIN_CURRENT Po=1 Sb=2 St=3", POL1_OFFSET + SB2_OFFSET + LNA3_DRAIN_CURRENT, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2 | MON_SB2_ST3, 1, NULL),
+        COLDCART_MON(lnaPol1Sb2St3GateVoltage, "LNA_GATE_VOLTAGE Po=1 Sb=2 St=3", POL1_OFFSET + SB2_OFFSET + LNA3_GATE_VOLTAGE, FEMON_RATE_EVERY_PASS, 0.0, MON_SB2 | MON_SB2_ST3, 1, NULL),
+        // Heater currents and temperatures drift slowly.  Poll them between 1 and 10 s depending on how much they change:
+        COLDCART_MON(sisHeaterPol0Current, "SIS_HEATER_CURRENT Po=0", SIS_HEATER_CURRENT, FEMON_RATE_THERMAL, 0.5, MON_SIS, 1, NULL),
+        COLDCART_MON(sisHeaterPol1Current, "SIS_HEATER_CURRENT Po=1", POL1_OFFSET + SIS_HEATER_CURRENT, FEMON_RATE_THERMAL, 0.5, MON_SIS, 1, NULL),
+        COLDCART_MON(cartridgeTemperature0, "CARTRIDGE_TEMP Te=0", CARTRIDGE_TEMP, FEMON_RATE_THERMAL, 0.05, 0, 1, "4K stage"),
+        COLDCART_MON(cartridgeTemperature1, "CARTRIDGE_TEMP Te=1", CARTRIDGE_TEMP + 0x10, FEMON_RATE_THERMAL, 0.05, 0, 1, "110K stage"),
+        COLDCART_MON(cartridgeTemperature2, "CARTRIDGE_TEMP Te=2", CARTRIDGE_TEMP + 0x20, FEMON_RATE_THERMAL, 0.05, 0, 1, "mixer pol0"),
+        COLDCART_MON(cartridgeTemperature3, "CARTRIDGE_TEMP Te=3", CARTRIDGE_TEMP + 0x30, FEMON_RATE_THERMAL, 0.05, 0, 1, "spare"),
+        COLDCART_MON(cartridgeTemperature4, "CARTRIDGE_TEMP Te=4", CARTRIDGE_TEMP + 0x40, FEMON_RATE_THERMAL, 0.05, 0, 1, "15K stage"),
+        COLDCART_MON(cartridgeTemperature5, "CARTRIDGE_TEMP Te=5", CARTRIDGE_TEMP + 0x50, FEMON_RATE_THERMAL, 0.05, 0, 1, "mixer pol1")
+    };
+#undef COLDCART_MON
+    ///< the analog monitor points, in the order they are read by the monitor registry, also giving the thermal log columns.
+    static constexpr unsigned monitorTableSize = sizeof(monitorTable) / sizeof(monitorTable[0]);
+
     DECLARE_MONITORS_REGISTRY(ColdCartImpl)
     void logMon(bool printHeader = false) const;
 };
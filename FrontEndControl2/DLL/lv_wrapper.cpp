@@ -29,12 +29,18 @@
 #include "splitPath.h"
 #include "FrontEndAMB/NICANBusInterface.h"
 #include "FrontEndAMB/SocketClientBusInterface.h"
+#include "FrontEndAMB/ReplayBusInterface.h"
+#include "FrontEndAMB/ambCompletion.h"
+#include "FrontEndAMB/ambCoalescer.h"
+#include "FrontEndAMB/ambGovernor.h"
 
 #include "FEBASE/FEHardwareDevice.h"
 #include "LOGGER/AmbTransactionLogger.h"
+#include "LOGGER/feAddressMeta.h"
 #include "LOGGER/logDir.h"
 #include "OPTIMIZE/OptimizeBase.h"
 #include "FEMCEventQueue.h"
+#include "SimulatedBusInterface.h"
 #include "DLL/SWVersion.h"
 
 #include <algorithm>
@@ -56,7 +62,11 @@ namespace FrontEndLVWrapper {
     // Debug options:
     logLevel reportingLevel(LM_INFO);   ///< global logging level
     std::string logDir("");             ///< output logs are created here
+    bool asyncLog(false);               ///< Normally false: FELog lines are written by a background thread instead of the caller
     bool logTransactions = false;       ///< Normally false: log all low-level CAN transactions to FELog
+    std::string transactionLogFile("");  ///< If set, write all logged transactions to this binary file
+    bool transactionLogOverwrite(false); ///< Normally false: when a thread's log ring is full drop new entries, else overwrite the oldest
+    unsigned transactionLogRingSize(AmbTransactionLogger::DEFAULT_RING_SIZE); ///< Entries buffered per logging thread
     bool debugLVStructures = false;     ///< Normally false: dump all monitor data results to the log
     bool CAN_noTransmit = false;        ///< Normally false: ignore CAN connection failure and suppress all CAN messages
     unsigned int thermalLogInterval = 30; ///< Seconds between rows in the thermal log file
@@ -65,15 +75,46 @@ namespace FrontEndLVWrapper {
     bool useSocketServer(false);
     std::string socketServerHost("");
     unsigned int socketServerPort(2000);
+
+    // Simulated bus option:
+    bool useSimulatedBus(false);         ///< Normally false: answer all CAN messages with a simulated FEMC module
+
+    // Monitor coalescing options:
+    bool coalesceMonitors(false);        ///< Normally false: merge identical monitor requests which are in flight together
+    unsigned long monitorFreshness(0);   ///< Answer repeated monitor requests within this many us from the last response.  0=off
+
+    // Bus bandwidth governor options:
+    double busMaxRate(0);                ///< Limit on bus transactions per second shared out by the governor.  0=no governor
+    double busShareObserving(50);        ///< Percent of busMaxRate for the observing cartridge
+    double busShareCartridge(30);        ///< Percent of busMaxRate for all other cartridges
+    double busShareInfrastructure(20);   ///< Percent of busMaxRate for the cryostat, LPR, IF switch, and power distribution
+
+    // Capture and replay options:
+    std::string traceFile("");           ///< If set, record every CAN transaction to this binary trace file
+    std::string replayTrace("");         ///< If set, answer all CAN messages from this trace file instead of CAN
+    double replaySpeedup(1.0);           ///< 1=replay with the recorded timing, >1 faster, 0=no waiting
     
     // Software objects we create:
     FILE *logStream = NULL;
     static const AmbInterface *ambItf;
     static CANBusInterface *canBus = NULL;
+    static AmbCoalescer *coalescer = NULL;
+    static AmbGovernor *governor = NULL;
+    static AmbTraceWriter *trace = NULL;
     static AmbTransactionLogger *logger = NULL;
+
+    // Crash handling:
+    static LPTOP_LEVEL_EXCEPTION_FILTER excHndlFilter = NULL; ///< the filter installed by ExcHndlInit()
+    static LONG WINAPI crashFlushFilter(EXCEPTION_POINTERS *exceptionInfo);
 };
 using namespace FrontEndLVWrapper;
 
+/// Unhandled exception filter: write out the queued FELog lines, then let ExcHndl report the crash.
+LONG WINAPI FrontEndLVWrapper::crashFlushFilter(EXCEPTION_POINTERS *exceptionInfo) {
+    AsyncStreamOutput::flush();
+    return (excHndlFilter) ? excHndlFilter(exceptionInfo) : EXCEPTION_CONTINUE_SEARCH;
+}
+
 short LVWrapperInit() {
     // If first client, initialize the shared data mutex:
     if (!connectedModules)
@@ -99,6 +140,11 @@ short LVWrapperInit() {
     // initialize exception handling library:
     ExcHndlInit();
 
+    // flush the asynchronous log before ExcHndl reports a crash:
+    LPTOP_LEVEL_EXCEPTION_FILTER previousFilter = SetUnhandledExceptionFilter(crashFlushFilter);
+    if (previousFilter != crashFlushFilter)
+        excHndlFilter = previousFilter;
+
     // Get the path to FrontEndControlDLL.ini from the environment or assume it in the working directory:
     char *fn=getenv("FRONTENDCONTROL.INI");
     iniFileName = (fn) ? fn : "FrontendControlDLL.ini";
@@ -138,6 +184,11 @@ short LVWrapperInit() {
         if (!temp.empty())
             reportingLevel = StreamLogger::levelFromString(temp);
 
+        // asyncLog = if true, FELog lines are queued for a background thread to write in large batches:
+        temp = configINI.GetValue("logger", "asyncLog");
+        if (!temp.empty())
+            asyncLog = from_string<unsigned long>(temp);
+
         // Compose the log file and excHndl file names:
         string logFile("");
         string excHndlFile("");
@@ -154,6 +205,8 @@ short LVWrapperInit() {
             logStream = fopen(logFile.c_str(), "w");
             StreamOutput::setStream(logStream);
             StreamLogger::setReportingLevel(reportingLevel);
+            if (asyncLog && logStream)
+                AsyncStreamOutput::start();
 
             excHndlFile = logDir + "ExcHndl-" + tmp  + ".txt";
             ExcHndlSetLogFileNameA(excHndlFile.c_str());
@@ -168,7 +221,7 @@ short LVWrapperInit() {
         if (!logDir.empty())
             LOG(LM_INFO) << "Using log directory '" << logDir << "'" << endl;
         if (!logFile.empty())
-            LOG(LM_INFO) << "Using log file '" << logFile << "'" << endl;
+            LOG(LM_INFO) << "Using log file '" << logFile << "'" << (AsyncStreamOutput::running() ? " written asynchronously" : "") << endl;
         if (!excHndlFile.empty())
             LOG(LM_INFO) << "Using ExcHndl file '" << excHndlFile << "'" << endl;
 
@@ -183,8 +236,99 @@ short LVWrapperInit() {
         if (!tmp.empty())
             socketServerPort = from_string<unsigned int>(tmp);
         
+        // socketServerPipeline = max requests in flight to the Socket Server.  Default 1 is stop-and-wait:
+        tmp = configINI.GetValue("connection", "socketServerPipeline");
+        if (!tmp.empty())
+            SocketClientBusInterface::pipelineDepth_m = from_string<int>(tmp);
+
         if (useSocketServer)
-            LOG(LM_INFO) << "Using Socket Server (instead of CAN) host:" << socketServerHost << " port:" << socketServerPort << endl;
+            LOG(LM_INFO) << "Using Socket Server (instead of CAN) host:" << socketServerHost << " port:" << socketServerPort 
+                         << " pipeline:" << SocketClientBusInterface::pipelineDepth_m << endl;
+
+        // simulateBus = if true, use a simulated FEMC module instead of CAN or Socket Server:
+        tmp = configINI.GetValue("connection", "simulateBus");
+        if (!tmp.empty())
+            useSimulatedBus = from_string<unsigned long>(tmp);
+
+        // simulatedLatency, simulatedJitter = time per simulated transaction and random extra time, us:
+        tmp = configINI.GetValue("connection", "simulatedLatency");
+        if (!tmp.empty())
+            SimulatedBusInterface::latency_m = from_string<unsigned>(tmp);
+        tmp = configINI.GetValue("connection", "simulatedJitter");
+        if (!tmp.empty())
+            SimulatedBusInterface::jitter_m = from_string<unsigned>(tmp);
+
+        if (useSimulatedBus)
+            LOG(LM_INFO) << "Using simulated bus (instead of CAN) latency:" << SimulatedBusInterface::latency_m 
+                         << " us jitter:" << SimulatedBusInterface::jitter_m << " us" << endl;
+
+        // coalesceMonitors = if true, identical monitor requests in flight together share one bus transaction:
+        tmp = configINI.GetValue("connection", "coalesceMonitors");
+        if (!tmp.empty())
+            coalesceMonitors = from_string<unsigned long>(tmp);
+
+        // monitorFreshness = when coalescing, reuse a monitor response for this many us.  Default 0 = don't reuse:
+        tmp = configINI.GetValue("connection", "monitorFreshness");
+        if (!tmp.empty())
+            monitorFreshness = from_string<unsigned long>(tmp);
+
+        if (coalesceMonitors)
+            LOG(LM_INFO) << "Coalescing monitor requests freshness:" << monitorFreshness << " us" << endl;
+
+        // busMaxRate = transactions per second shared out between the observing cartridge, other cartridges, and 
+        //   infrastructure.  Default 0 = no limit:
+        // busShareObserving, busShareCartridge, busShareInfrastructure = percent of busMaxRate for each:
+        tmp = configINI.GetValue("connection", "busMaxRate");
+        if (!tmp.empty())
+            busMaxRate = from_string<double>(tmp);
+        tmp = configINI.GetValue("connection", "busShareObserving");
+        if (!tmp.empty())
+            busShareObserving = from_string<double>(tmp);
+        tmp = configINI.GetValue("connection", "busShareCartridge");
+        if (!tmp.empty())
+            busShareCartridge = from_string<double>(tmp);
+        tmp = configINI.GetValue("connection", "busShareInfrastructure");
+        if (!tmp.empty())
+            busShareInfrastructure = from_string<double>(tmp);
+
+        if (busMaxRate > 0)
+            LOG(LM_INFO) << "Bus governor max rate:" << busMaxRate << "/s shares observing:" << busShareObserving
+                         << "% cartridge:" << busShareCartridge << "% infrastructure:" << busShareInfrastructure << "%" << endl;
+
+        // replayTrace = if provided, answer from a trace recorded with traceFile instead of CAN, Socket Server or simulation:
+        tmp = configINI.GetValue("connection", "replayTrace");
+        if (!tmp.empty())
+            replayTrace = tmp;
+
+        // replaySpeedup = 1 to replay with the recorded timing, 10 for ten times faster, 0 for no waiting:
+        tmp = configINI.GetValue("connection", "replaySpeedup");
+        if (!tmp.empty())
+            replaySpeedup = from_string<double>(tmp);
+
+        if (!replayTrace.empty())
+            LOG(LM_INFO) << "Replaying trace (instead of CAN) file:" << replayTrace << " speedup:" << replaySpeedup << endl;
+
+        // breakerTimeouts = consecutive CAN timeouts which open a device's circuit breaker.  0 = never:
+        // breakerMinBackoff, breakerMaxBackoff = ms between probes of a device with an open breaker, doubling each time:
+        unsigned breakerTimeouts(FECircuitBreaker::threshold_m);
+        unsigned long breakerMinBackoff(FECircuitBreaker::minBackoff_m), breakerMaxBackoff(FECircuitBreaker::maxBackoff_m);
+        tmp = configINI.GetValue("connection", "breakerTimeouts");
+        if (!tmp.empty())
+            breakerTimeouts = from_string<unsigned>(tmp);
+        tmp = configINI.GetValue("connection", "breakerMinBackoff");
+        if (!tmp.empty())
+            breakerMinBackoff = from_string<unsigned long>(tmp);
+        tmp = configINI.GetValue("connection", "breakerMaxBackoff");
+        if (!tmp.empty())
+            breakerMaxBackoff = from_string<unsigned long>(tmp);
+        FECircuitBreaker::configure(breakerTimeouts, breakerMinBackoff, breakerMaxBackoff);
+        LOG(LM_INFO) << "Circuit breaker timeouts=" << FECircuitBreaker::threshold_m << " backoff=" << FECircuitBreaker::minBackoff_m
+                     << "-" << FECircuitBreaker::maxBackoff_m << " ms" << endl;
+
+        // traceFile = if provided, every CAN transaction will be recorded to this binary file for replay:
+        tmp = configINI.GetValue("logger", "traceFile");
+        if (!tmp.empty())
+            traceFile = tmp;
 
         // logTransactions = if true, every CAN message will be logged.  HUGE log file!
         tmp = configINI.GetValue("logger", "logTransactions");
@@ -192,6 +336,24 @@ short LVWrapperInit() {
             logTransactions = from_string<unsigned long>(tmp);
         LOG(LM_INFO) << "Logging FE transactions=" << logTransactions << endl;
 
+        // transactionLogFile = if provided, logged transactions are written to this compact binary file.
+        //   Decode it to text with decodeTransactionLog.exe:
+        // transactionLogOverflow = "drop" to drop new entries when a thread logs faster than they are written,
+        //   or "overwrite" to replace the oldest.  Default is drop:
+        // transactionLogRingSize = entries buffered for each thread which logs:
+        tmp = configINI.GetValue("logger", "transactionLogFile");
+        if (!tmp.empty())
+            transactionLogFile = tmp;
+        tmp = configINI.GetValue("logger", "transactionLogOverflow");
+        if (!tmp.empty())
+            transactionLogOverwrite = (tmp == "overwrite");
+        tmp = configINI.GetValue("logger", "transactionLogRingSize");
+        if (!tmp.empty())
+            transactionLogRingSize = from_string<unsigned>(tmp);
+        if (!transactionLogFile.empty())
+            LOG(LM_INFO) << "Transaction log file:" << transactionLogFile << " overflow:" 
+                         << (transactionLogOverwrite ? "overwrite" : "drop") << " ring size:" << transactionLogRingSize << endl;
+
         // CAN_debugStdout = if true, every low-level CAN frame will be logged to stdout:
         tmp = configINI.GetValue("debug", "CAN_debugStdout");
         if (!tmp.empty())
@@ -246,19 +408,60 @@ short LVWrapperInit() {
     }
     
     // Create the CAN interface:
+    WHACK(coalescer);
+    WHACK(governor);
     WHACK(canBus);
-    if (useSocketServer)
+    WHACK(trace);
+    if (!replayTrace.empty()) {
+        ReplayBusInterface *replay = new ReplayBusInterface(replaySpeedup);
+        if (replay -> load(replayTrace))
+            LOG(LM_INFO) << "Loaded " << replay -> getNumRecords() << " transactions from " << replayTrace << endl;
+        else
+            LOG(LM_ERROR) << "LVWrapperInit: can't read trace file " << replayTrace << endl;
+        canBus = replay;
+    } else if (useSimulatedBus)
+        canBus = new SimulatedBusInterface();
+    else if (useSocketServer)
         canBus = new SocketClientBusInterface(socketServerHost, socketServerPort);
     else
         canBus = new NICANBusInterface();
+    // Record all transactions if requested:
+    if (!traceFile.empty()) {
+        trace = new AmbTraceWriter();
+        if (trace -> open(traceFile)) {
+            canBus -> setTrace(trace);
+            LOG(LM_INFO) << "Recording CAN transactions to " << traceFile << endl;
+        } else {
+            LOG(LM_ERROR) << "LVWrapperInit: can't create trace file " << traceFile << endl;
+            WHACK(trace);
+        }
+    }
+    // Group the bus latency histograms by FE subsystem:
+    AmbLatencyTable::setClassifier(FrontEnd::latencySubsystem);
+    // Optionally share out the bus between cartridges and infrastructure:
+    AmbGovernor::setClassifier(FrontEnd::governorDevice);
+    if (busMaxRate > 0)
+        governor = new AmbGovernor(*canBus, busMaxRate, busShareObserving, busShareCartridge, busShareInfrastructure);
+    AmbInterfaceBus *bus = (governor) ? (AmbInterfaceBus *) governor : (AmbInterfaceBus *) canBus;
+    // Optionally merge identical monitor requests in front of that, so that only those sent are counted:
+    if (coalesceMonitors)
+        coalescer = new AmbCoalescer(*bus, monitorFreshness);
     // Tell the AmbInterface to use the bus:
     ambItf = AmbInterface::getInstance();
-    if (ambItf)
-        ambItf -> setBus(canBus);
+    if (ambItf) {
+        if (coalescer)
+            ambItf -> setBus(coalescer);
+        else
+            ambItf -> setBus(bus);
+    }
 
     // Create the CAN transaction logging queue:
     WHACK(logger);
-    logger = new AmbTransactionLogger(logTransactions);
+    logger = new AmbTransactionLogger(logTransactions, transactionLogRingSize);
+    if (transactionLogOverwrite)
+        logger -> setOverflowPolicy(AmbTransactionLogger::OVERWRITE_OLDEST);
+    if (!transactionLogFile.empty() && !logger -> open(transactionLogFile))
+        LOG(LM_ERROR) << "LVWrapperInit: can't create transaction log file " << transactionLogFile << endl;
     FEHardwareDevice::setLogger(*logger);
 
     // Create the FEMC event queue:
@@ -302,13 +505,23 @@ short LVWrapperShutdown() {
         FEMCEventQueue::destroyInstance();
         LOG(LM_INFO) << "LVWrapperShutdown: eventQueue destroyed" << endl;
 
+        FEMonitorScheduler::deleteInstance();
+        LOG(LM_INFO) << "LVWrapperShutdown: monitor scheduler destroyed" << endl;
+
+        FEMonitorHistoryStore::deleteInstance();
+        LOG(LM_INFO) << "LVWrapperShutdown: monitor history destroyed" << endl;
+
         AmbInterface::deleteInstance();
         ambItf = NULL;
         LOG(LM_INFO) << "LVWrapperShutdown: AmbInterface destroyed" << endl;
 
+        WHACK(coalescer);
+        WHACK(governor);
         WHACK(canBus);
+        WHACK(trace);
         LOG(LM_INFO) << "LVWrapperShutdown: CANBusInterface destroyed" << endl;
 
+        AsyncStreamOutput::stop();
         if (logStream) {
             fflush(logStream);
             fclose(logStream);
@@ -388,6 +601,205 @@ DLLEXPORT short getNextEventSeqNo(unsigned long *seq) {
     return (ret) ? 0 : -1;
 }
 
+DLLEXPORT short getBusLatency(short channel, short node, short subsystem, short queueDelay, 
+                              unsigned long *count, float *p50, float *p99, float *p999, float *maxValue)
+{
+    if (!canBus || !count || !p50 || !p99 || !p999 || !maxValue)
+        return -1;
+    AmbLatencyHistogram queue, roundTrip;
+    canBus -> getLatency(channel, node, subsystem, queue, roundTrip);
+    const AmbLatencyHistogram &hist = (queueDelay) ? queue : roundTrip;
+    *count = hist.count();
+    *p50 = hist.percentile(50);
+    *p99 = hist.percentile(99);
+    *p999 = hist.percentile(99.9);
+    *maxValue = hist.maxValue();
+    return 0;
+}
+
+DLLEXPORT short getBusLatencyReport(short reportLen, char *report) {
+    if (!canBus || !report || reportLen <= 0)
+        return -1;
+    std::vector<AmbLatencyKey> keys;
+    canBus -> getLatencyKeys(keys);
+    std::string text("ch\tnode\tsubsys\tname\tN\tqueue p50\tqueue p99\tp50\tp99\tp99.9\tmax\n");
+    char line[200];
+    for (unsigned index = 0; index < keys.size(); ++index) {
+        const AmbLatencyKey &key = keys[index];
+        AmbLatencyHistogram queue, roundTrip;
+        canBus -> getLatency(key.channel, key.node, key.subsystem, queue, roundTrip);
+        sprintf(line, "%u\t0x%lX\t0x%02X\t%s\t%lu\t%lu\t%lu\t%lu\t%lu\t%lu\t%lu\n",
+                (unsigned) key.channel, (unsigned long) key.node, key.subsystem,
+                FrontEnd::latencySubsystemName(key.subsystem).c_str(), roundTrip.count(),
+                queue.percentile(50), queue.percentile(99), roundTrip.percentile(50),
+                roundTrip.percentile(99), roundTrip.percentile(99.9), roundTrip.maxValue());
+        text += line;
+    }
+    strncpy(report, text.c_str(), reportLen - 1);
+    report[reportLen - 1] = '\0';
+    return 0;
+}
+
+DLLEXPORT short resetBusLatency() {
+    if (!canBus)
+        return -1;
+    canBus -> resetLatency();
+    return 0;
+}
+
+DLLEXPORT short getMonitorCoalescing(unsigned long *monitors, unsigned long *sent,
+                                     unsigned long *coalesced, unsigned long *cacheHits)
+{
+    if (!monitors || !sent || !coalesced || !cacheHits)
+        return -1;
+    AmbCoalescerStats stats;
+    if (coalescer)
+        coalescer -> getStats(stats);
+    *monitors = stats.monitors;
+    *sent = stats.sent;
+    *coalesced = stats.coalesced;
+    *cacheHits = stats.cacheHits;
+    return 0;
+}
+
+DLLEXPORT short setBusGovernor(float maxRate, float observingShare, float cartridgeShare, float infrastructureShare) {
+    if (!governor)
+        return -1;
+    governor -> configure(maxRate, observingShare, cartridgeShare, infrastructureShare);
+    LOG(LM_INFO) << "Bus governor max rate:" << maxRate << "/s shares observing:" << observingShare
+                 << "% cartridge:" << cartridgeShare << "% infrastructure:" << infrastructureShare << "%" << endl;
+    return 0;
+}
+
+DLLEXPORT short getBusGovernor(short budget, short device, float *share, float *allocated, float *rate,
+                               float *utilization, unsigned long *transactions, unsigned long *borrowed,
+                               unsigned long *throttled)
+{
+    if (!governor || !share || !allocated || !rate || !utilization || !transactions || !borrowed || !throttled)
+        return -1;
+    AmbGovernorStats stats;
+    if (device >= 0 && device < AmbGovernor::MAX_DEVICES)
+        governor -> getDeviceStats(device, stats);
+    else if (budget >= 0 && budget < AmbGovernor::NUM_BUDGETS)
+        governor -> getStats((AmbGovernor::Budget) budget, stats);
+    else
+        return -1;
+    *share = stats.share;
+    *allocated = stats.allocated;
+    *rate = stats.rate;
+    *utilization = stats.utilization;
+    *transactions = stats.transactions;
+    *borrowed = stats.borrowed;
+    *throttled = stats.throttled;
+    return 0;
+}
+
+DLLEXPORT short getBusGovernorReport(short reportLen, char *report) {
+    if (!governor || !report || reportLen <= 0)
+        return -1;
+    char line[200];
+    sprintf(line, "max rate %.0f/s, utilization %.1f%%, observing band %u\n",
+            governor -> getMaxRate(), governor -> getUtilization(), AmbGovernor::getObserving());
+    std::string text(line);
+    text += "name\tbudget\tshare %\tallocated/s\trate/s\tutilization %\tN\tborrowed\tthrottled\tavg wait ms\n";
+    AmbGovernorStats stats;
+    for (int budget = 0; budget < AmbGovernor::NUM_BUDGETS; ++budget) {
+        governor -> getStats((AmbGovernor::Budget) budget, stats);
+        sprintf(line, "%s\t%s\t%.1f\t%.1f\t%.1f\t%.1f\t%lu\t%lu\t%lu\t%.2f\n",
+                "all", AmbGovernor::budgetName((AmbGovernor::Budget) budget), stats.share, stats.allocated,
+                stats.rate, stats.utilization, stats.transactions, stats.borrowed, stats.throttled,
+                stats.throttled ? stats.totalWait / stats.throttled : 0.0);
+        text += line;
+    }
+    // Devices which have sent anything:
+    for (unsigned device = 0; device < AmbGovernor::MAX_DEVICES; ++device) {
+        governor -> getDeviceStats(device, stats);
+        if (!stats.transactions)
+            continue;
+        char name[20];
+        if (device)
+            sprintf(name, "band %u", device);
+        else
+            strcpy(name, "infrastructure");
+        sprintf(line, "%s\t%s\t%.1f\t%.1f\t%.1f\t%.1f\t%lu\t%lu\t%lu\t%.2f\n",
+                name, AmbGovernor::budgetName(AmbGovernor::budgetFor(device)), stats.share, stats.allocated,
+                stats.rate, stats.utilization, stats.transactions, stats.borrowed, stats.throttled,
+                stats.throttled ? stats.totalWait / stats.throttled : 0.0);
+        text += line;
+    }
+    strncpy(report, text.c_str(), reportLen - 1);
+    report[reportLen - 1] = '\0';
+    return 0;
+}
+
+DLLEXPORT short getMonitorHistoryNames(short listLen, char *list) {
+    if (!list || listLen <= 0)
+        return -1;
+    std::vector<std::string> devices, points;
+    FEMonitorHistoryStore::getInstance().getNames(devices, points);
+    std::string text;
+    for (unsigned index = 0; index < devices.size(); ++index)
+        text += devices[index] + "\t" + points[index] + "\n";
+    strncpy(list, text.c_str(), listLen - 1);
+    list[listLen - 1] = '\0';
+    return 0;
+}
+
+DLLEXPORT short getMonitorHistory(const char *device, const char *point, short resolution,
+                                  unsigned long long startTime, unsigned long long endTime, long maxEntries,
+                                  unsigned long long *times, float *minValues, float *maxValues,
+                                  float *meanValues, short *status, long *numEntries)
+{
+    if (!device || !point || maxEntries <= 0 || !times || !minValues || !maxValues || !meanValues || !status || !numEntries)
+        return -1;
+    *numEntries = 0;
+    if (resolution < FEMonitorHistory::RESOLUTION_RAW || resolution >= FEMonitorHistory::NUM_RESOLUTIONS)
+        return -1;
+    FEMonitorHistory *history = FEMonitorHistoryStore::getInstance().findHistory(device, point);
+    if (!history)
+        return -1;
+    std::vector<FEMonitorHistoryEntry> entries;
+    history -> query((FEMonitorHistory::Resolution) resolution, startTime, endTime, maxEntries, entries);
+    for (unsigned index = 0; index < entries.size(); ++index) {
+        const FEMonitorHistoryEntry &entry = entries[index];
+        times[index] = entry.timestamp;
+        minValues[index] = entry.minValue;
+        maxValues[index] = entry.maxValue;
+        meanValues[index] = entry.meanValue;
+        status[index] = entry.status;
+    }
+    *numEntries = entries.size();
+    return 0;
+}
+
+DLLEXPORT short getCircuitBreakerReport(short reportLen, char *report) {
+    if (!report || reportLen <= 0)
+        return -1;
+    std::string text;
+    FECircuitBreaker::getReport(text);
+    strncpy(report, text.c_str(), reportLen - 1);
+    report[reportLen - 1] = '\0';
+    return 0;
+}
+
+DLLEXPORT short getCircuitBreaker(const char *name, short *state, unsigned long *consecutiveTimeouts,
+                                  unsigned long *opens, unsigned long *probes, unsigned long *failedFast,
+                                  unsigned long *backoff)
+{
+    if (!name || !state || !consecutiveTimeouts || !opens || !probes || !failedFast || !backoff)
+        return -1;
+    FECircuitBreakerStats stats;
+    if (!FECircuitBreaker::findStats(name, stats))
+        return -1;
+    *state = stats.state;
+    *consecutiveTimeouts = stats.consecutiveTimeouts;
+    *opens = stats.opens;
+    *probes = stats.probes;
+    *failedFast = stats.failedFast;
+    *backoff = stats.backoff;
+    return 0;
+}
+
 //----------------------------------------------------------------------------
 
 DLLEXPORT short TestSocketClient() {
@@ -403,7 +815,7 @@ DLLEXPORT short TestSocketClient() {
 
     req.address = createAMBAddr(0x13, 0xD000);
     req.channel = 1;
-    req.completion_p = new AmbCompletion_t;
+    req.completion_p = AmbCompletionPool::allocate();
     req.completion_p->dataLength_p = &dataLen;
     req.completion_p->data_p       = &(data[0]);
     req.completion_p->channel_p    = NULL;
@@ -418,6 +830,8 @@ DLLEXPORT short TestSocketClient() {
     req.dataLen = 0;
     req.requestType = AMB_MONITOR;
     req.targetTE = 0;
+    req.priority = AMB_PRIORITY_CONTROL;
+    req.deadline = 0;
     itf.sendMessage(req);
     sem_wait(&synchLock);
     
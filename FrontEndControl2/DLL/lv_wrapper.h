@@ -80,6 +80,58 @@ DLLEXPORT short getNextEvent(unsigned long *seq,
 DLLEXPORT short getNextEventSeqNo(unsigned long *seq);
 ///< Get the next sequence number that the event queue will return.
 
+DLLEXPORT short getBusLatency(short channel, short node, short subsystem, short queueDelay, 
+                              unsigned long *count, float *p50, float *p99, float *p999, float *maxValue);
+///< Get latency percentiles in us for bus transactions.
+///< Pass -1 for channel, node, or subsystem to include all.  subsystem is as in getBusLatencyReport().
+///< queueDelay=1 for the time spent waiting in the queue, 0 for the bus round-trip time.
+
+DLLEXPORT short getBusLatencyReport(short reportLen, char *report);
+///< Get a text table of the latency percentiles for each channel, node, and subsystem seen.
+
+DLLEXPORT short resetBusLatency();
+///< Zero the bus latency histograms.
+
+DLLEXPORT short getMonitorCoalescing(unsigned long *monitors, unsigned long *sent,
+                                     unsigned long *coalesced, unsigned long *cacheHits);
+///< Get the counts of monitor requests seen, sent to the bus, merged with one in flight, and answered
+///< from the freshness cache.  All zero unless coalesceMonitors is set in the [connection] section.
+
+DLLEXPORT short setBusGovernor(float maxRate, float observingShare, float cartridgeShare, float infrastructureShare);
+///< Change the bus governor's limit on transactions per second and the percent of it for the observing
+///< cartridge, other cartridges, and infrastructure.  Returns -1 unless busMaxRate is set in the [connection] section.
+
+DLLEXPORT short getBusGovernor(short budget, short device, float *share, float *allocated, float *rate,
+                               float *utilization, unsigned long *transactions, unsigned long *borrowed,
+                               unsigned long *throttled);
+///< Get the allocation and usage of a bus governor budget or device.  If device is 0-15 it is reported, 
+///< otherwise pass -1 for device and budget 0=observing, 1=other cartridges, 2=infrastructure.
+///< Devices are 1-10 for the cartridge bands and 0 for infrastructure.  share is percent, allocated and rate
+///< are transactions per second, utilization is rate as percent of allocated.  Over 100 when using reclaimed share.
+
+DLLEXPORT short getBusGovernorReport(short reportLen, char *report);
+///< Get a text table of the allocation and usage of each bus governor budget and each device seen.
+
+DLLEXPORT short getMonitorHistoryNames(short listLen, char *list);
+///< Get the device and point names of all monitor histories, tab separated, one per line.
+
+DLLEXPORT short getMonitorHistory(const char *device, const char *point, short resolution,
+                                  unsigned long long startTime, unsigned long long endTime, long maxEntries,
+                                  unsigned long long *times, float *minValues, float *maxValues,
+                                  float *meanValues, short *status, long *numEntries);
+///< Get up to maxEntries of the latest history of a monitor point, oldest first, into the arrays provided.
+///< resolution 0=raw samples, 1=1 s, 2=1 min, 3=10 min rollups.  Times are in 100 ns units as from setTimeStamp().
+///< Pass 0 for startTime and endTime to get all that is kept.  status is the FEMC_ERROR of each entry.
+
+DLLEXPORT short getCircuitBreakerReport(short reportLen, char *report);
+///< Get a text table of the circuit breaker state and counters of each device and subsystem, one per line.
+
+DLLEXPORT short getCircuitBreaker(const char *name, short *state, unsigned long *consecutiveTimeouts,
+                                  unsigned long *opens, unsigned long *probes, unsigned long *failedFast,
+                                  unsigned long *backoff);
+///< Get the circuit breaker of a device or subsystem, named as in getCircuitBreakerReport().
+///< state 0=closed, 1=open, 2=half-open.  backoff is the current time between probes, ms.
+
 
 //----------------------------------------------------------------------------
 // Miscellaneous:
@@ -212,6 +212,31 @@ DLLEXPORT short FEControlInit() {
             logMonTimers = (from_string<unsigned int>(tmp) != 0);
         LOG(LM_INFO) << "logMonTimers=" << logMonTimers << endl;
 
+        tmp = configINI.GetValue("debug", "monitorDeadline");
+        if (!tmp.empty())
+            FEHardwareDevice::monitorDeadline(from_string<unsigned long>(tmp));
+        LOG(LM_INFO) << "monitorDeadline=" << FEHardwareDevice::getMonitorDeadline() << endl;
+
+        // monitorHistory = if true, keep an in-memory history of every monitor point for getMonitorHistory():
+        // monitorHistoryRaw, monitorHistorySeconds, monitorHistoryMinutes, monitorHistoryTenMinutes =
+        //   entries kept per point at each resolution.  About 32 bytes each, allocated when a point is first read:
+        bool monitorHistory = false;
+        unsigned historySizes[FEMonitorHistory::NUM_RESOLUTIONS] = {
+            FEMonitorHistory::RAW_SIZE, FEMonitorHistory::SECOND_SIZE, FEMonitorHistory::MINUTE_SIZE, FEMonitorHistory::TEN_MINUTES_SIZE };
+        const char *historySizeKeys[FEMonitorHistory::NUM_RESOLUTIONS] = {
+            "monitorHistoryRaw", "monitorHistorySeconds", "monitorHistoryMinutes", "monitorHistoryTenMinutes" };
+        tmp = configINI.GetValue("debug", "monitorHistory");
+        if (!tmp.empty())
+            monitorHistory = (from_string<unsigned int>(tmp) != 0);
+        for (int res = 0; res < FEMonitorHistory::NUM_RESOLUTIONS; ++res) {
+            tmp = configINI.GetValue("debug", historySizeKeys[res]);
+            if (!tmp.empty())
+                historySizes[res] = from_string<unsigned>(tmp);
+        }
+        FEMonitorHistoryStore::configure(monitorHistory, historySizes);
+        LOG(LM_INFO) << "monitorHistory=" << monitorHistory << " sizes=" << historySizes[0] << "/" << historySizes[1]
+                     << "/" << historySizes[2] << "/" << historySizes[3] << endl;
+
         // look for the item specifying a separate file for FineLOSweep
         tmp = configINI.GetValue("configFiles", "FineLOSweep");
         if (tmp.empty())
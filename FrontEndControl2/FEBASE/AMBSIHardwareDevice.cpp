@@ -51,13 +51,11 @@ std::string AMBSIHardwareDevice::AMBSIFirmwareRev() {
 unsigned long AMBSIHardwareDevice::AMBSINumErrors() {
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
     monitor(AMBSI_BASE + AMBSI_NUM_ERRORS, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     if (status != AMBERR_NOERR)
         AMBSINumErrors_value = 0;
     else
@@ -68,13 +66,11 @@ unsigned long AMBSIHardwareDevice::AMBSINumErrors() {
 unsigned long AMBSIHardwareDevice::AMBSINumTransactions() {
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
     monitor(AMBSI_BASE + AMBSI_NUM_TRANSACTIONS, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     if (status != AMBERR_NOERR)
         AMBSINumTransactions_value = 0;
     else
@@ -87,13 +83,11 @@ float AMBSIHardwareDevice::AMBSITemperature() {
     lastFemcError_m = FEMC_NO_ERROR;
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
     monitor(AMBSI_BASE + AMBSI_TEMPERATURE, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     if (status != AMBERR_NOERR)
         lastFemcError_m = FEMC_UNPACK_ERROR;
     else if (0 != unpackDS1820Temperature(AMBSITemperature_value, dataLength, data))
@@ -181,8 +181,8 @@ ColdCartImplBase::ColdCartImplBase(const std::string &name, int port)
     baseRCA = port - 1;
     baseRCA <<= 12;
     
-    AmbRelativeAddr pol1 = 0x0400;
-    AmbRelativeAddr sb2  = 0x0080;
+    AmbRelativeAddr pol1 = POL1_OFFSET;
+    AmbRelativeAddr sb2  = SB2_OFFSET;
 
     sisPol0Sb1Voltage_RCA           = baseRCA + SIS_VOLTAGE;
     sisPol0Sb1Current_RCA           = baseRCA + SIS_CURRENT;
@@ -269,6 +269,7 @@ ColdCartImplBase::ColdCartImplBase(const std::string &name, int port)
 void ColdCartImplBase::initialize(unsigned long channel, unsigned long nodeAddress) {
     m_channel = channel;
     m_nodeAddress = nodeAddress;
+    initializeSubsystemBreaker(baseRCA);
 }
 
 void ColdCartImplBase::shutdown() {
@@ -323,6 +324,38 @@ float ColdCartImplBase::avgSisPol1Sb2Current(int average) {
     SYNCMON_AVG_LOG_FLOAT(sisPol1Sb2Current, "SIS_CURRENT Po=1 Sb=2", average)
 }
 
+float ColdCartImplBase::statsSisPol0Sb1Voltage(int samples, FEMonitorStatistics &stats) {
+    SYNCMON_STATS_LOG_FLOAT(sisPol0Sb1Voltage, "SIS_VOLTAGE Po=0 Sb=1", samples, stats)
+}
+
+float ColdCartImplBase::statsSisPol0Sb2Voltage(int samples, FEMonitorStatistics &stats) {
+    SYNCMON_STATS_LOG_FLOAT(sisPol0Sb2Voltage, "SIS_VOLTAGE Po=0 Sb=2", samples, stats)
+}
+
+float ColdCartImplBase::statsSisPol1Sb1Voltage(int samples, FEMonitorStatistics &stats) {
+    SYNCMON_STATS_LOG_FLOAT(sisPol1Sb1Voltage, "SIS_VOLTAGE Po=1 Sb=1", samples, stats)
+}
+
+float ColdCartImplBase::statsSisPol1Sb2Voltage(int samples, FEMonitorStatistics &stats) {
+    SYNCMON_STATS_LOG_FLOAT(sisPol1Sb2Voltage, "SIS_VOLTAGE Po=1 Sb=2", samples, stats)
+}
+
+float ColdCartImplBase::statsSisPol0Sb1Current(int samples, FEMonitorStatistics &stats) {
+    SYNCMON_STATS_LOG_FLOAT(sisPol0Sb1Current, "SIS_CURRENT Po=0 Sb=1", samples, stats)
+}
+
+float ColdCartImplBase::statsSisPol0Sb2Current(int samples, FEMonitorStatistics &stats) {
+    SYNCMON_STATS_LOG_FLOAT(sisPol0Sb2Current, "SIS_CURRENT Po=0 Sb=2", samples, stats)
+}
+
+float ColdCartImplBase::statsSisPol1Sb1Current(int samples, FEMonitorStatistics &stats) {
+    SYNCMON_STATS_LOG_FLOAT(sisPol1Sb1Current, "SIS_CURRENT Po=1 Sb=1", samples, stats)
+}
+
+float ColdCartImplBase::statsSisPol1Sb2Current(int samples, FEMonitorStatistics &stats) {
+    SYNCMON_STATS_LOG_FLOAT(sisPol1Sb2Current, "SIS_CURRENT Po=1 Sb=2", samples, stats)
+}
+
 bool ColdCartImplBase::sisPol0Sb1OpenLoop() {
     SYNCMON_LOG_BOOL(sisPol0Sb1OpenLoop, "SIS_OPEN_LOOP Po=0 Sb=1")
 }
@@ -539,6 +572,63 @@ bool ColdCartImplBase::lnaLedPol1Enable() {
     SYNCMON_LOG_BOOL(lnaLedPol1Enable, "LNA_LED_ENABLE Po=1")
 }
     
+void ColdCartImplBase::monitorStatusBatch(bool hasSIS, bool hasSb2, bool hasLED) {
+    AmbRelativeAddr RCAs[10];
+    AmbMonitorResult_t results[10];
+    unsigned count = 0;
+    if (hasSIS) {
+        RCAs[count++] = sisPol0Sb1OpenLoop_RCA;
+        RCAs[count++] = sisPol1Sb1OpenLoop_RCA;
+        if (hasSb2) {
+            RCAs[count++] = sisPol0Sb2OpenLoop_RCA;
+            RCAs[count++] = sisPol1Sb2OpenLoop_RCA;
+        }
+    }
+    RCAs[count++] = lnaPol0Sb1Enable_RCA;
+    RCAs[count++] = lnaPol1Sb1Enable_RCA;
+    if (hasSb2) {
+        RCAs[count++] = lnaPol0Sb2Enable_RCA;
+        RCAs[count++] = lnaPol1Sb2Enable_RCA;
+    }
+    if (hasLED) {
+        RCAs[count++] = lnaLedPol0Enable_RCA;
+        RCAs[count++] = lnaLedPol1Enable_RCA;
+    }
+    syncMonitorBatch(count, RCAs, results);
+
+    // unpack in the same order:
+    sisPol0Sb1OpenLoop_value = sisPol1Sb1OpenLoop_value = sisPol0Sb2OpenLoop_value = sisPol1Sb2OpenLoop_value = false;
+    lnaPol0Sb2Enable_value = lnaPol1Sb2Enable_value = lnaLedPol0Enable_value = lnaLedPol1Enable_value = false;
+    const AmbMonitorResult_t *result = results;
+    if (hasSIS) {
+        BATCHMON_LOG_BOOL(sisPol0Sb1OpenLoop, *result, sisPol0Sb1OpenLoop_value, "SIS_OPEN_LOOP Po=0 Sb=1")
+        ++result;
+        BATCHMON_LOG_BOOL(sisPol1Sb1OpenLoop, *result, sisPol1Sb1OpenLoop_value, "SIS_OPEN_LOOP Po=1 Sb=1")
+        ++result;
+        if (hasSb2) {
+            BATCHMON_LOG_BOOL(sisPol0Sb2OpenLoop, *result, sisPol0Sb2OpenLoop_value, "SIS_OPEN_LOOP Po=0 Sb=2")
+            ++result;
+            BATCHMON_LOG_BOOL(sisPol1Sb2OpenLoop, *result, sisPol1Sb2OpenLoop_value, "SIS_OPEN_LOOP Po=1 Sb=2")
+            ++result;
+        }
+    }
+    BATCHMON_LOG_BOOL(lnaPol0Sb1Enable, *result, lnaPol0Sb1Enable_value, "LNA_ENABLE Po=0 Sb=1")
+    ++result;
+    BATCHMON_LOG_BOOL(lnaPol1Sb1Enable, *result, lnaPol1Sb1Enable_value, "LNA_ENABLE Po=1 Sb=1")
+    ++result;
+    if (hasSb2) {
+        BATCHMON_LOG_BOOL(lnaPol0Sb2Enable, *result, lnaPol0Sb2Enable_value, "LNA_ENABLE Po=0 Sb=2")
+        ++result;
+        BATCHMON_LOG_BOOL(lnaPol1Sb2Enable, *result, lnaPol1Sb2Enable_value, "LNA_ENABLE Po=1 Sb=2")
+        ++result;
+    }
+    if (hasLED) {
+        BATCHMON_LOG_BOOL(lnaLedPol0Enable, *result, lnaLedPol0Enable_value, "LNA_LED_ENABLE Po=0")
+        ++result;
+        BATCHMON_LOG_BOOL(lnaLedPol1Enable, *result, lnaLedPol1Enable_value, "LNA_LED_ENABLE Po=1")
+    }
+}
+
 float ColdCartImplBase::sisHeaterPol0Current() {
     SYNCMON_LOG_FLOAT(sisHeaterPol0Current, "SIS_HEATER_CURRENT Po=0")
 }
@@ -58,6 +58,17 @@ public:
     virtual float avgSisPol1Sb1Current(int average = 8);
     virtual float avgSisPol1Sb2Current(int average = 8);
 
+    virtual float statsSisPol0Sb1Voltage(int samples, FEMonitorStatistics &stats);
+    virtual float statsSisPol0Sb2Voltage(int samples, FEMonitorStatistics &stats);
+    virtual float statsSisPol1Sb1Voltage(int samples, FEMonitorStatistics &stats);
+    virtual float statsSisPol1Sb2Voltage(int samples, FEMonitorStatistics &stats);
+
+    virtual float statsSisPol0Sb1Current(int samples, FEMonitorStatistics &stats);
+    virtual float statsSisPol0Sb2Current(int samples, FEMonitorStatistics &stats);
+    virtual float statsSisPol1Sb1Current(int samples, FEMonitorStatistics &stats);
+    virtual float statsSisPol1Sb2Current(int samples, FEMonitorStatistics &stats);
+    ///< read samples readings in one batch, fill in their statistics, and return the mean.
+
     virtual bool sisPol0Sb1OpenLoop();
     virtual bool sisPol0Sb2OpenLoop();
     virtual bool sisPol1Sb1OpenLoop();
@@ -178,11 +189,18 @@ public:
 
 protected:
     virtual void monitorAction(Time *timestamp_p) = 0;
+
+    void monitorStatusBatch(bool hasSIS, bool hasSb2, bool hasLED);
+    ///< monitor the SIS open loop, LNA enable, and LNA LED enable bits using a single batch monitor request.
+    ///< Points which the cartridge doesn't have are set false without monitoring.
+
     // monitor registry and logging:
     Time lastMonitorTime;
     int monitorPhase;
 
     enum MonitorControlOffset {
+        POL1_OFFSET             = 0x0400,
+        SB2_OFFSET              = 0x0080,
         CARTRIDGE_TEMP          = 0x0880,
         SIS_VOLTAGE             = 0x0008,
         SIS_CURRENT             = 0x0010,
@@ -51,9 +51,10 @@ CompressorImplBase::CompressorImplBase(const std::string &name)
     getSWRevisionLevel_value(),
     getTimeSinceLastPowerOn_value(0),
     getTimeSinceLastPowerOff_value(0),
-    lastMonitorTime(0),
     monitorPhase(0)
 {
+    // monitorAction() every 10 s:
+    setMonitorRate(10000, 0, FEMonitorScheduler::PRIORITY_LOW);
 }
 
 void CompressorImplBase::initialize(unsigned long channel, unsigned long nodeAddress) {
@@ -179,16 +180,6 @@ void CompressorImplBase::monitorAction(Time *timestamp_p) {
     if (!timestamp_p)
         return;
 
-    // constant factor to convert 100 ns ticks to ms:
-    static const Time milliseconds = 10000;
-    static const Time monitorInterval = 10000 * milliseconds;
-    bool doMonitor = false;
-
-    if (lastMonitorTime == 0 || (*timestamp_p - lastMonitorTime >= monitorInterval)) {
-        lastMonitorTime = *timestamp_p;
-        doMonitor = true;
-    }
-
     static bool monitorOnce(true);
     if (monitorOnce) {
         monitorOnce = false;
@@ -196,27 +187,25 @@ void CompressorImplBase::monitorAction(Time *timestamp_p) {
         getSWRevisionLevel_value = getSWRevisionLevel();
     }
 
-    if (doMonitor) {
-        LOG(LM_TRACE) << "CompressorImplBase::monitorAction" << endl;
-        getTemp1_value = getTemp1();
-        getTemp2_value = getTemp2();
-        getTemp3_value = getTemp3();
-        getTemp4_value = getTemp4();
-        getReturnLinePressure_value = getReturnLinePressure();
-        getAuxTransducer_value = getAuxTransducer();
-        getSupplyPressure_value = getSupplyPressure();
-        getPressureAlarm_value = getPressureAlarm();
-        getTempAlarm_value = getTempAlarm();
-        getDriveIndicator_value = getDriveIndicator();
-        getICCUStatusError_value = getICCUStatusError();
-        getICCUCableError_value = getICCUCableError();
-        getFETIMStatusError_value = getFETIMStatusError();
-        getFETIMCableError_value = getFETIMCableError();
-        getInterlockOverride_value = getInterlockOverride();
-        getFaultStatusError_value = getFaultStatusError();
-        getTimeSinceLastPowerOn_value = getTimeSinceLastPowerOn();
-        getTimeSinceLastPowerOff_value = getTimeSinceLastPowerOff();
-    }
+    LOG(LM_TRACE) << "CompressorImplBase::monitorAction" << endl;
+    getTemp1_value = getTemp1();
+    getTemp2_value = getTemp2();
+    getTemp3_value = getTemp3();
+    getTemp4_value = getTemp4();
+    getReturnLinePressure_value = getReturnLinePressure();
+    getAuxTransducer_value = getAuxTransducer();
+    getSupplyPressure_value = getSupplyPressure();
+    getPressureAlarm_value = getPressureAlarm();
+    getTempAlarm_value = getTempAlarm();
+    getDriveIndicator_value = getDriveIndicator();
+    getICCUStatusError_value = getICCUStatusError();
+    getICCUCableError_value = getICCUCableError();
+    getFETIMStatusError_value = getFETIMStatusError();
+    getFETIMCableError_value = getFETIMCableError();
+    getInterlockOverride_value = getInterlockOverride();
+    getFaultStatusError_value = getFaultStatusError();
+    getTimeSinceLastPowerOn_value = getTimeSinceLastPowerOn();
+    getTimeSinceLastPowerOff_value = getTimeSinceLastPowerOff();
 }
 
 
@@ -136,7 +136,6 @@ private:
     // forbid copy constructor:
     CompressorImplBase(const CompressorImplBase &other);
 
-    Time lastMonitorTime;
     int monitorPhase;
 };
 
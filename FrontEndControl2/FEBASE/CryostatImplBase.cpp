@@ -84,6 +84,9 @@ CryostatImplBase::CryostatImplBase(const std::string &name)
     lastMonitorTime(0),
     monitorPhase(0)
 {
+    // monitorAction() every 50 ms:
+    setMonitorRate(50, 0, FEMonitorScheduler::PRIORITY_NORMAL);
+
     baseRCA = 0xC000;    
     cryostatTemperature0_RCA    = baseRCA + CRYOSTAT_TEMP;
     cryostatTemperature1_RCA    = baseRCA + CRYOSTAT_TEMP + 0x04;
@@ -114,29 +117,45 @@ CryostatImplBase::CryostatImplBase(const std::string &name)
 
     // Add all the analog monitor points to the registry:
     
-    addMon(&cryostatTemperature0_value, &CryostatImplBase::cryostatTemperature0);
-    addMon(&cryostatTemperature1_value, &CryostatImplBase::cryostatTemperature1);
-    addMon(&cryostatTemperature2_value, &CryostatImplBase::cryostatTemperature2);
-    addMon(&cryostatTemperature3_value, &CryostatImplBase::cryostatTemperature3);
-    addMon(&cryostatTemperature4_value, &CryostatImplBase::cryostatTemperature4);
-    addMon(&cryostatTemperature5_value, &CryostatImplBase::cryostatTemperature5);
-    addMon(&cryostatTemperature6_value, &CryostatImplBase::cryostatTemperature6);
-    addMon(&cryostatTemperature7_value, &CryostatImplBase::cryostatTemperature7);
-    addMon(&cryostatTemperature8_value, &CryostatImplBase::cryostatTemperature8);
-    addMon(&cryostatTemperature9_value, &CryostatImplBase::cryostatTemperature9);
-    addMon(&cryostatTemperature10_value, &CryostatImplBase::cryostatTemperature10);
-    addMon(&cryostatTemperature11_value, &CryostatImplBase::cryostatTemperature11);
-    addMon(&cryostatTemperature12_value, &CryostatImplBase::cryostatTemperature12);
-    addMon(&vacuumCryostatPressure_value, &CryostatImplBase::vacuumCryostatPressure);
-    addMon(&vacuumPortPressure_value, &CryostatImplBase::vacuumPortPressure);
-    addMon(&supplyCurrent230V_value, &CryostatImplBase::supplyCurrent230V);
-
-    nextMon = monitorRegistry.begin();
+    addMon(&cryostatTemperature0_value, &CryostatImplBase::cryostatTemperature0, "cryostatTemperature0");
+    addMon(&cryostatTemperature1_value, &CryostatImplBase::cryostatTemperature1, "cryostatTemperature1");
+    addMon(&cryostatTemperature2_value, &CryostatImplBase::cryostatTemperature2, "cryostatTemperature2");
+    addMon(&cryostatTemperature3_value, &CryostatImplBase::cryostatTemperature3, "cryostatTemperature3");
+    addMon(&cryostatTemperature4_value, &CryostatImplBase::cryostatTemperature4, "cryostatTemperature4");
+    addMon(&cryostatTemperature5_value, &CryostatImplBase::cryostatTemperature5, "cryostatTemperature5");
+    addMon(&cryostatTemperature6_value, &CryostatImplBase::cryostatTemperature6, "cryostatTemperature6");
+    addMon(&cryostatTemperature7_value, &CryostatImplBase::cryostatTemperature7, "cryostatTemperature7");
+    addMon(&cryostatTemperature8_value, &CryostatImplBase::cryostatTemperature8, "cryostatTemperature8");
+    addMon(&cryostatTemperature9_value, &CryostatImplBase::cryostatTemperature9, "cryostatTemperature9");
+    addMon(&cryostatTemperature10_value, &CryostatImplBase::cryostatTemperature10, "cryostatTemperature10");
+    addMon(&cryostatTemperature11_value, &CryostatImplBase::cryostatTemperature11, "cryostatTemperature11");
+    addMon(&cryostatTemperature12_value, &CryostatImplBase::cryostatTemperature12, "cryostatTemperature12");
+    addMon(&vacuumCryostatPressure_value, &CryostatImplBase::vacuumCryostatPressure, "vacuumCryostatPressure");
+    addMon(&vacuumPortPressure_value, &CryostatImplBase::vacuumPortPressure, "vacuumPortPressure");
+    addMon(&supplyCurrent230V_value, &CryostatImplBase::supplyCurrent230V, "supplyCurrent230V");
+
+    // Cryostat temperatures drift slowly except when cooling down or warming up.  Poll them between 1 and 10 s:
+    setMonRate(&cryostatTemperature0_value, 1000, 10000, 0.1);
+    setMonRate(&cryostatTemperature1_value, 1000, 10000, 0.1);
+    setMonRate(&cryostatTemperature2_value, 1000, 10000, 0.1);
+    setMonRate(&cryostatTemperature3_value, 1000, 10000, 0.1);
+    setMonRate(&cryostatTemperature4_value, 1000, 10000, 0.1);
+    setMonRate(&cryostatTemperature5_value, 1000, 10000, 0.1);
+    setMonRate(&cryostatTemperature6_value, 1000, 10000, 0.1);
+    setMonRate(&cryostatTemperature7_value, 1000, 10000, 0.1);
+    setMonRate(&cryostatTemperature8_value, 1000, 10000, 0.1);
+    setMonRate(&cryostatTemperature9_value, 1000, 10000, 0.1);
+    setMonRate(&cryostatTemperature10_value, 1000, 10000, 0.1);
+    setMonRate(&cryostatTemperature11_value, 1000, 10000, 0.1);
+    setMonRate(&cryostatTemperature12_value, 1000, 10000, 0.1);
+
+    nextMon = 0;
 }
 
 void CryostatImplBase::initialize(unsigned long channel, unsigned long nodeAddress) {
     m_channel = channel;
     m_nodeAddress = nodeAddress;
+    initializeSubsystemBreaker(baseRCA);
 }
 
 void CryostatImplBase::shutdown() {
@@ -144,8 +163,7 @@ void CryostatImplBase::shutdown() {
 
 FEMC_ERROR CryostatImplBase::CryostatMonitorTempsensor(AmbRelativeAddr RCA, float &target) {
     FEMC_ERROR ret(FEMC_NO_ERROR);
-    sem_t synchLock;
-    sem_init(&synchLock, 0, 0);
+    sem_t &synchLock(*ambThreadSynchLock());
     ret = syncMonitor(RCA, target, synchLock);
     // if AMB error, quit without retrying:
     if (ret == FEMC_AMB_ERROR)
@@ -155,7 +173,6 @@ FEMC_ERROR CryostatImplBase::CryostatMonitorTempsensor(AmbRelativeAddr RCA, floa
         ret = FEMC_NO_ERROR; // Proceed to 2nd measurement.
     SLEEP(25);
     syncMonitor(RCA, target, synchLock);
-    sem_destroy(&synchLock);
     return ret;
 }
 
@@ -308,52 +325,61 @@ void CryostatImplBase::setTVOCoefficient(unsigned char se, unsigned char co, flo
     SYNCCMD2_LOG_FLOAT(setTVOCoefficient_RCA + se * 0x0008 + co, val, "CRYO_SET_TVO_COEFFICIENT")
 }
 
+void CryostatImplBase::monitorStatusBatch() {
+    // The backing pump, gate valve, and vacuum gauge are always monitored:
+    AmbRelativeAddr RCAs[4] = { backingPumpEnable_RCA, gateValveState_RCA, vacuumGaugeEnable_RCA, vacuumGaugeErrorState_RCA };
+    AmbMonitorResult_t results[4];
+    syncMonitorBatch(4, RCAs, results);
+    BATCHMON_LOG_BOOL(backingPumpEnable, results[0], backingPumpEnable_value, "CRYO_BACKING_PUMP_ENABLE")
+    BATCHMON_LOG_BYTE(gateValveState, results[1], gateValveState_value, "CRYO_GATE_VALVE_STATE")
+    BATCHMON_LOG_BOOL(vacuumGaugeEnable, results[2], vacuumGaugeEnable_value, "CRYO_VACUUM_GAUGE_ENABLE")
+    BATCHMON_LOG_BOOL(vacuumGaugeErrorState, results[3], vacuumGaugeErrorState_value, "CRYO_VACUUM_GAUGE_ERROR_STATE")
+
+    // The turbo pump and solenoid valve are only monitored when the backing pump is on,
+    // otherwise report them as the individual monitor functions do:
+    if (!backingPumpEnable_value) {
+        turboPumpEnable_value = turboPumpErrorState_value = turboPumpHighSpeed_value = false;
+        turboPumpEnable_status = turboPumpErrorState_status = turboPumpHighSpeed_status = 0;
+        solenoidValveState_status = 0;
+        return;
+    }
+    RCAs[0] = turboPumpEnable_RCA;
+    RCAs[1] = turboPumpErrorState_RCA;
+    RCAs[2] = turboPumpHighSpeed_RCA;
+    RCAs[3] = solenoidValveState_RCA;
+    syncMonitorBatch(4, RCAs, results);
+    BATCHMON_LOG_BOOL(turboPumpEnable, results[0], turboPumpEnable_value, "CRYO_TURBO_PUMP_ENABLE")
+    BATCHMON_LOG_BOOL(turboPumpErrorState, results[1], turboPumpErrorState_value, "CRYO_TURBO_PUMP_ERROR_STATE")
+    BATCHMON_LOG_BOOL(turboPumpHighSpeed, results[2], turboPumpHighSpeed_value, "CRYO_TURBO_PUMP_HIGH_SPEED")
+    BATCHMON_LOG_BYTE(solenoidValveState, results[3], solenoidValveState_value, "CRYO_SOLENOID_VALVE_STATE")
+}
+
 void CryostatImplBase::monitorAction(Time *timestamp_p) {
     
     if (!timestamp_p)
         return;
 
-    // constant factor to convert 100 ns ticks to ms:
-    static const Time milliseconds = 10000;
-    static const Time monitorInterval = 50 * milliseconds;
-
-    bool doMonitor = false;
-
     if (lastMonitorTime == 0 && logMonitors_m)
         logMon(true);
     
-    if (lastMonitorTime == 0 || (*timestamp_p - lastMonitorTime >= monitorInterval)) {
-        lastMonitorTime = *timestamp_p;
-        doMonitor = true;
-    }
-
-    if (doMonitor) {
-        switch (monitorPhase) {
-            case 0:
-                if (!executeNextMon())
-                    monitorPhase = 1;
-                break;
-            case 1:
-                backingPumpEnable_value = backingPumpEnable();
-                turboPumpEnable_value = turboPumpEnable();
-                turboPumpErrorState_value = turboPumpErrorState();
-                turboPumpHighSpeed_value = turboPumpHighSpeed();
-                monitorPhase = 2;
-            case 2:
-                gateValveState_value = gateValveState();
-                solenoidValveState_value = solenoidValveState();
-                vacuumGaugeEnable_value = vacuumGaugeEnable();
-                vacuumGaugeErrorState_value = vacuumGaugeErrorState();
-                monitorPhase = 3;
-                break;
-            case 3:
-            default:
-                if (logMonitors_m)
-                    logMon();
-                monitorPhase = 0;
-                break;
-        };
-    }
+    lastMonitorTime = *timestamp_p;
+
+    switch (monitorPhase) {
+        case 0:
+            if (!executeNextMon())
+                monitorPhase = 1;
+            break;
+        case 1:
+            monitorStatusBatch();
+            monitorPhase = 2;
+            break;
+        case 2:
+        default:
+            if (logMonitors_m)
+                logMon();
+            monitorPhase = 0;
+            break;
+    };
 }
 
 DEFINE_MONITORS_REGISTRY(CryostatImplBase)
@@ -83,6 +83,9 @@ protected:
     
     virtual void monitorAction(Time *timestamp_p);
     
+    void monitorStatusBatch();
+    ///< monitor the pump, valve, and vacuum gauge states using batch monitor requests.
+    
     enum MonitorControlOffset {
         CRYOSTAT_TEMP                   = 0x0000,
         BACKING_PUMP_ENABLE             = 0x0034,
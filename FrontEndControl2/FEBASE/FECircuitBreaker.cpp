@@ -0,0 +1,173 @@
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2007
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ *----------------------------------------------------------------------
+ */
+
+#include "FECircuitBreaker.h"
+#include <algorithm>
+#include <stdio.h>
+using namespace std;
+using namespace std::chrono;
+
+unsigned FECircuitBreaker::threshold_m = 5;
+unsigned long FECircuitBreaker::minBackoff_m = 250;
+unsigned long FECircuitBreaker::maxBackoff_m = 16000;
+std::vector<FECircuitBreaker *> FECircuitBreaker::breakers_m;
+pthread_mutex_t FECircuitBreaker::breakersMutex_m = PTHREAD_MUTEX_INITIALIZER;
+
+FECircuitBreaker::FECircuitBreaker(const std::string &name)
+  : name_m(name)
+{
+    pthread_mutex_init(&mutex_m, NULL);
+    stats_m.backoff = minBackoff_m;
+    pthread_mutex_lock(&breakersMutex_m);
+    breakers_m.push_back(this);
+    pthread_mutex_unlock(&breakersMutex_m);
+}
+
+FECircuitBreaker::~FECircuitBreaker() {
+    pthread_mutex_lock(&breakersMutex_m);
+    breakers_m.erase(remove(breakers_m.begin(), breakers_m.end(), this), breakers_m.end());
+    pthread_mutex_unlock(&breakersMutex_m);
+    pthread_mutex_destroy(&mutex_m);
+}
+
+void FECircuitBreaker::configure(unsigned threshold, unsigned long minBackoff, unsigned long maxBackoff) {
+    threshold_m = threshold;
+    minBackoff_m = (minBackoff) ? minBackoff : 1;
+    maxBackoff_m = (maxBackoff > minBackoff_m) ? maxBackoff : minBackoff_m;
+}
+
+bool FECircuitBreaker::allow() {
+    pthread_mutex_lock(&mutex_m);
+    bool ret = true;
+    if (stats_m.state != CLOSED) {
+        Clock::time_point now = Clock::now();
+        // when open, one probe after the backoff.  When half open, another if the first was never answered:
+        if (now >= nextProbe_m) {
+            stats_m.state = HALF_OPEN;
+            nextProbe_m = now + milliseconds(stats_m.backoff);
+            ++stats_m.probes;
+        } else {
+            ++stats_m.failedFast;
+            ret = false;
+        }
+    }
+    pthread_mutex_unlock(&mutex_m);
+    return ret;
+}
+
+bool FECircuitBreaker::record(AmbErrorCode_t status) {
+    pthread_mutex_lock(&mutex_m);
+    bool changed = false;
+    if (status == AMBERR_NOERR) {
+        changed = (stats_m.state != CLOSED);
+        stats_m.state = CLOSED;
+        stats_m.consecutiveTimeouts = 0;
+        stats_m.backoff = minBackoff_m;
+
+    } else if (status == AMBERR_TIMEOUT) {
+        ++stats_m.consecutiveTimeouts;
+        if (stats_m.state == HALF_OPEN) {
+            // the probe failed.  Back off further:
+            stats_m.backoff = min(stats_m.backoff * 2, maxBackoff_m);
+            open(Clock::now());
+        } else if (stats_m.state == CLOSED && threshold_m && stats_m.consecutiveTimeouts >= threshold_m) {
+            stats_m.backoff = minBackoff_m;
+            open(Clock::now());
+            ++stats_m.opens;
+            changed = true;
+        }
+
+    } else if (stats_m.state == HALF_OPEN) {
+        // the probe didn't reach the device.  Let another through straight away:
+        stats_m.state = OPEN;
+        nextProbe_m = Clock::now();
+    }
+    pthread_mutex_unlock(&mutex_m);
+    return changed;
+}
+
+void FECircuitBreaker::reset() {
+    pthread_mutex_lock(&mutex_m);
+    stats_m = FECircuitBreakerStats();
+    stats_m.backoff = minBackoff_m;
+    pthread_mutex_unlock(&mutex_m);
+}
+
+FECircuitBreaker::State FECircuitBreaker::getState() const {
+    pthread_mutex_lock(&mutex_m);
+    State ret = (State) stats_m.state;
+    pthread_mutex_unlock(&mutex_m);
+    return ret;
+}
+
+void FECircuitBreaker::getStats(FECircuitBreakerStats &target) const {
+    pthread_mutex_lock(&mutex_m);
+    target = stats_m;
+    pthread_mutex_unlock(&mutex_m);
+}
+
+std::string FECircuitBreaker::stateText(int state) {
+    switch (state) {
+        case CLOSED:
+            return "closed";
+        case OPEN:
+            return "open";
+        case HALF_OPEN:
+            return "half-open";
+        default:
+            return "unknown";
+    }
+}
+
+void FECircuitBreaker::getReport(std::string &target) {
+    target = "name\tstate\ttimeouts\topens\tprobes\tfailed fast\tbackoff ms\n";
+    char line[100];
+    pthread_mutex_lock(&breakersMutex_m);
+    for (unsigned index = 0; index < breakers_m.size(); ++index) {
+        FECircuitBreakerStats stats;
+        breakers_m[index] -> getStats(stats);
+        sprintf(line, "\t%s\t%u\t%lu\t%lu\t%lu\t%lu\n", stateText(stats.state).c_str(), stats.consecutiveTimeouts,
+                stats.opens, stats.probes, stats.failedFast, stats.backoff);
+        target += breakers_m[index] -> getName() + line;
+    }
+    pthread_mutex_unlock(&breakersMutex_m);
+}
+
+bool FECircuitBreaker::findStats(const std::string &name, FECircuitBreakerStats &target) {
+    bool found = false;
+    pthread_mutex_lock(&breakersMutex_m);
+    for (unsigned index = 0; index < breakers_m.size() && !found; ++index) {
+        if (breakers_m[index] -> getName() == name) {
+            breakers_m[index] -> getStats(target);
+            found = true;
+        }
+    }
+    pthread_mutex_unlock(&breakersMutex_m);
+    return found;
+}
+
+void FECircuitBreaker::open(Clock::time_point now) {
+    stats_m.state = OPEN;
+    nextProbe_m = now + milliseconds(stats_m.backoff);
+}
@@ -0,0 +1,117 @@
+#ifndef FECIRCUITBREAKER_H_
+#define FECIRCUITBREAKER_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2007
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+
+/************************************************************************
+ * Circuit breaker which stops sending to a device which has stopped answering.
+ *
+ *----------------------------------------------------------------------
+ */
+
+#include <FrontEndAMB/ambDefs.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+/// Counters kept for each FECircuitBreaker.
+struct FECircuitBreakerStats {
+    int state;                      ///< FECircuitBreaker::State.
+    unsigned consecutiveTimeouts;   ///< timeouts since the last success.
+    unsigned long opens;            ///< times it has opened.
+    unsigned long probes;           ///< transactions let through to test whether the device is back.
+    unsigned long failedFast;       ///< transactions refused while open.
+    unsigned long backoff;          ///< current time between probes, ms.
+
+    FECircuitBreakerStats()
+      : state(0), consecutiveTimeouts(0), opens(0), probes(0), failedFast(0), backoff(0)
+      {}
+};
+
+/// FECircuitBreaker opens after threshold consecutive AMBERR_TIMEOUTs.  While open, allow() refuses
+/// transactions so that they fail fast instead of each waiting out the bus timeout.  Once the backoff
+/// has passed it lets one probe transaction through (HALF_OPEN).  A probe which succeeds closes it;
+/// one which times out opens it again with the backoff doubled, up to maxBackoff.
+/// Every breaker is listed so that they can all be reported.  All functions are thread safe.
+class FECircuitBreaker {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    enum State {
+        CLOSED,                     ///< transactions are sent normally.
+        OPEN,                       ///< transactions are refused until the backoff has passed.
+        HALF_OPEN                   ///< one probe is outstanding.
+    };
+
+    FECircuitBreaker(const std::string &name);
+    ~FECircuitBreaker();
+
+    static void configure(unsigned threshold, unsigned long minBackoff, unsigned long maxBackoff);
+    ///< set for all breakers the consecutive timeouts which open one and the range of backoff, ms.
+    ///< threshold = 0 disables them all.
+
+    bool allow();
+    ///< true if a transaction may be sent now.  Counts it as a probe or as failed fast.
+
+    bool record(AmbErrorCode_t status);
+    ///< count the result of a transaction which was sent.  Returns true if that opened or closed the breaker.
+
+    void reset();
+    ///< close and zero the counters.
+
+    State getState() const;
+    void getStats(FECircuitBreakerStats &target) const;
+
+    const std::string &getName() const
+      { return name_m; }
+
+    static std::string stateText(int state);
+    ///< "closed", "open", or "half-open".
+
+    static void getReport(std::string &target);
+    ///< a text table of the state and counters of every breaker, one per line.
+
+    static bool findStats(const std::string &name, FECircuitBreakerStats &target);
+    ///< get the counters of the breaker with the given name.  Returns false if there is none.
+
+    static unsigned threshold_m;            ///< consecutive timeouts which open a breaker.  Default 5.
+    static unsigned long minBackoff_m;      ///< first backoff after opening, ms.  Default 250.
+    static unsigned long maxBackoff_m;      ///< longest backoff, ms.  Default 16000.
+
+private:
+    // forbid copy construct, assignment:
+    FECircuitBreaker(const FECircuitBreaker &other);
+    FECircuitBreaker &operator =(const FECircuitBreaker &other);
+
+    void open(Clock::time_point now);
+    ///< open and schedule the next probe.  Called with the mutex locked.
+
+    std::string name_m;             ///< device or subsystem name for the report.
+    FECircuitBreakerStats stats_m;  ///< state and counters.
+    Clock::time_point nextProbe_m;  ///< when open, the time the next probe may be sent.
+    mutable pthread_mutex_t mutex_m;///< protects the above.
+
+    static std::vector<FECircuitBreaker *> breakers_m;  ///< every breaker which exists.
+    static pthread_mutex_t breakersMutex_m;             ///< protects breakers_m.
+};
+
+#endif /*FECIRCUITBREAKER_H_*/
@@ -1,12 +1,16 @@
 #include "FEHardwareDevice.h"
+#include "LOGGER/feAddressMeta.h"
 #include "logger.h"
 #include "setTimeStamp.h"
+#include <stdint.h>
 #include <string>
 #include <iomanip>
+#include <map>
 using namespace std;
 
 bool FEHardwareDevice::logMonitors_m(false);
 bool FEHardwareDevice::logAmbErrors_m(true);
+unsigned long FEHardwareDevice::monitorDeadline_m(500000);
 FEHardwareDevice::LogInterface FEHardwareDevice::defaultLogger_m;
 FEHardwareDevice::LogInterface *FEHardwareDevice::logger_mp(NULL);
 
@@ -15,15 +19,23 @@ FEHardwareDevice::FEHardwareDevice(const std::string &name)
     ESN_m(),
     running_m(false),
     minimalMonitoring_m(false),
-    stopped_m(true),
     paused_m(false),
     exceededErrorCount_m(false),
     errorCount_m(0),
-    maxErrorCount_m(0)
-    {} 
+    maxErrorCount_m(0),
+    commandMismatchCount_m(0),
+    breaker_m(name),
+    subsystemBreaker_mp(NULL),
+    monitorInterval_m(FEMonitorScheduler::TICK_MS),
+    minimalMonitorInterval_m(FEMonitorScheduler::TICK_MS),
+    monitorPriority_m(FEMonitorScheduler::PRIORITY_NORMAL)
+{
+    pthread_mutex_init(&commandMutex_m, NULL);
+} 
     
 FEHardwareDevice::~FEHardwareDevice() {
     stopMonitor();
+    pthread_mutex_destroy(&commandMutex_m);
 }    
 
 // monitor thread operations:    
@@ -31,25 +43,19 @@ FEHardwareDevice::~FEHardwareDevice() {
 void FEHardwareDevice::startMonitor() {
     if (running_m)
         return;
-    stopped_m = false;
-    LOG(LM_INFO) << "FEHardwareDevice(" << name_m << "): starting monitor thread..." << endl;
-    pthread_create(&thread_m, NULL, reinterpret_cast<void*(*)(void*)>(monitorThread), this); 
-    pthread_detach(thread_m);
+    LOG(LM_INFO) << "FEHardwareDevice(" << name_m << "): starting monitoring every " << monitorInterval_m << " ms..." << endl;
     running_m = true;
     resetErrorCount();
+    FEMonitorScheduler::getInstance().add(*this);
 }
 
 void FEHardwareDevice::stopMonitor() {
     if (!running_m)
         return;
-    LOG(LM_INFO) << "FEHardwareDevice(" << name_m << "): stopping monitor thread..." << endl;
+    LOG(LM_INFO) << "FEHardwareDevice(" << name_m << "): stopping monitoring..." << endl;
     running_m = false;
-    int retry = 250;
-    while (!stopped_m && retry--)
-        SLEEP(100);
-    int elapsed = (250 - retry) / 10;
-    if (!stopped_m)
-        LOG(LM_INFO) << "FEHardwareDevice(" << name_m << "): NOT stopped after " << elapsed << " seconds." << endl;
+    FEMonitorScheduler::getInstance().remove(*this);
+    logMonitorStats();
 }
 
 void FEHardwareDevice::pauseMonitor(bool pause, const char *reason) {
@@ -57,8 +63,11 @@ void FEHardwareDevice::pauseMonitor(bool pause, const char *reason) {
         paused_m = pause;
         LOG(LM_INFO) << "FEHardwareDevice(" << name_m << "): " << ((paused_m) ? "paused monitoring. " : "resumed monitoring. ")
                      << (reason ? reason : "") << endl; 
-        if (!paused_m)
+        if (!paused_m) {
             resetErrorCount();
+            if (running_m)
+                FEMonitorScheduler::getInstance().hurry(*this);
+        }
     }
 }
 
@@ -67,9 +76,22 @@ void FEHardwareDevice::minimalMonitor(bool minimal, const char *reason) {
         minimalMonitoring_m = minimal;
         LOG(LM_INFO) << "FEHardwareDevice(" << name_m << "): " << ((minimalMonitoring_m) ? "minimal monitoring. " : "normal monitoring. ")
                      << (reason ? reason : "") << endl; 
+        // The interval may have changed:
+        if (running_m)
+            FEMonitorScheduler::getInstance().hurry(*this);
     }
 }
 
+bool FEHardwareDevice::isMinimalMonitoring() const {
+    return minimalMonitoring_m || FEMonitorScheduler::isMinimal();
+}
+
+void FEHardwareDevice::setMonitorRate(unsigned long interval, unsigned long minimalInterval, int priority) {
+    monitorInterval_m = interval;
+    minimalMonitorInterval_m = (minimalInterval) ? minimalInterval : interval;
+    monitorPriority_m = priority;
+}
+
 // logging helpers and operations:
 
 const char *FEHardwareDevice::TransactionText[14] = {
@@ -94,13 +116,12 @@ FEMC_ERROR FEHardwareDevice::syncMonitorThreeByteRevLevel(AmbRelativeAddr RCA, s
     target.erase();
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
     monitor(RCA, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
+    recordBusResult(status);
     if (status == AMBERR_NOERR) {
         postMonitorHook(RCA);
         char buf[20];
@@ -115,13 +136,12 @@ FEMC_ERROR FEHardwareDevice::syncMonitorEightByteESN(AmbRelativeAddr RCA, std::s
     target.erase();
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
     monitor(RCA, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
+    recordBusResult(status);
     if (status == AMBERR_NOERR) {
         postMonitorHook(RCA);
         char buf[20];
@@ -138,35 +158,386 @@ FEMC_ERROR FEHardwareDevice::syncMonitorEightByteESN(AmbRelativeAddr RCA, std::s
         return FEMC_UNPACK_ERROR;
 }
 
+void FEHardwareDevice::syncMonitorBatch(unsigned count, const AmbRelativeAddr *RCAs, AmbMonitorResult_t *results) {
+    if (!count)
+        return;
+    AmbCompletionLatch latch(*ambThreadSynchLock());
+    monitorBatch(count, RCAs, results, &latch);
+    latch.wait();
+}
+
+void FEHardwareDevice::asyncMonitor(AmbRelativeAddr RCA, AsyncMonitorBase &request, AsyncMonitorGroup &group, int retries) {
+    // If the request is still outstanding from an earlier call, let it finish first:
+    if (!request.done_m && request.group_mp)
+        request.group_mp -> wait(request);
+    request.device_mp = this;
+    request.group_mp = &group;
+    request.RCA_m = RCA;
+    request.retries_m = retries;
+    request.status_m = FEMC_NO_ERROR;
+    request.done_m = false;
+    ++group.outstanding_m;
+    sendAsyncMonitor(request);
+}
+
+void FEHardwareDevice::sendAsyncMonitor(AsyncMonitorBase &request) {
+    monitorAsync(request.RCA_m, &request.result_m, AsyncMonitorGroup::completed, &request);
+}
+
 FEMC_ERROR FEHardwareDevice::syncMonitorAverage(AmbRelativeAddr RCA, float &target, int average) {
+    FEMonitorStatistics stats;
+    FEMC_ERROR ret = syncMonitorStatistics(RCA, average, stats);
+    // don't report the mean of the readings before an AMB error as if it were the average:
+    target = (ret == FEMC_AMB_ERROR) ? 0.0 : (float) stats.mean;
+    return ret;
+}
+
+FEMC_ERROR FEHardwareDevice::syncMonitorStatistics(AmbRelativeAddr RCA, int samples, FEMonitorStatistics &target) {
     FEMC_ERROR ret(FEMC_NO_ERROR);
-    sem_t synchLock;
-    sem_init(&synchLock, 0, 0);
-    if (average < 1)
-        average = 1;
-    int count(average);
-    double sum(0.0);
-    float val(0.0);
-    bool done(false);
-    while (!done) {
-        ret = syncMonitor(RCA, val, synchLock);
-        --count;
-        // if AMB error, quit immediately:
-        if (ret == FEMC_AMB_ERROR)
-            done = true;
-        // accumulate sum until requested number of readings done:
+    target.reset();
+    if (samples < 1)
+        samples = 1;
+    // send up to FEMON_MAX_BATCH requests at once and wait for them together:
+    AmbRelativeAddr RCAs[FEMON_MAX_BATCH];
+    AmbMonitorResult_t results[FEMON_MAX_BATCH];
+    for (int index = 0; index < FEMON_MAX_BATCH; ++index)
+        RCAs[index] = RCA;
+    float values[FEMON_MAX_BATCH];
+    FEMC_ERROR decoded[FEMON_MAX_BATCH];
+    int remaining(samples);
+    while (remaining > 0 && ret != FEMC_AMB_ERROR) {
+        int count = (remaining > FEMON_MAX_BATCH) ? FEMON_MAX_BATCH : remaining;
+        syncMonitorBatch(count, RCAs, results);
+        remaining -= count;
+        AmbCodecBatch::unpackFloats(count, results, values, decoded);
+        for (int index = 0; index < count; ++index) {
+            ret = checkBatchFloat(RCA, results[index], values[index], decoded[index]);
+            // if AMB error, quit immediately:
+            if (ret == FEMC_AMB_ERROR)
+                break;
+            target.add(values[index]);
+        }
+    }
+    setThreadMonitorStatus(ret);
+    return ret;
+}
+
+float FEHardwareDevice::syncMonitorTablePoint(AmbRelativeAddr RCA, const FEMonitorDef &def, int &status) {
+    FEMC_ERROR ret(FEMC_NO_ERROR);
+    float value(0.0);
+    switch (def.wireType) {
+        case FEMON_WIRE_BOOL: {
+            bool val(false);
+            ret = syncMonitorWithRetry(RCA, val);
+            value = (val) ? 1.0 : 0.0;
+            break;
+        }
+        case FEMON_WIRE_UCHAR: {
+            unsigned char val(0);
+            ret = syncMonitorWithRetry(RCA, val);
+            value = val;
+            break;
+        }
+        case FEMON_WIRE_USHORT: {
+            unsigned short val(0);
+            ret = syncMonitorWithRetry(RCA, val);
+            value = val;
+            break;
+        }
+        case FEMON_WIRE_FLOAT:
+        default:
+            ret = (def.average > 1) ? syncMonitorAverage(RCA, value, def.average) : syncMonitorWithRetry(RCA, value);
+            break;
+    }
+    return logTablePoint(RCA, def, ret, value, status);
+}
+
+float FEHardwareDevice::unpackTablePoint(AmbRelativeAddr RCA, const FEMonitorDef &def, const AmbMonitorResult_t &result, int &status) {
+    FEMC_ERROR ret(FEMC_NO_ERROR);
+    float value(0.0);
+    switch (def.wireType) {
+        case FEMON_WIRE_BOOL: {
+            bool val(false);
+            ret = unpackBatchResult(RCA, result, val);
+            value = (val) ? 1.0 : 0.0;
+            break;
+        }
+        case FEMON_WIRE_UCHAR: {
+            unsigned char val(0);
+            ret = unpackBatchResult(RCA, result, val);
+            value = val;
+            break;
+        }
+        case FEMON_WIRE_USHORT: {
+            unsigned short val(0);
+            ret = unpackBatchResult(RCA, result, val);
+            value = val;
+            break;
+        }
+        case FEMON_WIRE_FLOAT:
+        default:
+            ret = unpackBatchResult(RCA, result, value);
+            break;
+    }
+    setThreadMonitorStatus(ret);
+    return logTablePoint(RCA, def, ret, value, status);
+}
+
+void FEHardwareDevice::unpackTablePoints(unsigned count, const AmbRelativeAddr *RCAs, const FEMonitorDef *const *defs,
+                                         const AmbMonitorResult_t *results, float *values, int *const *status)
+{
+    // decode every result as a float, then finish the ones which are:
+    FEMC_ERROR decoded[FEMON_MAX_BATCH];
+    AmbCodecBatch::unpackFloats(count, results, values, decoded);
+    for (unsigned index = 0; index < count; ++index) {
+        const FEMonitorDef &def = *defs[index];
+        if (def.wireType == FEMON_WIRE_FLOAT) {
+            FEMC_ERROR ret = checkBatchFloat(RCAs[index], results[index], values[index], decoded[index]);
+            setThreadMonitorStatus(ret);
+            values[index] = logTablePoint(RCAs[index], def, ret, values[index], *status[index]);
+        } else
+            values[index] = unpackTablePoint(RCAs[index], def, results[index], *status[index]);
+    }
+}
+
+FEMC_ERROR FEHardwareDevice::checkBatchFloat(AmbRelativeAddr RCA, const AmbMonitorResult_t &result, float &value, FEMC_ERROR decoded) {
+    FEMC_ERROR ret = checkMonitorResult(RCA, result.status, decoded);
+    if (ret == FEMC_HARDW_RETRY_WARN)
+        ret = syncMonitorWithRetry(RCA, value);
+    return ret;
+}
+
+FEMC_ERROR FEHardwareDevice::checkMonitorResult(AmbRelativeAddr RCA, AmbErrorCode_t status, FEMC_ERROR ret) {
+    recordBusResult(status);
+    if (status == AMBERR_NOERR)
+        postMonitorHook(RCA);
+    else if (status == AMBERR_EXPIRED || status == AMBERR_BREAKER_OPEN) {
+        // dropped unsent because the queue was busy or the device isn't answering.  Not a communication error:
+        return FEMC_AMB_ERROR;
+    } else {
+        ret = FEMC_AMB_ERROR;
+        if (logAmbErrors_m) {
+            LOG(LM_ERROR) << "FEHardwareDevice(0x" << std::uppercase << std::hex << m_nodeAddress << "): AMB error=" << status << " RCA=" << " 0x" << std::uppercase << std::hex << std::setw(6) << std::setfill('0') << RCA << std::endl;
+        }
+    }
+    if (!monitorIgnorableError(ret))
+        ++errorCount_m;   // increment error counter.
+    return ret;
+}
+
+float FEHardwareDevice::logTablePoint(AmbRelativeAddr RCA, const FEMonitorDef &def, FEMC_ERROR ret, float value, int &status) {
+    status = ret;
+    if (ret == FEMC_AMB_ERROR)
+        value = 0.0;
+    if (def.wireType == FEMON_WIRE_FLOAT)
+        getLogger().log(FEMC_LOG_MONITOR, def.logText, RCA, (signed char) status, 0, value);
+    else
+        getLogger().log(FEMC_LOG_MONITOR, def.logText, RCA, (signed char) status, (unsigned long) value, 0.0);
+    return value;
+}
+
+// per-thread status of the last synchronous monitor:
+
+static pthread_key_t threadMonitorStatusKey;
+static pthread_once_t threadMonitorStatusOnce = PTHREAD_ONCE_INIT;
+
+static void createThreadMonitorStatusKey() {
+    pthread_key_create(&threadMonitorStatusKey, NULL);
+}
+
+void FEHardwareDevice::setThreadMonitorStatus(FEMC_ERROR status) {
+    pthread_once(&threadMonitorStatusOnce, createThreadMonitorStatusKey);
+    // stored in the pointer itself, so there is nothing to allocate or free:
+    pthread_setspecific(threadMonitorStatusKey, reinterpret_cast<void *>((intptr_t) status));
+}
+
+FEMC_ERROR FEHardwareDevice::getThreadMonitorStatus() {
+    pthread_once(&threadMonitorStatusOnce, createThreadMonitorStatusKey);
+    return (FEMC_ERROR) (intptr_t) pthread_getspecific(threadMonitorStatusKey);
+}
+
+// commands with deferred readback:
+
+static pthread_key_t threadDeferReadbackKey;
+static pthread_once_t threadDeferReadbackOnce = PTHREAD_ONCE_INIT;
+
+static void createThreadDeferReadbackKey() {
+    pthread_key_create(&threadDeferReadbackKey, NULL);
+}
+
+void FEHardwareDevice::deferCommandReadback(bool defer) {
+    pthread_once(&threadDeferReadbackOnce, createThreadDeferReadbackKey);
+    pthread_setspecific(threadDeferReadbackKey, reinterpret_cast<void *>((intptr_t) defer));
+}
+
+bool FEHardwareDevice::isCommandReadbackDeferred() {
+    pthread_once(&threadDeferReadbackOnce, createThreadDeferReadbackKey);
+    return pthread_getspecific(threadDeferReadbackKey) != NULL;
+}
+
+FEMC_ERROR FEHardwareDevice::sendUnverifiedCommand(AmbRelativeAddr RCA, AmbDataLength_t dataLength, const AmbDataMem_t *data) {
+    // wait for the command itself, so that a caller dwelling between steps dwells after each one is sent:
+    AmbErrorCode_t status(AMBERR_NOERR);
+    sem_t &synchLock(*ambThreadSynchLock());
+    command(RCA, dataLength, data, &synchLock, NULL, &status);
+    sem_wait(&synchLock);
+    recordBusResult(status);
+
+    pthread_mutex_lock(&commandMutex_m);
+    vector<UnverifiedCommand>::iterator it = unverifiedCommands_m.begin();
+    while (it != unverifiedCommands_m.end() && it -> RCA != RCA)
+        ++it;
+    if (it == unverifiedCommands_m.end())
+        it = unverifiedCommands_m.insert(it, UnverifiedCommand());
+    it -> RCA = RCA;
+    it -> dataLength = dataLength;
+    memcpy(it -> data, data, dataLength);
+    pthread_mutex_unlock(&commandMutex_m);
+    return (status == AMBERR_NOERR) ? FEMC_NO_ERROR : FEMC_AMB_ERROR;
+}
+
+void FEHardwareDevice::forgetUnverifiedCommand(AmbRelativeAddr RCA) {
+    pthread_mutex_lock(&commandMutex_m);
+    for (vector<UnverifiedCommand>::iterator it = unverifiedCommands_m.begin(); it != unverifiedCommands_m.end(); ++it) {
+        if (it -> RCA == RCA) {
+            unverifiedCommands_m.erase(it);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&commandMutex_m);
+}
+
+FEMC_ERROR FEHardwareDevice::verifyCommands() {
+    vector<UnverifiedCommand> commands;
+    pthread_mutex_lock(&commandMutex_m);
+    commands.swap(unverifiedCommands_m);
+    pthread_mutex_unlock(&commandMutex_m);
+    if (commands.empty())
+        return FEMC_NO_ERROR;
+
+    // read them all back at once:
+    unsigned count = commands.size();
+    vector<AmbRelativeAddr> RCAs(count);
+    vector<AmbMonitorResult_t> results(count);
+    for (unsigned index = 0; index < count; ++index)
+        RCAs[index] = commands[index].RCA;
+    syncMonitorBatch(count, &RCAs[0], &results[0]);
+
+    FEMC_ERROR ret(FEMC_NO_ERROR);
+    for (unsigned index = 0; index < count; ++index) {
+        const UnverifiedCommand &sent = commands[index];
+        const AmbMonitorResult_t &result = results[index];
+        recordBusResult(result.status);
+        FEMC_ERROR status(FEMC_NO_ERROR);
+        if (result.status != AMBERR_NOERR)
+            status = FEMC_AMB_ERROR;
+        // the readback is the value sent followed by the status byte:
+        else if (result.dataLength < 1)
+            status = FEMC_UNPACK_ERROR;
         else {
-            sum += val;
-            if (count == 0)
-                done = true;
+            status = AmbWire::status(result.data[result.dataLength - 1]);
+            if (status == FEMC_NO_ERROR && (result.dataLength != sent.dataLength + 1 || memcmp(result.data, sent.data, sent.dataLength)))
+                status = FEMC_UNPACK_ERROR;
+        }
+        if (status != FEMC_NO_ERROR) {
+            ++commandMismatchCount_m;
+            ++errorCount_m;
+            if (ret == FEMC_NO_ERROR)
+                ret = status;
+            LOG(LM_ERROR) << "FEHardwareDevice(" << name_m << "): command readback failed status=" << status << " RCA=0x"
+                          << uppercase << hex << setw(6) << setfill('0') << sent.RCA << dec << endl;
         }
     }
-    sem_destroy(&synchLock);
-    // calculate average:
-    target = (float) (sum / (double) average);
     return ret;
 }
 
+// circuit breakers:
+
+void FEHardwareDevice::monitor(AmbRelativeAddr RCA, AmbDataLength_t &dataLength, AmbDataMem_t *data,
+                               sem_t *synchLock, Time *timestamp, AmbErrorCode_t *status)
+{
+    if (breakerAllows()) {
+        AmbDeviceImpl::monitor(RCA, dataLength, data, synchLock, timestamp, status);
+        return;
+    }
+    // fail fast, signaling the caller the same as the bus would:
+    dataLength = 0;
+    if (status)
+        *status = AMBERR_BREAKER_OPEN;
+    if (synchLock)
+        sem_post(synchLock);
+}
+
+void FEHardwareDevice::monitorBatch(unsigned count, const AmbRelativeAddr *RCAs, AmbMonitorResult_t *results,
+                                    AmbCompletionLatch *latch)
+{
+    if (!count || breakerAllows()) {
+        AmbDeviceImpl::monitorBatch(count, RCAs, results, latch);
+        return;
+    }
+    latch -> add(count);
+    for (unsigned index = 0; index < count; ++index) {
+        results[index].dataLength = 0;
+        results[index].status = AMBERR_BREAKER_OPEN;
+        latch -> countDown();
+    }
+}
+
+void FEHardwareDevice::monitorAsync(AmbRelativeAddr RCA, AmbMonitorResult_t *result, AmbCompletionCallback callback,
+                                    void *context)
+{
+    if (breakerAllows()) {
+        AmbDeviceImpl::monitorAsync(RCA, result, callback, context);
+        return;
+    }
+    result -> dataLength = 0;
+    result -> status = AMBERR_BREAKER_OPEN;
+    callback(context);
+}
+
+static std::map<unsigned long long, FECircuitBreaker *> subsystemBreakers;
+static pthread_mutex_t subsystemBreakersMutex = PTHREAD_MUTEX_INITIALIZER;
+
+void FEHardwareDevice::initializeSubsystemBreaker(AmbRelativeAddr RCA) {
+    // Cartridge devices share a breaker for their band, others one for their subsystem:
+    unsigned band = FrontEnd::governorDevice(RCA);
+    unsigned subsystem = (band) ? band : 0x100 | FrontEnd::latencySubsystem(RCA);
+    unsigned long long key = ((unsigned long long) m_channel << 40) | ((unsigned long long) m_nodeAddress << 16) | subsystem;
+
+    pthread_mutex_lock(&subsystemBreakersMutex);
+    FECircuitBreaker *&breaker = subsystemBreakers[key];
+    // never deleted, so the pointer stays valid:
+    if (!breaker) {
+        char name[40];
+        sprintf(name, "ch%u node 0x%lX ", (unsigned) m_channel, (unsigned long) m_nodeAddress);
+        std::string text(name);
+        if (band) {
+            sprintf(name, "band %u", band);
+            text += name;
+        } else
+            text += FrontEnd::latencySubsystemName(subsystem & 0xFF);
+        breaker = new FECircuitBreaker(text);
+    }
+    subsystemBreaker_mp = breaker;
+    pthread_mutex_unlock(&subsystemBreakersMutex);
+}
+
+bool FEHardwareDevice::breakerAllows() {
+    return breaker_m.allow() && (!subsystemBreaker_mp || subsystemBreaker_mp -> allow());
+}
+
+void FEHardwareDevice::recordBusResult(AmbErrorCode_t status) {
+    // results which never reached the bus don't count:
+    if (status == AMBERR_BREAKER_OPEN || status == AMBERR_PENDING)
+        return;
+    if (breaker_m.record(status))
+        LOG(LM_INFO) << "FEHardwareDevice(" << name_m << "): circuit breaker "
+                     << FECircuitBreaker::stateText(breaker_m.getState()) << endl;
+    if (subsystemBreaker_mp && subsystemBreaker_mp -> record(status))
+        LOG(LM_INFO) << "FEHardwareDevice(" << name_m << "): circuit breaker for " << subsystemBreaker_mp -> getName() << " "
+                     << FECircuitBreaker::stateText(subsystemBreaker_mp -> getState()) << endl;
+}
+
 void FEHardwareDevice::checkExceededErrorCount() {
     if (!exceededErrorCount_m && maxErrorCount_m > 0 && errorCount_m > maxErrorCount_m) {
         exceededErrorCount_m = true;
@@ -174,38 +545,81 @@ void FEHardwareDevice::checkExceededErrorCount() {
     }
 }
 
-// implement the monitor thread:
-void *FEHardwareDevice::monitorThread(FEHardwareDevice *dev) {
-    // refuse to run if not passed an owner pointer:
-    if (!dev)
-        return NULL;
+// asynchronous monitor completion handling:
 
-    LOG(LM_TRACE) << "FEHardwareDevice(" << dev -> name_m << "): in monitor thread." << endl;
-    
-	while (true) {
-        // signal back to the owner whether running or stopped:
-        dev -> stopped_m = (!dev -> running_m);
-
-        if (dev -> stopped_m) {
-            // If stopped, worker thread dies:
-            LOG(LM_TRACE) << "FEHardwareDevice(" << dev -> name_m << "): exiting monitor thread." << endl;
-            pthread_exit(NULL);
-        
-        } else if (!dev -> paused_m) {
-            // If not paused, call the derived class' monitorAction:
-    		Time timestamp;
-    		setTimeStamp(&timestamp);
-            dev -> monitorAction(&timestamp);
-        }
-        // check if we should stop because of too many errors:
-        dev -> checkExceededErrorCount();
+AsyncMonitorGroup::AsyncMonitorGroup()
+  : completed_mp(NULL),
+    outstanding_m(0)
+{
+    pthread_mutex_init(&mutex_m, NULL);
+    sem_init(&signal_m, 0, 0);
+}
+
+AsyncMonitorGroup::~AsyncMonitorGroup() {
+    waitAll();
+    sem_destroy(&signal_m);
+    pthread_mutex_destroy(&mutex_m);
+}
+
+unsigned AsyncMonitorGroup::poll() {
+    return handleCompleted();
+}
 
-        // pause between calls to monitorAction:
-        SLEEP(5);
+void AsyncMonitorGroup::wait(AsyncMonitorBase &request) {
+    // There may be more posts than completions left to handle, so check before each wait:
+    while (!request.done_m) {
+        if (!handleCompleted())
+            sem_wait(&signal_m);
     }
-	return NULL;
 }
 
+void AsyncMonitorGroup::waitAll() {
+    while (outstanding_m) {
+        if (!handleCompleted())
+            sem_wait(&signal_m);
+    }
+}
 
+void AsyncMonitorGroup::completed(void *context) {
+    AsyncMonitorBase *request = static_cast<AsyncMonitorBase *>(context);
+    AsyncMonitorGroup *group = request -> group_mp;
+    // Post while locked so the group can't be destroyed before we are done with it:
+    pthread_mutex_lock(&(group -> mutex_m));
+    request -> next_mp = group -> completed_mp;
+    group -> completed_mp = request;
+    sem_post(&(group -> signal_m));
+    pthread_mutex_unlock(&(group -> mutex_m));
+}
 
+unsigned AsyncMonitorGroup::handleCompleted() {
+    pthread_mutex_lock(&mutex_m);
+    AsyncMonitorBase *list = completed_mp;
+    completed_mp = NULL;
+    pthread_mutex_unlock(&mutex_m);
 
+    // Put them back in order of completion:
+    AsyncMonitorBase *ordered = NULL;
+    while (list) {
+        AsyncMonitorBase *next = list -> next_mp;
+        list -> next_mp = ordered;
+        ordered = list;
+        list = next;
+    }
+    unsigned count = 0;
+    while (ordered) {
+        AsyncMonitorBase *request = ordered;
+        ordered = request -> next_mp;
+        request -> next_mp = NULL;
+        ++count;
+        request -> status_m = request -> unpackResult();
+        // Retry the same as syncMonitorWithRetry():
+        if (request -> status_m == FEMC_HARDW_RETRY_WARN && --(request -> retries_m) > 0) {
+            request -> device_mp -> sendAsyncMonitor(*request);
+            continue;
+        }
+        request -> done_m = true;
+        --outstanding_m;
+        request -> notify();
+    }
+    return count;
+}
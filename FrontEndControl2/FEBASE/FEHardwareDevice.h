@@ -21,17 +21,125 @@
 */
  
 #include <FrontEndAMB/ambDeviceImpl.h>
+#include <FrontEndAMB/ambCompletion.h>
 #include <FrontEndAMB/femcDefs.h>
 #include <FrontEndAMB/messagePackUnpack.h>
+#include "FEMonitorScheduler.h"
+#include "FEMonitorPoint.h"
+#include "FEMonitorHistory.h"
+#include "FEMonitorTable.h"
+#include "FEMonitorStatistics.h"
+#include "FECircuitBreaker.h"
 #include "logger.h"
-#include <tuple>
-#include <list>
+#include "setTimeStamp.h"
+#include <vector>
+#include <functional>
 #include <algorithm>
 #include <iomanip>
 
+class FEHardwareDevice;
+class AsyncMonitorGroup;
+template<typename T> class AsyncMonitor;
+
+/// AsyncMonitorBase holds the state of one asynchronous monitor request made with FEHardwareDevice::asyncMonitor().
+/// Use AsyncMonitor<T>, below, for the value type being monitored.
+class AsyncMonitorBase {
+public:
+    virtual ~AsyncMonitorBase()
+      {}
+
+    bool isDone() const
+      { return done_m; }
+    ///< true when the request has completed, been unpacked, and its callback has been called.
+
+    AmbRelativeAddr getRCA() const
+      { return RCA_m; }
+    ///< the monitor point requested.
+
+    FEMC_ERROR getStatus() const
+      { return status_m; }
+    ///< the result, as syncMonitorWithRetry() would have returned it.  Valid once isDone().
+
+protected:
+    AsyncMonitorBase()
+      : device_mp(NULL),
+        group_mp(NULL),
+        next_mp(NULL),
+        RCA_m(0),
+        retries_m(0),
+        status_m(FEMC_NO_ERROR),
+        done_m(true)
+      {}
+
+    virtual FEMC_ERROR unpackResult() = 0;
+    ///< unpack result_m into the value held by the derived class.
+
+    virtual void notify()
+      {}
+    ///< called on the group's thread when the request is done.
+
+    FEHardwareDevice *device_mp;    ///< the device which sent the request.
+    AsyncMonitorGroup *group_mp;    ///< the group which collects its completion.
+    AsyncMonitorBase *next_mp;      ///< link in the group's list of completions.
+    AmbRelativeAddr RCA_m;          ///< the monitor point.
+    int retries_m;                  ///< tries remaining if the FEMC asks for a retry.
+    AmbMonitorResult_t result_m;    ///< raw result, filled in by the bus.
+    FEMC_ERROR status_m;            ///< unpacked result.
+    bool done_m;                    ///< true when done.
+
+    friend class AsyncMonitorGroup;
+    friend class FEHardwareDevice;
+
+private:
+    AsyncMonitorBase(const AsyncMonitorBase &other);
+    ///< forbid copy construct.
+};
+
+/// AsyncMonitorGroup collects the completions of asynchronous monitor requests, so that a single
+/// thread can have many transactions outstanding at once.
+/// The bus thread only hands each completed request back to its group.  Unpacking, retries on
+/// FEMC_HARDW_RETRY_WARN, and callbacks all happen on the thread which calls poll() or wait(),
+/// so a callback may send further requests.  A group and its requests belong to one thread.
+class AsyncMonitorGroup {
+public:
+    AsyncMonitorGroup();
+    ~AsyncMonitorGroup();
+    ///< waits for any requests still outstanding.
+
+    unsigned getOutstanding() const
+      { return outstanding_m; }
+    ///< number of requests sent and not yet done.
+
+    unsigned poll();
+    ///< handle any completions which have arrived, without blocking.  Returns how many were handled.
+
+    void wait(AsyncMonitorBase &request);
+    ///< handle completions as they arrive until the given request is done.
+
+    void waitAll();
+    ///< handle completions as they arrive until no request is outstanding.
+
+private:
+    AsyncMonitorGroup(const AsyncMonitorGroup &other);
+    ///< forbid copy construct.
+
+    static void completed(void *context);
+    ///< AmbCompletionCallback for each request.  Runs on the bus thread.
+
+    unsigned handleCompleted();
+    ///< take the list of completions and finish or retry each one.  Returns how many were taken.
+
+    pthread_mutex_t mutex_m;        ///< protects completed_mp.
+    sem_t signal_m;                 ///< posted for each completion.
+    AsyncMonitorBase *completed_mp; ///< completions not yet handled, most recent first.
+    unsigned outstanding_m;         ///< requests sent and not yet done.  Used only by the owning thread.
+
+    friend class FEHardwareDevice;
+};
+
 /// FEHardwareDevice is a base class common to all front end ImplBase classes.
 /// It provides CAN message packing and unpacking services, synchronous monitor 
-/// and control, and a monitor thread for each device.  
+/// and control, and periodic monitoring by the shared FEMonitorScheduler.  
 class FEHardwareDevice : public AmbDeviceImpl, public MessagePackUnpack {
 public:
     FEHardwareDevice(const std::string &name);
@@ -54,19 +162,30 @@ public:
 // monitor thread operations:    
 
     virtual void startMonitor();
-    ///< start the monitor thread.
+    ///< start periodic calls to monitorAction() by the monitor scheduler.
     virtual void stopMonitor();
-    ///< stop the monitor thread.
+    ///< stop periodic monitoring.  Waits for monitorAction() to return if it is running.
     void pauseMonitor(bool pause, const char *reason = NULL);
-    ///< pause/resume the monitor thread.
+    ///< pause/resume periodic monitoring.
     void minimalMonitor(bool minimal, const char *reason = NULL);
     ///< reduce monitoring to the minimum if true.
+    bool isMinimalMonitoring() const;
+    ///< true if reduced to the minimum, either for this device or for all devices.
+    virtual void logMonitorStats() const
+      {}
+    ///< log the statistics of adaptive monitor points.  Classes with a MONITORS_REGISTRY override this.
     static void logMonitors(bool doLog)
       { logMonitors_m = doLog; }
     ///< enable/disable continuous logging of monitor points for all devices.
     static void logAmbErrors(bool doLog)
       { logAmbErrors_m = doLog; }
     ///< enable/disable logging of CAN bus error messages.
+    static void monitorDeadline(unsigned long deadline)
+      { monitorDeadline_m = deadline; }
+    ///< set how long in us a monitor thread request may wait in the CAN queue before it is dropped.  0 = never.
+    static unsigned long getMonitorDeadline()
+      { return monitorDeadline_m; }
+    ///< get the monitor thread queueing deadline, us.
     bool isErrorStop() const
       { return exceededErrorCount_m; }
     ///< return whether paused, either by user or measurement process or too many errors.
@@ -76,6 +195,25 @@ public:
     void resetErrorCount()
       { errorCount_m = 0; exceededErrorCount_m = false; }
     ///< reset the error counter
+    unsigned getCommandMismatchCount() const
+      { return commandMismatchCount_m; }
+    ///< number of deferred command readbacks which didn't match what was sent.  Each also counts as an error.
+    const FECircuitBreaker &getCircuitBreaker() const
+      { return breaker_m; }
+    ///< the circuit breaker for this device's own transactions.
+    void resetCircuitBreaker()
+      { breaker_m.reset(); }
+    ///< close the circuit breaker and zero its counters.
+
+// AmbDeviceInt monitor operations, overridden to fail fast while a circuit breaker is open:
+
+    virtual void monitor(AmbRelativeAddr RCA, AmbDataLength_t &dataLength, AmbDataMem_t *data,
+                         sem_t *synchLock, Time *timestamp, AmbErrorCode_t *status);
+    virtual void monitorBatch(unsigned count, const AmbRelativeAddr *RCAs, AmbMonitorResult_t *results,
+                              AmbCompletionLatch *latch);
+    virtual void monitorAsync(AmbRelativeAddr RCA, AmbMonitorResult_t *result, AmbCompletionCallback callback,
+                              void *context);
+    ///< while this device's or its subsystem's breaker is open, these complete at once with AMBERR_BREAKER_OPEN.
 
 // logging helpers and operations:
 
@@ -129,6 +267,10 @@ public:
     ///< get a reference to the current logger   
 
 protected:
+    void initializeSubsystemBreaker(AmbRelativeAddr RCA);
+    ///< share a circuit breaker with the other devices in the subsystem of RCA on this device's channel and node:
+    ///< a cartridge band, or a subsystem such as the cryostat.  Call from initialize(), after the channel and node
+    ///< are set and before any transactions.  Devices which don't call it have only their own breaker.
 
 
 // Monitor and control operations:
@@ -137,6 +279,11 @@ protected:
     virtual void postMonitorHook(const AmbRelativeAddr &RCA)
       {}
 
+    /// This hook is called by the monitor registry after it records each monitor point, with the time
+    /// the point was acquired.  def_p is the monitor table row of the point, or NULL if it was added by addMon():
+    virtual void postRecordMonHook(const float *target, const FEMonitorDef *def_p, Time timestamp)
+      {}
+
     /// Monitor a three-byte software version number and return a string.
     FEMC_ERROR syncMonitorThreeByteRevLevel(AmbRelativeAddr RCA, std::string &target);
 
@@ -144,10 +291,9 @@ protected:
     FEMC_ERROR syncMonitorEightByteESN(AmbRelativeAddr RCA, std::string &target, bool reverseBytes = false);
 
     /// Synchronous monitor of any type supported with an unpack() function.
-    /// synchLock must be initialized before and destroyed after calling.
+    /// synchLock must be initialized before and destroyed after calling, or use *ambThreadSynchLock().
     template<typename T>
     FEMC_ERROR syncMonitor(AmbRelativeAddr RCA, T &target, sem_t &synchLock) {
-        FEMC_ERROR ret(FEMC_NO_ERROR);
         AmbErrorCode_t status(AMBERR_NOERR);
         AmbDataLength_t dataLength;
         AmbDataMem_t data[8];
@@ -157,26 +303,28 @@ protected:
         // wait on the semaphore:
         sem_wait(&synchLock);
         // check for errors and return result:
-        if (status == AMBERR_NOERR) {
-            postMonitorHook(RCA);
-            ret = unpack(target, dataLength, data);
-        } else {
-            ret = FEMC_AMB_ERROR;
-            if (logAmbErrors_m) {
-                LOG(LM_ERROR) << "FEHardwareDevice(0x" << std::uppercase << std::hex << m_nodeAddress << "): AMB error=" << status << " RCA=" << " 0x" << std::uppercase << std::hex << std::setw(6) << std::setfill('0') << RCA << std::endl;
-            }
-        }
-        if (!monitorIgnorableError(ret))
-            ++errorCount_m;   // increment error counter.
-        return ret;
+        return unpackMonitor(RCA, status, dataLength, data, target);
+    }
+
+    /// Check the status of a completed monitor transaction and unpack its data into target.
+    /// Shared by the synchronous and batch monitors so that errors are logged and counted the same way.
+    template<typename T>
+    FEMC_ERROR unpackMonitor(AmbRelativeAddr RCA, AmbErrorCode_t status, AmbDataLength_t dataLength, const AmbDataMem_t *data, T &target) {
+        FEMC_ERROR ret(FEMC_AMB_ERROR);
+        if (status == AMBERR_NOERR)
+            ret = AmbCodecSelect<T>::unpack(*this, target, dataLength, data);
+        return checkMonitorResult(RCA, status, ret);
     }
 
+    /// Check the bus status of a completed monitor transaction whose data unpacked with status ret.
+    /// Records, logs, and counts errors and calls postMonitorHook().  Returns the status of the monitor.
+    FEMC_ERROR checkMonitorResult(AmbRelativeAddr RCA, AmbErrorCode_t status, FEMC_ERROR ret);
+
     /// Synchronous monitor with retries of any type supported with an unpack() function.
     template<typename T>
     FEMC_ERROR syncMonitorWithRetry(AmbRelativeAddr RCA, T &target, int retries = 12) {
         FEMC_ERROR ret(FEMC_NO_ERROR);
-        sem_t synchLock;
-        sem_init(&synchLock, 0, 0);
+        sem_t &synchLock(*ambThreadSynchLock());
         bool done = false;
         while (!done && retries > 0) {
             ret = syncMonitor(RCA, target, synchLock);
@@ -190,56 +338,136 @@ protected:
             else
                 done = true;
         }
-        sem_destroy(&synchLock);
+        setThreadMonitorStatus(ret);
         return ret;
     }
     
-    /// Synchronous monitor a float with averaging.
+    /// Synchronous batch monitor:  send requests for count RCAs in one step and wait once for all to complete.
+    /// results must have room for count entries.  Unpack each with unpackBatchResult(), or many floats at once with AmbCodecBatch.
+    void syncMonitorBatch(unsigned count, const AmbRelativeAddr *RCAs, AmbMonitorResult_t *results);
+
+    /// Unpack one result from syncMonitorBatch() the same as syncMonitor() would.
+    /// If the FEMC asks for a retry, the point is monitored again using syncMonitorWithRetry().
+    template<typename T>
+    FEMC_ERROR unpackBatchResult(AmbRelativeAddr RCA, const AmbMonitorResult_t &result, T &target) {
+        FEMC_ERROR ret = unpackMonitor(RCA, result.status, result.dataLength, result.data, target);
+        if (ret == FEMC_HARDW_RETRY_WARN)
+            ret = syncMonitorWithRetry(RCA, target);
+        return ret;
+    }
+
+    /// Asynchronous monitor of any type supported with an unpack() function.
+    /// Returns immediately.  The request is unpacked, retried, and its callback called when group
+    /// handles its completion.  request and group must outlive the transaction.
+    void asyncMonitor(AmbRelativeAddr RCA, AsyncMonitorBase &request, AsyncMonitorGroup &group, int retries = 12);
+
+    /// Synchronous monitor a float with averaging.  The readings are sent in batches of up to FEMON_MAX_BATCH.
+    /// On AMB error target is set to 0.
     FEMC_ERROR syncMonitorAverage(AmbRelativeAddr RCA, float &target, int average);
+
+    /// Synchronous monitor a float samples times, sent in batches of up to FEMON_MAX_BATCH, and compute their statistics.
+    /// Stops adding readings at the first AMB error.
+    FEMC_ERROR syncMonitorStatistics(AmbRelativeAddr RCA, int samples, FEMonitorStatistics &target);
+
+    /// Synchronous monitor of a point described by a monitor table, as the SYNCMON_LOG macros would do it.
+    /// Stores the result in status, logs the transaction, and returns the value, or 0 on AMB error.
+    float syncMonitorTablePoint(AmbRelativeAddr RCA, const FEMonitorDef &def, int &status);
+
+    /// Unpack one result from syncMonitorBatch() for a point described by a monitor table.
+    /// The same as syncMonitorTablePoint() but without averaging.
+    float unpackTablePoint(AmbRelativeAddr RCA, const FEMonitorDef &def, const AmbMonitorResult_t &result, int &status);
+
+    /// Unpack count results from syncMonitorBatch() for points described by monitor tables, as unpackTablePoint() does for each.
+    /// The float points are decoded together with AmbCodecBatch.  count is at most FEMON_MAX_BATCH.
+    void unpackTablePoints(unsigned count, const AmbRelativeAddr *RCAs, const FEMonitorDef *const *defs,
+                           const AmbMonitorResult_t *results, float *values, int *const *status);
+
+    static void setThreadMonitorStatus(FEMC_ERROR status);
+    static FEMC_ERROR getThreadMonitorStatus();
+    ///< the status of the last synchronous monitor made by the calling thread.
+    ///< Lets the MONITORS_REGISTRY record the status of each point along with its value.
     
     /// Template function to perform a pair of command/readback transactions at the given RCA.
     /// The 'value' is sent as the payload.
     /// FEStatus receives the status byte from the readback.
     /// pack(T, AmbDataLength_t&, AmbDataMem_t*) must be defined for T.
+    /// If the calling thread has deferred readbacks, only sends the command and waits for it to complete.
     template<typename T>
     FEMC_ERROR syncCommand(AmbRelativeAddr RCA, T value) {
         FEMC_ERROR ret(FEMC_NO_ERROR);
         AmbErrorCode_t status(AMBERR_NOERR);
         AmbDataLength_t dataLength;
         AmbDataMem_t data[8];
-        pack(value, dataLength, data);
+        AmbCodecSelect<T>::pack(*this, value, dataLength, data);
+        // send and leave the readback for verifyCommands():
+        if (isCommandReadbackDeferred())
+            return sendUnverifiedCommand(RCA, dataLength, data);
         Time timestamp;
         // send command with a semaphore:
-        sem_t synchLock;
-        sem_init(&synchLock, 0, 0);
+        sem_t &synchLock(*ambThreadSynchLock());
         command(RCA, dataLength, data, &synchLock, &timestamp, &status);
         // wait on the semaphore (hence synchronous):
         sem_wait(&synchLock);
         // send a monitor request to the same RCA with the semaphore and wait:
-        monitor(RCA, dataLength, data, &synchLock, NULL, NULL);
+        monitor(RCA, dataLength, data, &synchLock, NULL, &status);
         sem_wait(&synchLock);
-        sem_destroy(&synchLock);
+        recordBusResult(status);
         T temp;
-        ret = unpack(temp, dataLength, data);
+        ret = AmbCodecSelect<T>::unpack(*this, temp, dataLength, data);
+        // this readback supersedes any deferred one for the same RCA:
+        forgetUnverifiedCommand(RCA);
         return ret;
     }
 
+    static void deferCommandReadback(bool defer);
+    static bool isCommandReadbackDeferred();
+    ///< while deferred, syncCommand() called by this thread returns as soon as the command has been sent, without reading it back.
+    ///< Used for the intermediate steps of ramps.  The last value sent to each RCA is kept for verifyCommands().
+
+    FEMC_ERROR verifyCommands();
+    ///< read back, in one batch, the last value of each deferred command not since superseded by a synchronous one.
+    ///< Counts and logs any whose readback has an error status or doesn't match what was sent.
+    ///< Returns the first error found, or FEMC_NO_ERROR.
+
     virtual void monitorAction(Time *timestamp_p) = 0;
-    ///< derived classes must declare a monitorAction method for the monitor thread to call.
+    ///< derived classes must declare a monitorAction method for the monitor scheduler to call.
+    ///< It is called once per monitor interval and should do one step of monitoring.
+
+    void setMonitorRate(unsigned long interval, unsigned long minimalInterval = 0, int priority = FEMonitorScheduler::PRIORITY_NORMAL);
+    ///< set how often monitorAction() is called, ms, normally and when minimal.  minimalInterval = 0 for the same as normal.
+    ///< priority orders devices which are due at the same time.  Call from the derived class' constructor.
     
 protected:
     bool minimalMonitoring_m;   ///< true if only the bare minimum monitoring should be performed.
     FEMC_ERROR lastFemcError_m; ///< store error/status of last operation.
     static bool logMonitors_m;  ///< true if analog monitor points should be continuously dumped to the log.
     static bool logAmbErrors_m; ///< true if AMB errors should be logged.
+    static unsigned long monitorDeadline_m; ///< max queueing time for monitor thread requests, us.
     
 private:
-    bool running_m;             ///< true if the monitor thread should continue to run.
-    bool paused_m;              ///< true if the monitor thread is paused.
-    bool exceededErrorCount_m;  ///< true if the monitor thread stopped because of too many errors.
+    bool running_m;             ///< true if registered with the monitor scheduler.
+    bool paused_m;              ///< true if monitoring is paused.
+    bool exceededErrorCount_m;  ///< true if monitoring stopped because of too many errors.
     
-    unsigned errorCount_m;      ///< count of errors seen by the monitor thread since started/unpaused.
-    unsigned maxErrorCount_m;   ///< maximum error count before the thread is stopped.
+    unsigned errorCount_m;      ///< count of errors seen by monitoring since started/unpaused.
+    unsigned maxErrorCount_m;   ///< maximum error count before monitoring is paused.
+    unsigned commandMismatchCount_m;    ///< count of deferred commands which failed verification.
+
+    /// A command sent with its readback deferred.
+    struct UnverifiedCommand {
+        AmbRelativeAddr RCA;
+        AmbDataLength_t dataLength;
+        AmbDataMem_t data[AMB_DATA_MSG_SIZE];
+    };
+    std::vector<UnverifiedCommand> unverifiedCommands_m;    ///< latest deferred command to each RCA.
+    pthread_mutex_t commandMutex_m;                         ///< protects unverifiedCommands_m.
+
+    FECircuitBreaker breaker_m;             ///< breaker for this device's own transactions.
+    FECircuitBreaker *subsystemBreaker_mp;  ///< breaker shared by the devices in this device's subsystem, or NULL.  Set by initialize().
+
+    unsigned long monitorInterval_m;        ///< ms between calls to monitorAction().
+    unsigned long minimalMonitorInterval_m; ///< ms between calls when minimal.
+    int monitorPriority_m;                  ///< FEMonitorScheduler::Priority.
 
     void checkExceededErrorCount();
     //< private helper to check whether maxErrorCount_m is newly exceeded.
@@ -256,47 +484,243 @@ private:
     static LogInterface *logger_mp;
     ///< the interface to use for all transaction logging.
     
-    pthread_t thread_m; ///< the monitor thread handle.
-    bool stopped_m;       ///< true when the monitor thread has stopped and may be destroyed.
+    void sendAsyncMonitor(AsyncMonitorBase &request);
+    ///< send or resend an asynchronous monitor request.
 
-    static void *monitorThread(FEHardwareDevice *dev);
-    ///< the monitor thread runner function.  Calls derived class' monitorAction().
+    FEMC_ERROR sendUnverifiedCommand(AmbRelativeAddr RCA, AmbDataLength_t dataLength, const AmbDataMem_t *data);
+    ///< send a command, wait for it to complete, and keep it for verifyCommands().  Returns FEMC_AMB_ERROR if the send failed.
+
+    void forgetUnverifiedCommand(AmbRelativeAddr RCA);
+    ///< drop the deferred command to RCA, if any.
+
+    bool breakerAllows();
+    ///< true if both this device's breaker and its subsystem's breaker allow a transaction now.
+
+    void recordBusResult(AmbErrorCode_t status);
+    ///< count the result of a transaction in both breakers and log any change of state.
+
+    float logTablePoint(AmbRelativeAddr RCA, const FEMonitorDef &def, FEMC_ERROR ret, float value, int &status);
+    ///< finish a monitor table read:  store the status, log the transaction, and return the value.
+
+    FEMC_ERROR checkBatchFloat(AmbRelativeAddr RCA, const AmbMonitorResult_t &result, float &value, FEMC_ERROR decoded);
+    ///< finish a float from syncMonitorBatch() decoded by AmbCodecBatch with status decoded, as unpackBatchResult() would.
+
+    friend class AsyncMonitorGroup;
+    friend class FEMonitorScheduler;
+    template<typename T> friend class AsyncMonitor;
+};
+
+/// AsyncMonitor is an asynchronous monitor request for a value of type T.  It serves as a future:
+/// call get() to wait for the result.  Or construct it with a callback to be called when it is done.
+/// It may be sent again once done.
+template<typename T>
+class AsyncMonitor : public AsyncMonitorBase {
+public:
+    typedef std::function<void(AsyncMonitor<T> &request)> Callback;
+
+    AsyncMonitor(Callback callback = Callback())
+      : value_m(),
+        callback_m(callback)
+      {}
+    ///< construct with an optional callback.
+
+    const T &getValue() const
+      { return value_m; }
+    ///< the unpacked value.  Valid once isDone().
+
+    FEMC_ERROR get(T &target) {
+        if (group_mp)
+            group_mp -> wait(*this);
+        target = value_m;
+        return status_m;
+    }
+    ///< wait for the request to be done and get its result, as syncMonitorWithRetry() would.
+
+protected:
+    virtual FEMC_ERROR unpackResult()
+      { return device_mp -> unpackMonitor(RCA_m, result_m.status, result_m.dataLength, result_m.data, value_m); }
+
+    virtual void notify()
+      { if (callback_m) callback_m(*this); }
+
+private:
+    T value_m;                      ///< the unpacked value.
+    Callback callback_m;            ///< called when done, if set.
 };
 
 // These macros support declaring and defining a MONITORS_REGISTRY in a derived class having the interface:
-// addMon(float *target, (pointer to member function) pf), bool isTemporary;
+// addMon(float *target, (pointer to member function) pf, const char *name, bool isTemporary);
 //  - add a monitor point and its corresponding function to the registry.
-//  - if isTemporary insert it at the front and reset the iterator to service it next.
+//  - if FEMonitorHistoryStore::enabled() and not isTemporary, its values are recorded in the FEMonitorHistory for this device and name.
+//  - if isTemporary it is serviced ahead of all others, once, and then deleted.
+// addMonTable(const FEMonitorTableEntry<BASE> *table, unsigned count, AmbRelativeAddr baseRCA, unsigned features)
+//  - add the monitor points of a table, reading each at baseRCA + its offset without a monitor function.
+//  - points needing features which are not set are not added and their values are set to 0.
+//  - adaptive rate classes are applied as by setMonRate.
+// setMonRate(float *target, unsigned long minInterval, unsigned long maxInterval, float deadband)
+//  - make the monitor point having target adaptive.  See FEMonitorPoint.
+// setMonLimits(float *target, float lowLimit, float highLimit)
+//  - poll the monitor point having target at its fastest rate while outside these limits.
+// setMonBatch(unsigned batch)
+//  - read up to batch consecutive table points which are due in one bus batch.  Default 1.
 // executeNextMon()
-//  - call a monitor function from the registry and put its value in the target float variable.
-//  - if isTemporary, delete it after servicing.
+//  - take the turn of the next monitor point in the registry.  Returns false at the end of the registry.
+//  - if the point is due, read it and put its value in the target float variable.
+//  - if not, give the turn to the most overdue adaptive point, if any.  Otherwise no bus transaction is made.
+// logMonitorStats()
+//  - log the statistics of the adaptive monitor points.
+
+#define FEMON_MAX_BATCH 8
 
 #define DECLARE_MONITORS_REGISTRY(CLASS)                                    \
     typedef float (CLASS:: *MonFuncPtr) (void);                             \
-    typedef std::tuple<float *, MonFuncPtr, bool> RegEntry;                 \
-    std::list<RegEntry> monitorRegistry;                                    \
-    std::list<RegEntry>::iterator nextMon;                                  \
-    void addMon(float *target, MonFuncPtr pf, bool isTemporary = false) {   \
-        if (isTemporary) {                                                  \
-            monitorRegistry.push_front(RegEntry(target, pf, true));         \
-            nextMon = monitorRegistry.begin();                              \
-        } else monitorRegistry.push_back(RegEntry(target, pf, false)); }    \
-    bool executeNextMon();
+    struct RegEntry : public FEMonitorPoint {                               \
+        RegEntry(float *target, MonFuncPtr pf, const char *name, bool isTemporary) \
+          : FEMonitorPoint(target, name, isTemporary), pf(pf),              \
+            RCA(0), status_p(NULL), def_p(NULL) {}                          \
+        MonFuncPtr pf;                                                      \
+        AmbRelativeAddr RCA;                                                \
+        int *status_p;                                                      \
+        const FEMonitorDef *def_p; };                                       \
+    std::vector<RegEntry> monitorRegistry;                                  \
+    std::vector<RegEntry> monitorTemps;                                     \
+    std::vector<unsigned> adaptiveMons;                                     \
+    unsigned nextMon = 0;                                                   \
+    unsigned monBatch = 1;                                                  \
+    void addMon(float *target, MonFuncPtr pf, const char *name, bool isTemporary = false) { \
+        if (isTemporary)                                                    \
+            monitorTemps.push_back(RegEntry(target, pf, name, true));       \
+        else {                                                              \
+            monitorRegistry.push_back(RegEntry(target, pf, name, false));   \
+            if (FEMonitorHistoryStore::enabled())                           \
+                monitorRegistry.back().history_p =                          \
+                    FEMonitorHistoryStore::getInstance().getHistory(name_m, monitorRegistry.back().name()); \
+        }}                                                                  \
+    template<class BASE>                                                    \
+    void addMonTable(const FEMonitorTableEntry<BASE> *table, unsigned count, \
+                     AmbRelativeAddr baseRCA, unsigned features) {          \
+        for (unsigned index = 0; index < count; ++index) {                  \
+            const FEMonitorTableEntry<BASE> &row = table[index];            \
+            float *target = &(this ->* row.value);                          \
+            if (row.def.features & ~features) { *target = 0.0; continue; }  \
+            addMon(target, NULL, row.def.name);                             \
+            RegEntry &entry = monitorRegistry.back();                       \
+            entry.RCA = baseRCA + row.def.offset;                           \
+            entry.status_p = &(this ->* row.status);                        \
+            entry.def_p = &row.def;                                         \
+            FEMonitorRate rate = feMonitorRate(row.def.rateClass);          \
+            if (rate.maxInterval)                                           \
+                setMonRate(target, rate.minInterval, rate.maxInterval, row.def.deadband); \
+        }}                                                                  \
+    void setMonBatch(unsigned batch)                                        \
+      { monBatch = (batch < 1) ? 1 : ((batch > FEMON_MAX_BATCH) ? FEMON_MAX_BATCH : batch); } \
+    RegEntry *findMon(float *target);                                       \
+    void setMonRate(float *target, unsigned long minInterval,               \
+                    unsigned long maxInterval, float deadband);             \
+    void setMonLimits(float *target, float lowLimit, float highLimit);      \
+    bool executeNextMon();                                                  \
+    void readMon(RegEntry &entry, bool extra);                              \
+    void readMonBatch(unsigned first, unsigned count);                      \
+    void recordMon(RegEntry &entry, float val, FEMonitorPoint::Clock::time_point start, \
+                   FEMonitorPoint::Clock::time_point end, bool extra);      \
+    virtual void logMonitorStats() const;
 
 #define DEFINE_MONITORS_REGISTRY(CLASS)                                 \
+    CLASS ::RegEntry *CLASS ::findMon(float *target) {                  \
+        for (unsigned index = 0; index < monitorRegistry.size(); ++index) \
+            if (monitorRegistry[index].target_p == target) return &monitorRegistry[index]; \
+        return NULL; }                                                  \
+    void CLASS ::setMonRate(float *target, unsigned long minInterval,   \
+                            unsigned long maxInterval, float deadband) { \
+        RegEntry *entry = findMon(target);                              \
+        if (!entry) return;                                             \
+        if (!entry -> isAdaptive())                                     \
+            adaptiveMons.push_back(entry - &monitorRegistry[0]);        \
+        entry -> setRate(minInterval, maxInterval, deadband); }         \
+    void CLASS ::setMonLimits(float *target, float lowLimit, float highLimit) { \
+        RegEntry *entry = findMon(target);                              \
+        if (entry) entry -> setLimits(lowLimit, highLimit); }           \
+    void CLASS ::recordMon(RegEntry &entry, float val, FEMonitorPoint::Clock::time_point start, \
+                           FEMonitorPoint::Clock::time_point end, bool extra) { \
+        entry.update(val, start, end, extra);                           \
+        if (entry.target_p) *(entry.target_p) = val;                    \
+        Time timestamp;                                                 \
+        setTimeStamp(&timestamp);                                       \
+        if (entry.history_p)                                            \
+            entry.history_p -> add(timestamp, val, getThreadMonitorStatus()); \
+        postRecordMonHook(entry.target_p, entry.def_p, timestamp); }    \
+    void CLASS ::readMon(RegEntry &entry, bool extra) {                 \
+        FEMonitorPoint::Clock::time_point start = FEMonitorPoint::Clock::now(); \
+        setThreadMonitorStatus(FEMC_NO_ERROR);                          \
+        float val = (entry.pf) ? (this ->* entry.pf)()                  \
+                               : syncMonitorTablePoint(entry.RCA, *entry.def_p, *entry.status_p); \
+        recordMon(entry, val, start, FEMonitorPoint::Clock::now(), extra); } \
+    void CLASS ::readMonBatch(unsigned first, unsigned count) {         \
+        AmbRelativeAddr RCAs[FEMON_MAX_BATCH];                          \
+        const FEMonitorDef *defs[FEMON_MAX_BATCH];                      \
+        int *status[FEMON_MAX_BATCH];                                   \
+        AmbMonitorResult_t results[FEMON_MAX_BATCH];                    \
+        float values[FEMON_MAX_BATCH];                                  \
+        for (unsigned index = 0; index < count; ++index) {              \
+            const RegEntry &entry = monitorRegistry[first + index];     \
+            RCAs[index] = entry.RCA;                                    \
+            defs[index] = entry.def_p;                                  \
+            status[index] = entry.status_p;                             \
+        }                                                               \
+        FEMonitorPoint::Clock::time_point start = FEMonitorPoint::Clock::now(); \
+        syncMonitorBatch(count, RCAs, results);                         \
+        FEMonitorPoint::Clock::duration each = (FEMonitorPoint::Clock::now() - start) / count; \
+        unpackTablePoints(count, RCAs, defs, results, values, status);  \
+        for (unsigned index = 0; index < count; ++index) {              \
+            setThreadMonitorStatus((FEMC_ERROR) *status[index]);        \
+            recordMon(monitorRegistry[first + index], values[index], start, start + each, false); \
+        }}                                                              \
     bool CLASS ::executeNextMon() {                                     \
-        if (nextMon == monitorRegistry.end()) {                         \
-            nextMon = monitorRegistry.begin();                          \
+        if (!monitorTemps.empty()) {                                    \
+            RegEntry entry(monitorTemps.front());                       \
+            monitorTemps.erase(monitorTemps.begin());                   \
+            readMon(entry, false);                                      \
+            return true;                                                \
+        }                                                               \
+        if (nextMon >= monitorRegistry.size()) {                        \
+            nextMon = 0;                                                \
             return false;                                               \
-        } else {                                                        \
-            float *target; MonFuncPtr pf; bool isTemporary;             \
-            std::tie(target, pf, isTemporary) = *nextMon;               \
-            float val = (this ->* pf)();                                \
-            if (target) *(target) = val;                                \
-            if (isTemporary) nextMon = monitorRegistry.erase(nextMon);  \
-            else ++nextMon;                                             \
-			return true;                                                \
-    }}
+        }                                                               \
+        FEMonitorPoint::Clock::time_point now = FEMonitorPoint::Clock::now(); \
+        if (monitorRegistry[nextMon].isDue(now)) {                      \
+            unsigned count = 0;                                         \
+            while (count < monBatch && nextMon + count < monitorRegistry.size()) { \
+                const RegEntry &entry = monitorRegistry[nextMon + count]; \
+                if (entry.pf || entry.def_p -> average > 1 || !entry.isDue(now)) break; \
+                ++count;                                                \
+            }                                                           \
+            if (count > 1) readMonBatch(nextMon, count);                \
+            else { readMon(monitorRegistry[nextMon], false); count = 1; } \
+            nextMon += count;                                           \
+            return true;                                                \
+        }                                                               \
+        monitorRegistry[nextMon].skip();                                \
+        ++nextMon;                                                      \
+        RegEntry *best = NULL;                                          \
+        for (unsigned index = 0; index < adaptiveMons.size(); ++index) { \
+            RegEntry &entry = monitorRegistry[adaptiveMons[index]];     \
+            if (entry.isDue(now) && (!best || entry.isDueBefore(*best))) \
+                best = &entry;                                          \
+        }                                                               \
+        if (best) readMon(*best, true);                                 \
+        return true;                                                    \
+    }                                                                   \
+    void CLASS ::logMonitorStats() const {                              \
+        for (unsigned index = 0; index < adaptiveMons.size(); ++index) { \
+            const RegEntry &entry = monitorRegistry[adaptiveMons[index]]; \
+            const FEMonitorPointStats &stats = entry.stats();           \
+            LOG(LM_INFO) << "MonitorStats:" << name_m << ": " << entry.name() \
+                         << " interval=" << stats.interval << " ms polls=" << stats.polls \
+                         << " extra=" << stats.extraPolls << " skipped=" << stats.skipped \
+                         << " changes=" << stats.changes << " violations=" << stats.violations \
+                         << " busTime=" << stats.busTime / 1000 << " ms saved=" << stats.savedTime() / 1000 \
+                         << " ms" << std::endl;                         \
+        }}
 
 
 
@@ -0,0 +1,210 @@
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2007
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ *----------------------------------------------------------------------
+ */
+
+#include "FEMonitorHistory.h"
+#include <FrontEndAMB/femcDefs.h>
+using namespace std;
+
+FEMonitorHistory::FEMonitorHistory(const unsigned *sizes)
+  : samples_m(0)
+{
+    pthread_mutex_init(&mutex_m, NULL);
+    rings_m[RESOLUTION_RAW].reset(sizes ? sizes[RESOLUTION_RAW] : RAW_SIZE);
+    rings_m[RESOLUTION_SECOND].reset(sizes ? sizes[RESOLUTION_SECOND] : SECOND_SIZE);
+    rings_m[RESOLUTION_MINUTE].reset(sizes ? sizes[RESOLUTION_MINUTE] : MINUTE_SIZE);
+    rings_m[RESOLUTION_10MINUTES].reset(sizes ? sizes[RESOLUTION_10MINUTES] : TEN_MINUTES_SIZE);
+    for (int res = 0; res < NUM_RESOLUTIONS; ++res) {
+        rollups_m[res].entry = FEMonitorHistoryEntry();
+        rollups_m[res].sum = 0.0;
+    }
+}
+
+FEMonitorHistory::~FEMonitorHistory() {
+    pthread_mutex_destroy(&mutex_m);
+}
+
+Time FEMonitorHistory::period(Resolution resolution) {
+    switch (resolution) {
+        case RESOLUTION_SECOND:
+            return TICKS_PER_SECOND;
+        case RESOLUTION_MINUTE:
+            return 60 * TICKS_PER_SECOND;
+        case RESOLUTION_10MINUTES:
+            return 600 * TICKS_PER_SECOND;
+        case RESOLUTION_RAW:
+        default:
+            return 0;
+    }
+}
+
+void FEMonitorHistory::add(Time timestamp, float value, int status) {
+    FEMonitorHistoryEntry sample;
+    sample.timestamp = timestamp;
+    sample.minValue = sample.maxValue = sample.meanValue = value;
+    sample.count = 1;
+    sample.status = status;
+
+    pthread_mutex_lock(&mutex_m);
+    ++samples_m;
+    rings_m[RESOLUTION_RAW].push(sample);
+
+    for (int res = RESOLUTION_SECOND; res < NUM_RESOLUTIONS; ++res) {
+        Time length = period((Resolution) res);
+        Time start = timestamp - timestamp % length;
+        Rollup &rollup = rollups_m[res];
+        if (rollup.entry.count && rollup.entry.timestamp != start) {
+            // The sample is in a new period.  Close the one in progress:
+            rollup.entry.meanValue = (float) (rollup.sum / rollup.entry.count);
+            rings_m[res].push(rollup.entry);
+            rollup.entry.count = 0;
+        }
+        if (!rollup.entry.count) {
+            rollup.entry = sample;
+            rollup.entry.timestamp = start;
+            rollup.sum = value;
+        } else {
+            if (value < rollup.entry.minValue)
+                rollup.entry.minValue = value;
+            if (value > rollup.entry.maxValue)
+                rollup.entry.maxValue = value;
+            if (rollup.entry.status == FEMC_NO_ERROR)
+                rollup.entry.status = status;
+            rollup.sum += value;
+            ++rollup.entry.count;
+        }
+    }
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void FEMonitorHistory::select(const Ring &ring, Time startTime, Time endTime, std::vector<FEMonitorHistoryEntry> &target) {
+    for (unsigned index = 0; index < ring.count; ++index) {
+        const FEMonitorHistoryEntry &entry = ring.at(index);
+        if (entry.timestamp >= startTime && (!endTime || entry.timestamp < endTime))
+            target.push_back(entry);
+    }
+}
+
+unsigned FEMonitorHistory::query(Resolution resolution, Time startTime, Time endTime, unsigned maxEntries,
+                                 std::vector<FEMonitorHistoryEntry> &target) const
+{
+    target.clear();
+    if (resolution < RESOLUTION_RAW || resolution >= NUM_RESOLUTIONS)
+        return 0;
+
+    pthread_mutex_lock(&mutex_m);
+    select(rings_m[resolution], startTime, endTime, target);
+    if (resolution != RESOLUTION_RAW) {
+        // Include the rollup in progress:
+        const Rollup &rollup = rollups_m[resolution];
+        if (rollup.entry.count && rollup.entry.timestamp >= startTime && (!endTime || rollup.entry.timestamp < endTime)) {
+            target.push_back(rollup.entry);
+            target.back().meanValue = (float) (rollup.sum / rollup.entry.count);
+        }
+    }
+    pthread_mutex_unlock(&mutex_m);
+
+    if (maxEntries && target.size() > maxEntries)
+        target.erase(target.begin(), target.end() - maxEntries);
+    return target.size();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+std::atomic<FEMonitorHistoryStore*> FEMonitorHistoryStore::instance_mp(NULL);
+pthread_mutex_t FEMonitorHistoryStore::instanceLock_m = PTHREAD_MUTEX_INITIALIZER;
+bool FEMonitorHistoryStore::enabled_m(false);
+unsigned FEMonitorHistoryStore::sizes_m[FEMonitorHistory::NUM_RESOLUTIONS] = {
+    FEMonitorHistory::RAW_SIZE, FEMonitorHistory::SECOND_SIZE, FEMonitorHistory::MINUTE_SIZE, FEMonitorHistory::TEN_MINUTES_SIZE };
+
+FEMonitorHistoryStore &FEMonitorHistoryStore::getInstance() {
+    FEMonitorHistoryStore *instance = instance_mp.load();
+    if (!instance) {
+        // Only one thread creates it:
+        pthread_mutex_lock(&instanceLock_m);
+        instance = instance_mp.load();
+        if (!instance) {
+            instance = new FEMonitorHistoryStore;
+            instance_mp.store(instance);
+        }
+        pthread_mutex_unlock(&instanceLock_m);
+    }
+    return *instance;
+}
+
+void FEMonitorHistoryStore::deleteInstance() {
+    pthread_mutex_lock(&instanceLock_m);
+    FEMonitorHistoryStore *instance = instance_mp.exchange(NULL);
+    pthread_mutex_unlock(&instanceLock_m);
+    delete instance;
+}
+
+void FEMonitorHistoryStore::configure(bool enable, const unsigned *sizes) {
+    enabled_m = enable;
+    sizes_m[FEMonitorHistory::RESOLUTION_RAW] = sizes ? sizes[FEMonitorHistory::RESOLUTION_RAW] : FEMonitorHistory::RAW_SIZE;
+    sizes_m[FEMonitorHistory::RESOLUTION_SECOND] = sizes ? sizes[FEMonitorHistory::RESOLUTION_SECOND] : FEMonitorHistory::SECOND_SIZE;
+    sizes_m[FEMonitorHistory::RESOLUTION_MINUTE] = sizes ? sizes[FEMonitorHistory::RESOLUTION_MINUTE] : FEMonitorHistory::MINUTE_SIZE;
+    sizes_m[FEMonitorHistory::RESOLUTION_10MINUTES] = sizes ? sizes[FEMonitorHistory::RESOLUTION_10MINUTES] : FEMonitorHistory::TEN_MINUTES_SIZE;
+}
+
+FEMonitorHistoryStore::FEMonitorHistoryStore() {
+    pthread_mutex_init(&mutex_m, NULL);
+}
+
+FEMonitorHistoryStore::~FEMonitorHistoryStore() {
+    for (map<Key, FEMonitorHistory*>::iterator it = histories_m.begin(); it != histories_m.end(); ++it)
+        delete it -> second;
+    histories_m.clear();
+    pthread_mutex_destroy(&mutex_m);
+}
+
+FEMonitorHistory *FEMonitorHistoryStore::getHistory(const std::string &device, const std::string &point) {
+    pthread_mutex_lock(&mutex_m);
+    FEMonitorHistory *&history = histories_m[Key(device, point)];
+    if (!history)
+        history = new FEMonitorHistory(sizes_m);
+    FEMonitorHistory *ret = history;
+    pthread_mutex_unlock(&mutex_m);
+    return ret;
+}
+
+FEMonitorHistory *FEMonitorHistoryStore::findHistory(const std::string &device, const std::string &point) const {
+    FEMonitorHistory *ret = NULL;
+    pthread_mutex_lock(&mutex_m);
+    map<Key, FEMonitorHistory*>::const_iterator it = histories_m.find(Key(device, point));
+    if (it != histories_m.end())
+        ret = it -> second;
+    pthread_mutex_unlock(&mutex_m);
+    return ret;
+}
+
+void FEMonitorHistoryStore::getNames(std::vector<std::string> &devices, std::vector<std::string> &points) const {
+    devices.clear();
+    points.clear();
+    pthread_mutex_lock(&mutex_m);
+    for (map<Key, FEMonitorHistory*>::const_iterator it = histories_m.begin(); it != histories_m.end(); ++it) {
+        devices.push_back(it -> first.first);
+        points.push_back(it -> first.second);
+    }
+    pthread_mutex_unlock(&mutex_m);
+}
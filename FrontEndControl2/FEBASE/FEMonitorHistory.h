@@ -0,0 +1,180 @@
+#ifndef FEMONITORHISTORY_H_
+#define FEMONITORHISTORY_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2007
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ * In-memory history of monitor point values, raw and rolled up to
+ * 1 s, 1 min and 10 min resolution, and the store of all histories.
+ *
+ *----------------------------------------------------------------------
+ */
+
+#include "timeDef.h"
+#include <pthread.h>
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+/// One entry returned from a history query.  For raw samples min, max and mean are all the value and count is 1.
+struct FEMonitorHistoryEntry {
+    Time timestamp;         ///< time of the sample, or start of the rollup period.
+    float minValue;         ///< smallest value in the period.
+    float maxValue;         ///< largest value in the period.
+    float meanValue;        ///< mean of the values in the period.
+    unsigned long count;    ///< number of samples in the period.
+    int status;             ///< FEMC_ERROR of the sample, or the first which was not FEMC_NO_ERROR in the period.
+};
+
+/// FEMonitorHistory keeps the recent samples of one monitor point in a ring, and rolls them up as they arrive
+/// into rings of min/max/mean at three coarser resolutions.  The monitor thread adds samples and any thread
+/// may query.  Each ring holds a fixed number of entries, so the oldest are overwritten.
+/// The rings are allocated when the first sample is added.
+class FEMonitorHistory {
+public:
+    enum Resolution {
+        RESOLUTION_RAW = 0,         ///< every sample.
+        RESOLUTION_SECOND = 1,      ///< 1 s rollups.
+        RESOLUTION_MINUTE = 2,      ///< 1 min rollups.
+        RESOLUTION_10MINUTES = 3,   ///< 10 min rollups.
+        NUM_RESOLUTIONS = 4
+    };
+
+    enum {
+        RAW_SIZE = 1024,            ///< default samples kept.
+        SECOND_SIZE = 900,          ///< default 1 s rollups kept: 15 minutes.
+        MINUTE_SIZE = 720,          ///< default 1 min rollups kept: 12 hours.
+        TEN_MINUTES_SIZE = 432      ///< default 10 min rollups kept: 3 days.
+    };
+
+    static const Time TICKS_PER_SECOND = 10000000ULL;
+    ///< Time is in 100 ns units.
+
+    FEMonitorHistory(const unsigned *sizes = NULL);
+    ///< sizes gives the entries kept for each Resolution.  NULL for the defaults above.
+    ~FEMonitorHistory();
+
+    void add(Time timestamp, float value, int status);
+    ///< add a sample.  Timestamps must not go backwards.
+
+    unsigned query(Resolution resolution, Time startTime, Time endTime, unsigned maxEntries,
+                   std::vector<FEMonitorHistoryEntry> &target) const;
+    ///< get the entries with timestamps from startTime up to but not including endTime, oldest first.
+    ///< endTime = 0 for up to the latest.  If there are more than maxEntries, the latest maxEntries are returned.
+    ///< Rollups include the one in progress.  Returns the number of entries.
+
+    unsigned long samples() const
+      { return samples_m; }
+    ///< total samples added.
+
+    static Time period(Resolution resolution);
+    ///< length of one rollup, Time units.  0 for RESOLUTION_RAW.
+
+private:
+    // forbid copy construct, assignment:
+    FEMonitorHistory(const FEMonitorHistory &other);
+    FEMonitorHistory &operator =(const FEMonitorHistory &other);
+
+    /// A fixed size ring of entries.  The storage is allocated by the first push.
+    struct Ring {
+        std::vector<FEMonitorHistoryEntry> entries; ///< storage.
+        unsigned size;                              ///< entries to keep.
+        unsigned next;                              ///< where the next entry goes.
+        unsigned count;                             ///< entries in use.
+
+        void reset(unsigned ringSize)
+          { entries.clear(); size = (ringSize) ? ringSize : 1; next = count = 0; }
+
+        void push(const FEMonitorHistoryEntry &entry) {
+            if (entries.empty())
+                entries.resize(size);
+            entries[next] = entry;
+            next = (next + 1) % entries.size();
+            if (count < entries.size())
+                ++count;
+        }
+
+        const FEMonitorHistoryEntry &at(unsigned index) const
+          { return entries[(next + entries.size() - count + index) % entries.size()]; }
+        ///< index 0 is the oldest.
+    };
+
+    /// A rollup being accumulated.
+    struct Rollup {
+        FEMonitorHistoryEntry entry;    ///< the period so far.
+        double sum;                     ///< of the values, for the mean.
+    };
+
+    static void select(const Ring &ring, Time startTime, Time endTime, std::vector<FEMonitorHistoryEntry> &target);
+    ///< append the ring's entries in the time range to target.
+
+    Ring rings_m[NUM_RESOLUTIONS];              ///< one ring per resolution.
+    Rollup rollups_m[NUM_RESOLUTIONS];          ///< the rollup in progress.  Not used for RESOLUTION_RAW.
+    unsigned long samples_m;                    ///< total samples added.
+    mutable pthread_mutex_t mutex_m;            ///< protects all of the above.
+};
+
+/// FEMonitorHistoryStore owns the histories of all monitor points, by device and point name.
+/// Histories outlive the devices that feed them, so that a device which is recreated carries on where it left off.
+class FEMonitorHistoryStore {
+public:
+    static FEMonitorHistoryStore &getInstance();
+    ///< The shared store.  Created on first use.
+
+    static void configure(bool enable, const unsigned *sizes = NULL);
+    ///< Record history for the monitor points which devices register from now on, or not.  Off by default.
+    ///< sizes gives the entries kept for each Resolution in new histories.  NULL for the defaults.
+
+    static bool enabled()
+      { return enabled_m; }
+    ///< true if devices should record history for their monitor points.
+
+    static void deleteInstance();
+    ///< Delete the store and all histories.  Call after all devices have been deleted.
+
+    FEMonitorHistory *getHistory(const std::string &device, const std::string &point);
+    ///< get the history for a point, creating it if needed.
+
+    FEMonitorHistory *findHistory(const std::string &device, const std::string &point) const;
+    ///< get the history for a point, or NULL if there is none.
+
+    void getNames(std::vector<std::string> &devices, std::vector<std::string> &points) const;
+    ///< get the device and point names of all histories, in matching order.
+
+private:
+    FEMonitorHistoryStore();
+    ~FEMonitorHistoryStore();
+
+    // forbid copy construct, assignment:
+    FEMonitorHistoryStore(const FEMonitorHistoryStore &other);
+    FEMonitorHistoryStore &operator =(const FEMonitorHistoryStore &other);
+
+    typedef std::pair<std::string, std::string> Key;    ///< device, point.
+
+    static std::atomic<FEMonitorHistoryStore*> instance_mp; ///< the shared instance.
+    static pthread_mutex_t instanceLock_m;              ///< serializes creating and deleting the instance.
+    static bool enabled_m;                              ///< devices record history.
+    static unsigned sizes_m[FEMonitorHistory::NUM_RESOLUTIONS]; ///< ring sizes for new histories.
+    std::map<Key, FEMonitorHistory*> histories_m;       ///< all histories.
+    mutable pthread_mutex_t mutex_m;                    ///< protects histories_m.
+};
+
+#endif /*FEMONITORHISTORY_H_*/
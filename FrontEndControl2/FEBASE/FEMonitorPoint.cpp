@@ -0,0 +1,70 @@
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2007
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ *----------------------------------------------------------------------
+ */
+
+#include "FEMonitorPoint.h"
+#include <math.h>
+using namespace std;
+using namespace std::chrono;
+
+void FEMonitorPoint::setRate(unsigned long minInterval, unsigned long maxInterval, float deadband) {
+    // at least 1 ms so that doubling gets somewhere:
+    minInterval_m = (minInterval) ? minInterval : 1;
+    maxInterval_m = (maxInterval > minInterval_m) ? maxInterval : minInterval_m;
+    deadband_m = fabs(deadband);
+    stats_m.interval = minInterval_m;
+}
+
+void FEMonitorPoint::setLimits(float lowLimit, float highLimit) {
+    hasLimits_m = true;
+    lowLimit_m = lowLimit;
+    highLimit_m = highLimit;
+}
+
+void FEMonitorPoint::update(float value, Clock::time_point start, Clock::time_point end, bool extra) {
+    if (extra)
+        ++stats_m.extraPolls;
+    else
+        ++stats_m.polls;
+    stats_m.busTime += duration_cast<microseconds>(end - start).count();
+
+    if (!isAdaptive())
+        return;
+
+    bool changed = !haveValue_m || fabs(value - lastValue_m) > deadband_m;
+    bool violated = hasLimits_m && (value < lowLimit_m || value > highLimit_m);
+    if (changed && haveValue_m)
+        ++stats_m.changes;
+    if (violated)
+        ++stats_m.violations;
+    lastValue_m = value;
+    haveValue_m = true;
+
+    // Back to the fastest rate on any change or violation, otherwise slow down:
+    if (changed || violated)
+        stats_m.interval = minInterval_m;
+    else if (stats_m.interval < maxInterval_m)
+        stats_m.interval = (stats_m.interval * 2 < maxInterval_m) ? stats_m.interval * 2 : maxInterval_m;
+
+    due_m = start + milliseconds(stats_m.interval);
+}
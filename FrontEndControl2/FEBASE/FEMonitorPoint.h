@@ -0,0 +1,129 @@
+#ifndef FEMONITORPOINT_H_
+#define FEMONITORPOINT_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2007
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ * One analog monitor point in a device's MONITORS_REGISTRY, with its
+ * adaptive polling rate and statistics.
+ *
+ *----------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <string>
+
+class FEMonitorHistory;
+
+/// Counters kept for each adaptive monitor point.
+struct FEMonitorPointStats {
+    unsigned long polls;            ///< times it was read in its turn.
+    unsigned long extraPolls;       ///< times it was read in the turn of a point which wasn't due.
+    unsigned long skipped;          ///< times its turn came but it wasn't due.
+    unsigned long changes;          ///< reads which moved by more than the deadband.
+    unsigned long violations;       ///< reads outside the limits.
+    unsigned long long busTime;     ///< total time spent reading it, us.
+    unsigned long interval;         ///< its current interval, ms.
+
+    FEMonitorPointStats()
+      : polls(0), extraPolls(0), skipped(0), changes(0), violations(0), busTime(0), interval(0)
+      {}
+
+    unsigned long long savedTime() const
+      { unsigned long reads = polls + extraPolls;
+        return reads ? busTime * skipped / reads : 0; }
+    ///< estimated bus time saved by skipping it, us.
+};
+
+/// A registered monitor point.  Each value read is added to its FEMonitorHistory, if it has one.
+/// By default it is read every time its turn comes around, as before.
+/// After setRate() it is adaptive:  it is read no more often than minInterval and at least every maxInterval.
+/// Each read which stays within the deadband of the last doubles the interval, up to maxInterval.
+/// A read which moves by more than the deadband, or is outside the limits, drops it back to minInterval.
+class FEMonitorPoint {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    FEMonitorPoint(float *target, const char *name, bool isTemporary)
+      : target_p(target),
+        isTemporary(isTemporary),
+        history_p(NULL),
+        name_m((name) ? name : ""),
+        minInterval_m(0),
+        maxInterval_m(0),
+        deadband_m(0.0),
+        hasLimits_m(false),
+        lowLimit_m(0.0),
+        highLimit_m(0.0),
+        lastValue_m(0.0),
+        haveValue_m(false)
+      {}
+
+    float *target_p;                ///< where to put the value read.
+    bool isTemporary;               ///< true if it is to be deleted after it is read.
+    FEMonitorHistory *history_p;    ///< where to record the values read.  Owned by FEMonitorHistoryStore.
+
+    void setRate(unsigned long minInterval, unsigned long maxInterval, float deadband);
+    ///< make it adaptive.  Intervals in ms.
+
+    void setLimits(float lowLimit, float highLimit);
+    ///< read at minInterval whenever the value is outside these limits.
+
+    bool isAdaptive() const
+      { return maxInterval_m != 0; }
+    ///< true if setRate() has been called.
+
+    bool isDue(Clock::time_point now) const
+      { return !isAdaptive() || now >= due_m; }
+    ///< true if it should be read now.
+
+    bool isDueBefore(const FEMonitorPoint &other) const
+      { return due_m < other.due_m; }
+    ///< for finding the most overdue of several adaptive points.
+
+    void skip()
+      { ++stats_m.skipped; }
+    ///< count a turn in which it wasn't read.
+
+    void update(float value, Clock::time_point start, Clock::time_point end, bool extra);
+    ///< record a value read between start and end and choose the next interval.
+    ///< extra if it was read in the turn of another point.
+
+    const std::string &name() const
+      { return name_m; }
+
+    const FEMonitorPointStats &stats() const
+      { return stats_m; }
+
+private:
+    std::string name_m;             ///< for logging and for finding its history.
+    unsigned long minInterval_m;    ///< shortest interval, ms.
+    unsigned long maxInterval_m;    ///< longest interval, ms.  0 if not adaptive.
+    float deadband_m;               ///< changes no larger than this count as stable.
+    bool hasLimits_m;               ///< true if setLimits() was called.
+    float lowLimit_m;               ///< values below this are violations.
+    float highLimit_m;              ///< values above this are violations.
+    float lastValue_m;              ///< the value last read.
+    bool haveValue_m;               ///< true once it has been read.
+    Clock::time_point due_m;        ///< when it is next due.
+    FEMonitorPointStats stats_m;    ///< counters.
+};
+
+#endif /*FEMONITORPOINT_H_*/
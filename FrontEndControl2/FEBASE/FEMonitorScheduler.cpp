@@ -0,0 +1,423 @@
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2007
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ *----------------------------------------------------------------------
+ */
+
+#include "FEMonitorScheduler.h"
+#include "FEHardwareDevice.h"
+#include "logger.h"
+#include "setTimeStamp.h"
+#include "portable.h"
+#include <FrontEndAMB/ambCompletion.h>
+using namespace std;
+using namespace std::chrono;
+
+std::atomic<FEMonitorScheduler*> FEMonitorScheduler::instance_mp(NULL);
+pthread_mutex_t FEMonitorScheduler::instanceLock_m = PTHREAD_MUTEX_INITIALIZER;
+unsigned FEMonitorScheduler::numWorkers_m(DEFAULT_WORKERS);
+
+FEMonitorScheduler &FEMonitorScheduler::getInstance() {
+    FEMonitorScheduler *instance = instance_mp.load();
+    if (!instance) {
+        // Only one thread creates it:
+        pthread_mutex_lock(&instanceLock_m);
+        instance = instance_mp.load();
+        if (!instance) {
+            instance = new FEMonitorScheduler;
+            instance_mp.store(instance);
+        }
+        pthread_mutex_unlock(&instanceLock_m);
+    }
+    return *instance;
+}
+
+void FEMonitorScheduler::deleteInstance() {
+    pthread_mutex_lock(&instanceLock_m);
+    FEMonitorScheduler *instance = instance_mp.exchange(NULL);
+    pthread_mutex_unlock(&instanceLock_m);
+    delete instance;
+}
+
+bool FEMonitorScheduler::isPaused() {
+    // Called from devices, sometimes with our mutex locked, so read without it:
+    FEMonitorScheduler *instance = instance_mp.load();
+    return instance && instance -> paused_m.load();
+}
+
+bool FEMonitorScheduler::isMinimal() {
+    FEMonitorScheduler *instance = instance_mp.load();
+    return instance && instance -> minimal_m.load();
+}
+
+void FEMonitorScheduler::setWorkers(unsigned workers) {
+    numWorkers_m = (workers) ? workers : 1;
+}
+
+FEMonitorScheduler::FEMonitorScheduler()
+  : start_m(Clock::now()),
+    tick_m(0),
+    running_m(0),
+    started_m(false),
+    stop_m(false),
+    paused_m(false),
+    minimal_m(false)
+{
+    pthread_mutex_init(&mutex_m, NULL);
+    sem_init(&wake_m, 0, 0);
+    sem_init(&readySignal_m, 0, 0);
+    pthread_cond_init(&idle_m, NULL);
+}
+
+FEMonitorScheduler::~FEMonitorScheduler() {
+    stop();
+    for (map<FEHardwareDevice*, Entry*>::iterator it = entries_m.begin(); it != entries_m.end(); ++it)
+        delete it -> second;
+    entries_m.clear();
+    pthread_cond_destroy(&idle_m);
+    sem_destroy(&readySignal_m);
+    sem_destroy(&wake_m);
+    pthread_mutex_destroy(&mutex_m);
+}
+
+void FEMonitorScheduler::add(FEHardwareDevice &device) {
+    pthread_mutex_lock(&mutex_m);
+    if (entries_m.find(&device) != entries_m.end()) {
+        pthread_mutex_unlock(&mutex_m);
+        return;
+    }
+    // The timer thread doesn't advance the wheel while no devices are registered.  Catch up before the first:
+    if (entries_m.empty())
+        tick_m = currentTick();
+    Entry *entry = new Entry;
+    entry -> device_p = &device;
+    entry -> tick = tick_m;
+    entry -> queued = false;
+    entry -> running = false;
+    entry -> removed = false;
+    entry -> waiter = false;
+    entry -> hurry = false;
+    entries_m[&device] = entry;
+    ++stats_m.devices;
+    insert(entry);
+    bool wasIdle = (stats_m.devices == 1);
+    if (!started_m)
+        start();
+    pthread_mutex_unlock(&mutex_m);
+
+    // The timer thread sleeps while no devices are registered:
+    if (wasIdle)
+        sem_post(&wake_m);
+}
+
+void FEMonitorScheduler::remove(FEHardwareDevice &device) {
+    pthread_mutex_lock(&mutex_m);
+    map<FEHardwareDevice*, Entry*>::iterator it = entries_m.find(&device);
+    if (it == entries_m.end()) {
+        pthread_mutex_unlock(&mutex_m);
+        return;
+    }
+    Entry *entry = it -> second;
+    entries_m.erase(it);
+    --stats_m.devices;
+    entry -> removed = true;
+    if (entry -> queued)
+        unqueue(entry);
+    if (!entry -> running) {
+        delete entry;
+        pthread_mutex_unlock(&mutex_m);
+        return;
+    }
+    // A worker is in its monitorAction().  If that is us, the worker deletes the entry when we return:
+    bool self = pthread_equal(entry -> runner, pthread_self());
+    entry -> waiter = !self;
+    if (!self) {
+        // Otherwise wait for the worker to let go of the device:
+        while (entry -> running)
+            pthread_cond_wait(&idle_m, &mutex_m);
+        delete entry;
+    }
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void FEMonitorScheduler::hurry(FEHardwareDevice &device) {
+    pthread_mutex_lock(&mutex_m);
+    map<FEHardwareDevice*, Entry*>::iterator it = entries_m.find(&device);
+    if (it != entries_m.end())
+        hurry(it -> second);
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void FEMonitorScheduler::pauseAll(bool pause, const char *reason) {
+    pthread_mutex_lock(&mutex_m);
+    bool changed = (paused_m.exchange(pause) != pause);
+    pthread_mutex_unlock(&mutex_m);
+    if (changed)
+        LOG(LM_INFO) << "FEMonitorScheduler: " << ((pause) ? "paused monitoring of all devices. " : "resumed monitoring of all devices. ")
+                     << (reason ? reason : "") << endl;
+}
+
+void FEMonitorScheduler::minimalAll(bool minimal, const char *reason) {
+    pthread_mutex_lock(&mutex_m);
+    bool changed = (minimal_m.exchange(minimal) != minimal);
+    if (changed) {
+        // Every device's interval may have changed:
+        for (map<FEHardwareDevice*, Entry*>::iterator it = entries_m.begin(); it != entries_m.end(); ++it)
+            hurry(it -> second);
+    }
+    pthread_mutex_unlock(&mutex_m);
+    if (changed)
+        LOG(LM_INFO) << "FEMonitorScheduler: " << ((minimal) ? "minimal monitoring of all devices. " : "normal monitoring of all devices. ")
+                     << (reason ? reason : "") << endl;
+}
+
+void FEMonitorScheduler::getStats(FEMonitorSchedulerStats &target) const {
+    pthread_mutex_lock(&mutex_m);
+    target = stats_m;
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void FEMonitorScheduler::resetStats() {
+    pthread_mutex_lock(&mutex_m);
+    unsigned long devices = stats_m.devices;
+    unsigned long workers = stats_m.workers;
+    stats_m = FEMonitorSchedulerStats();
+    stats_m.devices = devices;
+    stats_m.workers = workers;
+    pthread_mutex_unlock(&mutex_m);
+}
+
+// --------------------------------------------------------------------------
+//private:
+
+unsigned long long FEMonitorScheduler::currentTick() const {
+    return duration_cast<milliseconds>(Clock::now() - start_m).count() / TICK_MS;
+}
+
+void FEMonitorScheduler::start() {
+    LOG(LM_INFO) << "FEMonitorScheduler: starting timer thread and " << numWorkers_m << " worker threads..." << endl;
+    stop_m = false;
+    started_m = true;
+    stats_m.workers = numWorkers_m;
+    pthread_t thread;
+    pthread_create(&thread, NULL, reinterpret_cast<void*(*)(void*)>(timerThread), this);
+    pthread_detach(thread);
+    ++running_m;
+    for (unsigned index = 0; index < numWorkers_m; ++index) {
+        pthread_create(&thread, NULL, reinterpret_cast<void*(*)(void*)>(workerThread), this);
+        pthread_detach(thread);
+        ++running_m;
+    }
+}
+
+void FEMonitorScheduler::stop() {
+    pthread_mutex_lock(&mutex_m);
+    bool started = started_m;
+    unsigned workers = stats_m.workers;
+    stop_m = true;
+    pthread_mutex_unlock(&mutex_m);
+    if (!started)
+        return;
+
+    LOG(LM_INFO) << "FEMonitorScheduler: stopping threads..." << endl;
+    // Wake all the threads and wait for them to exit:
+    sem_post(&wake_m);
+    for (unsigned index = 0; index < workers; ++index)
+        sem_post(&readySignal_m);
+    pthread_mutex_lock(&mutex_m);
+    while (running_m != 0)
+        pthread_cond_wait(&idle_m, &mutex_m);
+    started_m = false;
+    stats_m.workers = 0;
+    pthread_mutex_unlock(&mutex_m);
+}
+
+void FEMonitorScheduler::insert(Entry *entry) {
+    if (entry -> tick <= tick_m)
+        makeReady(entry);
+    else {
+        // Intervals longer than the wheel wait in their slot until it comes around for the last time:
+        wheel_m[entry -> tick & (SLOTS - 1)].push_back(entry);
+        entry -> queued = true;
+    }
+}
+
+void FEMonitorScheduler::unqueue(Entry *entry) {
+    entry -> queued = false;
+    if (entry -> tick > tick_m) {
+        wheel_m[entry -> tick & (SLOTS - 1)].remove(entry);
+        return;
+    }
+    for (ReadyQueue::iterator it = ready_m.begin(); it != ready_m.end(); ++it) {
+        if (it -> second == entry) {
+            ready_m.erase(it);
+            // The worker which takes the extra post finds nothing ready and waits again.
+            return;
+        }
+    }
+}
+
+void FEMonitorScheduler::hurry(Entry *entry) {
+    if (entry -> running)
+        entry -> hurry = true;
+    else if (entry -> queued && entry -> tick > tick_m) {
+        unqueue(entry);
+        entry -> tick = tick_m;
+        insert(entry);
+    }
+}
+
+void FEMonitorScheduler::makeReady(Entry *entry) {
+    ready_m.insert(ReadyQueue::value_type(entry -> device_p -> monitorPriority_m, entry));
+    entry -> queued = true;
+    sem_post(&readySignal_m);
+}
+
+void FEMonitorScheduler::advance(unsigned long long toTick) {
+    while (tick_m < toTick) {
+        ++tick_m;
+        list<Entry*> &slot = wheel_m[tick_m & (SLOTS - 1)];
+        list<Entry*>::iterator it = slot.begin();
+        while (it != slot.end()) {
+            Entry *entry = *it;
+            if (entry -> tick <= tick_m) {
+                it = slot.erase(it);
+                makeReady(entry);
+            } else
+                ++it;
+        }
+    }
+}
+
+void FEMonitorScheduler::run(Entry *entry, bool paused) {
+    FEHardwareDevice *device = entry -> device_p;
+    if (!paused) {
+        Time timestamp;
+        setTimeStamp(&timestamp);
+        device -> monitorAction(&timestamp);
+        // check if we should stop because of too many errors:
+        device -> checkExceededErrorCount();
+    }
+
+    pthread_mutex_lock(&mutex_m);
+    entry -> running = false;
+    if (entry -> removed) {
+        // Removed while running.  A remover waiting for us deletes it, otherwise we do:
+        if (entry -> waiter)
+            pthread_cond_broadcast(&idle_m);
+        else
+            delete entry;
+        pthread_mutex_unlock(&mutex_m);
+        return;
+    }
+    // Due again one interval after it was due, or now if it fell behind or was hurried:
+    unsigned long long due = entry -> tick + interval(entry);
+    if (entry -> hurry || due <= tick_m)
+        due = tick_m;
+    entry -> hurry = false;
+    entry -> tick = due;
+    insert(entry);
+    pthread_mutex_unlock(&mutex_m);
+}
+
+unsigned long FEMonitorScheduler::interval(const Entry *entry) const {
+    const FEHardwareDevice *device = entry -> device_p;
+    unsigned long ms = (device -> isMinimalMonitoring()) ? device -> minimalMonitorInterval_m : device -> monitorInterval_m;
+    unsigned long ticks = (ms + TICK_MS - 1) / TICK_MS;
+    return (ticks) ? ticks : 1;
+}
+
+void *FEMonitorScheduler::timerThread(FEMonitorScheduler *owner) {
+    if (!owner)
+        return NULL;
+    LOG(LM_TRACE) << "FEMonitorScheduler: in timer thread." << endl;
+    while (true) {
+        pthread_mutex_lock(&(owner -> mutex_m));
+        bool stop = owner -> stop_m;
+        if (!stop)
+            owner -> advance(owner -> currentTick());
+        bool empty = owner -> entries_m.empty();
+        pthread_mutex_unlock(&(owner -> mutex_m));
+
+        if (stop)
+            break;
+        if (empty)
+            // Nothing registered.  Sleep until something is added:
+            sem_wait(&(owner -> wake_m));
+        else
+            SLEEP(TICK_MS);
+    }
+    LOG(LM_TRACE) << "FEMonitorScheduler: exiting timer thread." << endl;
+    pthread_mutex_lock(&(owner -> mutex_m));
+    --(owner -> running_m);
+    pthread_cond_broadcast(&(owner -> idle_m));
+    pthread_mutex_unlock(&(owner -> mutex_m));
+    return NULL;
+}
+
+void *FEMonitorScheduler::workerThread(FEMonitorScheduler *owner) {
+    if (!owner)
+        return NULL;
+    LOG(LM_TRACE) << "FEMonitorScheduler: in worker thread." << endl;
+
+    while (true) {
+        sem_wait(&(owner -> readySignal_m));
+        pthread_mutex_lock(&(owner -> mutex_m));
+        if (owner -> stop_m) {
+            pthread_mutex_unlock(&(owner -> mutex_m));
+            break;
+        }
+        if (owner -> ready_m.empty()) {
+            // It was removed after it was made ready:
+            pthread_mutex_unlock(&(owner -> mutex_m));
+            continue;
+        }
+        Entry *entry = owner -> ready_m.begin() -> second;
+        owner -> ready_m.erase(owner -> ready_m.begin());
+        entry -> queued = false;
+        entry -> running = true;
+        entry -> runner = pthread_self();
+        FEMonitorSchedulerStats &stats = owner -> stats_m;
+        bool paused = owner -> paused_m || entry -> device_p -> paused_m;
+        if (paused)
+            ++stats.skipped;
+        else
+            ++stats.dispatched;
+        unsigned long late = (unsigned long) (owner -> currentTick() - entry -> tick) * TICK_MS;
+        if (late > TICK_MS) {
+            ++stats.late;
+            if (late > stats.maxLate)
+                stats.maxLate = late;
+        }
+        pthread_mutex_unlock(&(owner -> mutex_m));
+
+        // Monitoring yields to interactive and measurement transactions, and stale requests are dropped.
+        // Set for each dispatch, so that changes to the monitor deadline take effect at once:
+        ambSetThreadPriority(AMB_PRIORITY_BACKGROUND, FEHardwareDevice::getMonitorDeadline());
+        owner -> run(entry, paused);
+    }
+    LOG(LM_TRACE) << "FEMonitorScheduler: exiting worker thread." << endl;
+    pthread_mutex_lock(&(owner -> mutex_m));
+    --(owner -> running_m);
+    pthread_cond_broadcast(&(owner -> idle_m));
+    pthread_mutex_unlock(&(owner -> mutex_m));
+    return NULL;
+}
@@ -0,0 +1,196 @@
+#ifndef FEMONITORSCHEDULER_H_
+#define FEMONITORSCHEDULER_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2007
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ * The monitor scheduler shared by all FEHardwareDevices.
+ *
+ *----------------------------------------------------------------------
+ */
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <map>
+
+class FEHardwareDevice;
+
+/// Counters kept by FEMonitorScheduler.
+struct FEMonitorSchedulerStats {
+    unsigned long devices;          ///< devices registered.
+    unsigned long workers;          ///< worker threads.
+    unsigned long dispatched;       ///< calls made to monitorAction().
+    unsigned long skipped;          ///< times a device was due but paused.
+    unsigned long late;             ///< dispatches which started more than a tick after they were due.
+    unsigned long maxLate;          ///< largest lateness, ms.
+
+    FEMonitorSchedulerStats()
+      : devices(0), workers(0), dispatched(0), skipped(0), late(0), maxLate(0)
+      {}
+};
+
+/// FEMonitorScheduler calls each started device's monitorAction() at the rate the device declared
+/// with FEHardwareDevice::setMonitorRate().  It replaces a thread per device which woke every 5 ms.
+///
+/// Devices wait in a timer wheel of TICK_MS ticks.  A single timer thread advances the wheel and moves
+/// devices which are due onto a ready queue, highest priority first.  A small pool of worker threads
+/// takes devices from the queue and calls monitorAction(), so that several devices can have transactions
+/// on the bus at once.  A device is never run by more than one worker at a time.  After each call it is
+/// put back in the wheel one interval after it was due.
+///
+/// Monitoring may be paused or reduced to minimal for all devices at once, in addition to each device's
+/// own pauseMonitor() and minimalMonitor().
+class FEMonitorScheduler {
+public:
+    enum {
+        TICK_MS = 5,            ///< resolution of the wheel, ms.
+        SLOTS = 256,            ///< slots in the wheel.  It spans 1.28 s; longer intervals go around more than once.
+        DEFAULT_WORKERS = 4     ///< worker threads unless setWorkers() is called first.
+    };
+
+    /// Priorities for ordering devices which are due on the same tick.
+    enum Priority {
+        PRIORITY_LOW = 0,       ///< housekeeping: AMBSI status, power supplies, switches.
+        PRIORITY_NORMAL = 1,    ///< subsystem monitoring.
+        PRIORITY_HIGH = 2       ///< cartridge bias and LO, interlocks.
+    };
+
+    static FEMonitorScheduler &getInstance();
+    ///< The shared scheduler.  Created on first use.
+
+    static void deleteInstance();
+    ///< Stop the threads and delete the shared scheduler.  Call after all devices have stopped monitoring.
+
+    static void setWorkers(unsigned workers);
+    ///< Set the number of worker threads.  Takes effect when the threads are next started.
+
+    void add(FEHardwareDevice &device);
+    ///< Start calling the device's monitorAction().  It is due at once.  Starts the threads if needed.
+
+    void remove(FEHardwareDevice &device);
+    ///< Stop calling the device's monitorAction().  If a worker is in it, waits for it to return,
+    ///< unless called from monitorAction() itself.
+
+    void hurry(FEHardwareDevice &device);
+    ///< Make the device due at once, for when its rate or mode has changed.
+
+    void pauseAll(bool pause, const char *reason = NULL);
+    ///< Pause/resume monitoring of all devices.  Each device's own pause is unaffected.
+
+    void minimalAll(bool minimal, const char *reason = NULL);
+    ///< Reduce monitoring of all devices to the minimum if true.  Each device's own setting is unaffected.
+
+    static bool isPaused();
+    ///< true if monitoring of all devices is paused.
+
+    static bool isMinimal();
+    ///< true if monitoring of all devices is minimal.
+
+    void getStats(FEMonitorSchedulerStats &target) const;
+    ///< Get the counters.
+
+    void resetStats();
+    ///< Zero the counters.
+
+private:
+    FEMonitorScheduler();
+    ~FEMonitorScheduler();
+
+    // forbid copy construct, assignment:
+    FEMonitorScheduler(const FEMonitorScheduler &other);
+    FEMonitorScheduler &operator =(const FEMonitorScheduler &other);
+
+    typedef std::chrono::steady_clock Clock;
+
+    /// A registered device.
+    struct Entry {
+        FEHardwareDevice *device_p;     ///< the device to run.
+        unsigned long long tick;        ///< when it is next due.
+        bool queued;                    ///< true while in the wheel or on the ready queue.
+        bool running;                   ///< true while a worker is in its monitorAction().
+        bool removed;                   ///< true once removed while running.
+        bool waiter;                    ///< true if the remover is waiting to delete it.  Otherwise the worker does.
+        bool hurry;                     ///< true to make it due at once after the current run.
+        pthread_t runner;               ///< the worker running it.
+    };
+
+    typedef std::multimap<int, Entry*, std::greater<int> > ReadyQueue;
+
+    unsigned long long currentTick() const;
+    ///< ticks elapsed since start_m.
+
+    void start();
+    ///< Start the threads.  Mutex locked.
+
+    void stop();
+    ///< Stop the threads and wait for them to exit.  Mutex NOT locked.
+
+    void insert(Entry *entry);
+    ///< put an entry in the wheel or, if its tick has arrived, on the ready queue.  Mutex locked.
+
+    void unqueue(Entry *entry);
+    ///< take an entry out of the wheel or the ready queue.  Mutex locked.
+
+    void hurry(Entry *entry);
+    ///< make an entry due at once, or after its current run.  Mutex locked.
+
+    void makeReady(Entry *entry);
+    ///< put an entry on the ready queue and wake a worker.  Mutex locked.
+
+    void advance(unsigned long long toTick);
+    ///< move the wheel forward, making devices which are due ready.  Mutex locked.
+
+    void run(Entry *entry, bool paused);
+    ///< call the entry's monitorAction() unless paused, then put it back in the wheel.  Mutex NOT locked.
+
+    unsigned long interval(const Entry *entry) const;
+    ///< the entry's current interval, in ticks.
+
+    static void *timerThread(FEMonitorScheduler *owner);
+    ///< The function which the timer thread runs.
+
+    static void *workerThread(FEMonitorScheduler *owner);
+    ///< The function which each worker thread runs.
+
+    static std::atomic<FEMonitorScheduler*> instance_mp; ///< the shared instance.
+    static pthread_mutex_t instanceLock_m;  ///< serializes creating and deleting the instance.
+    static unsigned numWorkers_m;           ///< worker threads to start.
+
+    Clock::time_point start_m;              ///< time of tick zero.
+    unsigned long long tick_m;              ///< the tick the wheel has been advanced to.
+    std::list<Entry*> wheel_m[SLOTS];       ///< the wheel.
+    ReadyQueue ready_m;                     ///< devices which are due, by priority.
+    std::map<FEHardwareDevice*, Entry*> entries_m; ///< all registered devices.
+    FEMonitorSchedulerStats stats_m;        ///< counters.
+    mutable pthread_mutex_t mutex_m;        ///< protects all of the above.
+    sem_t wake_m;                           ///< posted to wake the timer thread when a device is added.
+    sem_t readySignal_m;                    ///< posted for each device made ready, and to stop the workers.
+    pthread_cond_t idle_m;                  ///< signalled when a removed device's run ends and when a thread exits.
+    unsigned running_m;                     ///< count of threads running.
+    bool started_m;                         ///< true once the threads have been created.
+    bool stop_m;                            ///< true tells the threads to exit.
+    std::atomic<bool> paused_m;             ///< true if all monitoring is paused.  Written with the mutex locked.
+    std::atomic<bool> minimal_m;            ///< true if all monitoring is minimal.  Written with the mutex locked.
+};
+
+#endif /*FEMONITORSCHEDULER_H_*/
@@ -0,0 +1,101 @@
+#ifndef FEMONITORSNAPSHOT_H_
+#define FEMONITORSNAPSHOT_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2007
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ * A versioned snapshot of one group of monitor values, published by the
+ * monitor thread and copied by any number of readers without locking.
+ *
+ *----------------------------------------------------------------------
+ */
+
+#include "FrontEndAMB/femcDefs.h"
+#include "timeDef.h"
+#include <atomic>
+#include <string.h>
+
+/// FEMonitorSnapshot<T> holds the latest copy of a monitor structure T, with the time it was acquired,
+/// a status, and a version which counts publications.  T must be plain data which can be copied with memcpy.
+///
+/// It is a sequence lock: the writer makes the sequence odd, copies in, then makes it even again.
+/// A reader copies out between two reads of the sequence and tries again if it changed or was odd.
+/// The writer never waits and a reader only repeats its copy if it overlapped a publish.
+/// There must be only one writer at a time, which the monitor scheduler ensures for each device.
+template<class T>
+class FEMonitorSnapshot {
+public:
+    FEMonitorSnapshot()
+      : sequence_m(0),
+        timestamp_m(0),
+        status_m(FEMC_NO_ERROR)
+      { memset(&data_m, 0, sizeof(data_m)); }
+
+    void publish(const T &data, Time timestamp, int status = FEMC_NO_ERROR) {
+        unsigned long sequence = sequence_m.load(std::memory_order_relaxed);
+        sequence_m.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&data_m, &data, sizeof(data_m));
+        timestamp_m = timestamp;
+        status_m = status;
+        sequence_m.store(sequence + 2, std::memory_order_release);
+    }
+    ///< publish a new snapshot.  Only the monitor thread may call this.
+
+    unsigned long read(T &target, Time *timestamp_p = NULL, int *status_p = NULL) const {
+        unsigned long before, after;
+        Time timestamp;
+        int status;
+        do {
+            before = sequence_m.load(std::memory_order_acquire);
+            memcpy(&target, &data_m, sizeof(data_m));
+            timestamp = timestamp_m;
+            status = status_m;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence_m.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        if (timestamp_p)
+            *timestamp_p = timestamp;
+        if (status_p)
+            *status_p = status;
+        return before / 2;
+    }
+    ///< copy out a consistent snapshot.  Returns its version, which is 0 if nothing has been published.
+
+    unsigned long version() const
+      { return sequence_m.load(std::memory_order_acquire) / 2; }
+    ///< the number of snapshots published so far.
+
+    static int combineStatus(int status, int next)
+      { return (status != FEMC_NO_ERROR) ? status : next; }
+    ///< accumulate the status of a group of monitor points: the first which is not FEMC_NO_ERROR.
+
+private:
+    // forbid copy construct, assignment:
+    FEMonitorSnapshot(const FEMonitorSnapshot &other);
+    FEMonitorSnapshot &operator =(const FEMonitorSnapshot &other);
+
+    std::atomic<unsigned long> sequence_m;  ///< odd while a publish is in progress.  Twice the version.
+    T data_m;                               ///< the monitor values.
+    Time timestamp_m;                       ///< when the values were acquired.
+    int status_m;                           ///< FEMC_ERROR of the group: FEMC_NO_ERROR if all points were read OK.
+};
+
+#endif /*FEMONITORSNAPSHOT_H_*/
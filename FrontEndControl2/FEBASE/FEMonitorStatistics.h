@@ -0,0 +1,67 @@
+#ifndef FEMONITORSTATISTICS_H_
+#define FEMONITORSTATISTICS_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2007
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+
+/************************************************************************
+ * Running statistics of repeated readings of a monitor point.
+ *
+ *----------------------------------------------------------------------
+ */
+
+#include <math.h>
+
+/// Mean, standard deviation, and range of a series of readings, updated one reading at a time.
+/// Uses Welford's method so that the variance doesn't lose precision when the readings are close together.
+struct FEMonitorStatistics {
+    unsigned count;                 ///< number of readings added.
+    double mean;                    ///< mean of the readings.
+    double m2;                      ///< sum of squared differences from the mean.
+    float minValue;                 ///< smallest reading.
+    float maxValue;                 ///< largest reading.
+
+    FEMonitorStatistics()
+      { reset(); }
+
+    void reset()
+      { count = 0; mean = m2 = 0.0; minValue = maxValue = 0.0; }
+
+    void add(float value) {
+        ++count;
+        double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+        if (count == 1 || value < minValue)
+            minValue = value;
+        if (count == 1 || value > maxValue)
+            maxValue = value;
+    }
+
+    double variance() const
+      { return (count > 1) ? m2 / (count - 1) : 0.0; }
+    ///< sample variance, or 0 if there are fewer than two readings.
+
+    double stdDev() const
+      { return sqrt(variance()); }
+    ///< sample standard deviation.
+};
+
+#endif /*FEMONITORSTATISTICS_H_*/
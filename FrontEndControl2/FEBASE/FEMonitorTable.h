@@ -0,0 +1,116 @@
+#ifndef FEMONITORTABLE_H_
+#define FEMONITORTABLE_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2007
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ * Compile-time tables describing the analog monitor points of a device,
+ * used to fill its MONITORS_REGISTRY.
+ *
+ *----------------------------------------------------------------------
+ */
+
+#include <FrontEndAMB/ambDefs.h>
+#include <stdio.h>
+#include <string>
+
+/// How a monitor point's payload is packed on the bus.  All are returned to the registry as float.
+enum FEMonitorWireType {
+    FEMON_WIRE_FLOAT,               ///< 4-byte float.
+    FEMON_WIRE_BOOL,                ///< 1-byte boolean.
+    FEMON_WIRE_UCHAR,               ///< 1-byte unsigned integer.
+    FEMON_WIRE_USHORT               ///< 2-byte unsigned integer.
+};
+
+/// The default polling rate of a monitor point.  See FEMonitorPoint::setRate().
+enum FEMonitorRateClass {
+    FEMON_RATE_EVERY_PASS,          ///< read every time its turn comes around.
+    FEMON_RATE_THERMAL,             ///< temperatures and heater currents which drift slowly:  1 to 10 s.
+    FEMON_RATE_LOCK                 ///< PLL lock and correction voltages:  30 ms to 2 s.
+};
+
+/// The intervals of a rate class, ms.  maxInterval = 0 for FEMON_RATE_EVERY_PASS.
+struct FEMonitorRate {
+    unsigned long minInterval;
+    unsigned long maxInterval;
+};
+
+constexpr FEMonitorRate feMonitorRate(FEMonitorRateClass rateClass) {
+    return (rateClass == FEMON_RATE_THERMAL) ? FEMonitorRate{ 1000, 10000 }
+         : (rateClass == FEMON_RATE_LOCK) ? FEMonitorRate{ 30, 2000 }
+         : FEMonitorRate{ 0, 0 };
+}
+
+/// Everything about a monitor point which doesn't depend on the device class.
+struct FEMonitorDef {
+    const char *name;               ///< point name, for the monitor history and statistics.
+    const char *logText;            ///< text for the transaction log.
+    AmbRelativeAddr offset;         ///< RCA relative to the device's base RCA.
+    FEMonitorWireType wireType;     ///< how the payload is packed.
+    FEMonitorRateClass rateClass;   ///< default polling rate.
+    float deadband;                 ///< for adaptive rate classes, changes no larger than this count as stable.
+    unsigned features;              ///< device features the point needs.  Points the device lacks are not registered.
+    int average;                    ///< number of readings to average.  FEMON_WIRE_FLOAT only.
+    const char *thermalColumn;      ///< header of its column in the thermal log, or NULL if not logged.
+};
+
+/// One row in a device's table of monitor points.  CLASS is the class holding its NAME_value and NAME_status members.
+template<class CLASS>
+struct FEMonitorTableEntry {
+    FEMonitorDef def;
+    float CLASS::*value;            ///< where the registry puts the value read.
+    int CLASS::*status;             ///< where the registry puts the status of the read.
+};
+
+/// Make a table row following the MonCtrlMacros naming convention:  the point NAME has members NAME_value and NAME_status.
+#define FEMON_TABLE_ENTRY(CLASS, NAME, TEXT, OFFSET, WIRE, RATE, DEADBAND, FEATURES, AVERAGE, THERMAL) \
+    { { #NAME, TEXT, OFFSET, WIRE, RATE, DEADBAND, FEATURES, AVERAGE, THERMAL }, &CLASS::NAME##_value, &CLASS::NAME##_status }
+
+/// Thermal log helpers.  The columns are those rows of the table having a thermalColumn, in table order.
+template<class CLASS>
+void appendTableThermalLogHeader(const FEMonitorTableEntry<CLASS> *table, unsigned count, std::string &target) {
+    for (unsigned index = 0; index < count; ++index) {
+        if (table[index].def.thermalColumn) {
+            target += "\t";
+            target += table[index].def.thermalColumn;
+        }
+    }
+}
+
+template<class DEVICE, class CLASS>
+void appendTableThermalLog(const DEVICE &device, const FEMonitorTableEntry<CLASS> *table, unsigned count, std::string &target) {
+    char buf[20];
+    for (unsigned index = 0; index < count; ++index) {
+        if (table[index].def.thermalColumn) {
+            sprintf(buf, "\t%.2f", device.*(table[index].value));
+            target += buf;
+        }
+    }
+}
+
+template<class CLASS>
+void appendTableThermalLogPlaceholder(const FEMonitorTableEntry<CLASS> *table, unsigned count, std::string &target) {
+    for (unsigned index = 0; index < count; ++index) {
+        if (table[index].def.thermalColumn)
+            target += "\t0";
+    }
+}
+
+#endif /*FEMONITORTABLE_H_*/
@@ -83,6 +83,9 @@ FETIMImplBase::FETIMImplBase(const std::string &name)
     lastMonitorTime(0),
     monitorPhase(0)
 {
+    // monitorAction() every 20 ms:
+    setMonitorRate(20, 0, FEMonitorScheduler::PRIORITY_HIGH);
+
     baseRCA = 0xE000;
     internalTemperature1_RCA            = baseRCA + FETIM_INTRLK_SENS_INT_TEMP + 0x0;
     internalTemperature2_RCA            = baseRCA + FETIM_INTRLK_SENS_INT_TEMP + 0x1;
@@ -110,24 +113,25 @@ FETIMImplBase::FETIMImplBase(const std::string &name)
     getCompressorCableStatus_RCA        = baseRCA + FETIM_COMP_CABLE_STATUS;
     setTriggerDewarN2Fill_RCA           = baseRCA + FETIM_COMP_DEWAR_N2_FILL;
 
-    addMon(&internalTemperature1_value, &FETIMImplBase::internalTemperature1);
-    addMon(&internalTemperature2_value, &FETIMImplBase::internalTemperature2);
-    addMon(&internalTemperature3_value, &FETIMImplBase::internalTemperature3);
-    addMon(&internalTemperature4_value, &FETIMImplBase::internalTemperature4);
-    addMon(&internalTemperature5_value, &FETIMImplBase::internalTemperature5);
-    addMon(&externalTemperature1_value, &FETIMImplBase::externalTemperature1);
-    addMon(&externalTemperature2_value, &FETIMImplBase::externalTemperature2);
-    addMon(&getAirflowSensor1_value, &FETIMImplBase::getAirflowSensor1);
-    addMon(&getAirflowSensor2_value, &FETIMImplBase::getAirflowSensor2);
-    addMon(&heliumBufferPressure_value, &FETIMImplBase::heliumBufferPressure);
-    addMon(&glitchValue_value, &FETIMImplBase::glitchValue);
-
-    nextMon = monitorRegistry.begin();
+    addMon(&internalTemperature1_value, &FETIMImplBase::internalTemperature1, "internalTemperature1");
+    addMon(&internalTemperature2_value, &FETIMImplBase::internalTemperature2, "internalTemperature2");
+    addMon(&internalTemperature3_value, &FETIMImplBase::internalTemperature3, "internalTemperature3");
+    addMon(&internalTemperature4_value, &FETIMImplBase::internalTemperature4, "internalTemperature4");
+    addMon(&internalTemperature5_value, &FETIMImplBase::internalTemperature5, "internalTemperature5");
+    addMon(&externalTemperature1_value, &FETIMImplBase::externalTemperature1, "externalTemperature1");
+    addMon(&externalTemperature2_value, &FETIMImplBase::externalTemperature2, "externalTemperature2");
+    addMon(&getAirflowSensor1_value, &FETIMImplBase::getAirflowSensor1, "getAirflowSensor1");
+    addMon(&getAirflowSensor2_value, &FETIMImplBase::getAirflowSensor2, "getAirflowSensor2");
+    addMon(&heliumBufferPressure_value, &FETIMImplBase::heliumBufferPressure, "heliumBufferPressure");
+    addMon(&glitchValue_value, &FETIMImplBase::glitchValue, "glitchValue");
+
+    nextMon = 0;
 }
 
 void FETIMImplBase::initialize(unsigned long channel, unsigned long nodeAddress) {
     m_channel = channel;
     m_nodeAddress = nodeAddress;
+    initializeSubsystemBreaker(baseRCA);
 }
 
 void FETIMImplBase::shutdown() {
@@ -233,61 +237,58 @@ void FETIMImplBase::setTriggerDewarN2Fill(bool val) {
     SYNCCMD_LOG_BOOL(setTriggerDewarN2Fill, val, "FETIM_COMP_DEWAR_N2_FILL")
 }
 
+void FETIMImplBase::monitorStatusBatch() {
+    static const unsigned count = 13;
+    AmbRelativeAddr RCAs[count] = {
+        internalTemperatureOOR_RCA, externalTemperatureOOR1_RCA, externalTemperatureOOR2_RCA,
+        airflowSensorOOR_RCA, heliumBufferPressureOOR_RCA,
+        sensorSingleFailed_RCA, sensorMultiFailed_RCA, glitchCounterTriggered_RCA,
+        delayShutdownTriggered_RCA, finalShutdownTriggered_RCA,
+        getCompressorStatus_RCA, getCompressorInterlockStatus_RCA, getCompressorCableStatus_RCA
+    };
+    AmbMonitorResult_t results[count];
+    syncMonitorBatch(count, RCAs, results);
+    BATCHMON_LOG_BOOL(internalTemperatureOOR, results[0], internalTemperatureOOR_value, "FETIM_INTRLK_SENS_INT_TEMP_OOR")
+    BATCHMON_LOG_BOOL(externalTemperatureOOR1, results[1], externalTemperatureOOR1_value, "FETIM_COMP_EXT_TEMP_OOR1")
+    BATCHMON_LOG_BOOL(externalTemperatureOOR2, results[2], externalTemperatureOOR2_value, "FETIM_COMP_EXT_TEMP_OOR2")
+    BATCHMON_LOG_BOOL(airflowSensorOOR, results[3], airflowSensorOOR_value, "FETIM_INTRLK_SENS_FLOW_OOR")
+    BATCHMON_LOG_BOOL(heliumBufferPressureOOR, results[4], heliumBufferPressureOOR_value, "FETIM_COMP_HE2_PRESS_OOR")
+    BATCHMON_LOG_BOOL(sensorSingleFailed, results[5], sensorSingleFailed_value, "FETIM_INTRLK_SENS_SINGLE_FAIL")
+    BATCHMON_LOG_BOOL(sensorMultiFailed, results[6], sensorMultiFailed_value, "FETIM_INTRLK_SENS_MULT_FAIL")
+    BATCHMON_LOG_BOOL(glitchCounterTriggered, results[7], glitchCounterTriggered_value, "FETIM_INTRLK_GLITCH_CNT_TRIG")
+    BATCHMON_LOG_BOOL(delayShutdownTriggered, results[8], delayShutdownTriggered_value, "FETIM_INTRLK_DELAY_TRIG")
+    BATCHMON_LOG_BOOL(finalShutdownTriggered, results[9], finalShutdownTriggered_value, "FETIM_INTRLK_SHUTDOWN_TRIG")
+    BATCHMON_LOG_BOOL(getCompressorStatus, results[10], getCompressorStatus_value, "FETIM_COMP_FE_STATUS")
+    BATCHMON_LOG_BOOL(getCompressorInterlockStatus, results[11], getCompressorInterlockStatus_value, "FETIM_COMP_INTRLK_STATUS")
+    BATCHMON_LOG_BOOL(getCompressorCableStatus, results[12], getCompressorCableStatus_value, "FETIM_COMP_CABLE_STATUS")
+}
+
 void FETIMImplBase::monitorAction(Time *timestamp_p) {
 
     if (!timestamp_p)
         return;
 
-    // constant factor to convert 100 ns ticks to ms:
-    static const Time milliseconds = 10000;
-    static const Time monitorInterval = 20 * milliseconds;
-
-    bool doMonitor = false;
-
     if (lastMonitorTime == 0 && logMonitors_m)
         logMon(true);
 
-    if (lastMonitorTime == 0 || (*timestamp_p - lastMonitorTime >= monitorInterval)) {
-        lastMonitorTime = *timestamp_p;
-        doMonitor = true;
-    }
-
-    if (doMonitor) {
-        switch (monitorPhase) {
-            case 0:
-                if (!executeNextMon())
-                    monitorPhase = 1;
-                break;
-            case 1:
-                internalTemperatureOOR_value = internalTemperatureOOR();
-                externalTemperatureOOR1_value = externalTemperatureOOR1();
-                externalTemperatureOOR2_value = externalTemperatureOOR2();
-                airflowSensorOOR_value = airflowSensorOOR();
-                heliumBufferPressureOOR_value = heliumBufferPressureOOR();
-                monitorPhase = 2;
-                break;
-            case 2:
-                sensorSingleFailed_value = sensorSingleFailed();
-                sensorMultiFailed_value = sensorMultiFailed();
-                glitchCounterTriggered_value = glitchCounterTriggered();
-                delayShutdownTriggered_value = delayShutdownTriggered();
-                finalShutdownTriggered_value = finalShutdownTriggered();
-                monitorPhase = 3;
-                break;
-            case 3:
-                getCompressorStatus_value = getCompressorStatus();
-                getCompressorInterlockStatus_value = getCompressorInterlockStatus();
-                getCompressorCableStatus_value = getCompressorCableStatus();
-                monitorPhase = 4;
-                break;
-            case 4:
-            default:
-                if (logMonitors_m)
-                    logMon();
-                monitorPhase = 0;
-                break;
-        };
-    }
+    lastMonitorTime = *timestamp_p;
+
+    switch (monitorPhase) {
+        case 0:
+            if (!executeNextMon())
+                monitorPhase = 1;
+            break;
+        case 1:
+            monitorStatusBatch();
+            monitorPhase = 2;
+            break;
+        case 2:
+        default:
+            if (logMonitors_m)
+                logMon();
+            monitorPhase = 0;
+            break;
+    };
 }
 
 DEFINE_MONITORS_REGISTRY(FETIMImplBase)
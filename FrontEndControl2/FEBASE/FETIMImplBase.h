@@ -77,6 +77,9 @@ public:
 protected:
     virtual void monitorAction(Time *timestamp_p);
 
+    void monitorStatusBatch();
+    ///< monitor the interlock and compressor status bits using a single batch monitor request.
+
     enum MonitorControlOffset {
         FETIM_INTRLK_SENS_INT_TEMP      = 0x0000,
         FETIM_INTRLK_SENS_FLOW_SENS     = 0x0008,
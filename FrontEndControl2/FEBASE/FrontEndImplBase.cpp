@@ -45,9 +45,10 @@ FrontEndImplBase::FrontEndImplBase(const std::string &name)
     powerEnableModule_RCA(POWER_ENABLE_MODULE),
     numErrors_RCA(SPECIAL_MONITOR + GET_ERRORS_NUMBER),
     nextError_RCA(SPECIAL_MONITOR + GET_NEXT_ERROR),
-    lastMonitorTime(0),
     monitorPhase(0)
 {
+    // monitorAction() every 5 s:
+    setMonitorRate(5000, 0, FEMonitorScheduler::PRIORITY_LOW);
 }
 
 void FrontEndImplBase::initialize(unsigned long channel, unsigned long nodeAddress) {
@@ -76,13 +77,11 @@ std::string FrontEndImplBase::FEMCFPGAVersion() {
 unsigned char FrontEndImplBase::FEMCGetESNsFound() {
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock; 
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
     monitor(SPECIAL_MONITOR + GET_ESNS_FOUND, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     if (status != AMBERR_NOERR)
         FEMCGetESNsFound_value = 0;
     else
@@ -98,13 +97,11 @@ std::string FrontEndImplBase::FEMCGetNextESN(bool reverseBytes) {
 
 unsigned char FrontEndImplBase::specialGetSetupInfo() {
     AmbDataLength_t dataLength; AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
     monitor(SPECIAL_MONITOR + GET_SETUP_INFO, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     if (status != AMBERR_NOERR)
         specialGetSetupInfo_value = 0xFF;
     else
@@ -122,10 +119,8 @@ unsigned char FrontEndImplBase::powerEnableModule(int port) {
     if (port >= 1 && port <= 10) {
         AmbRelativeAddr RCA(powerEnableModule_RCA);
         RCA |= ((port - 1) << 4);
-        sem_t synchLock;
-        sem_init(&synchLock, 0, 0);
+        sem_t &synchLock(*ambThreadSynchLock());
         FEMC_ERROR status = syncMonitor(RCA, val, synchLock);
-        sem_destroy(&synchLock);
         getLogger().log(FEMC_LOG_MONITOR, "POWER_ENABLE_MODULE", RCA, (signed char) status, val, 0.0);
     }
     return val;
@@ -157,13 +152,11 @@ void FrontEndImplBase::specialExitProgram(bool val) {
     AmbDataMem_t data[8];
     unsigned char wireVal = val;
     pack(wireVal, dataLength, data);
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
     command(SPECIAL_CONTROL + SET_EXIT_PROGRAM, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);    
 }
 
 void FrontEndImplBase::specialReadESNs(bool val) {
@@ -171,26 +164,22 @@ void FrontEndImplBase::specialReadESNs(bool val) {
     AmbDataMem_t data[8];
     unsigned char wireVal = val;
     pack(wireVal, dataLength, data);
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
     command(SPECIAL_CONTROL + SET_READ_ESN, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
 }
 
 void FrontEndImplBase::setFEMode(unsigned char val) {
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
     pack(val, dataLength, data);
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
     command(SPECIAL_CONTROL + SET_FE_MODE, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
 }
 
 void FrontEndImplBase::getMonitorTimers(unsigned short &monTimer1,
@@ -211,10 +200,9 @@ void FrontEndImplBase::getMonitorTimers(unsigned short &monTimer1,
 
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
 
     // Get the first set of timers:
     monitor(SPECIAL_MONITOR + GET_MON_TIMERS1, dataLength, data, &synchLock, &timestamp, &status);
@@ -236,7 +224,6 @@ void FrontEndImplBase::getMonitorTimers(unsigned short &monTimer1,
        maxTimerValue = ((data[6] & 0xff) << 8) + data[7];
     }
 
-    sem_destroy(&synchLock);
 }
 
 void FrontEndImplBase::monitorAction(Time *timestamp_p) {
@@ -244,23 +231,10 @@ void FrontEndImplBase::monitorAction(Time *timestamp_p) {
     if (!timestamp_p)
         return;
 
-    // constant factor to convert 100 ns ticks to ms:
-    static const Time milliseconds = 10000;
-    static const Time monitorInterval = 5000 * milliseconds;   
-
-    bool doMonitor = false;
-
-    if (lastMonitorTime == 0 || (*timestamp_p - lastMonitorTime >= monitorInterval)) {
-        lastMonitorTime = *timestamp_p;
-        doMonitor = true;
-    }
-
-    if (doMonitor) {
-        LOG(LM_TRACE) << "FrontEndImplBase::monitorAction" << endl;
-        AMBSINumErrors();
-        AMBSINumTransactions();
-        AMBSITemperature();
-        numEnabledModules_value = numEnabledModules();
-    }
+    LOG(LM_TRACE) << "FrontEndImplBase::monitorAction" << endl;
+    AMBSINumErrors();
+    AMBSINumTransactions();
+    AMBSITemperature();
+    numEnabledModules_value = numEnabledModules();
 }
 
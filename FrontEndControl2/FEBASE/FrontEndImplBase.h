@@ -135,7 +135,6 @@ private:
     // forbid copy constructor:
     FrontEndImplBase(const FrontEndImplBase &other);
     
-    Time lastMonitorTime;
     int monitorPhase;
 };      
 
@@ -48,6 +48,9 @@ IFSwitchImplBase::IFSwitchImplBase(const std::string &name)
     lastMonitorTime(0),
     monitorPhase(0)
 {
+    // monitorAction() every 2 s:
+    setMonitorRate(2000, 0, FEMonitorScheduler::PRIORITY_LOW);
+
     baseRCA = 0xB000;
     AmbRelativeAddr pol1 = 0x0004;
     AmbRelativeAddr sb2  = 0x0008;
@@ -66,18 +69,19 @@ IFSwitchImplBase::IFSwitchImplBase(const std::string &name)
     pol1Sb1TempServoEnable_RCA  = baseRCA + TEMP_SERVO_ENABLE + pol1;
     pol1Sb2TempServoEnable_RCA  = baseRCA + TEMP_SERVO_ENABLE + pol1 + sb2;
     
-    addMon(&pol0Sb1AssemblyTemp_value, &IFSwitchImplBase::pol0Sb1AssemblyTemp);
-    addMon(&pol0Sb2AssemblyTemp_value, &IFSwitchImplBase::pol0Sb2AssemblyTemp);
-    addMon(&pol1Sb1AssemblyTemp_value, &IFSwitchImplBase::pol1Sb1AssemblyTemp);
-    addMon(&pol1Sb2AssemblyTemp_value, &IFSwitchImplBase::pol1Sb2AssemblyTemp);
+    addMon(&pol0Sb1AssemblyTemp_value, &IFSwitchImplBase::pol0Sb1AssemblyTemp, "pol0Sb1AssemblyTemp");
+    addMon(&pol0Sb2AssemblyTemp_value, &IFSwitchImplBase::pol0Sb2AssemblyTemp, "pol0Sb2AssemblyTemp");
+    addMon(&pol1Sb1AssemblyTemp_value, &IFSwitchImplBase::pol1Sb1AssemblyTemp, "pol1Sb1AssemblyTemp");
+    addMon(&pol1Sb2AssemblyTemp_value, &IFSwitchImplBase::pol1Sb2AssemblyTemp, "pol1Sb2AssemblyTemp");
 
-    nextMon = monitorRegistry.begin();
+    nextMon = 0;
 }
     
 
 void IFSwitchImplBase::initialize(unsigned long channel, unsigned long nodeAddress) {
     m_channel = channel;
     m_nodeAddress = nodeAddress;
+    initializeSubsystemBreaker(baseRCA);
 }
 
 void IFSwitchImplBase::shutdown() {
@@ -192,34 +196,23 @@ void IFSwitchImplBase::monitorAction(Time *timestamp_p) {
     if (!timestamp_p)
         return;
 
-    // constant factor to convert 100 ns ticks to ms:
-    static const Time milliseconds = 10000;
-    static const Time monitorInterval = 2000 * milliseconds;   
-
-    bool doMonitor = false;
-
     if (lastMonitorTime == 0 && logMonitors_m)
         logMon(true);
 
-    if (lastMonitorTime == 0 || (*timestamp_p - lastMonitorTime >= monitorInterval)) {
-        lastMonitorTime = *timestamp_p;
-        doMonitor = true;
-    }
-
-    if (doMonitor) {
-        switchCartridge_value = switchCartridge();
-        pol0Sb1Attenuation_value = pol0Sb1Attenuation();
-        pol0Sb2Attenuation_value = pol0Sb2Attenuation();
-        pol1Sb1Attenuation_value = pol1Sb1Attenuation();
-        pol1Sb2Attenuation_value = pol1Sb2Attenuation();
-        pol0Sb1TempServoEnable_value = pol0Sb1TempServoEnable();
-        pol0Sb2TempServoEnable_value = pol0Sb2TempServoEnable();
-        pol1Sb1TempServoEnable_value = pol1Sb1TempServoEnable();
-        pol1Sb2TempServoEnable_value = pol1Sb2TempServoEnable();        
-        while (executeNextMon()) ;
-        if (logMonitors_m)
-           logMon();
-    }        
+    lastMonitorTime = *timestamp_p;
+
+    switchCartridge_value = switchCartridge();
+    pol0Sb1Attenuation_value = pol0Sb1Attenuation();
+    pol0Sb2Attenuation_value = pol0Sb2Attenuation();
+    pol1Sb1Attenuation_value = pol1Sb1Attenuation();
+    pol1Sb2Attenuation_value = pol1Sb2Attenuation();
+    pol0Sb1TempServoEnable_value = pol0Sb1TempServoEnable();
+    pol0Sb2TempServoEnable_value = pol0Sb2TempServoEnable();
+    pol1Sb1TempServoEnable_value = pol1Sb1TempServoEnable();
+    pol1Sb2TempServoEnable_value = pol1Sb2TempServoEnable();        
+    while (executeNextMon()) ;
+    if (logMonitors_m)
+       logMon();
 }
 
 DEFINE_MONITORS_REGISTRY(IFSwitchImplBase)
@@ -78,10 +78,11 @@ LORTMImplBase::LORTMImplBase(const std::string &name)
     PhaselockGetStatus_value(0),
     PhaselockGetSelectedLaser_value(0),
     PhaselockGetSelectedBand_value(0),
-    lastMonitorTime(0),
     lastMonitorTime30s(0),
     monitorPhase(0)
 {
+    // monitorAction() every 5 s.  The slower points are read every 30 s:
+    setMonitorRate(5000, 0, FEMonitorScheduler::PRIORITY_LOW);
 }
 
 void LORTMImplBase::initialize(unsigned long channel, unsigned long nodeAddress) {
@@ -100,13 +101,11 @@ std::string LORTMImplBase::GetSerialNumber() {
 std::string LORTMImplBase::GetProtocolRevision() {
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
     monitor(GET_PROTOCOL_REV_LEVEL, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     if (status != AMBERR_NOERR)
         ProtocolRevision_value = "";
     else {
@@ -120,13 +119,11 @@ std::string LORTMImplBase::GetProtocolRevision() {
 std::string LORTMImplBase::GetFirmwareVersion() {
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
     monitor(GET_SW_REV_LEVEL, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     if (status != AMBERR_NOERR)
         FirmwareVersion_value = "";
     else {
@@ -141,14 +138,12 @@ unsigned long LORTMImplBase::AMBSINumErrors() {
     AMBSINumErrors_value = 0;
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
     FEMC_ERROR feStatus = FEMC_NO_ERROR;
-    sem_init(&synchLock, 0, 0);
     monitor(AMBSI_NUM_ERRORS, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     if (status == AMBERR_NOERR)
         feStatus = unpack(AMBSINumErrors_value, dataLength, data);
     else
@@ -161,14 +156,12 @@ unsigned long LORTMImplBase::AMBSINumTransactions() {
     AMBSINumTransactions_value = 0;
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
     FEMC_ERROR feStatus = FEMC_NO_ERROR;
-    sem_init(&synchLock, 0, 0);
     monitor(AMBSI_NUM_TRANSACIONS, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     if (status == AMBERR_NOERR)
         feStatus = unpack(AMBSINumTransactions_value, dataLength, data);
     else
@@ -182,13 +175,11 @@ float LORTMImplBase::AmbientTemperature() {
     AmbientTemperature_value = 0;
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
-    sem_init(&synchLock, 0, 0);
     monitor(GET_AMBIENT_TEMPERATURE, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     if (status == AMBERR_NOERR) {
         // TODO: remove this workaround -- LORTM returns temperature bytes in reverse order.
         data[7] = data[0];
@@ -205,14 +196,12 @@ unsigned short LORTMImplBase::SystemGetStatus() {
     SystemGetStatus_value = 0;
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
     FEMC_ERROR feStatus = FEMC_NO_ERROR;
-    sem_init(&synchLock, 0, 0);
     monitor(SYSTEM_GET_STATUS, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     if (status == AMBERR_NOERR) {
         feStatus = unpack(SystemGetStatus_value, dataLength, data);
         if (feStatus == 0) {
@@ -404,14 +393,12 @@ unsigned short LORTMImplBase::PhaselockGetStatus() {
     PhaselockGetStatus_value = 0;
     AmbDataLength_t dataLength;
     AmbDataMem_t data[8];
-    sem_t synchLock;
+    sem_t &synchLock(*ambThreadSynchLock());
     Time timestamp;
     AmbErrorCode_t status = AMBERR_NOERR;
     FEMC_ERROR feStatus = FEMC_NO_ERROR;
-    sem_init(&synchLock, 0, 0);
     monitor(PHASELOCK_GET_STATUS, dataLength, data, &synchLock, &timestamp, &status);
     sem_wait(&synchLock);
-    sem_destroy(&synchLock);
     if (status == AMBERR_NOERR) {
         feStatus = unpack(PhaselockGetStatus_value, dataLength, data);
         if (feStatus == 0) {
@@ -501,47 +488,38 @@ void LORTMImplBase::monitorAction(Time* timestamp_p) {
     if (!timestamp_p)
         return;
 
-    // constant factor to convert 100 ns ticks to ms:
-    static const Time milliseconds = 10000;
-    static const Time monitorInterval = 5000 * milliseconds;
-    bool doMonitor = false;
-
-    if (lastMonitorTime == 0 || (*timestamp_p - lastMonitorTime >= monitorInterval)) {
-        lastMonitorTime = *timestamp_p;
-        doMonitor = true;
-    }
-
-    if (doMonitor) {
-        LOG(LM_TRACE) << "LORTMImplBase::monitorAction" << endl;
-        SystemGetStatus();
-        if (systemError)
-            SystemGetError_value = SystemGetError();
-        if (systemWarning)
-            SystemGetWarning_value = SystemGetWarning();
-        PhaselockGetStatus();
-        if (phaselockRFInputReady) {
-            PhaselockGetSelectedLaser_value = PhaselockGetSelectedLaser();
-            PhaselockGetSelectedBand_value = PhaselockGetSelectedBand();
-        }
-        LaserBiasMon1_value = LaserBiasMon1();
-        LaserBiasMon2_value = LaserBiasMon2();
-        LaserBiasMon3_value = LaserBiasMon3();
-        LaserBiasMon4_value = LaserBiasMon4();
-        LaserTempMon1_value = LaserTempMon1();
-        LaserTempMon2_value = LaserTempMon2();
-        LaserTempMon3_value = LaserTempMon3();
-        LaserTempMon4_value = LaserTempMon4();
-        LaserSlowCorrMon_value = LaserSlowCorrMon();
-        LaserGetStatus1_value = LaserGetStatus1();
-        LaserGetStatus2_value = LaserGetStatus2();
-        LaserGetStatus3_value = LaserGetStatus3();
-        LaserGetStatus4_value = LaserGetStatus4();
+    LOG(LM_TRACE) << "LORTMImplBase::monitorAction" << endl;
+    SystemGetStatus();
+    if (systemError)
+        SystemGetError_value = SystemGetError();
+    if (systemWarning)
+        SystemGetWarning_value = SystemGetWarning();
+    PhaselockGetStatus();
+    if (phaselockRFInputReady) {
+        PhaselockGetSelectedLaser_value = PhaselockGetSelectedLaser();
+        PhaselockGetSelectedBand_value = PhaselockGetSelectedBand();
     }
+    LaserBiasMon1_value = LaserBiasMon1();
+    LaserBiasMon2_value = LaserBiasMon2();
+    LaserBiasMon3_value = LaserBiasMon3();
+    LaserBiasMon4_value = LaserBiasMon4();
+    LaserTempMon1_value = LaserTempMon1();
+    LaserTempMon2_value = LaserTempMon2();
+    LaserTempMon3_value = LaserTempMon3();
+    LaserTempMon4_value = LaserTempMon4();
+    LaserSlowCorrMon_value = LaserSlowCorrMon();
+    LaserGetStatus1_value = LaserGetStatus1();
+    LaserGetStatus2_value = LaserGetStatus2();
+    LaserGetStatus3_value = LaserGetStatus3();
+    LaserGetStatus4_value = LaserGetStatus4();
 
+    // constant factor to convert 100 ns ticks to ms:
+    static const Time milliseconds = 10000;
     static const Time monitorInterval30s = 30000 * milliseconds;
     bool doMonitor30s = false;
 
-    if (lastMonitorTime30s == 0 || (*timestamp_p - lastMonitorTime30s >= monitorInterval30s)) {
+    // Allow a tick of slack, so that it comes every sixth call rather than the seventh:
+    if (lastMonitorTime30s == 0 || (*timestamp_p - lastMonitorTime30s >= monitorInterval30s - FEMonitorScheduler::TICK_MS * milliseconds)) {
         lastMonitorTime30s = *timestamp_p;
         doMonitor30s = true;
     }
@@ -273,7 +273,6 @@ private:
     // forbid copy constructor:
     LORTMImplBase(const LORTMImplBase &other);
     
-    Time lastMonitorTime;
     Time lastMonitorTime30s;
     int monitorPhase;
     
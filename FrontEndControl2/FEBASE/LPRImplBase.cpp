@@ -47,6 +47,9 @@ LPRImplBase::LPRImplBase(const std::string &name)
     lastMonitorTime(0),
     monitorPhase(0)
 {
+    // monitorAction() every 150 ms:
+    setMonitorRate(150, 0, FEMonitorScheduler::PRIORITY_NORMAL);
+
     baseRCA = 0xD000;
     LPRTemperature0_RCA             = baseRCA + LPR_TEMPERATURE_0;
     LPRTemperature1_RCA             = baseRCA + LPR_TEMPERATURE_1;
@@ -62,21 +65,22 @@ LPRImplBase::LPRImplBase(const std::string &name)
     EDFAPhotoDetectPower_RCA        = baseRCA + EDFA_PHOTODETECT_POWER;
     EDFAModulationInput_RCA         = baseRCA + EDFA_MODULATION_INPUT;
 
-    addMon(&LPRTemperature0_value, &LPRImplBase::LPRTemperature0);
-    addMon(&LPRTemperature1_value, &LPRImplBase::LPRTemperature1);
-    addMon(&EDFALaserPumpTemperature_value, &LPRImplBase::EDFALaserPumpTemperature);
-    addMon(&EDFALaserDriveCurrent_value, &LPRImplBase::EDFALaserDriveCurrent);
-    addMon(&EDFALaserPhotoDetectCurrent_value, &LPRImplBase::EDFALaserPhotoDetectCurrent);
-    addMon(&EDFAPhotoDetectCurrent_value, &LPRImplBase::EDFAPhotoDetectCurrent);
-    addMon(&EDFAPhotoDetectPower_value, &LPRImplBase::EDFAPhotoDetectPower);
-    addMon(&EDFAModulationInput_value, &LPRImplBase::EDFAModulationInput);
+    addMon(&LPRTemperature0_value, &LPRImplBase::LPRTemperature0, "LPRTemperature0");
+    addMon(&LPRTemperature1_value, &LPRImplBase::LPRTemperature1, "LPRTemperature1");
+    addMon(&EDFALaserPumpTemperature_value, &LPRImplBase::EDFALaserPumpTemperature, "EDFALaserPumpTemperature");
+    addMon(&EDFALaserDriveCurrent_value, &LPRImplBase::EDFALaserDriveCurrent, "EDFALaserDriveCurrent");
+    addMon(&EDFALaserPhotoDetectCurrent_value, &LPRImplBase::EDFALaserPhotoDetectCurrent, "EDFALaserPhotoDetectCurrent");
+    addMon(&EDFAPhotoDetectCurrent_value, &LPRImplBase::EDFAPhotoDetectCurrent, "EDFAPhotoDetectCurrent");
+    addMon(&EDFAPhotoDetectPower_value, &LPRImplBase::EDFAPhotoDetectPower, "EDFAPhotoDetectPower");
+    addMon(&EDFAModulationInput_value, &LPRImplBase::EDFAModulationInput, "EDFAModulationInput");
     
-    nextMon = monitorRegistry.begin();
+    nextMon = 0;
 }
 
 void LPRImplBase::initialize(unsigned long channel, unsigned long nodeAddress) {
     m_channel = channel;
     m_nodeAddress = nodeAddress;
+    initializeSubsystemBreaker(baseRCA);
 }
 
 void LPRImplBase::shutdown() {
@@ -151,41 +155,30 @@ void LPRImplBase::monitorAction(Time *timestamp_p) {
     if (!timestamp_p)
         return;
 
-    // constant factor to convert 100 ns ticks to ms:
-    static const Time milliseconds = 10000;
-    static const Time monitorInterval = 150 * milliseconds; 
-
-    bool doMonitor = false;
-
     if (lastMonitorTime == 0 && logMonitors_m)
         logMon(true);
     
-    if (lastMonitorTime == 0 || (*timestamp_p - lastMonitorTime >= monitorInterval)) {
-        lastMonitorTime = *timestamp_p;
-        doMonitor = true;
-    }
-
-    if (doMonitor) {
-        switch (monitorPhase) {
-            case 0:
-                if (!executeNextMon())
-                    monitorPhase = 1;
-                break;
-            case 1:
-                opticalSwitchPort_value = opticalSwitchPort();
-                opticalSwitchShutter_value = opticalSwitchShutter();
-                opticalSwitchState_value = opticalSwitchState();
-                opticalSwitchBusy_value = opticalSwitchBusy();
-                monitorPhase = 2;
-                break;
-            case 2:
-            default:
-                if (logMonitors_m)
-                    logMon();
-                monitorPhase = 0;
-                break;
-        };
-    }
+    lastMonitorTime = *timestamp_p;
+
+    switch (monitorPhase) {
+        case 0:
+            if (!executeNextMon())
+                monitorPhase = 1;
+            break;
+        case 1:
+            opticalSwitchPort_value = opticalSwitchPort();
+            opticalSwitchShutter_value = opticalSwitchShutter();
+            opticalSwitchState_value = opticalSwitchState();
+            opticalSwitchBusy_value = opticalSwitchBusy();
+            monitorPhase = 2;
+            break;
+        case 2:
+        default:
+            if (logMonitors_m)
+                logMon();
+            monitorPhase = 0;
+            break;
+    };
 }
 
 DEFINE_MONITORS_REGISTRY(LPRImplBase)
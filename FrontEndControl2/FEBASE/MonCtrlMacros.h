@@ -57,6 +57,10 @@
 #define SYNCMON_AVG(NAME, TARGET, AVERAGE) \
     NAME##_status = syncMonitorAverage(NAME##_RCA, TARGET, AVERAGE);
 
+/// synchronous monitor of SAMPLES readings sent as one batch, for a NAME and an FEMonitorStatistics STATS
+#define SYNCMON_STATS(NAME, SAMPLES, STATS) \
+    NAME##_status = syncMonitorStatistics(NAME##_RCA, SAMPLES, STATS);
+
 /// synchronous monitor, log, and return a float, given the parameter NAME and logging TEXT.
 #define SYNCMON_LOG_FLOAT(NAME, TEXT) { \
     float target; \
@@ -73,6 +77,13 @@
     LOG_FLOAT(FEMC_LOG_MONITOR, NAME, TEXT, target); \
     return target; }
 
+/// synchronous monitor with statistics, log the mean, and return it, given the parameter NAME and logging TEXT.
+#define SYNCMON_STATS_LOG_FLOAT(NAME, TEXT, SAMPLES, STATS) { \
+    SYNCMON_STATS(NAME, SAMPLES, STATS) \
+    float target = (NAME##_status == FEMC_AMB_ERROR) ? 0.0 : (float) STATS.mean; \
+    LOG_FLOAT(FEMC_LOG_MONITOR, NAME, TEXT, target); \
+    return target; }
+
 /// synchronous monitor, log, and return an integer TYPE, given the parameter NAME and logging TEXT.
 #define SYNCMON_LOG_INT(NAME, TYPE, TEXT) { \
     TYPE target; \
@@ -97,6 +108,22 @@
     LOG_BYTE(FEMC_LOG_MONITOR, NAME, TEXT, target); \
     return target; }
 
+/// unpack the RESULT of a batch monitor for NAME into a TARGET variable and set the corresponding NAME_status result.
+#define BATCHMON(NAME, RESULT, TARGET) \
+    NAME##_status = unpackBatchResult(NAME##_RCA, RESULT, TARGET);
+
+/// unpack the RESULT of a batch monitor into a bool TARGET and log it, given the parameter NAME and logging TEXT.
+#define BATCHMON_LOG_BOOL(NAME, RESULT, TARGET, TEXT) { \
+    BATCHMON(NAME, RESULT, TARGET) \
+    if (NAME##_status == FEMC_AMB_ERROR) TARGET = false; \
+    LOG_BOOL(FEMC_LOG_MONITOR, NAME, TEXT, TARGET); }
+
+/// unpack the RESULT of a batch monitor into a byte TARGET and log it, given the parameter NAME and logging TEXT.
+#define BATCHMON_LOG_BYTE(NAME, RESULT, TARGET, TEXT) { \
+    BATCHMON(NAME, RESULT, TARGET) \
+    if (NAME##_status == FEMC_AMB_ERROR) TARGET = 0; \
+    LOG_BYTE(FEMC_LOG_MONITOR, NAME, TEXT, TARGET); }
+
 /// skip monitoring and instead return a fixed value.
 #define MONRETURN(NAME, TYPE, VALUE) {\
     TYPE target = VALUE;\
@@ -146,9 +173,7 @@
 
 /// synchronous monitor for a NAME and TARGET for a given RCA.  Ignores status result.
 #define SYNCMON2(RCA, STATUS, TARGET) { \
-    sem_t synchLock; sem_init(&synchLock, 0, 0); \
-    STATUS = syncMonitor(RCA, TARGET, synchLock); \
-    sem_destroy(&synchLock); }
+    STATUS = syncMonitor(RCA, TARGET, *ambThreadSynchLock()); }
 
 /// synchronous monitor, log, and return a float, given the parameter NAME and logging TEXT.
 #define SYNCMON2_LOG_FLOAT(RCA, TEXT) { \
@@ -61,6 +61,9 @@ PowerModuleImplBase::PowerModuleImplBase(const std::string &name, int port)
     lastMonitorTime(0),
     monitorPhase(0)
 {
+    // monitorAction() every 2 s:
+    setMonitorRate(2000, 0, FEMonitorScheduler::PRIORITY_LOW);
+
     baseRCA = port - 1;
     baseRCA <<= 4;
     baseRCA += 0xA000;
@@ -81,25 +84,26 @@ PowerModuleImplBase::PowerModuleImplBase(const std::string &name, int port)
 
     // Add all the analog monitor points to the registry:
     
-    addMon(&voltageP6V_value, &PowerModuleImplBase::voltageP6V);
-    addMon(&currentP6V_value, &PowerModuleImplBase::currentP6V);
-    addMon(&voltageN6V_value, &PowerModuleImplBase::voltageN6V);
-    addMon(&currentN6V_value, &PowerModuleImplBase::currentN6V);
-    addMon(&voltageP15V_value, &PowerModuleImplBase::voltageP15V);
-    addMon(&currentP15V_value, &PowerModuleImplBase::currentP15V);
-    addMon(&voltageN15V_value, &PowerModuleImplBase::voltageN15V);
-    addMon(&currentN15V_value, &PowerModuleImplBase::currentN15V);
-    addMon(&voltageP24V_value, &PowerModuleImplBase::voltageP24V);
-    addMon(&currentP24V_value, &PowerModuleImplBase::currentP24V);
-    addMon(&voltageP8V_value, &PowerModuleImplBase::voltageP8V);
-    addMon(&currentP8V_value, &PowerModuleImplBase::currentP8V);
-
-    nextMon = monitorRegistry.begin();
+    addMon(&voltageP6V_value, &PowerModuleImplBase::voltageP6V, "voltageP6V");
+    addMon(&currentP6V_value, &PowerModuleImplBase::currentP6V, "currentP6V");
+    addMon(&voltageN6V_value, &PowerModuleImplBase::voltageN6V, "voltageN6V");
+    addMon(&currentN6V_value, &PowerModuleImplBase::currentN6V, "currentN6V");
+    addMon(&voltageP15V_value, &PowerModuleImplBase::voltageP15V, "voltageP15V");
+    addMon(&currentP15V_value, &PowerModuleImplBase::currentP15V, "currentP15V");
+    addMon(&voltageN15V_value, &PowerModuleImplBase::voltageN15V, "voltageN15V");
+    addMon(&currentN15V_value, &PowerModuleImplBase::currentN15V, "currentN15V");
+    addMon(&voltageP24V_value, &PowerModuleImplBase::voltageP24V, "voltageP24V");
+    addMon(&currentP24V_value, &PowerModuleImplBase::currentP24V, "currentP24V");
+    addMon(&voltageP8V_value, &PowerModuleImplBase::voltageP8V, "voltageP8V");
+    addMon(&currentP8V_value, &PowerModuleImplBase::currentP8V, "currentP8V");
+
+    nextMon = 0;
 }
 
 void PowerModuleImplBase::initialize(unsigned long channel, unsigned long nodeAddress) {
     m_channel = channel;
     m_nodeAddress = nodeAddress;
+    initializeSubsystemBreaker(baseRCA);
 }
 
 void PowerModuleImplBase::shutdown() {
@@ -160,26 +164,15 @@ void PowerModuleImplBase::monitorAction(Time *timestamp_p) {
     if (!timestamp_p)
         return;
 
-    // constant factor to convert 100 ns ticks to ms:
-    static const Time milliseconds = 10000;
-    static const Time monitorInterval = 2000 * milliseconds;   
-
-    bool doMonitor = false;
-
     if (lastMonitorTime == 0 && logMonitors_m)
         logMon(true);
 
-    if (lastMonitorTime == 0 || (*timestamp_p - lastMonitorTime >= monitorInterval)) {
-        lastMonitorTime = *timestamp_p;
-        doMonitor = true;
-    }
+    lastMonitorTime = *timestamp_p;
 
-    if (doMonitor) {
-        enableModule_value = enableModule();
-        while (executeNextMon()) ;
-        if (logMonitors_m)
-           logMon();
-    }
+    enableModule_value = enableModule();
+    while (executeNextMon()) ;
+    if (logMonitors_m)
+       logMon();
 }
 
 DEFINE_MONITORS_REGISTRY(PowerModuleImplBase)
@@ -107,6 +107,9 @@ WCAImplBase::WCAImplBase(const std::string &name, int port)
     lastMonitorTime(0),
     monitorPhase(0)
 {
+    // monitorAction() every 30 ms, or 5 s when minimal:
+    setMonitorRate(30, 5000, FEMonitorScheduler::PRIORITY_HIGH);
+
     baseRCA = port - 1;
     baseRCA <<= 12;
     
@@ -152,40 +155,50 @@ WCAImplBase::WCAImplBase(const std::string &name, int port)
     paPol1TeledyneCollector_RCA         = baseRCA + PA_TELEDYNE_COLLECTOR + 1;
     // Add all the analog monitor points to the registry:
     
-    addMon(&photomixerVoltage_value, &WCAImplBase::photomixerVoltage);
-    addMon(&photomixerCurrent_value, &WCAImplBase::photomixerCurrent);
-    addMon(&pllLockDetectVoltage_value, &WCAImplBase::pllLockDetectVoltage);
-    addMon(&pllCorrectionVoltage_value, &WCAImplBase::pllCorrectionVoltage);
-    addMon(&pllRefTotalPower_value, &WCAImplBase::pllRefTotalPower);
-    addMon(&pllIfTotalPower_value, &WCAImplBase::pllIfTotalPower);
-    addMon(&amcGateAVoltage_value, &WCAImplBase::amcGateAVoltage);
-    addMon(&amcDrainAVoltage_value, &WCAImplBase::amcDrainAVoltage);
-    addMon(&amcDrainACurrent_value, &WCAImplBase::amcDrainACurrent);
-    addMon(&amcGateBVoltage_value, &WCAImplBase::amcGateBVoltage);
-    addMon(&amcDrainBVoltage_value, &WCAImplBase::amcDrainBVoltage);
-    addMon(&amcDrainBCurrent_value, &WCAImplBase::amcDrainBCurrent);
-    addMon(&amcGateEVoltage_value, &WCAImplBase::amcGateEVoltage);
-    addMon(&amcDrainEVoltage_value, &WCAImplBase::amcDrainEVoltage);
-    addMon(&amcDrainECurrent_value, &WCAImplBase::amcDrainECurrent);
-    addMon(&paPol0GateVoltage_value, &WCAImplBase::paPol0GateVoltage);
-    addMon(&paPol0DrainVoltage_value, &WCAImplBase::paPol0DrainVoltage);
-    addMon(&paPol0DrainCurrent_value, &WCAImplBase::paPol0DrainCurrent);
-    addMon(&paPol1GateVoltage_value, &WCAImplBase::paPol1GateVoltage);
-    addMon(&paPol1DrainVoltage_value, &WCAImplBase::paPol1DrainVoltage);
-    addMon(&paPol1DrainCurrent_value, &WCAImplBase::paPol1DrainCurrent);
-    addMon(&amcMultiplierDCurrent_value, &WCAImplBase::amcMultiplierDCurrent);
-    addMon(&amcSupplyVoltage5V_value, &WCAImplBase::amcSupplyVoltage5V);
-    addMon(&paSupplyVoltage3V_value, &WCAImplBase::paSupplyVoltage3V);
-    addMon(&paSupplyVoltage5V_value, &WCAImplBase::paSupplyVoltage5V);
-    addMon(&pllAssemblyTemp_value, &WCAImplBase::pllAssemblyTemp);
-    addMon(&pllYTOHeaterCurrent_value, &WCAImplBase::pllYTOHeaterCurrent);
-
-    nextMon = monitorRegistry.begin();
+    addMon(&photomixerVoltage_value, &WCAImplBase::photomixerVoltage, "photomixerVoltage");
+    addMon(&photomixerCurrent_value, &WCAImplBase::photomixerCurrent, "photomixerCurrent");
+    addMon(&pllLockDetectVoltage_value, &WCAImplBase::pllLockDetectVoltage, "pllLockDetectVoltage");
+    addMon(&pllCorrectionVoltage_value, &WCAImplBase::pllCorrectionVoltage, "pllCorrectionVoltage");
+    addMon(&pllRefTotalPower_value, &WCAImplBase::pllRefTotalPower, "pllRefTotalPower");
+    addMon(&pllIfTotalPower_value, &WCAImplBase::pllIfTotalPower, "pllIfTotalPower");
+    addMon(&amcGateAVoltage_value, &WCAImplBase::amcGateAVoltage, "amcGateAVoltage");
+    addMon(&amcDrainAVoltage_value, &WCAImplBase::amcDrainAVoltage, "amcDrainAVoltage");
+    addMon(&amcDrainACurrent_value, &WCAImplBase::amcDrainACurrent, "amcDrainACurrent");
+    addMon(&amcGateBVoltage_value, &WCAImplBase::amcGateBVoltage, "amcGateBVoltage");
+    addMon(&amcDrainBVoltage_value, &WCAImplBase::amcDrainBVoltage, "amcDrainBVoltage");
+    addMon(&amcDrainBCurrent_value, &WCAImplBase::amcDrainBCurrent, "amcDrainBCurrent");
+    addMon(&amcGateEVoltage_value, &WCAImplBase::amcGateEVoltage, "amcGateEVoltage");
+    addMon(&amcDrainEVoltage_value, &WCAImplBase::amcDrainEVoltage, "amcDrainEVoltage");
+    addMon(&amcDrainECurrent_value, &WCAImplBase::amcDrainECurrent, "amcDrainECurrent");
+    addMon(&paPol0GateVoltage_value, &WCAImplBase::paPol0GateVoltage, "paPol0GateVoltage");
+    addMon(&paPol0DrainVoltage_value, &WCAImplBase::paPol0DrainVoltage, "paPol0DrainVoltage");
+    addMon(&paPol0DrainCurrent_value, &WCAImplBase::paPol0DrainCurrent, "paPol0DrainCurrent");
+    addMon(&paPol1GateVoltage_value, &WCAImplBase::paPol1GateVoltage, "paPol1GateVoltage");
+    addMon(&paPol1DrainVoltage_value, &WCAImplBase::paPol1DrainVoltage, "paPol1DrainVoltage");
+    addMon(&paPol1DrainCurrent_value, &WCAImplBase::paPol1DrainCurrent, "paPol1DrainCurrent");
+    addMon(&amcMultiplierDCurrent_value, &WCAImplBase::amcMultiplierDCurrent, "amcMultiplierDCurrent");
+    addMon(&amcSupplyVoltage5V_value, &WCAImplBase::amcSupplyVoltage5V, "amcSupplyVoltage5V");
+    addMon(&paSupplyVoltage3V_value, &WCAImplBase::paSupplyVoltage3V, "paSupplyVoltage3V");
+    addMon(&paSupplyVoltage5V_value, &WCAImplBase::paSupplyVoltage5V, "paSupplyVoltage5V");
+    addMon(&pllAssemblyTemp_value, &WCAImplBase::pllAssemblyTemp, "pllAssemblyTemp");
+    addMon(&pllYTOHeaterCurrent_value, &WCAImplBase::pllYTOHeaterCurrent, "pllYTOHeaterCurrent");
+
+    // The correction and lock detect voltages matter while locking.  Poll them as often as every 30 ms while they move
+    // or while the lock detect is low, but no less often than every 2 s:
+    setMonRate(&pllCorrectionVoltage_value, 30, 2000, 0.05);
+    setMonRate(&pllLockDetectVoltage_value, 30, 2000, 0.05);
+    setMonLimits(&pllLockDetectVoltage_value, 3.0, 100.0);
+    // The PLL temperature and YTO heater current drift slowly:
+    setMonRate(&pllAssemblyTemp_value, 1000, 10000, 0.1);
+    setMonRate(&pllYTOHeaterCurrent_value, 1000, 10000, 0.5);
+
+    nextMon = 0;
 }
 
 void WCAImplBase::initialize(unsigned long channel, unsigned long nodeAddress) {
     m_channel = channel;
     m_nodeAddress = nodeAddress;
+    initializeSubsystemBreaker(baseRCA);
 }
 
 void WCAImplBase::shutdown() {
@@ -410,58 +423,45 @@ void WCAImplBase::paPol1TeledyneCollector(unsigned char val) {
 }
 
 void WCAImplBase::monitorAction(Time *timestamp_p) {
-    // constant factor to convert 100 ns ticks to ms:
-    static const Time milliseconds = 10000;   
-
-    static const Time monitorInterval = 30 * milliseconds;
-    static const Time minMonitorInterval = 5000 * milliseconds;
-
-    bool doMonitor = false;
-
     if (lastMonitorTime == 0 && logMonitors_m)
         logMon(true);
 
-    if (lastMonitorTime == 0 || (*timestamp_p - lastMonitorTime >= ((minimalMonitoring_m) ? minMonitorInterval : monitorInterval))) {
-        lastMonitorTime = *timestamp_p;
-        doMonitor = true;
-    }
-
-    if (doMonitor) {
-        if (minimalMonitoring_m) {
-            pllUnlockDetectLatch_value = pllUnlockDetectLatch();
-            pllLockDetectVoltage_value = pllLockDetectVoltage();
-            pllCorrectionVoltage_value = pllCorrectionVoltage();
-            photomixerCurrent_value = photomixerCurrent();
-            pllRefTotalPower_value = pllRefTotalPower();
-            pllIfTotalPower_value = pllIfTotalPower();
-            pllAssemblyTemp_value = pllAssemblyTemp();
-            pllNullLoopIntegrator_value = pllNullLoopIntegrator();
-        } else {        
-            switch (monitorPhase) {
-                case 0:
-                    if (!executeNextMon())
-                        monitorPhase = 1;
-                    break;
-                case 1:
-                    pllUnlockDetectLatch_value = pllUnlockDetectLatch();
-                    ytoCoarseTune_value = ytoCoarseTune();
-                    pllNullLoopIntegrator_value = pllNullLoopIntegrator();
-                    monitorPhase = 2;
-                    break;
-                case 2:
-                    amcMultiplierDCounts_value = amcMultiplierDCounts();
-                    photomixerEnable_value = photomixerEnable();
-                    pllLoopBandwidthSelect_value = pllLoopBandwidthSelect();
-                    pllSidebandLockSelect_value = pllSidebandLockSelect();
-                    monitorPhase = 3;
-                    break;
-                case 3:
-                default:
-                    if (logMonitors_m)
-                       logMon();
-                    monitorPhase = 0;
-                    break;
-            }
+    lastMonitorTime = *timestamp_p;
+
+    if (isMinimalMonitoring()) {
+        pllUnlockDetectLatch_value = pllUnlockDetectLatch();
+        pllLockDetectVoltage_value = pllLockDetectVoltage();
+        pllCorrectionVoltage_value = pllCorrectionVoltage();
+        photomixerCurrent_value = photomixerCurrent();
+        pllRefTotalPower_value = pllRefTotalPower();
+        pllIfTotalPower_value = pllIfTotalPower();
+        pllAssemblyTemp_value = pllAssemblyTemp();
+        pllNullLoopIntegrator_value = pllNullLoopIntegrator();
+    } else {        
+        switch (monitorPhase) {
+            case 0:
+                if (!executeNextMon())
+                    monitorPhase = 1;
+                break;
+            case 1:
+                pllUnlockDetectLatch_value = pllUnlockDetectLatch();
+                ytoCoarseTune_value = ytoCoarseTune();
+                pllNullLoopIntegrator_value = pllNullLoopIntegrator();
+                monitorPhase = 2;
+                break;
+            case 2:
+                amcMultiplierDCounts_value = amcMultiplierDCounts();
+                photomixerEnable_value = photomixerEnable();
+                pllLoopBandwidthSelect_value = pllLoopBandwidthSelect();
+                pllSidebandLockSelect_value = pllSidebandLockSelect();
+                monitorPhase = 3;
+                break;
+            case 3:
+            default:
+                if (logMonitors_m)
+                   logMon();
+                monitorPhase = 0;
+                break;
         }
     }
 }
@@ -261,12 +261,13 @@ protected:
 protected:    
     int port_m; ///< to which FEMC port is this module connected. 
 
+    // monitor registry and logging:
+    Time lastMonitorTime;
+    int monitorPhase;
+
 private:
     // forbid copy constructor:
     WCAImplBase(const WCAImplBase &other);
-
-    Time lastMonitorTime;
-    int monitorPhase;
     
     DECLARE_MONITORS_REGISTRY(WCAImplBase)
     void logMon(bool printHeader = false) const;
@@ -38,6 +38,7 @@
 #include "CONFIG/FrontEndDataBase.h"
 #include "CONFIG/IFPowerDataSet.h"
 #include "OPTIMIZE/XYPlotArray.h"
+#include "FrontEndAMB/ambGovernor.h"
 #include <stdio.h>
 #include <limits>
 #include <cmath>
@@ -880,6 +881,7 @@ bool FrontEndImpl::setCartridgeOff(int port) {
 
     // set the CartAssembly to powered off state:
     carts_mp -> clearEnable(port);
+    AmbGovernor::setPowered(port, false);
 
     // If no CPDS, send the power command anyway so that FEMC is in proper state:
     if (!cpds_m)
@@ -914,6 +916,7 @@ bool FrontEndImpl::setCartridgeOn(int port) {
 
     // set the CartAssembly to powered on state:
     carts_mp -> setEnable(port);
+    AmbGovernor::setPowered(port, true);
     msg += " is now powered ON.";
     FEMCEventQueue::addStatusMessage(true, msg);
     
@@ -1011,6 +1014,8 @@ bool FrontEndImpl::setCartridgeObserving(int port) {
         FEMCEventQueue::addStatusMessage(false, "Set observing port failed.");
         return false;
     }
+    // Give the observing cartridge the largest share of the bus:
+    AmbGovernor::setObserving(port);
     
     unsigned long stopTime = GETTIMER();
     LOG(LM_INFO) << "FrontEndImpl::setCartridgeObserving port=" << port << " took " << (stopTime - startTime) << " ms." << endl;
@@ -1020,6 +1025,7 @@ bool FrontEndImpl::setCartridgeObserving(int port) {
 void FrontEndImpl::clearCartridgeObserving() {
     LOG(LM_INFO) << "FrontEndImpl::clearCartridgeObserving" << endl;
     carts_mp -> clearObserving();
+    AmbGovernor::setObserving(0);
 }
 
 int FrontEndImpl::getCartridgeObserving() const {
@@ -0,0 +1,239 @@
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2008
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+#include "ambTransactionLogFile.h"
+#include "feAddressMeta.h"
+#include "FEBASE/FEHardwareDevice.h"
+#include "setTimeStamp.h"
+#include <string.h>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+using namespace std;
+
+static const char logMagic[8] = { 'F', 'E', 'T', 'R', 'N', 'L', 'O', 'G' };
+
+void AmbTransactionLogEntry::set(int _trans, const char *_text, AmbRelativeAddr _RCA, int _FEStatus,
+                                 unsigned long _iValue, float _fValue)
+{
+    trans = _trans;
+    RCA = _RCA;
+    FEStatus = _FEStatus;
+    iValue = _iValue;
+    fValue = _fValue;
+    if (!_text)
+        _text = "";
+    strncpy(text, _text, TEXT_SIZE - 1);
+    text[TEXT_SIZE - 1] = '\0';
+}
+
+string formatAmbTransaction(const AmbTransactionLogEntry &entry) {
+    switch (entry.trans) {
+        case FEHardwareDevice::FEMC_LOG_CHECKPOINT:
+            return entry.text;
+
+        case FEHardwareDevice::FEMC_LOG_MONITOR:
+        case FEHardwareDevice::FEMC_LOG_COMMAND: {
+            FrontEnd::FESelector_t selector;
+            selector.decode(entry.RCA);
+            ostringstream sel;
+            sel << selector;
+            ostringstream os;
+            os << FEHardwareDevice::TransactionText[entry.trans]
+               << " 0x" << uppercase << hex << setw(6) << setfill('0') << (unsigned long) entry.RCA << dec << setw(0)
+               << " '" << entry.text << (sel.str().length() ? " " : "") << sel.str() << "'"
+               << " i=" << entry.iValue << " f=" << entry.fValue << " stat=" << entry.FEStatus;
+            return os.str();
+        }
+        default:
+            return "";
+    }
+}
+
+//----------------------------------------------------------------------------
+
+AmbTransactionLogWriter::AmbTransactionLogWriter()
+  : file_mp(NULL),
+    count_m(0)
+{}
+
+AmbTransactionLogWriter::~AmbTransactionLogWriter() {
+    close();
+}
+
+bool AmbTransactionLogWriter::open(const string &fileName) {
+    close();
+    FILE *file = fopen(fileName.c_str(), "wb");
+    if (!file)
+        return false;
+    setvbuf(file, NULL, _IOFBF, 64 * 1024);
+
+    AmbTransactionLogHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, logMagic, sizeof(header.magic));
+    header.version = VERSION;
+    header.recordSize = sizeof(AmbTransactionLogRecord);
+    Time now;
+    setTimeStamp(&now);
+    header.startTime = now;
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        fclose(file);
+        return false;
+    }
+    file_mp = file;
+    texts_m.clear();
+    count_m = 0;
+    return true;
+}
+
+void AmbTransactionLogWriter::close() {
+    if (file_mp) {
+        fclose(file_mp);
+        file_mp = NULL;
+    }
+}
+
+void AmbTransactionLogWriter::write(const AmbTransactionLogEntry *entries, unsigned count) {
+    if (!file_mp)
+        return;
+    AmbTransactionLogRecord record;
+    for (unsigned index = 0; index < count; ++index) {
+        const AmbTransactionLogEntry &entry = entries[index];
+        memset(&record, 0, sizeof(record));
+        record.timestamp = entry.ts;
+        record.RCA = entry.RCA;
+        record.iValue = entry.iValue;
+        record.fValue = entry.fValue;
+        record.FEStatus = entry.FEStatus;
+        record.trans = entry.trans;
+
+        // Find or assign the id of the text:
+        uint16_t textId = AmbTransactionLogRecord::TEXT_INLINE;
+        if (entry.trans != FEHardwareDevice::FEMC_LOG_CHECKPOINT) {
+            map<string, uint16_t>::const_iterator it = texts_m.find(entry.text);
+            if (it != texts_m.end())
+                textId = it -> second;
+            else if (texts_m.size() < AmbTransactionLogRecord::TEXT_INLINE) {
+                textId = texts_m.size();
+                texts_m[entry.text] = textId;
+                writeText(textId, entry.text);
+            }
+        }
+        if (textId == AmbTransactionLogRecord::TEXT_INLINE)
+            writeText(textId, entry.text);
+        record.textId = textId;
+        if (fwrite(&record, sizeof(record), 1, file_mp) == 1)
+            ++count_m;
+    }
+    fflush(file_mp);
+}
+
+void AmbTransactionLogWriter::writeText(uint16_t textId, const char *text) {
+    AmbTransactionLogRecord record;
+    memset(&record, 0, sizeof(record));
+    record.trans = AmbTransactionLogRecord::TRANS_TEXT;
+    record.textId = textId;
+    record.iValue = strlen(text);
+    fwrite(&record, sizeof(record), 1, file_mp);
+    // The text, padded to a whole number of records:
+    char padded[((AmbTransactionLogEntry::TEXT_SIZE + sizeof(record) - 1) / sizeof(record)) * sizeof(record)];
+    unsigned size = ((record.iValue + sizeof(record) - 1) / sizeof(record)) * sizeof(record);
+    memset(padded, 0, sizeof(padded));
+    memcpy(padded, text, record.iValue);
+    if (size)
+        fwrite(padded, size, 1, file_mp);
+}
+
+//----------------------------------------------------------------------------
+
+AmbTransactionLogReader::AmbTransactionLogReader()
+  : file_mp(NULL)
+{
+    memset(&header_m, 0, sizeof(header_m));
+}
+
+AmbTransactionLogReader::~AmbTransactionLogReader() {
+    close();
+}
+
+bool AmbTransactionLogReader::open(const string &fileName) {
+    close();
+    file_mp = fopen(fileName.c_str(), "rb");
+    if (!file_mp)
+        return false;
+    texts_m.clear();
+    inline_m.clear();
+    bool ret = fread(&header_m, sizeof(header_m), 1, file_mp) == 1
+            && memcmp(header_m.magic, logMagic, sizeof(header_m.magic)) == 0
+            && header_m.version == AmbTransactionLogWriter::VERSION
+            && header_m.recordSize == sizeof(AmbTransactionLogRecord);
+    if (!ret)
+        close();
+    return ret;
+}
+
+void AmbTransactionLogReader::close() {
+    if (file_mp) {
+        fclose(file_mp);
+        file_mp = NULL;
+    }
+}
+
+bool AmbTransactionLogReader::next(AmbTransactionLogEntry &target) {
+    if (!file_mp)
+        return false;
+    AmbTransactionLogRecord record;
+    while (fread(&record, sizeof(record), 1, file_mp) == 1) {
+        if (record.trans == AmbTransactionLogRecord::TRANS_TEXT) {
+            string text;
+            if (!readText(record.iValue, text))
+                return false;
+            if (record.textId == AmbTransactionLogRecord::TEXT_INLINE)
+                inline_m = text;
+            else
+                texts_m[record.textId] = text;
+            continue;
+        }
+        const char *text = "";
+        if (record.textId == AmbTransactionLogRecord::TEXT_INLINE)
+            text = inline_m.c_str();
+        else {
+            map<uint16_t, string>::const_iterator it = texts_m.find(record.textId);
+            if (it != texts_m.end())
+                text = it -> second.c_str();
+        }
+        target.set(record.trans, text, record.RCA, record.FEStatus, record.iValue, record.fValue);
+        target.ts = record.timestamp;
+        return true;
+    }
+    return false;
+}
+
+bool AmbTransactionLogReader::readText(uint32_t length, string &target) {
+    unsigned size = ((length + sizeof(AmbTransactionLogRecord) - 1) / sizeof(AmbTransactionLogRecord))
+                  * sizeof(AmbTransactionLogRecord);
+    if (length >= AmbTransactionLogEntry::TEXT_SIZE)
+        return false;
+    vector<char> buffer(size + 1, '\0');
+    if (size && fread(&buffer[0], size, 1, file_mp) != 1)
+        return false;
+    target.assign(&buffer[0], length);
+    return true;
+}
@@ -0,0 +1,154 @@
+#ifndef AMBTRANSACTIONLOGFILE_H_
+#define AMBTRANSACTIONLOGFILE_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2008
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ * Binary files of logged FE transactions, written by AmbTransactionLogger.
+ *
+ * A file is an AmbTransactionLogHeader followed by AmbTransactionLogRecords.  All fields are
+ * little-endian.  The property name of each transaction is written once, as a text record
+ * followed by the text itself padded to a whole number of records, and after that is referred
+ * to by its textId.  Checkpoint text is not kept:  each one is written inline before its record.
+ *----------------------------------------------------------------------
+ */
+
+#include <FrontEndAMB/ambDefs.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+#include <string>
+
+/// A transaction waiting to be logged.  Plain data, so that it can be copied into a ring without allocating.
+struct AmbTransactionLogEntry {
+    enum { TEXT_SIZE = 64 };        ///< longer property names and checkpoint text are truncated.
+
+    Time ts;                        ///< when it was logged, in the 100 ns units of setTimeStamp().
+    unsigned long iValue;           ///< integer value if applicable.
+    float fValue;                   ///< float value if applicable.
+    AmbRelativeAddr RCA;
+    int FEStatus;                   ///< status code returned by the FEMC.
+    int trans;                      ///< FEHardwareDevice::Transaction_t
+    char text[TEXT_SIZE];           ///< property name or checkpoint text.  Always terminated.
+
+    void set(int _trans, const char *_text, AmbRelativeAddr _RCA, int _FEStatus, unsigned long _iValue, float _fValue);
+    ///< fill in everything but the timestamp.
+};
+
+std::string formatAmbTransaction(const AmbTransactionLogEntry &entry);
+///< The text which AmbTransactionLogger writes to the log after the timestamp.
+///< Empty for transaction types which are not logged as text.
+
+/// The start of a transaction log file.
+struct AmbTransactionLogHeader {
+    char magic[8];                  ///< "FETRNLOG"
+    uint32_t version;               ///< AmbTransactionLogWriter::VERSION
+    uint32_t recordSize;            ///< sizeof(AmbTransactionLogRecord) when written.
+    uint64_t startTime;             ///< when the file was opened, in the 100 ns units of setTimeStamp().
+};
+
+/// One logged transaction, or the definition of a text.
+struct AmbTransactionLogRecord {
+    enum {
+        TRANS_TEXT = 0xFF,          ///< trans for a text record.  iValue is the length of the text which follows.
+        TEXT_INLINE = 0xFFFF        ///< textId for checkpoint text and for text which didn't fit in the table.
+                                    ///< It refers to the text record just before.
+    };
+
+    uint64_t timestamp;             ///< in the 100 ns units of setTimeStamp().
+    uint32_t RCA;
+    uint32_t iValue;
+    float fValue;
+    uint16_t textId;                ///< property name, as given by an earlier text record.
+    int8_t FEStatus;
+    uint8_t trans;                  ///< FEHardwareDevice::Transaction_t or TRANS_TEXT.
+};
+
+/// AmbTransactionLogWriter appends entries to a transaction log file.  Not thread safe:  it is only
+/// used by the AmbTransactionLogger thread.
+class AmbTransactionLogWriter {
+public:
+    enum { VERSION = 1 };
+
+    AmbTransactionLogWriter();
+    ~AmbTransactionLogWriter();
+
+    bool open(const std::string &fileName);
+    ///< Create the file and write the header.  Returns false if it can't be created.
+
+    void close();
+    ///< Flush and close the file.
+
+    bool isOpen() const
+      { return file_mp != NULL; }
+
+    void write(const AmbTransactionLogEntry *entries, unsigned count);
+    ///< Append a batch of entries and flush.
+
+    unsigned long getCount() const
+      { return count_m; }
+    ///< the number of entries written.
+
+private:
+    // forbid copy construct, assignment:
+    AmbTransactionLogWriter(const AmbTransactionLogWriter &other);
+    AmbTransactionLogWriter &operator =(const AmbTransactionLogWriter &other);
+
+    void writeText(uint16_t textId, const char *text);
+    ///< write a text record and the text.
+
+    FILE *file_mp;                              ///< the log.  NULL if not open.
+    std::map<std::string, uint16_t> texts_m;    ///< ids of the property names written so far.
+    unsigned long count_m;                      ///< entries written.
+};
+
+/// AmbTransactionLogReader reads back the entries from a transaction log file, one at a time.
+class AmbTransactionLogReader {
+public:
+    AmbTransactionLogReader();
+    ~AmbTransactionLogReader();
+
+    bool open(const std::string &fileName);
+    ///< Open the file and check the header.  Returns false if it can't be read or is not a log of this version.
+
+    void close();
+
+    const AmbTransactionLogHeader &getHeader() const
+      { return header_m; }
+
+    bool next(AmbTransactionLogEntry &target);
+    ///< Get the next entry.  Returns false at the end of the file.
+    ///< A file cut short by a crash may end with a partial record.  It is ignored.
+
+private:
+    // forbid copy construct, assignment:
+    AmbTransactionLogReader(const AmbTransactionLogReader &other);
+    AmbTransactionLogReader &operator =(const AmbTransactionLogReader &other);
+
+    bool readText(uint32_t length, std::string &target);
+    ///< read the text which follows a text record.
+
+    FILE *file_mp;                              ///< the log.  NULL if not open.
+    AmbTransactionLogHeader header_m;
+    std::map<uint16_t, std::string> texts_m;    ///< property names read so far.
+    std::string inline_m;                       ///< the last inline text.
+};
+
+#endif /*AMBTRANSACTIONLOGFILE_H_*/
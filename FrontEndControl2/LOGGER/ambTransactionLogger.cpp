@@ -21,231 +21,55 @@
 #include "AmbTransactionLogger.h"
 #include "logger.h"
 #include "setTimeStamp.h"
-#include "feAddressMeta.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <string>
-#include <sstream>
-#include <iomanip>
+#include <algorithm>
 using namespace std;
 
-/// define the structure for items waiting to be logged.
-struct AmbTransactionLogger::LogEntry {
-    Time ts;
-    FEHardwareDevice::Transaction_t trans;
-    string text;
-    AmbRelativeAddr RCA;
-    int FEStatus;
-    unsigned long iValue;
-    float fValue;
-    
-    LogEntry(Time _ts = 0,
-             FEHardwareDevice::Transaction_t _trans = FEHardwareDevice::FEMC_LOG_NONE,
-             const char *_text = "",
-             AmbRelativeAddr _RCA = 0,
-             int _FEStatus = FEMC_NO_ERROR,
-             unsigned long _iValue = 0,
-             float _fValue = 0.0)
-      : ts(_ts),
-        trans(_trans),
-        text(_text),
-        RCA(_RCA),
-        FEStatus(_FEStatus),
-        iValue(_iValue),
-        fValue(_fValue)
-        {}
-};
-
-typedef std::vector<AmbTransactionLogger::LogEntry *> LogBuffer_t;
-///< type for circular buffer and for passing sets of entries.
-
-//----------------------------------------------------------------------------
-
-static const int BUFFER_SIZE = 4000;
-
-/// Define the class for the log buffer, a circular buffer of pointers to LogEntry with a mutex to protect the queue.
-class AmbTransactionLogger::LogBuffer {
-public:
-    LogBuffer(int bufferSize = BUFFER_SIZE);
-    ///< construct with the size (number of messages) in the circular buffer.
-
-    ~LogBuffer();
-    ///< destructor.  deletes all entries by calling reset().
-    
-    void insertEntry(LogEntry *entry);
-    ///< insert the entry to be logged.  LogBuffer takes ownership of the pointer.
-    
-    int getEntriesToLog(LogBuffer_t &toLog);
-    ///< get the sequence of entries to be logged since last call to getEntriesToLog().
-    ///< items are copied into toLog and must be deleted by the caller.
-    ///< Returns the number of items found. 
-        
-private:
-    LogBuffer(const AmbTransactionLogger::LogBuffer &other);
-    
-    LogBuffer &operator =(const AmbTransactionLogger::LogBuffer &other);
-    
-    void reset();
-    ///< delete all entries and set pointers to NULL.
-    ///< handles locking/unlocking the mutex.
-        
-    int getNextInsertIndex();
-    ///< get the index of the next available insert position.
-    ///< handles locking/unlocking the mutex.
-
-    int getNextLogIndex(int &nextLogBegin, int &nextLogEnd);
-    ///< get the range of indexes to be logged.  If begin==end then nothing to log.
-    ///< handles locking/unlocking the mutex.
-    ///< returns the maximum number of items to log.
-    
-    void setNextLogIndex(int nextLogBegin, int numItemsLogged);
-    ///< set the actual next item to be logged.  
-    ///< May be different from nextLogEnd returned by getNextLogIndex if a NULL item was found before reaching nextLogEnd.
-
-    pthread_mutex_t mutex;  ///< mutex to protect the buffer.
-    int bufferSize_m;       ///< size of the circular buffer.
-    int nextInsertPos_m;    ///< next available position for an entry to be inserted.
-    int nextLogPos_m;       ///< next item waiting to be logged.
-    int numItems_m;         ///< number of items waiting to be logged.
-    LogBuffer_t buffer_m;   ///< the circular buffer of entries to log.
+/// A ring of entries written by one thread and read by the logger thread.
+struct AmbTransactionLogger::Ring {
+    /// An entry and its sequence number:  2 * position + 1 while being written, 2 * position + 2 once written.
+    struct Slot {
+        std::atomic<unsigned long long> sequence;
+        AmbTransactionLogEntry entry;
+    };
+
+    Slot *slots_p;                              ///< the ring buffer.
+    unsigned mask;                              ///< size - 1, for wrapping positions.
+    std::atomic<unsigned long long> head;       ///< next position to write.  Only the producer changes it.
+    std::atomic<unsigned long long> tail;       ///< next position to read.  Only the consumer changes it.
+    std::atomic<unsigned long> logged;          ///< entries accepted.  Only the producer changes it.
+    std::atomic<unsigned long> dropped;         ///< entries dropped because the ring was full.
+    std::atomic<bool> owned;                    ///< a thread is logging to this ring.
+
+    Ring(unsigned size)
+      : slots_p(new Slot[size]), mask(size - 1), head(0), tail(0), logged(0), dropped(0), owned(false)
+      { for (unsigned index = 0; index < size; ++index) slots_p[index].sequence = 0; }
+
+    ~Ring()
+      { delete[] slots_p; }
 };
 
-AmbTransactionLogger::LogBuffer::LogBuffer(int bufferSize)
-  : bufferSize_m(bufferSize),
-    nextInsertPos_m(0),
-    nextLogPos_m(0),
-    numItems_m(0),
-    buffer_m(bufferSize_m, (LogEntry *)(NULL))
-{ 
-    LOG(LM_TRACE) << "AmbTransactionLogger::LogBuffer constructor" << endl;
-    pthread_mutex_init(&mutex, NULL);
-}
-
-AmbTransactionLogger::LogBuffer::~LogBuffer() {
-    reset(); 
-    pthread_mutex_destroy(&mutex);
-    LOG(LM_TRACE) << "AmbTransactionLogger::LogBuffer destructor" << endl;
-}
-
-void AmbTransactionLogger::LogBuffer::insertEntry(LogEntry *entry) {
-    if (!entry)
-        return;
-    // get the next insert position (takes care of locking the mutex):
-    int pos = getNextInsertIndex();
-    if (pos < 0) {
-        LOG(LM_WARNING) << "AmbTransactionLogger::LogBuffer::insertEntry:  Buffer is full." << endl;
-        delete entry;
-    } else {
-        // and save the pointer to the new entry:
-        buffer_m[pos] = entry;
-    }
-}
-    
-int AmbTransactionLogger::LogBuffer::getEntriesToLog(LogBuffer_t &toLog) {
-    // get the range of indexes to return:
-    int nextLogBegin, nextLogEnd, maxCount;
-    maxCount = getNextLogIndex(nextLogBegin, nextLogEnd);
-    // quit if nothing to log:
-    if (maxCount == 0)
-        return 0;
-    // prepare the output buffer:    
-    toLog.clear();
-    toLog.reserve(maxCount);
-    // move up to maxCount items from buffer_m into toLog:
-    // Stop early if a NULL pointer is encountered.
-    int pos(nextLogBegin), count(0);
-    while (count < maxCount && buffer_m[pos] != NULL) {        
-        ++count;
-        // ownership of the pointer is transferred over to toLog:
-        toLog.push_back(buffer_m[pos]);
-        buffer_m[pos] = NULL;
-        ++pos;
-        if (pos == bufferSize_m)
-            pos = 0;
-    }
-    // Save the next starting log index:
-    setNextLogIndex(pos, count);
-    // return the number of items actually moved:
-    return count;
-}
-    
-// private:
-
-void AmbTransactionLogger::LogBuffer::reset() {
-    pthread_mutex_lock(&mutex);
-    // delete and set all entries to NULL:
-    for (int index = 0; index < bufferSize_m; ++index) {
-        delete buffer_m[index];
-        buffer_m[index] = NULL;
-    }
-    nextInsertPos_m = 0,
-    nextLogPos_m = 0;    
-    pthread_mutex_unlock(&mutex);
-}
-    
-int AmbTransactionLogger::LogBuffer::getNextInsertIndex() {
-    pthread_mutex_lock(&mutex);
-    // get the next insert position:
-//    int preInsertPos(nextInsertPos_m);
-//    int preLogPos(nextLogPos_m);
-//    int preNumItems(numItems_m);
-    int pos(nextInsertPos_m);
-    // if an entry already exists then the buffer is full; return -1:
-    if (buffer_m[pos] != NULL)
-        pos = -1;
-    // otherwise, increment and account for circular buffer wraparound: 
-    else {
-        ++numItems_m;
-        ++nextInsertPos_m;
-        if (nextInsertPos_m == bufferSize_m)
-            nextInsertPos_m = 0;
-    }
-//    int postInsertPos(nextInsertPos_m);
-//    int postNumItems(numItems_m);
-    // unlock and return the saved position:
-    pthread_mutex_unlock(&mutex);
-    //LOG(LM_DEBUG) << "LogBuffer::getNextInsertIndex preInsertPos=" << preInsertPos 
-    //              << " preNumItems=" << preNumItems << " preLogPos=" << preLogPos 
-    //              << " postInsertPos=" << postInsertPos
-    //              << " postNumItems=" << postNumItems << " pos=" << pos << endl;
-    return pos;
-}
-
-int AmbTransactionLogger::LogBuffer::getNextLogIndex(int &nextLogBegin, int &nextLogEnd) {        
-    pthread_mutex_lock(&mutex);
-//    int preNumItems(numItems_m);
-    // set nextLogBegin to the first available item:
-    nextLogBegin = nextLogPos_m;
-    // set nextLogEnd one past the last available item, = the next insert position:    
-    nextLogEnd = nextInsertPos_m;
-    pthread_mutex_unlock(&mutex);
-    // compute and return the number of items in the range:
-    int count = numItems_m; // nextLogEnd - nextLogBegin;
-    //LOG(LM_DEBUG) << "LogBuffer::getNextLogIndex nextLogBegin=" << nextLogBegin << " nextLogEnd=" << nextLogEnd 
-    //              << " preNumItems=" << preNumItems << " count=" << count << endl;
-    return count;
-}
-
-void AmbTransactionLogger::LogBuffer::setNextLogIndex(int nextLogBegin, int numItemsLogged) {
-    pthread_mutex_lock(&mutex);
-//    int preLogPos(nextLogPos_m);
-//    int preNumItems(numItems_m);
-    nextLogPos_m = nextLogBegin;
-    numItems_m -= numItemsLogged;
-//    int postNumItems(numItems_m);
-    pthread_mutex_unlock(&mutex);
-    //LOG(LM_DEBUG) << "LogBuffer::setNextLogIndex preLogPos=" << preLogPos << " preNumItems=" << preNumItems
-    //              << " nextLogPos_m=" << nextLogPos_m << " postNumItems=" << postNumItems << endl;
-}    
-
 //-----------------------------------------------------------------------------
 
-AmbTransactionLogger::AmbTransactionLogger(bool useStream)
-  : buffer_mp(new LogBuffer),
+AmbTransactionLogger::AmbTransactionLogger(bool useStream, unsigned ringSize)
+  : ringSize_m(2),
+    policy_m(DROP_NEWEST),
+    overwritten_m(0),
+    written_m(0),
     useStream_m(useStream),
+    interval_m(DEFAULT_INTERVAL),
     do_shutdown(false),
     shutdown_done(false)
 {
+    while (ringSize_m < ringSize)
+        ringSize_m <<= 1;
+    pthread_mutex_init(&ringsMutex_m, NULL);
+    pthread_mutex_init(&writerMutex_m, NULL);
+    pthread_key_create(&ringKey_m, releaseRing);
+
     // Create the worker thread, passing this as the thread argument:
     LOG(LM_INFO) << "AmbTransactionLogger starting logger thread..." << endl;
     pthread_create(&thread_m, NULL, reinterpret_cast<void*(*)(void*)> (loggerThread), this);
@@ -254,13 +78,48 @@ AmbTransactionLogger::AmbTransactionLogger(bool useStream)
 
 AmbTransactionLogger::~AmbTransactionLogger() {
     shutdown();
-    delete buffer_mp;
+    close();
+    // No more thread exit callbacks to touch the rings:
+    pthread_key_delete(ringKey_m);
+    pthread_mutex_lock(&ringsMutex_m);
+    for (vector<Ring *>::iterator it = rings_m.begin(); it != rings_m.end(); ++it)
+        delete *it;
+    rings_m.clear();
+    pthread_mutex_unlock(&ringsMutex_m);
+    pthread_mutex_destroy(&ringsMutex_m);
+    pthread_mutex_destroy(&writerMutex_m);
 }
 
 void AmbTransactionLogger::setUseStream(bool useStream) {
 	useStream_m = useStream;
 }
 
+bool AmbTransactionLogger::open(const string &fileName) {
+    pthread_mutex_lock(&writerMutex_m);
+    bool ret = writer_m.open(fileName);
+    pthread_mutex_unlock(&writerMutex_m);
+    return ret;
+}
+
+void AmbTransactionLogger::close() {
+    pthread_mutex_lock(&writerMutex_m);
+    writer_m.close();
+    pthread_mutex_unlock(&writerMutex_m);
+}
+
+void AmbTransactionLogger::getStats(AmbTransactionLoggerStats &target) const {
+    target = AmbTransactionLoggerStats();
+    target.overwritten = overwritten_m;
+    target.written = written_m;
+    pthread_mutex_lock(const_cast<pthread_mutex_t *>(&ringsMutex_m));
+    target.rings = rings_m.size();
+    for (vector<Ring *>::const_iterator it = rings_m.begin(); it != rings_m.end(); ++it) {
+        target.logged += (*it) -> logged.load(std::memory_order_relaxed);
+        target.dropped += (*it) -> dropped;
+    }
+    pthread_mutex_unlock(const_cast<pthread_mutex_t *>(&ringsMutex_m));
+}
+
 void AmbTransactionLogger::shutdown() {
 	LOG(LM_INFO) << "AmbTransactionLogger stopping logger thread..." << endl;
     do_shutdown = true;
@@ -276,9 +135,10 @@ void AmbTransactionLogger::shutdown() {
 }
 
 void AmbTransactionLogger::checkPoint(const char *text) {
-    LogEntry *entry = new LogEntry(0, FEHardwareDevice::FEMC_LOG_CHECKPOINT, text);
-    setTimeStamp(&(entry -> ts));
-    buffer_mp -> insertEntry(entry);
+    AmbTransactionLogEntry entry;
+    entry.set(FEHardwareDevice::FEMC_LOG_CHECKPOINT, text, 0, FEMC_NO_ERROR, 0, 0.0);
+    setTimeStamp(&entry.ts);
+    insertEntry(entry);
 }    
 
 void AmbTransactionLogger::log(FEHardwareDevice::Transaction_t trans,
@@ -288,63 +148,142 @@ void AmbTransactionLogger::log(FEHardwareDevice::Transaction_t trans,
                                unsigned long iValue,
                                float fValue)
 {
-    LogEntry *entry = new LogEntry(0, trans, text, RCA, FEStatus, iValue, fValue);
-    setTimeStamp(&(entry -> ts));
-    buffer_mp -> insertEntry(entry);
+    AmbTransactionLogEntry entry;
+    entry.set(trans, text, RCA, FEStatus, iValue, fValue);
+    setTimeStamp(&entry.ts);
+    insertEntry(entry);
 }                               
 
+// private:
+
+AmbTransactionLogger::Ring &AmbTransactionLogger::getRing() {
+    Ring *ring = static_cast<Ring *>(pthread_getspecific(ringKey_m));
+    if (ring)
+        return *ring;
+    // First call from this thread.  Reuse a ring left empty by a thread which has exited, or make a new one:
+    pthread_mutex_lock(&ringsMutex_m);
+    for (vector<Ring *>::iterator it = rings_m.begin(); !ring && it != rings_m.end(); ++it) {
+        if (!(*it) -> owned && (*it) -> head == (*it) -> tail)
+            ring = *it;
+    }
+    if (!ring) {
+        ring = new Ring(ringSize_m);
+        rings_m.push_back(ring);
+    }
+    ring -> owned = true;
+    pthread_mutex_unlock(&ringsMutex_m);
+    pthread_setspecific(ringKey_m, ring);
+    return *ring;
+}
 
-void AmbTransactionLogger::logSingleItem(const LogEntry *entry) const {
-    if (entry && useStream_m) {
-        
-        const char *transText = FEHardwareDevice::TransactionText[entry -> trans];
+void AmbTransactionLogger::releaseRing(void *ring) {
+    if (ring)
+        static_cast<Ring *>(ring) -> owned = false;
+}
 
-        FrontEnd::FESelector_t selector;
-        selector.decode(entry -> RCA);
-        std::ostringstream os;
-        os << selector;       
-    
-        switch (entry -> trans) {
-            case FEHardwareDevice::FEMC_LOG_CHECKPOINT:
-            	LOGT(LM_INFO, &(entry -> ts)) << entry -> text << endl;  
-                break;
-            case FEHardwareDevice::FEMC_LOG_MONITOR:
-            case FEHardwareDevice::FEMC_LOG_COMMAND:
-            	LOGT(LM_INFO, &(entry -> ts)) << transText
-            	    << " 0x" << uppercase << hex << setw(6) << setfill('0') << (unsigned long) entry -> RCA << dec << setw(0)            	
-            	    << " '" << entry -> text << (os.str().length() ? " " : "") << os.str() << "'"
-            	    << " i=" << entry -> iValue << " f=" << entry -> fValue << " stat=" << entry -> FEStatus << endl;
-                break;
-            default:
-                break;
+void AmbTransactionLogger::insertEntry(const AmbTransactionLogEntry &entry) {
+    Ring &ring = getRing();
+    unsigned long long pos = ring.head.load(std::memory_order_relaxed);
+    if (policy_m == DROP_NEWEST && pos - ring.tail.load(std::memory_order_acquire) > ring.mask) {
+        ++ring.dropped;
+        return;
+    }
+    // Mark the slot as being written, write it, then publish it:
+    Ring::Slot &slot = ring.slots_p[pos & ring.mask];
+    slot.sequence.store(2 * pos + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.entry = entry;
+    slot.sequence.store(2 * pos + 2, std::memory_order_release);
+    ring.head.store(pos + 1, std::memory_order_release);
+    // single writer, so no read-modify-write is needed:
+    ring.logged.store(ring.logged.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+unsigned AmbTransactionLogger::drain(vector<AmbTransactionLogEntry> &target) {
+    target.clear();
+    pthread_mutex_lock(&ringsMutex_m);
+    vector<Ring *> rings(rings_m);
+    pthread_mutex_unlock(&ringsMutex_m);
+
+    AmbTransactionLogEntry entry;
+    for (vector<Ring *>::iterator it = rings.begin(); it != rings.end(); ++it) {
+        Ring &ring = **it;
+        unsigned long long head = ring.head.load(std::memory_order_acquire);
+        unsigned long long pos = ring.tail.load(std::memory_order_relaxed);
+        // Skip whatever has been overwritten already:
+        if (head - pos > ring.mask + 1) {
+            overwritten_m += head - pos - (ring.mask + 1);
+            pos = head - (ring.mask + 1);
         }
+        for (; pos < head; ++pos) {
+            Ring::Slot &slot = ring.slots_p[pos & ring.mask];
+            unsigned long long sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == 2 * pos + 2) {
+                entry = slot.entry;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                // Keep it only if the producer didn't start overwriting it while we copied:
+                if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+                    target.push_back(entry);
+                    continue;
+                }
+            }
+            ++overwritten_m;
+        }
+        ring.tail.store(pos, std::memory_order_release);
     }
+    stable_sort(target.begin(), target.end(),
+                [](const AmbTransactionLogEntry &a, const AmbTransactionLogEntry &b) { return a.ts < b.ts; });
+    return target.size();
+}
+
+void AmbTransactionLogger::writeEntries(const vector<AmbTransactionLogEntry> &entries) {
+    if (entries.empty())
+        return;
+    bool written = false;
+    pthread_mutex_lock(&writerMutex_m);
+    if (writer_m.isOpen()) {
+        writer_m.write(&entries[0], entries.size());
+        written = true;
+    }
+    pthread_mutex_unlock(&writerMutex_m);
+
+    if (useStream_m) {
+        for (vector<AmbTransactionLogEntry>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+            string text = formatAmbTransaction(*it);
+            if (!text.empty())
+                LOGT(LM_INFO, &(it -> ts)) << text << endl;
+        }
+        written = true;
+    }
+    if (written)
+        written_m += entries.size();
 }
 
 void *AmbTransactionLogger::loggerThread(AmbTransactionLogger *owner) {
     if (!owner)
         pthread_exit(NULL);
 
-    LogBuffer_t toLog;
-    LogEntry *entry;
-        
+    vector<AmbTransactionLogEntry> toLog;
+    toLog.reserve(owner -> ringSize_m);
+    AmbTransactionLoggerStats stats;
+    unsigned long lostBefore = 0;
+
     while (true) {
-        if (owner -> buffer_mp -> getEntriesToLog(toLog)) {
-            for (LogBuffer_t::iterator it = toLog.begin(); it != toLog.end(); ++it) {
-                entry = *it;
-                if (!entry)
-                    LOG(LM_WARNING) << "AmbTransactionLogger: Bad entry in loggerThread!" << endl;
-                else {
-                    owner -> logSingleItem(entry);
-                    delete entry;
-                }
-            }
+        bool stopping = owner -> do_shutdown;
+        if (owner -> drain(toLog))
+            owner -> writeEntries(toLog);
+        // Warn once per batch if any rings were full:
+        owner -> getStats(stats);
+        if (stats.dropped + stats.overwritten > lostBefore) {
+            LOG(LM_WARNING) << "AmbTransactionLogger: " << stats.dropped + stats.overwritten - lostBefore
+                            << " entries lost because a ring was full." << endl;
+            lostBefore = stats.dropped + stats.overwritten;
         }
-        if (owner -> do_shutdown) {    
+        if (stopping) {    
             owner -> shutdown_done = true;
             pthread_exit(NULL);
         } else
-            SLEEP(2000);
+            SLEEP(owner -> interval_m);
     }
 }
 
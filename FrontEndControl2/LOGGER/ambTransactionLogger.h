@@ -28,12 +28,45 @@
  */
 
 #include "FEBASE/FEHardwareDevice.h"
+#include "ambTransactionLogFile.h"
+#include <atomic>
 #include <string>
 #include <vector>
 
+/// Counters kept by AmbTransactionLogger.
+struct AmbTransactionLoggerStats {
+    unsigned long logged;           ///< entries accepted into the rings.
+    unsigned long dropped;          ///< entries not accepted because a ring was full.  DROP_NEWEST only.
+    unsigned long overwritten;      ///< entries overwritten in a ring before they were written.  OVERWRITE_OLDEST only.
+    unsigned long written;          ///< entries written to the binary file or the log stream.
+    unsigned rings;                 ///< rings created, one per thread which has logged.
+
+    AmbTransactionLoggerStats()
+      : logged(0), dropped(0), overwritten(0), written(0), rings(0)
+      {}
+};
+
+/// AmbTransactionLogger keeps a ring of AmbTransactionLogEntry for each thread which logs.  Each ring has a
+/// single producer and a single consumer, so log() takes no lock and allocates nothing after a thread's first call.
+/// A worker thread periodically drains all the rings, sorts what it found by time, and writes it in one batch
+/// to the binary log file and, if enabled, as text to the log stream.  The text decoding of the RCAs is done
+/// by the worker, or later by the decodeTransactionLog tool, never by the thread which logs.
+///
+/// When a ring is full, either the new entry is dropped or it overwrites the oldest one not yet written.
+/// Each slot carries a sequence number so that the worker can tell if an entry was overwritten while it read it.
 class AmbTransactionLogger : public FEHardwareDevice::LogInterface {
 public:    
-    AmbTransactionLogger(bool useStream = false);
+    enum OverflowPolicy {
+        DROP_NEWEST,                ///< keep what is in a full ring and count the new entry as dropped.
+        OVERWRITE_OLDEST            ///< replace the oldest entry in a full ring.
+    };
+
+    enum {
+        DEFAULT_RING_SIZE = 1024,   ///< entries per thread.  Always rounded up to a power of two.
+        DEFAULT_INTERVAL = 250      ///< ms between batches written by the worker.
+    };
+
+    AmbTransactionLogger(bool useStream = false, unsigned ringSize = DEFAULT_RING_SIZE);
     ///< construct
         
     virtual ~AmbTransactionLogger();
@@ -41,6 +74,26 @@ public:
     void setUseStream(bool useStream);
     ///< start/stop logging to the configured log stream.
 
+    bool open(const std::string &fileName);
+    ///< start writing to a binary log file.  Returns false if it can't be created.
+
+    void close();
+    ///< stop writing to the binary log file.
+
+    void setOverflowPolicy(OverflowPolicy policy)
+      { policy_m = policy; }
+    ///< what to do when a thread's ring is full.  Default DROP_NEWEST.
+
+    OverflowPolicy getOverflowPolicy() const
+      { return (OverflowPolicy) policy_m.load(); }
+
+    void setInterval(unsigned interval)
+      { interval_m = interval ? interval : 1; }
+    ///< set the ms between batches written by the worker.
+
+    void getStats(AmbTransactionLoggerStats &target) const;
+    ///< get the counters.
+
     void shutdown();
     ///< flushes log queue in preparation for destruction.
 
@@ -55,21 +108,46 @@ public:
                      float fValue);
     ///< Log an actual transaction. 
 
-    struct LogEntry;        ///< forward declare log entry structure.
-    
 private:
-    class LogBuffer;        ///< forward declare the circular buffer class.
-    LogBuffer *buffer_mp;   ///< circular buffer of log entries.
+    // forbid copy construct, assignment:
+    AmbTransactionLogger(const AmbTransactionLogger &other);
+    AmbTransactionLogger &operator =(const AmbTransactionLogger &other);
+
+    struct Ring;            ///< forward declare the per-thread ring.
+
+    Ring &getRing();
+    ///< the calling thread's ring.  Creates or reuses one on its first call.
+
+    static void releaseRing(void *ring);
+    ///< called when a thread exits to make its ring available for reuse.
+
+    void insertEntry(const AmbTransactionLogEntry &entry);
+    ///< copy an entry into the calling thread's ring.
+
+    unsigned drain(std::vector<AmbTransactionLogEntry> &target);
+    ///< move everything waiting in all rings into target, sorted by time.  Returns the number of entries.
+
+    void writeEntries(const std::vector<AmbTransactionLogEntry> &entries);
+    ///< write a batch to the binary file and the log stream.
+
+    std::vector<Ring *> rings_m;        ///< every ring created.  Only deleted with the logger.
+    pthread_mutex_t ringsMutex_m;       ///< protects rings_m.
+    pthread_key_t ringKey_m;            ///< each thread's ring.
+    unsigned ringSize_m;                ///< entries per ring.  A power of two.
+    std::atomic<int> policy_m;          ///< OverflowPolicy.
+    std::atomic<unsigned long> overwritten_m;   ///< counters reported by getStats(), with those of the rings:
+    std::atomic<unsigned long> written_m;
+
+    AmbTransactionLogWriter writer_m;   ///< the binary log file.
+    pthread_mutex_t writerMutex_m;      ///< protects writer_m.
 
     bool useStream_m;       ///< if true, log to the stream output.
+    unsigned interval_m;    ///< ms between batches.
 
     pthread_t thread_m;     ///< handle for the logging worker thread.
     bool do_shutdown;       ///< True when worker should die.
     bool shutdown_done;     ///< True when worker has died.
 
-    void logSingleItem(const LogEntry *entry) const;
-    ///< Log a single item to the output stream
-
     static void *loggerThread(AmbTransactionLogger *arg);
     ///< The function for the worker thread to which periodically logs whats in the buffer.
 
@@ -1,4 +1,5 @@
 #include "feAddressMeta.h"
+#include <stdio.h>
 
 namespace FrontEnd {
 
@@ -126,5 +127,45 @@ void FESelector_t::streamOut(std::ostream& out) const {
     if (cartridge >= 0)
         out << "Ca=" << (cartridge + 1);
 } 
+
+unsigned latencySubsystem(AmbRelativeAddr RCA) {
+    FESelector_t sel;
+    if (!sel.decode(RCA) || sel.subsys == SUBSYS_NONE)
+        return 0;
+    unsigned cartridge = (sel.cartridge >= 0 && sel.cartridge <= 9) ? (unsigned) sel.cartridge : 0x0F;
+    return ((sel.subsys + 1) << 4) | cartridge;
+}
+
+std::string latencySubsystemName(unsigned subsystem) {
+    static const char *names[] = { "AMBSI", "AMBSI S/N", "special monitor", "special control", 
+                                   "cartridge bias", "LO", "cartridge temp", "power distribution", 
+                                   "power module", "IF switch", "cryostat", "LPR" };
+    unsigned index = subsystem >> 4;
+    if (index == 0 || index > sizeof(names) / sizeof(names[0]))
+        return "other";
+    std::string name(names[index - 1]);
+    unsigned cartridge = subsystem & 0x0F;
+    if (cartridge <= 9) {
+        char band[12];
+        sprintf(band, " band %u", cartridge + 1);
+        name += band;
+    }
+    return name;
+}
+
+unsigned governorDevice(AmbRelativeAddr RCA) {
+    FESelector_t sel;
+    if (!sel.decode(RCA))
+        return 0;
+    switch (sel.subsys) {
+        case SUBSYS_CARTRIDGE_BIAS:
+        case SUBSYS_CARTRIDGE_LO:
+        case SUBSYS_CARTRIDGE_TEMP:
+        case SUBSYS_POWERDIST_CHANNEL:
+            return (sel.cartridge >= 0 && sel.cartridge <= 9) ? (unsigned) sel.cartridge + 1 : 0;
+        default:
+            return 0;
+    }
+}
     
 };  // namespace FrontEnd
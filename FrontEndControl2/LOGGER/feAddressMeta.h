@@ -112,6 +112,17 @@ namespace FrontEnd {
     inline std::ostream &operator << (std::ostream& out, const FESelector_t &sel)
       { sel.streamOut(out); return out; }
     ///< stream output for debugging FESelector_t 
+
+    unsigned latencySubsystem(AmbRelativeAddr RCA);
+    ///< Classify an RCA for the bus latency histograms:  (subsys + 1) << 4 plus the cartridge number,
+    ///< or 0x0F in place of the cartridge if not applicable.  Returns 0 if the RCA cannot be decoded.
+
+    std::string latencySubsystemName(unsigned subsystem);
+    ///< Describe a value returned by latencySubsystem().
+
+    unsigned governorDevice(AmbRelativeAddr RCA);
+    ///< Classify an RCA for the AmbGovernor:  the band 1-10 for the cartridge bias, LO, temperature,
+    ///< and power channel subsystems, otherwise 0 for the shared infrastructure.
     
 };
   
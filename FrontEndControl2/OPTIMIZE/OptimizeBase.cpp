@@ -21,6 +21,7 @@
 #include "OptimizeBase.h"
 #include "logger.h"
 #include <LOGGER/logDir.h>
+#include <FrontEndAMB/ambCompletion.h>
 using namespace std;
 
 OptimizeBase::OptimizeBase(const char *name)
@@ -96,6 +97,9 @@ void *OptimizeBase::optimizeThread(OptimizeBase *owner) {
     optimizeData &data_m = owner -> data_m;
     // TESTING:  try caching the name pointer to avoid access violation on exit.
     std::string name(owner -> name_m);
+
+    // CAN transactions made by this thread are queued ahead of background monitoring:
+    ambSetThreadPriority(AMB_PRIORITY_MEASUREMENT);
     
     bool done = false;
     while (!done) {
@@ -0,0 +1,562 @@
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2006
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ * class SimulatedBusInterface implements the command and monitor protocol
+ * with a simulated FEMC module.
+ *
+ *----------------------------------------------------------------------
+ */
+
+#include "SimulatedBusInterface.h"
+#include <FrontEndAMB/femcDefs.h>
+#include "portable.h"
+#include <chrono>
+#include <math.h>
+#include <string.h>
+using namespace FrontEnd;
+using namespace std::chrono;
+
+unsigned SimulatedBusInterface::latency_m = 150;
+unsigned SimulatedBusInterface::jitter_m = 0;
+
+namespace {
+    // offsets within the cartridge bias block:
+    const AmbRelativeAddr BIAS_POL_BIT          = 0x0400;
+    const AmbRelativeAddr BIAS_SB2_BIT          = 0x0080;
+    const AmbRelativeAddr BIAS_SIS_VOLTAGE      = 0x0008;
+    const AmbRelativeAddr BIAS_SIS_CURRENT      = 0x0010;
+    const AmbRelativeAddr BIAS_SIS_OPEN_LOOP    = 0x0018;
+    const AmbRelativeAddr BIAS_MAGNET_VOLTAGE   = 0x0020;
+    const AmbRelativeAddr BIAS_MAGNET_CURRENT   = 0x0030;
+    const AmbRelativeAddr BIAS_LNA_ENABLE       = 0x0058;
+    const AmbRelativeAddr BIAS_LED_ENABLE       = 0x0100;
+    const AmbRelativeAddr BIAS_HEATER_ENABLE    = 0x0180;
+    const AmbRelativeAddr BIAS_HEATER_CURRENT   = 0x01C0;
+
+    // offsets within the LO block, relative to BITMASK_CARTRIDGE_LO:
+    const AmbRelativeAddr LO_YTO_COARSE_TUNE    = 0x0000;
+    const AmbRelativeAddr LO_PHOTOMIXER_ENABLE  = 0x0010;
+    const AmbRelativeAddr LO_PHOTOMIXER_VOLTAGE = 0x0014;
+    const AmbRelativeAddr LO_PHOTOMIXER_CURRENT = 0x0018;
+    const AmbRelativeAddr LO_LOCK_DETECT        = 0x0020;
+    const AmbRelativeAddr LO_CORRECTION_VOLTAGE = 0x0021;
+    const AmbRelativeAddr LO_ASSEMBLY_TEMP      = 0x0022;
+    const AmbRelativeAddr LO_YTO_HEATER_CURRENT = 0x0023;
+    const AmbRelativeAddr LO_REF_TOTAL_POWER    = 0x0024;
+    const AmbRelativeAddr LO_IF_TOTAL_POWER     = 0x0025;
+    const AmbRelativeAddr LO_UNLOCK_LATCH       = 0x0027;
+    const AmbRelativeAddr LO_NULL_INTEGRATOR    = 0x002B;
+
+    // points in the power distribution module:
+    const AmbRelativeAddr POWER_ENABLE_MODULE   = 0xA00C;
+    const AmbRelativeAddr POWER_NUM_ENABLED     = 0xA0A0;
+
+    // the FETIM block, which FESelector_t does not decode:
+    const AmbRelativeAddr FETIM_BASE            = 0xE000;
+
+    // SIS junction model:
+    const float SIS_GAP_VOLTAGE = 2.8;      // mV
+    const float SIS_GAP_WIDTH = 0.05;       // mV
+    const float SIS_NORMAL_R = 20.0;        // ohms
+    const float SIS_SUBGAP_R = 400.0;       // ohms
+};
+
+SimulatedBusInterface::SimulatedBusInterface()
+  : transactions_m(0)
+{
+    pthread_mutex_init(&mutex_m, NULL);
+}
+
+SimulatedBusInterface::~SimulatedBusInterface() {
+    shutdown();
+    pthread_mutex_destroy(&mutex_m);
+}
+
+const nodeList_t* SimulatedBusInterface::findNodes(AmbChannel channel) {
+    if (!channelNodeMap_m.isOpenChannel(channel))
+        openChannel(channel);
+    channelNodeMap_m.clearNodes(channel);
+    // The FEMC module is the only node on the bus:
+    unsigned char serialNumber[8] = { 0x10, 'S', 'I', 'M', (unsigned char) channel, 0, 0, 0 };
+    channelNodeMap_m.addNode(channel, FE_NODE, serialNumber);
+    return &(channelNodeMap_m.getNodes(channel));
+}
+
+bool SimulatedBusInterface::openChannel(AmbChannel channel) {
+    channelNodeMap_m.setHandle(channel, 0);
+    channelNodeMap_m.openChannel(channel);
+    return true;
+}
+
+void SimulatedBusInterface::closeChannel(AmbChannel channel) {
+    if (channelNodeMap_m.isOpenChannel(channel))
+        channelNodeMap_m.closeChannel(channel);
+}
+
+void SimulatedBusInterface::monitorImpl(unsigned long handle, AmbMessage_t &msg) {
+    ++transactions_m;
+    simulateLatency();
+
+    AmbNodeAddr node = (msg.address >> 18) - 1;
+    AmbRelativeAddr RCA = msg.address & 0x3FFFF;
+    AmbDataLength_t dataLength = 0;
+    AmbDataMem_t data[AMB_DATA_MSG_SIZE];
+    memset(data, 0, AMB_DATA_MSG_SIZE);
+
+    // Anything not addressed to the FEMC module goes unanswered:
+    bool success = (node == FE_NODE) && simulateMonitor(msg.channel, RCA, dataLength, data);
+
+    if (msg.completion_p -> dataLength_p)
+        *(msg.completion_p -> dataLength_p) = success ? dataLength : 0;
+    if (msg.completion_p -> data_p)
+        memcpy(msg.completion_p -> data_p, data, AMB_DATA_MSG_SIZE);
+    if (msg.completion_p -> status_p)
+        *(msg.completion_p -> status_p) = success ? AMBERR_NOERR : AMBERR_TIMEOUT;
+}
+
+void SimulatedBusInterface::commandImpl(unsigned long handle, AmbMessage_t &msg) {
+    ++transactions_m;
+    simulateLatency();
+
+    AmbNodeAddr node = (msg.address >> 18) - 1;
+    if (node == FE_NODE)
+        simulateCommand(msg.channel, msg.address & 0x3FFFF, msg.dataLen, msg.data);
+
+    // Like CAN, a command is not acknowledged:
+    if (msg.completion_p -> status_p)
+        *(msg.completion_p -> status_p) = AMBERR_NOERR;
+}
+
+// --------------------------------------------------------------------------
+// transaction timing:
+
+void SimulatedBusInterface::simulateLatency() {
+    unsigned delay = latency_m;
+    if (jitter_m) {
+        pthread_mutex_lock(&mutex_m);
+        delay += random_m() % (jitter_m + 1);
+        pthread_mutex_unlock(&mutex_m);
+    }
+    if (!delay)
+        return;
+    ambWaitUntil(steady_clock::now() + microseconds(delay));
+}
+
+// --------------------------------------------------------------------------
+// monitor and command handling:
+
+bool SimulatedBusInterface::simulateMonitor(AmbChannel channel, AmbRelativeAddr RCA,
+                                            AmbDataLength_t &dataLength, AmbDataMem_t *data)
+{
+    // AMBSI serial number:
+    if (RCA == 0) {
+        unsigned char serialNumber[8] = { 0x10, 'S', 'I', 'M', (unsigned char) channel, 0, 0, 0 };
+        memcpy(data, serialNumber, 8);
+        dataLength = 8;
+        return true;
+    }
+    // Standard AMBSI monitor points.  These have no FE status byte:
+    if (RCA >= AMBSI_BASE) {
+        switch (RCA - AMBSI_BASE) {
+            case 0:     // protocol revision
+                data[0] = 1;
+                data[1] = 2;
+                data[2] = 0;
+                dataLength = 3;
+                return true;
+            case 1:     // CAN errors
+                pack((unsigned long) 0, dataLength, data);
+                return true;
+            case 2:     // transactions
+                pack((unsigned long) transactions_m, dataLength, data);
+                return true;
+            case 3:     // DS1820 temperature, in half degrees C:
+                data[0] = 60;
+                data[1] = 0;
+                data[2] = 0;
+                data[3] = 0;
+                dataLength = 4;
+                return true;
+            default:
+                return false;
+        }
+    }
+    // Readback of the last value sent to a control point:
+    if ((RCA & AMBSI_BASE) == CONTROL_BASE) {
+        if (getRegister(channel, RCA - CONTROL_BASE, dataLength, data))
+            data[dataLength++] = FEMC_NO_ERROR;
+        else
+            respond(0.0f, dataLength, data);
+        return true;
+    }
+    // FEMC special monitor points:
+    if ((RCA & AMBSI_BASE) == SPECIAL_MONITOR) {
+        switch (RCA - SPECIAL_MONITOR) {
+            case 0x00:  // AMBSI firmware version
+            case 0x02:  // FEMC firmware version
+            case 0x08:  // FPGA version
+                data[0] = 3;
+                data[1] = 0;
+                data[2] = 0;
+                dataLength = 3;
+                return true;
+            case 0x01:  // setup info
+                data[0] = 0;
+                dataLength = 1;
+                return true;
+            case 0x0A:  // ESNs found
+                respond((unsigned char) 0, dataLength, data);
+                return true;
+            case 0x0C:  // number of errors
+            case 0x0D:  // next error
+                respond((unsigned short) 0, dataLength, data);
+                return true;
+            case 0x0E:  // FE mode
+                respond(getByte(channel, RCA), dataLength, data);
+                return true;
+            default:
+                dataLength = 8;
+                return true;
+        }
+    }
+    return simulateFEMonitor(channel, RCA, dataLength, data);
+}
+
+bool SimulatedBusInterface::simulateFEMonitor(AmbChannel channel, AmbRelativeAddr RCA,
+                                              AmbDataLength_t &dataLength, AmbDataMem_t *data)
+{
+    // FETIM:
+    if ((RCA & BITMASK_CARTRIDGE) == FETIM_BASE) {
+        switch (RCA - FETIM_BASE) {
+            case 0x10: case 0x22: case 0x24: case 0x28: case 0x2C: case 0x30: case 0x34:
+            case 0x44: case 0x4C: case 0x54: case 0x58: case 0x60: case 0x68: case 0x80:
+                respond(getByte(channel, RCA), dataLength, data);
+                return true;
+            case 0x40: case 0x48:   // compressor external temperatures
+                respond(285.0f + noise(0.1), dataLength, data);
+                return true;
+            case 0x50:              // compressor He2 pressure
+                respond(1.5f + noise(0.01), dataLength, data);
+                return true;
+            default:
+                if ((RCA - FETIM_BASE) < 0x08)  // internal temperatures
+                    respond(295.0f + noise(0.1), dataLength, data);
+                else if ((RCA - FETIM_BASE) < 0x10) // air flow sensors
+                    respond(2.5f + noise(0.01), dataLength, data);
+                else
+                    respond(0.0f, dataLength, data);
+                return true;
+        }
+    }
+
+    FESelector_t sel;
+    if (!sel.decode(RCA)) {
+        respond(getFloat(channel, RCA), dataLength, data);
+        return true;
+    }
+    AmbRelativeAddr offset = sel.offset;
+    AmbRelativeAddr cartBase = RCA & BITMASK_CARTRIDGE;
+
+    switch (sel.subsys) {
+        case SUBSYS_CARTRIDGE_BIAS: {
+            // LED and heater points are per polarization; the rest per polarization and sideband:
+            AmbRelativeAddr point = (offset & 0x0100) ? (offset & 0x01C0) : (offset & 0x007F);
+            AmbRelativeAddr sbPolBase = RCA - point;
+            switch (point) {
+                case BIAS_SIS_VOLTAGE:
+                    respond(getFloat(channel, RCA) + noise(0.002), dataLength, data);
+                    break;
+                case BIAS_SIS_CURRENT:
+                    respond(sisCurrent(getFloat(channel, sbPolBase + BIAS_SIS_VOLTAGE)), dataLength, data);
+                    break;
+                case BIAS_MAGNET_VOLTAGE:
+                    // a superconducting coil.  Only the leads are resistive:
+                    respond(0.002f * getFloat(channel, sbPolBase + BIAS_MAGNET_CURRENT) + noise(0.0005), dataLength, data);
+                    break;
+                case BIAS_MAGNET_CURRENT:
+                    respond(getFloat(channel, RCA) + noise(0.01), dataLength, data);
+                    break;
+                case BIAS_SIS_OPEN_LOOP:
+                case BIAS_LNA_ENABLE:
+                case BIAS_LED_ENABLE:
+                case BIAS_HEATER_ENABLE:
+                    respond(getByte(channel, RCA), dataLength, data);
+                    break;
+                case BIAS_HEATER_CURRENT:
+                    respond(getByte(channel, sbPolBase + BIAS_HEATER_ENABLE) ? 20.0f + noise(0.05) : noise(0.05),
+                            dataLength, data);
+                    break;
+                default:
+                    if (point >= 0x40 && point < 0x58) {
+                        // LNA stages.  Drain voltage and current follow the commands while enabled:
+                        bool enabled = getByte(channel, sbPolBase + BIAS_LNA_ENABLE) != 0;
+                        if ((point & 0x03) == 0x02)
+                            respond(enabled ? 0.1f + noise(0.01) : 0.0f, dataLength, data);
+                        else
+                            respond(enabled ? getFloat(channel, RCA) + noise(0.01) : 0.0f, dataLength, data);
+                    } else
+                        respond(getFloat(channel, RCA), dataLength, data);
+                    break;
+            }
+            return true;
+        }
+
+        case SUBSYS_CARTRIDGE_TEMP: {
+            static const float temps[6] = { 4.0, 110.0, 4.0, 4.0, 15.0, 4.0 };
+            unsigned sensor = offset >> 4;
+            respond((sensor < 6 ? temps[sensor] : 4.0f) + noise(0.01), dataLength, data);
+            return true;
+        }
+
+        case SUBSYS_CARTRIDGE_LO: {
+            AmbRelativeAddr loBase = cartBase + BITMASK_CARTRIDGE_LO;
+            bool photomixer = getByte(channel, loBase + LO_PHOTOMIXER_ENABLE) != 0;
+            switch (offset) {
+                case LO_YTO_COARSE_TUNE:
+                    respond(getUShort(channel, RCA), dataLength, data);
+                    break;
+                case LO_PHOTOMIXER_VOLTAGE:
+                    respond(photomixer ? -1.0f + noise(0.01) : 0.0f, dataLength, data);
+                    break;
+                case LO_PHOTOMIXER_CURRENT:
+                    respond(photomixer ? -10.0f + noise(0.1) : 0.0f, dataLength, data);
+                    break;
+                case LO_LOCK_DETECT:
+                    respond(pllLocked(channel, cartBase) ? 4.8f + noise(0.05) : 0.1f + noise(0.05), dataLength, data);
+                    break;
+                case LO_CORRECTION_VOLTAGE:
+                    respond(pllLocked(channel, cartBase) ? noise(0.5) : -10.0f, dataLength, data);
+                    break;
+                case LO_ASSEMBLY_TEMP:
+                    respond(48.0f + noise(0.05), dataLength, data);
+                    break;
+                case LO_YTO_HEATER_CURRENT:
+                    respond(60.0f + noise(0.1), dataLength, data);
+                    break;
+                case LO_REF_TOTAL_POWER:
+                    respond(photomixer ? -1.5f + noise(0.01) : 0.0f, dataLength, data);
+                    break;
+                case LO_IF_TOTAL_POWER:
+                    respond(pllLocked(channel, cartBase) ? -1.0f + noise(0.01) : 0.0f, dataLength, data);
+                    break;
+                case LO_UNLOCK_LATCH:
+                    respond((unsigned char) (pllLocked(channel, cartBase) ? 0 : 1), dataLength, data);
+                    break;
+                case LO_PHOTOMIXER_ENABLE:
+                case 0x29: case 0x2A: case LO_NULL_INTEGRATOR:
+                case 0x36:
+                    respond(getByte(channel, RCA), dataLength, data);
+                    break;
+                default:
+                    if (offset >= 0x50 && offset < 0x60)    // PA Teledyne chip
+                        respond(getByte(channel, RCA), dataLength, data);
+                    else
+                        respond(getFloat(channel, RCA), dataLength, data);
+                    break;
+            }
+            return true;
+        }
+
+        case SUBSYS_POWERDIST_CHANNEL: {
+            AmbRelativeAddr moduleBase = RCA & ~0x000F;
+            AmbRelativeAddr point = RCA & 0x000F;
+            if (point == (POWER_ENABLE_MODULE & 0x000F)) {
+                respond(getByte(channel, RCA), dataLength, data);
+                return true;
+            }
+            static const float voltages[6] = { 6.0, -6.0, 15.0, -15.0, 24.0, 8.0 };
+            bool enabled = getByte(channel, moduleBase + (POWER_ENABLE_MODULE & 0x000F)) != 0;
+            if (point > 0x0B)
+                respond(0.0f, dataLength, data);
+            else if (point & 1)
+                respond(enabled ? voltages[point >> 1] + noise(0.01) : 0.0f, dataLength, data);
+            else
+                respond(enabled ? 150.0f + noise(1.0) : 0.0f, dataLength, data);
+            return true;
+        }
+
+        case SUBSYS_POWERDIST:
+            if (RCA == POWER_NUM_ENABLED) {
+                unsigned char count = 0;
+                for (AmbRelativeAddr cart = 0; cart < 10; ++cart)
+                    if (getByte(channel, POWER_ENABLE_MODULE + (cart << BITSHIFT_POWERDIST_CART)))
+                        ++count;
+                respond(count, dataLength, data);
+            } else
+                respond(getFloat(channel, RCA), dataLength, data);
+            return true;
+
+        case SUBSYS_IFSWITCH:
+            if (offset == 0x10 || (offset & 0x03) != 0x02)
+                // switch cartridge, temperature servo enable, attenuation:
+                respond(getByte(channel, RCA), dataLength, data);
+            else
+                respond(303.0f + noise(0.05), dataLength, data);
+            return true;
+
+        case SUBSYS_CRYOSTAT:
+            if (offset < 0x34) {
+                // 4 K, 15 K and 110 K stage sensors:
+                unsigned sensor = offset >> 2;
+                float temp = (sensor < 5) ? 4.0 : (sensor < 9) ? 15.0 : 110.0;
+                respond(temp + noise(0.01), dataLength, data);
+            } else switch (offset) {
+                case 0x34: case 0x38: case 0x39: case 0x3A: case 0x3C:
+                case 0x40: case 0x46: case 0x47:
+                    respond(getByte(channel, RCA), dataLength, data);
+                    break;
+                case 0x44:
+                    respond(1.0e-7f, dataLength, data);
+                    break;
+                case 0x45:
+                    respond(1.0e-3f, dataLength, data);
+                    break;
+                case 0x48:
+                    respond(2.5f + noise(0.01), dataLength, data);
+                    break;
+                default:
+                    respond(getFloat(channel, RCA), dataLength, data);
+                    break;
+            }
+            return true;
+
+        case SUBSYS_LPR:
+            if ((offset >= 0x20 && offset < 0x30) || offset == 0x3C)
+                respond(getByte(channel, RCA), dataLength, data);
+            else if (offset == 0x00 || offset == 0x10 || offset == 0x30)
+                respond(298.0f + noise(0.05), dataLength, data);
+            else
+                respond(getFloat(channel, RCA), dataLength, data);
+            return true;
+
+        default:
+            respond(getFloat(channel, RCA), dataLength, data);
+            return true;
+    }
+}
+
+void SimulatedBusInterface::simulateCommand(AmbChannel channel, AmbRelativeAddr RCA,
+                                            AmbDataLength_t dataLength, const AmbDataMem_t *data)
+{
+    // Store each command under the monitor RCA which reads it back:
+    AmbRelativeAddr key;
+    if ((RCA & AMBSI_BASE) == CONTROL_BASE)
+        key = RCA - CONTROL_BASE;
+    else if (RCA >= SPECIAL_CONTROL && RCA < AMBSI_BASE)
+        key = RCA - SPECIAL_CONTROL + SPECIAL_MONITOR;
+    else
+        return;
+
+    if (dataLength > AMB_DATA_MSG_SIZE)
+        dataLength = AMB_DATA_MSG_SIZE;
+    pthread_mutex_lock(&mutex_m);
+    Register &reg = registers_m[registerKey(channel, key)];
+    reg.dataLength = dataLength;
+    memcpy(reg.data, data, dataLength);
+    pthread_mutex_unlock(&mutex_m);
+}
+
+// --------------------------------------------------------------------------
+// models:
+
+float SimulatedBusInterface::sisCurrent(float voltage) {
+    // Smoothed step at the gap voltage from the subgap leakage to the normal resistance line:
+    float magnitude = fabs(voltage);
+    float step = 1.0 / (1.0 + exp(-(magnitude - SIS_GAP_VOLTAGE) / SIS_GAP_WIDTH));
+    float current = magnitude / SIS_SUBGAP_R + step * magnitude / SIS_NORMAL_R;
+    return ((voltage < 0) ? -current : current) + noise(0.0002);
+}
+
+bool SimulatedBusInterface::pllLocked(AmbChannel channel, AmbRelativeAddr cartBase) {
+    AmbRelativeAddr loBase = cartBase + BITMASK_CARTRIDGE_LO;
+    AmbDataLength_t dataLength;
+    AmbDataMem_t data[AMB_DATA_MSG_SIZE];
+    // Locks once the YTO has been tuned with the photomixer on and the loop integrator not nulled:
+    return getRegister(channel, loBase + LO_YTO_COARSE_TUNE, dataLength, data)
+        && getByte(channel, loBase + LO_PHOTOMIXER_ENABLE) != 0
+        && getByte(channel, loBase + LO_NULL_INTEGRATOR) == 0;
+}
+
+// --------------------------------------------------------------------------
+// register access:
+
+bool SimulatedBusInterface::getRegister(AmbChannel channel, AmbRelativeAddr RCA,
+                                        AmbDataLength_t &dataLength, AmbDataMem_t *data) const
+{
+    pthread_mutex_lock(&mutex_m);
+    std::map<RegisterKey, Register>::const_iterator it = registers_m.find(registerKey(channel, RCA));
+    bool found = (it != registers_m.end());
+    if (found) {
+        dataLength = it -> second.dataLength;
+        memcpy(data, it -> second.data, dataLength);
+    }
+    pthread_mutex_unlock(&mutex_m);
+    return found;
+}
+
+float SimulatedBusInterface::getFloat(AmbChannel channel, AmbRelativeAddr RCA, float defaultValue) {
+    AmbDataLength_t dataLength;
+    AmbDataMem_t data[AMB_DATA_MSG_SIZE];
+    float value = defaultValue;
+    if (getRegister(channel, RCA, dataLength, data))
+        unpack(value, dataLength, data);
+    return value;
+}
+
+unsigned short SimulatedBusInterface::getUShort(AmbChannel channel, AmbRelativeAddr RCA, unsigned short defaultValue) {
+    AmbDataLength_t dataLength;
+    AmbDataMem_t data[AMB_DATA_MSG_SIZE];
+    unsigned short value = defaultValue;
+    if (getRegister(channel, RCA, dataLength, data))
+        unpack(value, dataLength, data);
+    return value;
+}
+
+unsigned char SimulatedBusInterface::getByte(AmbChannel channel, AmbRelativeAddr RCA, unsigned char defaultValue) {
+    AmbDataLength_t dataLength;
+    AmbDataMem_t data[AMB_DATA_MSG_SIZE];
+    unsigned char value = defaultValue;
+    if (getRegister(channel, RCA, dataLength, data))
+        unpack(value, dataLength, data);
+    return value;
+}
+
+float SimulatedBusInterface::noise(float amplitude) {
+    pthread_mutex_lock(&mutex_m);
+    float value = (float) (random_m() - random_m.min()) / (random_m.max() - random_m.min());
+    pthread_mutex_unlock(&mutex_m);
+    return amplitude * (2.0 * value - 1.0);
+}
+
+void SimulatedBusInterface::respond(float value, AmbDataLength_t &dataLength, AmbDataMem_t *data) {
+    pack(value, dataLength, data);
+    data[dataLength++] = FEMC_NO_ERROR;
+}
+
+void SimulatedBusInterface::respond(unsigned short value, AmbDataLength_t &dataLength, AmbDataMem_t *data) {
+    pack(value, dataLength, data);
+    data[dataLength++] = FEMC_NO_ERROR;
+}
+
+void SimulatedBusInterface::respond(unsigned char value, AmbDataLength_t &dataLength, AmbDataMem_t *data) {
+    pack(value, dataLength, data);
+    data[dataLength++] = FEMC_NO_ERROR;
+}
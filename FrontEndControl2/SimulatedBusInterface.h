@@ -0,0 +1,133 @@
+#ifndef SIMULATEDBUSINTERFACE_H_
+#define SIMULATEDBUSINTERFACE_H_
+/*******************************************************************************
+* ALMA - Atacama Large Millimeter Array
+* (c) Associated Universities Inc., 2006
+*
+*This library is free software; you can redistribute it and/or
+*modify it under the terms of the GNU Lesser General Public
+*License as published by the Free Software Foundation; either
+*version 2.1 of the License, or (at your option) any later version.
+*
+*This library is distributed in the hope that it will be useful,
+*but WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*Lesser General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with this library; if not, write to the Free Software
+*Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*
+*/
+
+/************************************************************************
+ * class SimulatedBusInterface implements the command and monitor protocol
+ * with a simulated FEMC module in place of the CAN hardware, so that the
+ * whole control stack can be run and benchmarked without a front end.
+ *
+ *----------------------------------------------------------------------
+ */
+
+#include <FrontEndAMB/CANBusInterface.h>
+#include <FrontEndAMB/messagePackUnpack.h>
+#include "LOGGER/feAddressMeta.h"
+#include <map>
+#include <random>
+#include <atomic>
+
+/// SimulatedBusInterface answers the FE monitor and control RCA space as decoded by FrontEnd::FESelector_t.
+/// Commands are stored as register values, so that readbacks and dependent monitor points follow them.
+/// A few points are modeled rather than echoed:  SIS junction current follows a simple I-V curve
+/// of the commanded junction voltage, the LO PLL locks once the YTO is tuned with the photomixer on,
+/// and temperatures and pressures read back plausible values for a cold front end.
+/// Anything else reads back the last value commanded, or zero.
+///
+/// Each transaction takes latency_m plus up to jitter_m microseconds.  The wait is spent in the
+/// channel worker thread, like a real bus transaction, so queuing and pipelining behave as they would.
+class SimulatedBusInterface : public CANBusInterface, private MessagePackUnpack {
+public:
+    enum {
+        FE_NODE = 0x13      ///< the FEMC module's node address.
+    };
+
+    SimulatedBusInterface();
+    virtual ~SimulatedBusInterface();
+
+    virtual const nodeList_t* findNodes(AmbChannel channel);
+    ///< Report the simulated FEMC node on the specified channel.  Opens the channel if necessary.
+
+    unsigned long getTransactionCount() const
+      { return transactions_m; }
+    ///< the number of monitor and command transactions handled so far.
+
+    static unsigned latency_m;      ///< simulated time per transaction, us.  Default 150.
+    static unsigned jitter_m;       ///< random extra time per transaction, 0 to jitter_m us.  Default 0.
+
+private:
+    // forbid copy construct, assignment:
+    SimulatedBusInterface(const SimulatedBusInterface &other);
+    SimulatedBusInterface &operator =(const SimulatedBusInterface &other);
+
+    virtual bool openChannel(AmbChannel channel);
+    // mark the channel open.  Always succeeds.
+
+    virtual void closeChannel(AmbChannel channel);
+    // mark the channel closed.
+
+    virtual void monitorImpl(unsigned long handle, AmbMessage_t &msg);
+    // Called by worker thread.  Waits out the simulated transaction time and answers the monitor request.
+
+    virtual void commandImpl(unsigned long handle, AmbMessage_t &msg);
+    // Called by worker thread.  Waits out the simulated transaction time and stores the command payload.
+
+    void simulateLatency();
+    // busy-wait for the transaction time.  The bulk of a long wait is slept.
+
+    bool simulateMonitor(AmbChannel channel, AmbRelativeAddr RCA, AmbDataLength_t &dataLength, AmbDataMem_t *data);
+    // produce the response to a monitor request.  Returns false if there would be no response.
+
+    bool simulateFEMonitor(AmbChannel channel, AmbRelativeAddr RCA, AmbDataLength_t &dataLength, AmbDataMem_t *data);
+    // produce the response for a monitor point in MONITOR_BASE.
+
+    void simulateCommand(AmbChannel channel, AmbRelativeAddr RCA, AmbDataLength_t dataLength, const AmbDataMem_t *data);
+    // store the payload of a command.
+
+    // models for particular monitor points:
+    float sisCurrent(float voltage);
+    ///< SIS junction current in mA for a junction voltage in mV.
+
+    bool pllLocked(AmbChannel channel, AmbRelativeAddr cartBase);
+    ///< true if the LO with the given cartridge base address is locked.
+
+    // register access.  The register for a control RCA is keyed by its monitor RCA:
+    typedef unsigned long long RegisterKey;
+    static RegisterKey registerKey(AmbChannel channel, AmbRelativeAddr RCA)
+      { return ((RegisterKey) channel << 32) | RCA; }
+
+    bool getRegister(AmbChannel channel, AmbRelativeAddr RCA, AmbDataLength_t &dataLength, AmbDataMem_t *data) const;
+    ///< get the payload last commanded to RCA.  Returns false if never commanded.
+
+    float getFloat(AmbChannel channel, AmbRelativeAddr RCA, float defaultValue = 0.0);
+    unsigned short getUShort(AmbChannel channel, AmbRelativeAddr RCA, unsigned short defaultValue = 0);
+    unsigned char getByte(AmbChannel channel, AmbRelativeAddr RCA, unsigned char defaultValue = 0);
+    ///< the last value commanded to RCA, unpacked, or defaultValue.
+
+    float noise(float amplitude);
+    ///< a uniform random value between -amplitude and +amplitude.
+
+    // helpers to pack a response with the trailing FE status byte:
+    void respond(float value, AmbDataLength_t &dataLength, AmbDataMem_t *data);
+    void respond(unsigned short value, AmbDataLength_t &dataLength, AmbDataMem_t *data);
+    void respond(unsigned char value, AmbDataLength_t &dataLength, AmbDataMem_t *data);
+
+    struct Register {
+        AmbDataLength_t dataLength;         ///< payload length, not including any status byte.
+        AmbDataMem_t data[AMB_DATA_MSG_SIZE];
+    };
+    std::map<RegisterKey, Register> registers_m;    ///< values commanded so far.
+    std::minstd_rand random_m;                      ///< noise generator.
+    mutable pthread_mutex_t mutex_m;                ///< protects registers_m and random_m.
+    std::atomic<unsigned long> transactions_m;      ///< count of transactions handled.
+};
+
+#endif /*SIMULATEDBUSINTERFACE_H_*/
@@ -0,0 +1,119 @@
+// Step a dummy device's MONITORS_REGISTRY with a mix of fixed and adaptive monitor points and check
+// that stable points slow down, changing points and points outside their limits stay fast, and
+// that fixed points are still read once per pass.
+
+#include "FEBASE/FEHardwareDevice.h"
+#include "portable.h"
+#include <stdio.h>
+
+const int numFixed = 20;
+
+/// A device with fixed and adaptive monitor points which need no hardware.
+class AdaptiveDevice : public FEHardwareDevice {
+public:
+    AdaptiveDevice()
+      : FEHardwareDevice("Adaptive"),
+        stable_value(0), moving_value(0), limited_value(0),
+        fixedReads(0), stableReads(0), movingReads(0), limitedReads(0),
+        passes(0)
+    {
+        // The stable point in the middle of the fixed points:
+        for (int index = 0; index < numFixed; ++index) {
+            addMon(&fixed_value[index], &AdaptiveDevice::fixed, "fixed");
+            if (index == numFixed / 2)
+                addMon(&stable_value, &AdaptiveDevice::stable, "stable");
+        }
+        addMon(&moving_value, &AdaptiveDevice::moving, "moving");
+        addMon(&limited_value, &AdaptiveDevice::limited, "limited");
+        setMonRate(&stable_value, 20, 1000, 0.1);
+        setMonRate(&moving_value, 20, 1000, 0.1);
+        setMonRate(&limited_value, 20, 1000, 0.1);
+        setMonLimits(&limited_value, 0.0, 1.0);
+        nextMon = 0;
+    }
+
+    float fixed()
+      { ++fixedReads; return 1.0; }
+    float stable()
+      { ++stableReads; return 4.0 + 0.01 * (stableReads & 1); }
+    float moving()
+      { ++movingReads; return (float) movingReads; }
+    float limited()
+      { ++limitedReads; return 2.0; }
+
+    void step() {
+        if (!executeNextMon())
+            ++passes;
+    }
+
+    void printStats() const {
+        for (unsigned index = 0; index < adaptiveMons.size(); ++index) {
+            const RegEntry &entry = monitorRegistry[adaptiveMons[index]];
+            const FEMonitorPointStats &stats = entry.stats();
+            printf("  %-8s interval %4lu ms, %4lu polls, %4lu extra, %4lu skipped, %4lu changes, %4lu violations\n",
+                   entry.name().c_str(), stats.interval, stats.polls, stats.extraPolls, stats.skipped, stats.changes, stats.violations);
+        }
+    }
+
+    const FEMonitorPointStats &stats(float *target)
+      { return findMon(target) -> stats(); }
+
+    float fixed_value[numFixed], stable_value, moving_value, limited_value;
+    unsigned long fixedReads, stableReads, movingReads, limitedReads;
+    unsigned long passes;
+
+protected:
+    virtual void monitorAction(Time *timestamp_p)
+      {}
+
+private:
+    DECLARE_MONITORS_REGISTRY(AdaptiveDevice)
+};
+
+DEFINE_MONITORS_REGISTRY(AdaptiveDevice)
+
+int main(int, char*[]) {
+    int errors = 0;
+    AdaptiveDevice device;
+
+    // Step every 5 ms for 3 seconds, as the monitor scheduler would:
+    for (int step = 0; step < 600; ++step) {
+        device.step();
+        SLEEP(5);
+    }
+    printf("%lu passes: fixed %lu, stable %lu, moving %lu, limited %lu reads\n",
+           device.passes, device.fixedReads, device.stableReads, device.movingReads, device.limitedReads);
+    device.printStats();
+
+    // The fixed points are read once per pass:
+    if (device.fixedReads < numFixed * device.passes || device.fixedReads > numFixed * (device.passes + 1)) {
+        printf("fixed points read %lu times in %lu passes <-- ERROR\n", device.fixedReads, device.passes);
+        ++errors;
+    }
+    // The stable point slows down to its maximum interval:
+    if (device.stats(&device.stable_value).interval != 1000 || device.stableReads > 15) {
+        printf("stable point didn't slow down <-- ERROR\n");
+        ++errors;
+    }
+    // The moving point stays fast:
+    if (device.stats(&device.moving_value).interval != 20) {
+        printf("moving point didn't stay fast <-- ERROR\n");
+        ++errors;
+    }
+    // The limited point never changes, but is outside its limits:
+    if (device.stats(&device.limited_value).interval != 20) {
+        printf("limited point didn't stay fast <-- ERROR\n");
+        ++errors;
+    }
+    // Between them they get the stable point's turns as well as their own:
+    if (device.movingReads + device.limitedReads < 2 * device.passes + device.passes / 2) {
+        printf("stable point's turns not given to the fast points <-- ERROR\n");
+        ++errors;
+    }
+    if (!device.stats(&device.stable_value).savedTime() && !device.stats(&device.stable_value).skipped) {
+        printf("no turns skipped <-- ERROR\n");
+        ++errors;
+    }
+    printf("%d errors\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+// Benchmark of unpacking float monitor payloads through the MessagePackUnpack virtual interface
+// against the inlined AmbCodec and the AmbCodecBatch struct-of-arrays decoder.
+// Also checks that all three give the same values and statuses for every payload layout.
+
+#include "FrontEndAMB/messagePackUnpack.h"
+#include "FrontEndAMB/ambCodec.h"
+#include <chrono>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std::chrono;
+
+const unsigned numPayloads = 4096;
+const int passes = 2000;
+
+int checkTypes(MessagePackUnpack &packer) {
+    int errors = 0;
+    AmbDataLength_t dataLength;
+    AmbDataMem_t data[8];
+
+    // Every integer type round trips through pack and unpack, with and without a status byte:
+    unsigned long ulValue = 0xDEADBEEF, ulTarget;
+    packer.pack(ulValue, dataLength, data);
+    if (packer.unpack(ulTarget, dataLength, data) != FEMC_NO_ERROR || ulTarget != ulValue)
+        ++errors;
+    data[dataLength++] = (AmbDataMem_t) FEMC_HARDW_RETRY_WARN;
+    if (AmbCodec<unsigned long>::unpack(ulTarget, dataLength, data) != FEMC_HARDW_RETRY_WARN || ulTarget != ulValue)
+        ++errors;
+
+    short sValue = -1234, sTarget;
+    AmbCodec<short>::pack(sValue, dataLength, data);
+    if (packer.unpack(sTarget, dataLength, data) != FEMC_NO_ERROR || sTarget != sValue)
+        ++errors;
+
+    unsigned short usValue = 0xABCD, usTarget;
+    packer.pack(usValue, dataLength, data);
+    if (AmbCodec<unsigned short>::unpack(usTarget, dataLength, data) != FEMC_NO_ERROR || usTarget != usValue)
+        ++errors;
+
+    bool bTarget = false;
+    AmbCodec<bool>::pack(true, dataLength, data);
+    data[dataLength++] = FEMC_NO_ERROR;
+    if (packer.unpack(bTarget, dataLength, data) != FEMC_NO_ERROR || !bTarget)
+        ++errors;
+
+    // A lone byte in the range of FEMC_ERROR is a status:
+    unsigned char ucTarget;
+    data[0] = (AmbDataMem_t) FEMC_HARDW_BLOCKED_ERR;
+    if (AmbCodec<unsigned char>::unpack(ucTarget, 1, data) != FEMC_HARDW_BLOCKED_ERR || ucTarget != 0)
+        ++errors;
+
+    if (errors)
+        printf("checkTypes: %d errors\n", errors);
+    return errors;
+}
+
+int main(int, char*[]) {
+    MessagePackUnpack packer;
+    MessagePackUnpack &virtualPacker(packer);
+    int errors = checkTypes(packer);
+
+    // Payloads as they come back from the FEMC: mostly a float and status byte, with some bare floats,
+    // some bare status bytes, and some too short to unpack:
+    std::vector<AmbDataMem_t> payloads(numPayloads * AMB_DATA_MSG_SIZE, 0);
+    std::vector<AmbDataLength_t> lengths(numPayloads);
+    std::vector<AmbMonitorResult_t> results(numPayloads);
+    srand(1);
+    for (unsigned index = 0; index < numPayloads; ++index) {
+        AmbDataMem_t *data = &payloads[index * AMB_DATA_MSG_SIZE];
+        AmbDataLength_t dataLength;
+        AmbCodec<float>::pack((rand() % 200000 - 100000) / 1000.0f, dataLength, data);
+        switch (index % 16) {
+            case 0:
+                dataLength = 4;
+                break;
+            case 1:
+                dataLength = 1;
+                data[0] = (AmbDataMem_t) FEMC_HARDW_RETRY_WARN;
+                break;
+            case 2:
+                dataLength = 2;
+                break;
+            default:
+                data[4] = (index % 7) ? FEMC_NO_ERROR : (AmbDataMem_t) FEMC_HARDW_UPDATE_WARN;
+                dataLength = 5;
+                break;
+        }
+        lengths[index] = dataLength;
+        results[index].dataLength = dataLength;
+        memcpy(results[index].data, data, AMB_DATA_MSG_SIZE);
+        results[index].status = (index % 101) ? AMBERR_NOERR : AMBERR_TIMEOUT;
+    }
+
+    std::vector<float> virtualValues(numPayloads), codecValues(numPayloads), batchValues(numPayloads), resultValues(numPayloads);
+    std::vector<FEMC_ERROR> virtualStatus(numPayloads), codecStatus(numPayloads), batchStatus(numPayloads), resultStatus(numPayloads);
+
+    // The virtual path, as FEHardwareDevice used to unpack:
+    steady_clock::time_point start = steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (unsigned index = 0; index < numPayloads; ++index)
+            virtualStatus[index] = virtualPacker.unpack(virtualValues[index], lengths[index], &payloads[index * AMB_DATA_MSG_SIZE]);
+    }
+    double virtualTime = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+    // The inlined codec, one payload at a time:
+    start = steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (unsigned index = 0; index < numPayloads; ++index)
+            codecStatus[index] = AmbCodec<float>::unpack(codecValues[index], lengths[index], &payloads[index * AMB_DATA_MSG_SIZE]);
+    }
+    double codecTime = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+    // The batch decoder:
+    start = steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass)
+        AmbCodecBatch::unpackFloats(numPayloads, &payloads[0], &lengths[0], &batchValues[0], &batchStatus[0]);
+    double batchTime = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+    // The batch decoder on the results of a batch monitor:
+    start = steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass)
+        AmbCodecBatch::unpackFloats(numPayloads, &results[0], &resultValues[0], &resultStatus[0]);
+    double resultTime = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+    int mismatches = 0;
+    for (unsigned index = 0; index < numPayloads; ++index) {
+        if (codecValues[index] != virtualValues[index] || codecStatus[index] != virtualStatus[index])
+            ++mismatches;
+        if (batchValues[index] != virtualValues[index] || batchStatus[index] != virtualStatus[index])
+            ++mismatches;
+        bool busError = (results[index].status != AMBERR_NOERR);
+        if (resultStatus[index] != (busError ? FEMC_AMB_ERROR : virtualStatus[index])
+                || resultValues[index] != (busError ? 0.0f : virtualValues[index]))
+            ++mismatches;
+    }
+    errors += mismatches;
+
+    double total = (double) numPayloads * passes;
+    printf("unpack %u float payloads x %d passes:\n", numPayloads, passes);
+    printf("  virtual MessagePackUnpack: %6.2f ns/payload\n", virtualTime / total);
+    printf("  AmbCodec<float>:           %6.2f ns/payload\n", codecTime / total);
+    printf("  AmbCodecBatch payloads:    %6.2f ns/payload\n", batchTime / total);
+    printf("  AmbCodecBatch results:     %6.2f ns/payload\n", resultTime / total);
+    printf("%d mismatches, %d errors\n", mismatches, errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,168 @@
+// Time LOG() on the calling thread with StreamOutput writing and flushing every line, and again with
+// AsyncStreamOutput handing the lines to its writer thread.  Check that every line reaches the file
+// and that each thread's lines are in order.
+
+#include "logger.h"
+#include "portable.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <pthread.h>
+
+using namespace std::chrono;
+
+const int numThreads = 4;
+const int linesPerThread = 20000;
+
+/// Caller-side time in ns for each line logged by each thread:
+std::vector<double> samples[numThreads];
+
+/// Latency summary for one run:
+struct LatencyResult {
+    double mean;
+    double median;
+    double p99;
+    double max;
+};
+
+/// Log linesPerThread lines, timing each one.
+void *logLoop(void *arg) {
+    int thread = (int) (long) arg;
+    std::vector<double> &times = samples[thread];
+    times.clear();
+    times.reserve(linesPerThread);
+    for (int index = 0; index < linesPerThread; ++index) {
+        steady_clock::time_point start = steady_clock::now();
+        LOG(LM_INFO) << "thread " << thread << " line " << index << " SIS_VOLTAGE=" << 1.5 * index << std::endl;
+        times.push_back((double) duration_cast<nanoseconds>(steady_clock::now() - start).count());
+    }
+    return NULL;
+}
+
+/// Run the threads logging to fileName and summarize the caller-side ns per line.
+void runThreads(const char *fileName, LatencyResult &result) {
+    FILE *logStream = fopen(fileName, "w");
+    StreamOutput::setStream(logStream);
+    pthread_t threads[numThreads];
+    for (long thread = 0; thread < numThreads; ++thread)
+        pthread_create(&threads[thread], NULL, logLoop, (void *) thread);
+    for (int thread = 0; thread < numThreads; ++thread)
+        pthread_join(threads[thread], NULL);
+    if (AsyncStreamOutput::running())
+        AsyncStreamOutput::stop();
+    StreamOutput::setStream(NULL);
+    fclose(logStream);
+
+    std::vector<double> all;
+    for (int thread = 0; thread < numThreads; ++thread)
+        all.insert(all.end(), samples[thread].begin(), samples[thread].end());
+    std::sort(all.begin(), all.end());
+    double total = 0;
+    for (size_t index = 0; index < all.size(); ++index)
+        total += all[index];
+    result.mean = total / all.size();
+    result.median = all[all.size() / 2];
+    result.p99 = all[all.size() * 99 / 100];
+    result.max = all.back();
+}
+
+void printResult(const char *name, const LatencyResult &result) {
+    printf("%-18s mean %7.0f  median %7.0f  p99 %8.0f  max %10.0f ns/line\n",
+           name, result.mean, result.median, result.p99, result.max);
+}
+
+/// Read fileName back and check that every line from every thread is there, in order for each thread.
+int checkFile(const char *fileName) {
+    FILE *in = fopen(fileName, "r");
+    if (!in) {
+        printf("can't open %s <-- ERROR\n", fileName);
+        return 1;
+    }
+    std::vector<int> next(numThreads, 0);
+    int errors = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), in)) {
+        const char *text = strstr(line, "thread ");
+        int thread, index;
+        if (!text || sscanf(text, "thread %d line %d", &thread, &index) != 2 || thread < 0 || thread >= numThreads) {
+            printf("%s: bad line '%s' <-- ERROR\n", fileName, line);
+            ++errors;
+        } else if (index != next[thread]) {
+            if (errors++ < 10)
+                printf("%s: thread %d line %d expected %d <-- ERROR\n", fileName, thread, index, next[thread]);
+            next[thread] = index + 1;
+        } else
+            ++next[thread];
+    }
+    fclose(in);
+    for (int thread = 0; thread < numThreads; ++thread) {
+        if (next[thread] != linesPerThread) {
+            printf("%s: thread %d ended at line %d <-- ERROR\n", fileName, thread, next[thread]);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+int main(int, char*[]) {
+    int errors = 0;
+    LatencyResult syncResult, asyncResult;
+
+    // Every line written and flushed by the caller:
+    runThreads("t_AsyncStreamLogger_sync.txt", syncResult);
+    errors += checkFile("t_AsyncStreamLogger_sync.txt");
+
+    // Lines queued for the writer thread:
+    AsyncStreamOutput::start();
+    runThreads("t_AsyncStreamLogger_async.txt", asyncResult);
+    AsyncStreamStats stats;
+    AsyncStreamOutput::getStats(stats);
+    errors += checkFile("t_AsyncStreamLogger_async.txt");
+
+    printf("%d threads x %d lines\n", numThreads, linesPerThread);
+    printResult("StreamOutput:", syncResult);
+    printResult("AsyncStreamOutput:", asyncResult);
+    printf("async: lines=%llu waits=%llu writes=%llu flushes=%llu\n",
+           stats.lines, stats.waits, stats.writes, stats.flushes);
+    if (stats.lines != (unsigned long long) numThreads * linesPerThread) {
+        printf("async lines queued=%llu <-- ERROR\n", stats.lines);
+        ++errors;
+    }
+
+    // A single line reaches the file within the flush interval while the writer keeps running:
+    FILE *logStream = fopen("t_AsyncStreamLogger_idle.txt", "w");
+    StreamOutput::setStream(logStream);
+    AsyncStreamOutput::start();
+    LOG(LM_INFO) << "while idle" << std::endl;
+    SLEEP(3 * AsyncStreamOutput::DEFAULT_FLUSH_INTERVAL);
+    FILE *in = fopen("t_AsyncStreamLogger_idle.txt", "r");
+    char line[256] = "";
+    if (!in || !fgets(line, sizeof(line), in) || !strstr(line, "while idle")) {
+        printf("line not flushed while idle <-- ERROR\n");
+        ++errors;
+    }
+    if (in)
+        fclose(in);
+    AsyncStreamOutput::stop();
+    StreamOutput::setStream(NULL);
+    fclose(logStream);
+
+    // With the writer stopped, lines are written directly again:
+    logStream = fopen("t_AsyncStreamLogger_after.txt", "w");
+    StreamOutput::setStream(logStream);
+    LOG(LM_INFO) << "after stop" << std::endl;
+    StreamOutput::setStream(NULL);
+    fclose(logStream);
+    logStream = fopen("t_AsyncStreamLogger_after.txt", "r");
+    line[0] = '\0';
+    if (!fgets(line, sizeof(line), logStream) || !strstr(line, "after stop")) {
+        printf("line after stop() is missing <-- ERROR\n");
+        ++errors;
+    }
+    fclose(logStream);
+
+    printf("%d errors\n", errors);
+    return errors ? 1 : 0;
+}
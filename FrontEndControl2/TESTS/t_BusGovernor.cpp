@@ -0,0 +1,157 @@
+// Run senders for the observing cartridge, another cartridge, and the infrastructure through an
+// AmbGovernor on the simulated bus.  Check that each gets its share when all are busy and that
+// share left unused by idle budgets is reclaimed by a busy one, and that control messages never wait.
+
+#include "SimulatedBusInterface.h"
+#include "FrontEndAMB/ambCompletion.h"
+#include "FrontEndAMB/ambGovernor.h"
+#include "LOGGER/feAddressMeta.h"
+#include <chrono>
+#include <atomic>
+#include <stdio.h>
+#include <math.h>
+#include <semaphore.h>
+#include <pthread.h>
+
+using namespace std::chrono;
+
+const double maxRate = 1000;            // transactions per second.
+const int runMs = 2000;                 // how long the senders run in each test.
+
+std::atomic<bool> stop(false);
+
+/// One thread sending monitor requests to an RCA as fast as the governor lets it.
+struct Sender {
+    AmbGovernor *governor_p;
+    AmbRelativeAddr RCA;
+    AmbPriority_t priority;
+    unsigned long count;
+    pthread_t thread;
+};
+
+void *sendLoop(void *arg) {
+    Sender *sender = static_cast<Sender *>(arg);
+    sem_t *synchLock = ambThreadSynchLock();
+    AmbDataLength_t dataLength;
+    AmbDataMem_t data[8];
+    AmbErrorCode_t status;
+    Time timestamp;
+    while (!stop) {
+        AmbMessage_t msg;
+        msg.requestType = AMB_MONITOR;
+        msg.channel = 0;
+        msg.address = createAMBAddr(SimulatedBusInterface::FE_NODE, sender -> RCA);
+        msg.dataLen = 0;
+        msg.targetTE = 0;
+        msg.priority = sender -> priority;
+        msg.deadline = 0;
+        msg.completion_p = AmbCompletionPool::allocate();
+        msg.completion_p -> dataLength_p = &dataLength;
+        msg.completion_p -> data_p = data;
+        msg.completion_p -> status_p = &status;
+        msg.completion_p -> timestamp_p = &timestamp;
+        msg.completion_p -> synchLock_p = synchLock;
+        sender -> governor_p -> sendMessage(msg);
+        sem_wait(synchLock);
+        ++sender -> count;
+    }
+    return NULL;
+}
+
+/// Run a sender for each non-zero RCA for runMs and report the rates.
+void run(AmbGovernor &governor, Sender *senders, int numSenders, double *rates) {
+    stop = false;
+    for (int index = 0; index < numSenders; ++index) {
+        senders[index].governor_p = &governor;
+        senders[index].count = 0;
+        pthread_create(&senders[index].thread, NULL, sendLoop, &senders[index]);
+    }
+    SLEEP(runMs);
+    stop = true;
+    for (int index = 0; index < numSenders; ++index) {
+        pthread_join(senders[index].thread, NULL);
+        rates[index] = senders[index].count * 1000.0 / runMs;
+    }
+}
+
+int check(bool ok, const char *what) {
+    if (ok)
+        return 0;
+    printf("%s <-- ERROR\n", what);
+    return 1;
+}
+
+bool near(double value, double expected) {
+    return fabs(value - expected) < 0.2 * expected;
+}
+
+int main(int, char*[]) {
+    int errors = 0;
+    SimulatedBusInterface::latency_m = 0;
+    SimulatedBusInterface itf;
+    itf.findNodes(0);
+    AmbGovernor::setClassifier(FrontEnd::governorDevice);
+    AmbGovernor::setPowered(3, true);
+    AmbGovernor::setPowered(6, true);
+    AmbGovernor::setObserving(3);
+    AmbGovernor governor(itf, maxRate);
+
+    // Band 3 SIS voltage, band 6 SIS voltage, and a cryostat temperature:
+    Sender senders[3];
+    for (int index = 0; index < 3; ++index)
+        senders[index].priority = AMB_PRIORITY_BACKGROUND;
+    senders[0].RCA = 0x2008;
+    senders[1].RCA = 0x5008;
+    senders[2].RCA = 0xC000;
+    errors += check(FrontEnd::governorDevice(senders[0].RCA) == 3 && FrontEnd::governorDevice(senders[1].RCA) == 6
+                    && FrontEnd::governorDevice(senders[2].RCA) == 0, "wrong devices");
+
+    // All busy:  each should get its share:
+    double rates[3];
+    run(governor, senders, 3, rates);
+    printf("all busy:  observing %.0f/s, cartridge %.0f/s, infrastructure %.0f/s\n", rates[0], rates[1], rates[2]);
+    errors += check(near(rates[0], 500) && near(rates[1], 300) && near(rates[2], 200), "shares not enforced");
+    errors += check(rates[0] + rates[1] + rates[2] < 1.1 * maxRate, "total rate exceeded");
+
+    AmbGovernorStats stats;
+    governor.getStats(AmbGovernor::OBSERVING, stats);
+    printf("observing budget: share %.0f%% allocated %.0f/s rate %.0f/s utilization %.0f%% throttled %lu\n",
+           stats.share, stats.allocated, stats.rate, stats.utilization, stats.throttled);
+    errors += check(stats.allocated == 500 && stats.throttled > 0, "observing budget stats wrong");
+    governor.getDeviceStats(6, stats);
+    errors += check(stats.allocated == 300 && stats.transactions > 0, "band 6 stats wrong");
+
+    // Only the non-observing cartridge busy:  it should reclaim the unused share:
+    governor.resetStats();
+    run(governor, senders + 1, 1, rates);
+    governor.getDeviceStats(6, stats);
+    printf("one busy:  cartridge %.0f/s, %lu borrowed\n", rates[0], stats.borrowed);
+    errors += check(rates[0] > 0.8 * maxRate && rates[0] < 1.1 * maxRate, "unused share not reclaimed");
+    errors += check(stats.borrowed > 0, "borrowing not counted");
+
+    // Changing the observing band moves the larger share:
+    AmbGovernor::setObserving(6);
+    run(governor, senders, 3, rates);
+    printf("band 6 observing:  band 3 %.0f/s, band 6 %.0f/s, infrastructure %.0f/s\n", rates[0], rates[1], rates[2]);
+    errors += check(near(rates[0], 300) && near(rates[1], 500), "observing share did not move");
+
+    // Control messages are charged but never wait, and the monitoring sharing their budget waits instead:
+    governor.resetStats();
+    senders[0].priority = AMB_PRIORITY_CONTROL;
+    run(governor, senders, 2, rates);
+    governor.getDeviceStats(3, stats);
+    printf("band 3 control:  band 3 %.0f/s throttled %lu, band 6 %.0f/s\n", rates[0], stats.throttled, rates[1]);
+    errors += check(stats.throttled == 0, "control messages throttled");
+    errors += check(rates[0] > maxRate, "control messages limited");
+    senders[0].priority = AMB_PRIORITY_BACKGROUND;
+
+    // No limit:
+    governor.configure(0, 50, 30, 20);
+    run(governor, senders + 2, 1, rates);
+    printf("no limit:  infrastructure %.0f/s\n", rates[0]);
+    errors += check(rates[0] > 2 * maxRate, "limited with maxRate 0");
+
+    governor.shutdown();
+    printf("%d errors\n", errors);
+    return errors ? 1 : 0;
+}
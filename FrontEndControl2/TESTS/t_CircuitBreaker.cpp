@@ -0,0 +1,141 @@
+// Check the FECircuitBreaker state machine, then check that a device at a node which doesn't answer
+// stops sending to it after the threshold number of timeouts and is probed again after the backoff.
+
+#include "FEBASE/FEHardwareDevice.h"
+#include "SimulatedBusInterface.h"
+#include <stdio.h>
+#include <unistd.h>
+
+/// A device at a node address which may not be on the simulated bus.
+class BreakerDevice : public FEHardwareDevice {
+public:
+    BreakerDevice(const std::string &name, AmbNodeAddr node)
+      : FEHardwareDevice(name)
+    {
+        m_channel = 0;
+        m_nodeAddress = node;
+        nextMon = 0;
+    }
+
+    using FEHardwareDevice::syncMonitor;
+    using FEHardwareDevice::initializeSubsystemBreaker;
+
+    DECLARE_MONITORS_REGISTRY(BreakerDevice)
+
+protected:
+    virtual void monitorAction(Time *timestamp_p)
+      {}
+};
+
+DEFINE_MONITORS_REGISTRY(BreakerDevice)
+
+int check(bool ok, const char *what) {
+    if (ok)
+        return 0;
+    printf("%s <-- ERROR\n", what);
+    return 1;
+}
+
+int main(int, char*[]) {
+    int errors = 0;
+    FECircuitBreaker::configure(3, 20, 80);
+
+    // The state machine on its own:
+    {
+        FECircuitBreaker breaker("unit");
+        FECircuitBreakerStats stats;
+        for (int i = 0; i < 2; ++i) {
+            errors += check(breaker.allow(), "closed breaker refused");
+            breaker.record(AMBERR_TIMEOUT);
+        }
+        errors += check(breaker.getState() == FECircuitBreaker::CLOSED, "opened below the threshold");
+        breaker.record(AMBERR_TIMEOUT);
+        errors += check(breaker.getState() == FECircuitBreaker::OPEN, "not opened at the threshold");
+        errors += check(!breaker.allow() && !breaker.allow(), "open breaker allowed");
+
+        usleep(30000);
+        errors += check(breaker.allow(), "no probe after the backoff");
+        errors += check(breaker.getState() == FECircuitBreaker::HALF_OPEN, "not half-open while probing");
+        errors += check(!breaker.allow(), "second probe allowed");
+
+        breaker.record(AMBERR_TIMEOUT);
+        breaker.getStats(stats);
+        errors += check(stats.state == FECircuitBreaker::OPEN && stats.backoff == 40, "backoff not doubled");
+
+        usleep(50000);
+        errors += check(breaker.allow(), "no second probe");
+        breaker.record(AMBERR_NOERR);
+        breaker.getStats(stats);
+        printf("unit: %s, %lu opens, %lu probes, %lu failed fast\n",
+               FECircuitBreaker::stateText(stats.state).c_str(), stats.opens, stats.probes, stats.failedFast);
+        errors += check(stats.state == FECircuitBreaker::CLOSED && stats.consecutiveTimeouts == 0, "probe success did not close");
+        errors += check(stats.opens == 1 && stats.probes == 2 && stats.failedFast == 3, "wrong counters");
+    }
+
+    SimulatedBusInterface::latency_m = 0;
+    SimulatedBusInterface itf;
+    itf.findNodes(0);
+    // The AmbInterface must exist before its bus is set:
+    AmbInterface::getInstance();
+    AmbInterface::setBus(&itf);
+    {
+        BreakerDevice missing("Missing", 0x42), present("Present", SimulatedBusInterface::FE_NODE);
+        const AmbRelativeAddr sisVoltage = 0x0008;
+        float value(0);
+
+        // Timeouts open the breaker after which nothing more is sent:
+        for (int i = 0; i < 3; ++i)
+            missing.syncMonitor(sisVoltage, value, *ambThreadSynchLock());
+        errors += check(missing.getCircuitBreaker().getState() == FECircuitBreaker::OPEN, "device breaker not open");
+        unsigned long before = itf.getTransactionCount();
+        for (int i = 0; i < 10; ++i)
+            errors += check(missing.syncMonitor(sisVoltage, value, *ambThreadSynchLock()) != FEMC_NO_ERROR, "monitor succeeded");
+        errors += check(itf.getTransactionCount() == before, "sent while open");
+
+        // A device at a node which answers is unaffected:
+        errors += check(present.syncMonitor(sisVoltage, value, *ambThreadSynchLock()) == FEMC_NO_ERROR, "other node refused");
+
+        // After the backoff one probe is sent:
+        usleep(30000);
+        before = itf.getTransactionCount();
+        missing.syncMonitor(sisVoltage, value, *ambThreadSynchLock());
+        missing.syncMonitor(sisVoltage, value, *ambThreadSynchLock());
+        errors += check(itf.getTransactionCount() == before + 1, "not exactly one probe");
+
+        FECircuitBreakerStats stats;
+        errors += check(FECircuitBreaker::findStats("Missing", stats) && stats.opens == 1 && stats.failedFast == 11, "device stats not found");
+
+        std::string report;
+        FECircuitBreaker::getReport(report);
+        printf("%s", report.c_str());
+
+        missing.resetCircuitBreaker();
+        errors += check(missing.getCircuitBreaker().getState() == FECircuitBreaker::CLOSED, "reset did not close");
+    }
+    {
+        // Devices in the same band at a node which doesn't answer share a breaker.  Another band doesn't:
+        BreakerDevice cold("Band 3 cold", 0x43), warm("Band 3 warm", 0x43), other("Band 4 cold", 0x43);
+        cold.initializeSubsystemBreaker(0x2000);
+        warm.initializeSubsystemBreaker(0x2800);
+        other.initializeSubsystemBreaker(0x3000);
+        float value(0);
+
+        for (int i = 0; i < 3; ++i)
+            cold.syncMonitor(0x2008, value, *ambThreadSynchLock());
+        FECircuitBreakerStats stats;
+        errors += check(FECircuitBreaker::findStats("ch0 node 0x43 band 3", stats) && stats.state == FECircuitBreaker::OPEN,
+                        "band breaker not open");
+        unsigned long before = itf.getTransactionCount();
+        errors += check(warm.syncMonitor(0x2800, value, *ambThreadSynchLock()) != FEMC_NO_ERROR, "same band monitor succeeded");
+        errors += check(itf.getTransactionCount() == before, "sent while band open");
+        errors += check(warm.getCircuitBreaker().getState() == FECircuitBreaker::CLOSED, "same band device breaker opened");
+
+        other.syncMonitor(0x3008, value, *ambThreadSynchLock());
+        errors += check(itf.getTransactionCount() == before + 1, "other band not sent");
+    }
+    AmbInterface::deleteInstance();
+    FEMonitorHistoryStore::deleteInstance();
+
+    printf("%d errors\n", errors);
+    return errors ? 1 : 0;
+}
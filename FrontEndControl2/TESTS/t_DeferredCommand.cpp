@@ -0,0 +1,111 @@
+// Send a ramp of commands to the simulated bus with the readbacks deferred and check that they are
+// verified in one batch, that each deferred command has been sent when it returns, that a synchronous
+// command supersedes a deferred one, and that a readback which doesn't match what was sent is counted.
+
+#include "FEBASE/FEHardwareDevice.h"
+#include "SimulatedBusInterface.h"
+#include <chrono>
+#include <stdio.h>
+#include <math.h>
+
+using namespace std::chrono;
+
+/// A device for commanding the band 1 cartridge.
+class CommandDevice : public FEHardwareDevice {
+public:
+    CommandDevice()
+      : FEHardwareDevice("Command")
+    {
+        m_channel = 0;
+        m_nodeAddress = SimulatedBusInterface::FE_NODE;
+        nextMon = 0;
+    }
+
+    using FEHardwareDevice::syncCommand;
+    using FEHardwareDevice::syncMonitor;
+    using FEHardwareDevice::deferCommandReadback;
+    using FEHardwareDevice::verifyCommands;
+
+    DECLARE_MONITORS_REGISTRY(CommandDevice)
+
+protected:
+    virtual void monitorAction(Time *timestamp_p)
+      {}
+};
+
+DEFINE_MONITORS_REGISTRY(CommandDevice)
+
+int check(bool ok, const char *what) {
+    if (ok)
+        return 0;
+    printf("%s <-- ERROR\n", what);
+    return 1;
+}
+
+int main(int, char*[]) {
+    int errors = 0;
+    SimulatedBusInterface::latency_m = 0;
+    SimulatedBusInterface itf;
+    itf.findNodes(0);
+    // The AmbInterface must exist before its bus is set:
+    AmbInterface::getInstance();
+    AmbInterface::setBus(&itf);
+    {
+        CommandDevice device, other;
+        const AmbRelativeAddr sisVoltage = 0x0008;
+        const AmbRelativeAddr sisVoltageControl = 0x10000 + sisVoltage;
+        const AmbRelativeAddr magnetCurrent = 0x10000 + 0x0018;
+        const int steps = 20;
+
+        // A ramp with the readbacks deferred, then one readback for the last step:
+        unsigned long before = itf.getTransactionCount();
+        CommandDevice::deferCommandReadback(true);
+        for (int step = 1; step <= steps; ++step)
+            errors += check(device.syncCommand(sisVoltageControl, (float) (0.05 * step)) == FEMC_NO_ERROR, "deferred command failed");
+        device.syncCommand(magnetCurrent, (float) 10.0);
+        CommandDevice::deferCommandReadback(false);
+        FEMC_ERROR ret = device.verifyCommands();
+        unsigned long transactions = itf.getTransactionCount() - before;
+        printf("ramp: %lu transactions\n", transactions);
+        errors += check(ret == FEMC_NO_ERROR && device.getCommandMismatchCount() == 0, "ramp not verified");
+        errors += check(transactions == steps + 1 + 2, "readbacks not deferred and batched");
+
+        float voltage(0);
+        device.syncMonitor(sisVoltageControl, voltage, *ambThreadSynchLock());
+        errors += check(fabs(voltage - 0.05 * steps) < 1e-5, "last step not set");
+
+        // A deferred command has completed when it returns, so a ramp can dwell after it:
+        SimulatedBusInterface::latency_m = 2000;
+        steady_clock::time_point start = steady_clock::now();
+        CommandDevice::deferCommandReadback(true);
+        device.syncCommand(sisVoltageControl, (float) 0.25);
+        CommandDevice::deferCommandReadback(false);
+        long elapsed = (long) duration_cast<microseconds>(steady_clock::now() - start).count();
+        SimulatedBusInterface::latency_m = 0;
+        errors += check(elapsed >= 2000, "deferred command returned before it was sent");
+        errors += check(device.verifyCommands() == FEMC_NO_ERROR, "deferred command not verified");
+
+        // A synchronous command supersedes a deferred one to the same RCA:
+        CommandDevice::deferCommandReadback(true);
+        device.syncCommand(sisVoltageControl, (float) 0.5);
+        CommandDevice::deferCommandReadback(false);
+        device.syncCommand(sisVoltageControl, (float) 0.0);
+        before = itf.getTransactionCount();
+        errors += check(device.verifyCommands() == FEMC_NO_ERROR && itf.getTransactionCount() == before, "superseded command verified");
+
+        // Another device changes the value before the readback:
+        CommandDevice::deferCommandReadback(true);
+        device.syncCommand(sisVoltageControl, (float) 1.0);
+        CommandDevice::deferCommandReadback(false);
+        other.syncCommand(sisVoltageControl, (float) 2.0);
+        ret = device.verifyCommands();
+        printf("mismatch: status %d, %u mismatches\n", (int) ret, device.getCommandMismatchCount());
+        errors += check(ret != FEMC_NO_ERROR && device.getCommandMismatchCount() == 1, "mismatch not detected");
+        errors += check(device.verifyCommands() == FEMC_NO_ERROR, "commands verified twice");
+    }
+    AmbInterface::deleteInstance();
+    FEMonitorHistoryStore::deleteInstance();
+
+    printf("%d errors\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,103 @@
+// Add a known series of samples to a monitor history and check the raw samples, the 1 s, 1 min, and
+// 10 min rollups, time range and maxEntries queries, and that the rings wrap around.
+
+#include "FEBASE/FEMonitorHistory.h"
+#include <FrontEndAMB/femcDefs.h>
+#include <stdio.h>
+#include <math.h>
+
+const Time second = FEMonitorHistory::TICKS_PER_SECOND;
+
+int check(bool ok, const char *what) {
+    if (ok)
+        return 0;
+    printf("%s <-- ERROR\n", what);
+    return 1;
+}
+
+int main(int, char*[]) {
+    int errors = 0;
+    std::vector<FEMonitorHistoryEntry> entries;
+
+    // 10 samples per second for 20 minutes, values 0..9 repeating, starting on a 10 minute boundary:
+    const Time start = 1000 * 600 * second;
+    const unsigned long numSamples = 20 * 60 * 10;
+    FEMonitorHistory history;
+    for (unsigned long index = 0; index < numSamples; ++index)
+        history.add(start + index * second / 10, (float) (index % 10), (index == 15) ? FEMC_HARDW_RETRY_WARN : FEMC_NO_ERROR);
+
+    errors += check(history.samples() == numSamples, "wrong number of samples");
+
+    // The raw ring keeps the latest samples:
+    history.query(FEMonitorHistory::RESOLUTION_RAW, 0, 0, 0, entries);
+    printf("raw: %u entries\n", (unsigned) entries.size());
+    errors += check(entries.size() == FEMonitorHistory::RAW_SIZE, "raw ring not full");
+    errors += check(entries.back().timestamp == start + (numSamples - 1) * second / 10, "latest raw sample missing");
+    errors += check(entries.front().timestamp == start + (numSamples - FEMonitorHistory::RAW_SIZE) * second / 10, "raw ring out of order");
+
+    // A full ring of 1 s rollups plus the one in progress, each with all ten values:
+    history.query(FEMonitorHistory::RESOLUTION_SECOND, 0, 0, 0, entries);
+    printf("1 s: %u entries\n", (unsigned) entries.size());
+    errors += check(entries.size() == FEMonitorHistory::SECOND_SIZE + 1, "1 s ring not full");
+    bool ok = true;
+    for (unsigned index = 0; index < entries.size(); ++index) {
+        const FEMonitorHistoryEntry &entry = entries[index];
+        if (entry.count != 10 || entry.minValue != 0 || entry.maxValue != 9 || fabs(entry.meanValue - 4.5) > 1e-5 || entry.timestamp % second)
+            ok = false;
+        if (index && entry.timestamp != entries[index - 1].timestamp + second)
+            ok = false;
+    }
+    errors += check(ok, "bad 1 s rollup");
+
+    // 19 complete 1 min rollups and the one in progress:
+    history.query(FEMonitorHistory::RESOLUTION_MINUTE, 0, 0, 0, entries);
+    printf("1 min: %u entries\n", (unsigned) entries.size());
+    errors += check(entries.size() == 20, "wrong number of 1 min rollups");
+    errors += check(entries.front().timestamp == start && entries.front().count == 600, "bad 1 min rollup");
+    errors += check(entries.front().status == FEMC_HARDW_RETRY_WARN && entries[1].status == FEMC_NO_ERROR, "1 min rollup status not kept");
+
+    // Only the first 10 min rollup is complete; the second is in progress:
+    history.query(FEMonitorHistory::RESOLUTION_10MINUTES, 0, 0, 0, entries);
+    printf("10 min: %u entries\n", (unsigned) entries.size());
+    errors += check(entries.size() == 2, "wrong number of 10 min rollups");
+    errors += check(entries.size() == 2 && entries[0].count == 6000 && entries[1].count == 6000, "bad 10 min rollup");
+    errors += check(entries.size() == 2 && fabs(entries[1].meanValue - 4.5) < 1e-5, "bad 10 min rollup in progress");
+
+    // A time range, half open:
+    history.query(FEMonitorHistory::RESOLUTION_MINUTE, start + 60 * second, start + 180 * second, 0, entries);
+    errors += check(entries.size() == 2 && entries[0].timestamp == start + 60 * second, "bad time range");
+
+    // maxEntries keeps the latest:
+    history.query(FEMonitorHistory::RESOLUTION_SECOND, 0, 0, 5, entries);
+    errors += check(entries.size() == 5 && entries.back().timestamp == start + (numSamples / 10 - 1) * second, "bad maxEntries");
+
+    // The store creates each history once and lists them:
+    FEMonitorHistoryStore &store = FEMonitorHistoryStore::getInstance();
+    FEMonitorHistory *first = store.getHistory("Device", "point1");
+    errors += check(store.getHistory("Device", "point1") == first, "history created twice");
+    errors += check(store.findHistory("Device", "point2") == NULL, "found a history never created");
+    store.getHistory("Device", "point2");
+    std::vector<std::string> devices, points;
+    store.getNames(devices, points);
+    errors += check(devices.size() == 2 && points.size() == 2 && points[1] == "point2", "bad names");
+    FEMonitorHistoryStore::deleteInstance();
+
+    // Configured sizes apply to new histories:
+    const unsigned sizes[FEMonitorHistory::NUM_RESOLUTIONS] = { 8, 4, 2, 1 };
+    FEMonitorHistoryStore::configure(true, sizes);
+    errors += check(FEMonitorHistoryStore::enabled(), "history not enabled");
+    FEMonitorHistory *small = FEMonitorHistoryStore::getInstance().getHistory("Device", "small");
+    small -> query(FEMonitorHistory::RESOLUTION_RAW, 0, 0, 0, entries);
+    errors += check(entries.empty(), "new history not empty");
+    for (unsigned sample = 0; sample < 100; ++sample)
+        small -> add(start + sample * second, (float) sample, FEMC_NO_ERROR);
+    small -> query(FEMonitorHistory::RESOLUTION_RAW, 0, 0, 0, entries);
+    errors += check(entries.size() == 8 && entries.back().meanValue == 99.0, "configured raw size not used");
+    small -> query(FEMonitorHistory::RESOLUTION_SECOND, 0, 0, 0, entries);
+    errors += check(entries.size() == 5, "configured 1 s size not used");
+    FEMonitorHistoryStore::deleteInstance();
+    FEMonitorHistoryStore::configure(false);
+
+    printf("%d errors\n", errors);
+    return errors ? 1 : 0;
+}
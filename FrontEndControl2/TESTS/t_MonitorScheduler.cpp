@@ -0,0 +1,156 @@
+// Run a set of dummy devices under the shared monitor scheduler and check that each is called at
+// the rate it declared, that pausing and minimal monitoring work, and that devices can be stopped
+// while being monitored.
+
+#include "FEBASE/FEHardwareDevice.h"
+#include "FEBASE/FEMonitorScheduler.h"
+#include "portable.h"
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <stdio.h>
+
+using namespace std::chrono;
+
+/// A device which counts calls to monitorAction() and spends some time in each, as if on the bus.
+class CountingDevice : public FEHardwareDevice {
+public:
+    CountingDevice(const std::string &name, unsigned long interval, unsigned long minimalInterval, int priority, unsigned busy)
+      : FEHardwareDevice(name),
+        calls_m(0),
+        busy_m(busy),
+        inside_m(0),
+        overlaps_m(0)
+      { setMonitorRate(interval, minimalInterval, priority); }
+
+    virtual ~CountingDevice()
+      { stopMonitor(); }
+
+    virtual void monitorAction(Time *timestamp_p) {
+        if (++inside_m > 1)
+            ++overlaps_m;
+        ++calls_m;
+        if (busy_m)
+            SLEEP(busy_m);
+        --inside_m;
+    }
+
+    unsigned long calls() const
+      { return calls_m; }
+    unsigned long overlaps() const
+      { return overlaps_m; }
+    void reset()
+      { calls_m = 0; }
+
+private:
+    std::atomic<unsigned long> calls_m;
+    unsigned busy_m;
+    std::atomic<int> inside_m;
+    std::atomic<unsigned long> overlaps_m;
+};
+
+int checkRate(const char *what, unsigned long calls, double seconds, unsigned long interval) {
+    double expected = seconds * 1000.0 / interval;
+    bool ok = (calls >= expected * 0.6 && calls <= expected * 1.2 + 1);
+    printf("  %-24s %5lu calls, expected about %.0f %s\n", what, calls, expected, ok ? "" : "<-- ERROR");
+    return ok ? 0 : 1;
+}
+
+int main(int, char*[]) {
+    int errors = 0;
+    const double seconds = 2.0;
+
+    std::vector<CountingDevice *> devices;
+    devices.push_back(new CountingDevice("ColdCart", 15, 0, FEMonitorScheduler::PRIORITY_HIGH, 2));
+    devices.push_back(new CountingDevice("FETIM", 20, 0, FEMonitorScheduler::PRIORITY_HIGH, 1));
+    devices.push_back(new CountingDevice("WCA", 30, 500, FEMonitorScheduler::PRIORITY_HIGH, 1));
+    devices.push_back(new CountingDevice("Cryostat", 50, 0, FEMonitorScheduler::PRIORITY_NORMAL, 1));
+    devices.push_back(new CountingDevice("LPR", 150, 0, FEMonitorScheduler::PRIORITY_NORMAL, 0));
+    devices.push_back(new CountingDevice("IFSwitch", 500, 0, FEMonitorScheduler::PRIORITY_LOW, 0));
+
+    // Normal monitoring:
+    for (unsigned index = 0; index < devices.size(); ++index)
+        devices[index] -> startMonitor();
+    SLEEP((unsigned) (seconds * 1000));
+    printf("normal monitoring for %.1f s:\n", seconds);
+    errors += checkRate("ColdCart 15 ms", devices[0] -> calls(), seconds, 15);
+    errors += checkRate("FETIM 20 ms", devices[1] -> calls(), seconds, 20);
+    errors += checkRate("WCA 30 ms", devices[2] -> calls(), seconds, 30);
+    errors += checkRate("Cryostat 50 ms", devices[3] -> calls(), seconds, 50);
+    errors += checkRate("LPR 150 ms", devices[4] -> calls(), seconds, 150);
+    errors += checkRate("IFSwitch 500 ms", devices[5] -> calls(), seconds, 500);
+
+    // Minimal monitoring of one device:
+    devices[2] -> reset();
+    devices[2] -> minimalMonitor(true, "test");
+    SLEEP((unsigned) (seconds * 1000));
+    printf("WCA minimal:\n");
+    errors += checkRate("WCA 500 ms", devices[2] -> calls(), seconds, 500);
+    devices[2] -> minimalMonitor(false);
+
+    // Pause one device, then all:
+    devices[0] -> pauseMonitor(true, "test");
+    SLEEP(100);
+    devices[0] -> reset();
+    SLEEP(500);
+    unsigned long paused = devices[0] -> calls();
+    printf("ColdCart paused: %lu calls %s\n", paused, paused ? "<-- ERROR" : "");
+    if (paused)
+        ++errors;
+    devices[0] -> pauseMonitor(false);
+
+    FEMonitorScheduler::getInstance().pauseAll(true, "test");
+    SLEEP(100);
+    unsigned long total = 0;
+    for (unsigned index = 0; index < devices.size(); ++index)
+        devices[index] -> reset();
+    SLEEP(500);
+    for (unsigned index = 0; index < devices.size(); ++index)
+        total += devices[index] -> calls();
+    printf("all paused: %lu calls %s\n", total, total ? "<-- ERROR" : "");
+    if (total)
+        ++errors;
+    FEMonitorScheduler::getInstance().pauseAll(false);
+
+    // Global minimal uses each device's minimal interval:
+    FEMonitorScheduler::getInstance().minimalAll(true, "test");
+    devices[2] -> reset();
+    devices[3] -> reset();
+    SLEEP((unsigned) (seconds * 1000));
+    printf("all minimal:\n");
+    errors += checkRate("WCA 500 ms", devices[2] -> calls(), seconds, 500);
+    errors += checkRate("Cryostat 50 ms", devices[3] -> calls(), seconds, 50);
+    FEMonitorScheduler::getInstance().minimalAll(false);
+
+    // Stop and restart repeatedly while being monitored:
+    steady_clock::time_point start = steady_clock::now();
+    for (int pass = 0; pass < 50; ++pass) {
+        devices[0] -> stopMonitor();
+        devices[0] -> startMonitor();
+        SLEEP(3);
+    }
+    printf("50 stop/start while running: %.1f ms\n", duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0);
+
+    FEMonitorSchedulerStats stats;
+    FEMonitorScheduler::getInstance().getStats(stats);
+    printf("scheduler: %lu devices, %lu workers, %lu dispatched, %lu skipped, %lu late, max late %lu ms\n",
+           stats.devices, stats.workers, stats.dispatched, stats.skipped, stats.late, stats.maxLate);
+
+    unsigned long overlaps = 0;
+    for (unsigned index = 0; index < devices.size(); ++index) {
+        overlaps += devices[index] -> overlaps();
+        delete devices[index];
+    }
+    printf("overlapping calls: %lu %s\n", overlaps, overlaps ? "<-- ERROR" : "");
+    if (overlaps)
+        ++errors;
+
+    FEMonitorScheduler::getInstance().getStats(stats);
+    if (stats.devices) {
+        printf("%lu devices still registered <-- ERROR\n", stats.devices);
+        ++errors;
+    }
+    FEMonitorScheduler::deleteInstance();
+    printf("%d errors\n", errors);
+    return errors ? 1 : 0;
+}
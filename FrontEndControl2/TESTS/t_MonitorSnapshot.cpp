@@ -0,0 +1,101 @@
+// Publish monitor snapshots from one thread while several threads read them, and check that
+// every snapshot read is consistent and that versions only go forward.
+
+#include "FEBASE/FEMonitorSnapshot.h"
+#include "portable.h"
+#include <pthread.h>
+#include <chrono>
+#include <stdio.h>
+
+using namespace std::chrono;
+
+const int numReaders = 3;
+const unsigned long numPublish = 2000000;
+
+/// A group of values which are all set the same, so that a torn copy is easy to see.
+struct Group_t {
+    float values[12];
+    bool flag;
+    unsigned char counts;
+};
+
+FEMonitorSnapshot<Group_t> snapshot;
+volatile bool done = false;
+
+struct ReaderResult {
+    unsigned long reads;
+    unsigned long torn;
+    unsigned long backwards;
+    unsigned long badStatus;
+};
+
+void *reader(void *arg) {
+    ReaderResult *result = static_cast<ReaderResult *>(arg);
+    unsigned long last = 0;
+    Group_t group;
+    Time timestamp;
+    int status;
+    while (!done) {
+        unsigned long version = snapshot.read(group, &timestamp, &status);
+        ++result -> reads;
+        if (version < last)
+            ++result -> backwards;
+        last = version;
+        bool torn = (group.counts != (unsigned char) timestamp);
+        for (int index = 1; index < 12; ++index) {
+            if (group.values[index] != group.values[0])
+                torn = true;
+        }
+        if (torn)
+            ++result -> torn;
+        // odd timestamps are published with an error status:
+        if (status != ((timestamp & 1) ? FEMC_HARDW_RETRY_WARN : FEMC_NO_ERROR))
+            ++result -> badStatus;
+    }
+    return NULL;
+}
+
+int main(int, char*[]) {
+    int errors = 0;
+    Group_t group;
+    if (snapshot.read(group) != 0) {
+        printf("unpublished snapshot has a version <-- ERROR\n");
+        ++errors;
+    }
+
+    pthread_t readers[numReaders];
+    ReaderResult results[numReaders];
+    for (int index = 0; index < numReaders; ++index) {
+        memset(&results[index], 0, sizeof(ReaderResult));
+        pthread_create(&readers[index], NULL, reader, &results[index]);
+    }
+
+    steady_clock::time_point start = steady_clock::now();
+    for (unsigned long count = 1; count <= numPublish; ++count) {
+        for (int index = 0; index < 12; ++index)
+            group.values[index] = (float) count;
+        group.flag = (count & 1);
+        group.counts = (unsigned char) count;
+        snapshot.publish(group, count, (count & 1) ? FEMC_HARDW_RETRY_WARN : FEMC_NO_ERROR);
+    }
+    double publishTime = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    done = true;
+
+    unsigned long reads = 0, torn = 0, backwards = 0, badStatus = 0;
+    for (int index = 0; index < numReaders; ++index) {
+        pthread_join(readers[index], NULL);
+        reads += results[index].reads;
+        torn += results[index].torn;
+        backwards += results[index].backwards;
+        badStatus += results[index].badStatus;
+    }
+    if (snapshot.version() != numPublish) {
+        printf("version %lu, expected %lu <-- ERROR\n", snapshot.version(), numPublish);
+        ++errors;
+    }
+    printf("%lu publishes at %.1f ns each, %lu reads by %d readers\n", numPublish, publishTime / numPublish, reads, numReaders);
+    printf("torn reads: %lu, versions backwards: %lu, wrong status: %lu\n", torn, backwards, badStatus);
+    errors += (torn + backwards + badStatus) ? 1 : 0;
+    printf("%d errors\n", errors);
+    return errors ? 1 : 0;
+}
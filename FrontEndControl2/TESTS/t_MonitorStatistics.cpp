@@ -0,0 +1,107 @@
+// Check the running statistics against a two-pass calculation, then read the SIS voltage of band 1
+// from the simulated bus with syncMonitorStatistics() and check that the samples go in batches.
+
+#include "FEBASE/FEHardwareDevice.h"
+#include "SimulatedBusInterface.h"
+#include <stdio.h>
+#include <math.h>
+
+/// A device for sending batches of monitor requests to the band 1 cartridge.
+class StatsDevice : public FEHardwareDevice {
+public:
+    StatsDevice()
+      : FEHardwareDevice("Stats")
+    {
+        m_channel = 0;
+        m_nodeAddress = SimulatedBusInterface::FE_NODE;
+        nextMon = 0;
+    }
+
+    using FEHardwareDevice::syncMonitorStatistics;
+    using FEHardwareDevice::syncMonitorAverage;
+    using FEHardwareDevice::getThreadMonitorStatus;
+
+    DECLARE_MONITORS_REGISTRY(StatsDevice)
+
+protected:
+    virtual void monitorAction(Time *timestamp_p)
+      {}
+};
+
+DEFINE_MONITORS_REGISTRY(StatsDevice)
+
+int check(bool ok, const char *what) {
+    if (ok)
+        return 0;
+    printf("%s <-- ERROR\n", what);
+    return 1;
+}
+
+int main(int, char*[]) {
+    int errors = 0;
+
+    // Small differences on a large offset, where summing squares would lose them:
+    const float values[] = { 1000.001, 1000.003, 1000.002, 1000.006, 1000.003 };
+    const unsigned count = sizeof(values) / sizeof(values[0]);
+    FEMonitorStatistics stats;
+    double sum = 0.0;
+    for (unsigned index = 0; index < count; ++index) {
+        stats.add(values[index]);
+        sum += values[index];
+    }
+    double mean = sum / count;
+    double squares = 0.0;
+    for (unsigned index = 0; index < count; ++index)
+        squares += (values[index] - mean) * (values[index] - mean);
+    double stdDev = sqrt(squares / (count - 1));
+    printf("mean %.6f stdDev %.6f min %.3f max %.3f\n", stats.mean, stats.stdDev(), stats.minValue, stats.maxValue);
+    errors += check(stats.count == count, "wrong count");
+    errors += check(fabs(stats.mean - mean) < 1e-9, "wrong mean");
+    errors += check(fabs(stats.stdDev() - stdDev) < 1e-9, "wrong standard deviation");
+    errors += check(stats.minValue == values[0] && stats.maxValue == values[3], "wrong range");
+
+    stats.reset();
+    stats.add(2.5);
+    errors += check(stats.count == 1 && stats.mean == 2.5 && stats.stdDev() == 0.0, "wrong statistics of one reading");
+
+    SimulatedBusInterface::latency_m = 0;
+    SimulatedBusInterface itf;
+    itf.findNodes(0);
+    // The AmbInterface must exist before its bus is set:
+    AmbInterface::getInstance();
+    AmbInterface::setBus(&itf);
+    {
+        StatsDevice device;
+        const AmbRelativeAddr sisVoltage = 0x0008;
+        const int samples = 6;
+
+        unsigned long before = itf.getTransactionCount();
+        FEMC_ERROR ret = device.syncMonitorStatistics(sisVoltage, samples, stats);
+        unsigned long transactions = itf.getTransactionCount() - before;
+        printf("%lu transactions: mean %.4f stdDev %.4f min %.4f max %.4f mV\n",
+               transactions, stats.mean, stats.stdDev(), stats.minValue, stats.maxValue);
+        errors += check(ret == FEMC_NO_ERROR, "monitor failed");
+        errors += check(transactions == samples && stats.count == samples, "wrong number of samples");
+        errors += check(stats.minValue <= stats.mean && stats.mean <= stats.maxValue, "mean outside range");
+        errors += check(stats.stdDev() < 0.002, "more noise than simulated");
+        errors += check(StatsDevice::getThreadMonitorStatus() == FEMC_NO_ERROR, "thread status not set");
+
+        // syncMonitorAverage() returns the same mean:
+        float average(-1);
+        before = itf.getTransactionCount();
+        ret = device.syncMonitorAverage(sisVoltage, average, samples);
+        errors += check(ret == FEMC_NO_ERROR && itf.getTransactionCount() - before == samples, "average not read in one batch");
+        errors += check(fabs(average) < 0.002, "wrong average");
+
+        // more samples than fit in one batch are sent in several:
+        before = itf.getTransactionCount();
+        ret = device.syncMonitorStatistics(sisVoltage, 2 * FEMON_MAX_BATCH + 1, stats);
+        errors += check(ret == FEMC_NO_ERROR && stats.count == 2 * FEMON_MAX_BATCH + 1
+                        && itf.getTransactionCount() - before == 2 * FEMON_MAX_BATCH + 1, "wrong number of samples in several batches");
+    }
+    AmbInterface::deleteInstance();
+    FEMonitorHistoryStore::deleteInstance();
+
+    printf("%d errors\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,124 @@
+// Fill a dummy device's MONITORS_REGISTRY from a monitor table and read it from the simulated bus.
+// Check that points needing missing features are left out, that consecutive points are read in one
+// batch, that averaged points are read alone, and that the thermal log columns come from the table.
+
+#include "FEBASE/FEHardwareDevice.h"
+#include "SimulatedBusInterface.h"
+#include <stdio.h>
+#include <math.h>
+
+/// A device with a few cartridge monitor points at band 1 RCAs.
+class TableDevice : public FEHardwareDevice {
+public:
+    enum MonitorFeature {
+        MON_SIS = 0x01
+    };
+
+    TableDevice()
+      : FEHardwareDevice("Table"),
+        cartridgeTemperature0_value(-1), cartridgeTemperature1_value(-1), cartridgeTemperature4_value(-1),
+        sisPol0Sb1Voltage_value(99), sisPol0Sb1Current_value(-1), lnaPol0Sb1Enable_value(-1),
+        cartridgeTemperature0_status(FEMC_NOT_CONNECTED), cartridgeTemperature1_status(FEMC_NOT_CONNECTED),
+        cartridgeTemperature4_status(FEMC_NOT_CONNECTED), sisPol0Sb1Voltage_status(FEMC_NOT_CONNECTED),
+        sisPol0Sb1Current_status(FEMC_NOT_CONNECTED), lnaPol0Sb1Enable_status(FEMC_NOT_CONNECTED)
+    {
+        m_channel = 0;
+        m_nodeAddress = SimulatedBusInterface::FE_NODE;
+        // This device has no SIS:
+        addMonTable(monitorTable, monitorTableSize, 0, 0);
+        setMonBatch(3);
+        nextMon = 0;
+    }
+
+    unsigned registrySize() const
+      { return monitorRegistry.size(); }
+
+    static const FEMonitorTableEntry<TableDevice> monitorTable[];
+    static const unsigned monitorTableSize;
+
+    float cartridgeTemperature0_value, cartridgeTemperature1_value, cartridgeTemperature4_value;
+    float sisPol0Sb1Voltage_value, sisPol0Sb1Current_value, lnaPol0Sb1Enable_value;
+    int cartridgeTemperature0_status, cartridgeTemperature1_status, cartridgeTemperature4_status;
+    int sisPol0Sb1Voltage_status, sisPol0Sb1Current_status, lnaPol0Sb1Enable_status;
+
+    DECLARE_MONITORS_REGISTRY(TableDevice)
+
+protected:
+    virtual void monitorAction(Time *timestamp_p)
+      {}
+};
+
+constexpr FEMonitorTableEntry<TableDevice> TableDevice::monitorTable[] = {
+    FEMON_TABLE_ENTRY(TableDevice, cartridgeTemperature0, "CARTRIDGE_TEMP Te=0", 0x0880, FEMON_WIRE_FLOAT, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, "4K"),
+    FEMON_TABLE_ENTRY(TableDevice, cartridgeTemperature1, "CARTRIDGE_TEMP Te=1", 0x0890, FEMON_WIRE_FLOAT, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, "110K"),
+    FEMON_TABLE_ENTRY(TableDevice, cartridgeTemperature4, "CARTRIDGE_TEMP Te=4", 0x08C0, FEMON_WIRE_FLOAT, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, "15K"),
+    FEMON_TABLE_ENTRY(TableDevice, sisPol0Sb1Voltage, "SIS_VOLTAGE Po=0 Sb=1", 0x0008, FEMON_WIRE_FLOAT, FEMON_RATE_EVERY_PASS, 0.0, MON_SIS, 1, NULL),
+    FEMON_TABLE_ENTRY(TableDevice, sisPol0Sb1Current, "SIS_CURRENT Po=0 Sb=1", 0x0010, FEMON_WIRE_FLOAT, FEMON_RATE_EVERY_PASS, 0.0, 0, 4, NULL),
+    FEMON_TABLE_ENTRY(TableDevice, lnaPol0Sb1Enable, "LNA_ENABLE Po=0 Sb=1", 0x0058, FEMON_WIRE_BOOL, FEMON_RATE_EVERY_PASS, 0.0, 0, 1, NULL)
+};
+
+constexpr unsigned TableDevice::monitorTableSize = sizeof(TableDevice::monitorTable) / sizeof(TableDevice::monitorTable[0]);
+
+static_assert(TableDevice::monitorTable[1].def.offset == 0x0890, "monitor table is not a constant expression");
+
+DEFINE_MONITORS_REGISTRY(TableDevice)
+
+int check(bool ok, const char *what) {
+    if (ok)
+        return 0;
+    printf("%s <-- ERROR\n", what);
+    return 1;
+}
+
+int main(int, char*[]) {
+    int errors = 0;
+    SimulatedBusInterface::latency_m = 0;
+    SimulatedBusInterface itf;
+    itf.findNodes(0);
+    // The AmbInterface must exist before its bus is set:
+    AmbInterface::getInstance();
+    AmbInterface::setBus(&itf);
+    FEMonitorHistoryStore::configure(true);
+    {
+        TableDevice device;
+        errors += check(device.registrySize() == TableDevice::monitorTableSize - 1, "point needing a missing feature was registered");
+        errors += check(device.sisPol0Sb1Voltage_value == 0.0, "point needing a missing feature was not zeroed");
+
+        // One pass:  a batch of three temperatures, then the averaged current alone, then the LNA enable:
+        unsigned long before = itf.getTransactionCount();
+        int steps = 0;
+        while (device.executeNextMon())
+            ++steps;
+        unsigned long transactions = itf.getTransactionCount() - before;
+        printf("%d steps, %lu transactions: %.2f %.2f %.2f K, %.3f uA, enable %.0f\n", steps, transactions,
+               device.cartridgeTemperature0_value, device.cartridgeTemperature1_value, device.cartridgeTemperature4_value,
+               device.sisPol0Sb1Current_value, device.lnaPol0Sb1Enable_value);
+        errors += check(steps == 3, "wrong number of steps in a pass");
+        errors += check(transactions == 3 + 4 + 1, "wrong number of transactions in a pass");
+        errors += check(fabs(device.cartridgeTemperature0_value - 4.0) < 0.1 && fabs(device.cartridgeTemperature1_value - 110.0) < 0.1
+                        && fabs(device.cartridgeTemperature4_value - 15.0) < 0.1, "wrong temperatures");
+        errors += check(device.cartridgeTemperature1_status == FEMC_NO_ERROR && device.sisPol0Sb1Current_status == FEMC_NO_ERROR
+                        && device.lnaPol0Sb1Enable_status == FEMC_NO_ERROR, "status not stored");
+        errors += check(device.sisPol0Sb1Voltage_status == FEMC_NOT_CONNECTED, "point needing a missing feature was read");
+
+        // The thermal log columns:
+        std::string header, line, placeholder;
+        appendTableThermalLogHeader(TableDevice::monitorTable, TableDevice::monitorTableSize, header);
+        appendTableThermalLog(device, TableDevice::monitorTable, TableDevice::monitorTableSize, line);
+        appendTableThermalLogPlaceholder(TableDevice::monitorTable, TableDevice::monitorTableSize, placeholder);
+        printf("thermal log:%s\n            %s\n", header.c_str(), line.c_str());
+        errors += check(header == "\t4K\t110K\t15K", "wrong thermal log header");
+        errors += check(std::count(line.begin(), line.end(), '\t') == 3, "wrong thermal log columns");
+        errors += check(placeholder == "\t0\t0\t0", "wrong thermal log placeholder");
+
+        // Each registered point has a history:
+        FEMonitorHistory *history = FEMonitorHistoryStore::getInstance().findHistory("Table", "cartridgeTemperature1");
+        errors += check(history && history -> samples() == 1, "no history for a table point");
+        errors += check(!FEMonitorHistoryStore::getInstance().findHistory("Table", "sisPol0Sb1Voltage"), "history for a point not registered");
+    }
+    AmbInterface::deleteInstance();
+    FEMonitorHistoryStore::deleteInstance();
+
+    printf("%d errors\n", errors);
+    return errors ? 1 : 0;
+}
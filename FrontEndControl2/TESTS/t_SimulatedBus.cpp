@@ -0,0 +1,219 @@
+// Exercise SimulatedBusInterface:  check a few of the device models
+// and measure throughput at several simulated transaction latencies.
+
+#include "SimulatedBusInterface.h"
+#include "FrontEndAMB/ambCompletion.h"
+#include "FrontEndAMB/ambCoalescer.h"
+#include "FrontEndAMB/messagePackUnpack.h"
+#include <chrono>
+#include <vector>
+#include <stdio.h>
+#include <math.h>
+#include <semaphore.h>
+#include <pthread.h>
+
+using namespace std::chrono;
+
+const int messageCount = 2000;
+
+struct Result {
+    AmbDataLength_t dataLength;
+    AmbDataMem_t data[8];
+    AmbErrorCode_t status;
+    Time timestamp;
+};
+
+MessagePackUnpack packer;
+
+void send(AmbInterfaceBus &itf, AmbTransaction_t type, AmbRelativeAddr RCA,
+          AmbDataLength_t dataLength, const AmbDataMem_t *data, Result &result, sem_t *synchLock)
+{
+    AmbMessage_t msg;
+    msg.requestType = type;
+    msg.channel = 0;
+    msg.address = createAMBAddr(SimulatedBusInterface::FE_NODE, RCA);
+    msg.dataLen = dataLength;
+    if (dataLength)
+        memcpy(msg.data, data, dataLength);
+    msg.targetTE = 0;
+    msg.priority = AMB_PRIORITY_CONTROL;
+    msg.deadline = 0;
+    msg.completion_p = AmbCompletionPool::allocate();
+    msg.completion_p -> dataLength_p = &result.dataLength;
+    msg.completion_p -> data_p = result.data;
+    msg.completion_p -> status_p = &result.status;
+    msg.completion_p -> timestamp_p = &result.timestamp;
+    msg.completion_p -> synchLock_p = synchLock;
+    itf.sendMessage(msg);
+}
+
+float monitorFloat(AmbInterfaceBus &itf, AmbRelativeAddr RCA, sem_t *synchLock) {
+    Result result;
+    send(itf, AMB_MONITOR, RCA, 0, NULL, result, synchLock);
+    sem_wait(synchLock);
+    float value = 0;
+    packer.unpack(value, result.dataLength, result.data);
+    return value;
+}
+
+template<class T>
+void command(AmbInterfaceBus &itf, AmbRelativeAddr RCA, T value, sem_t *synchLock) {
+    Result result;
+    AmbDataLength_t dataLength;
+    AmbDataMem_t data[8];
+    packer.pack(value, dataLength, data);
+    send(itf, AMB_CONTROL, RCA, dataLength, data, result, synchLock);
+    sem_wait(synchLock);
+}
+
+int testModels() {
+    int errors = 0;
+    SimulatedBusInterface::latency_m = 0;
+    SimulatedBusInterface itf;
+    itf.findNodes(0);
+    sem_t synchLock;
+    sem_init(&synchLock, 0, 0);
+
+    // Sweep the band 1 pol0 sb1 SIS junction.  The current should jump at the gap:
+    printf("SIS I-V:\n");
+    float lastCurrent = -1.0e6;
+    for (int step = -20; step <= 20; ++step) {
+        float voltage = step * 0.5;
+        command(itf, 0x10008, voltage, &synchLock);
+        float readback = monitorFloat(itf, 0x0008, &synchLock);
+        float current = monitorFloat(itf, 0x0010, &synchLock);
+        printf("  %6.2f mV %8.4f mA\n", readback, current);
+        if (fabs(readback - voltage) > 0.01 || current < lastCurrent - 0.001)
+            ++errors;
+        lastCurrent = current;
+    }
+    command(itf, 0x10008, 2.0f, &synchLock);
+    float below = monitorFloat(itf, 0x0010, &synchLock);
+    command(itf, 0x10008, 4.0f, &synchLock);
+    float above = monitorFloat(itf, 0x0010, &synchLock);
+    printf("  I(4 mV) / I(2 mV) = %.1f\n", above / below);
+    if (above < 10 * below)
+        ++errors;
+
+    // The band 1 LO should lock once the YTO is tuned with the photomixer on:
+    float before = monitorFloat(itf, 0x0820, &synchLock);
+    command(itf, 0x10810, (unsigned char) 1, &synchLock);
+    command(itf, 0x10800, (unsigned short) 2000, &synchLock);
+    float after = monitorFloat(itf, 0x0820, &synchLock);
+    printf("PLL lock detect: %.2f V before, %.2f V after tuning\n", before, after);
+    if (before > 1.0 || after < 3.0)
+        ++errors;
+
+    itf.shutdown();
+    sem_destroy(&synchLock);
+    printf("models: %d errors\n", errors);
+    return errors;
+}
+
+AmbCoalescer *coalescer = NULL;
+const int coalesceThreads = 8;
+
+void *coalesceReader(void *arg) {
+    int *errors = static_cast<int *>(arg);
+    sem_t *synchLock = ambThreadSynchLock();
+    for (int index = 0; index < 500; ++index) {
+        Result result;
+        send(*coalescer, AMB_MONITOR, 0xC000 + 4 * (index % 4), 0, NULL, result, synchLock);
+        sem_wait(synchLock);
+        if (result.status != AMBERR_NOERR || result.dataLength != 5)
+            ++(*errors);
+    }
+    return NULL;
+}
+
+int testCoalescing(unsigned long freshness) {
+    SimulatedBusInterface::latency_m = 300;
+    SimulatedBusInterface::jitter_m = 0;
+    SimulatedBusInterface itf;
+    itf.findNodes(0);
+    coalescer = new AmbCoalescer(itf, freshness);
+
+    // Several threads polling the same few points:
+    pthread_t threads[coalesceThreads];
+    int threadErrors[coalesceThreads] = { 0 };
+    for (int index = 0; index < coalesceThreads; ++index)
+        pthread_create(&threads[index], NULL, coalesceReader, &threadErrors[index]);
+    int errors = 0;
+    for (int index = 0; index < coalesceThreads; ++index) {
+        pthread_join(threads[index], NULL);
+        errors += threadErrors[index];
+    }
+    AmbCoalescerStats stats;
+    coalescer -> getStats(stats);
+    unsigned long transactions = itf.getTransactionCount();
+
+    // A readback right after a command must never come from before the command:
+    sem_t *synchLock = ambThreadSynchLock();
+    for (int step = 0; step < 20; ++step) {
+        float voltage = step * 0.5;
+        command(*coalescer, 0x10008, voltage, synchLock);
+        if (fabs(monitorFloat(*coalescer, 0x0008, synchLock) - voltage) > 0.01)
+            ++errors;
+    }
+    delete coalescer;
+    coalescer = NULL;
+    itf.shutdown();
+
+    printf("coalescing freshness=%lu us: %lu monitors, %lu sent, %lu coalesced, %lu cache hits, %lu transactions, %d errors\n",
+           freshness, stats.monitors, stats.sent, stats.coalesced, stats.cacheHits, transactions, errors);
+    if (stats.sent != transactions || stats.sent + stats.coalesced + stats.cacheHits != stats.monitors)
+        ++errors;
+    return errors;
+}
+
+void runTest(unsigned latency, unsigned jitter, bool burst) {
+    SimulatedBusInterface::latency_m = latency;
+    SimulatedBusInterface::jitter_m = jitter;
+    SimulatedBusInterface itf;
+    itf.findNodes(0);
+    std::vector<Result> results(messageCount);
+    sem_t synchLock;
+    sem_init(&synchLock, 0, 0);
+
+    steady_clock::time_point start = steady_clock::now();
+    for (int index = 0; index < messageCount; ++index) {
+        // cycle through the cryostat temperature sensors:
+        send(itf, AMB_MONITOR, 0xC000 + 4 * (index % 13), 0, NULL, results[index], &synchLock);
+        if (!burst)
+            sem_wait(&synchLock);
+    }
+    if (burst)
+        for (int index = 0; index < messageCount; ++index)
+            sem_wait(&synchLock);
+    double elapsed = duration_cast<microseconds>(steady_clock::now() - start).count() / 1.0e6;
+    AmbLatencyHistogram queueDelay, roundTrip;
+    itf.getLatency(AmbLatencyTable::ANY, AmbLatencyTable::ANY, AmbLatencyTable::ANY, queueDelay, roundTrip);
+    itf.shutdown();
+    sem_destroy(&synchLock);
+
+    int errors = 0;
+    for (int index = 0; index < messageCount; ++index)
+        if (results[index].status != AMBERR_NOERR || results[index].dataLength != 5)
+            ++errors;
+
+    printf("latency=%-4u jitter=%-4u %-5s %d messages in %.3f s = %8.0f msg/s, %d errors\n",
+           latency, jitter, burst ? "burst" : "sync", messageCount, elapsed, messageCount / elapsed, errors);
+    printf("    round-trip p50=%lu p99=%lu max=%lu us, queue p50=%lu p99=%lu us, N=%lu\n",
+           roundTrip.percentile(50), roundTrip.percentile(99), roundTrip.maxValue(),
+           queueDelay.percentile(50), queueDelay.percentile(99), roundTrip.count());
+    if (roundTrip.count() != (unsigned long) messageCount || roundTrip.percentile(50) < latency)
+        printf("    latency histogram ERROR\n");
+}
+
+int main(int, char*[]) {
+    int errors = testModels();
+    errors += testCoalescing(0);
+    errors += testCoalescing(2000);
+    runTest(0, 0, false);
+    runTest(0, 0, true);
+    runTest(150, 0, true);
+    runTest(150, 50, true);
+    runTest(500, 0, false);
+    runTest(500, 0, true);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,296 @@
+// Benchmark SocketClientBusInterface stop-and-wait vs. pipelined mode
+// against a local stand-in for the AmbSocketServer.
+//
+// The stand-in server answers each 18-byte request with a 13-byte response.
+// Responses are delayed to model the network round-trip plus a serialized CAN bus transaction time.
+// Monitor responses echo the request address so the client can check that they were matched in order.
+// The last test has the server cut a response short and drop the connection, and reject one address,
+// to check that the client fails what was in flight, reconnects, and keeps matching responses in order.
+
+#include "FrontEndAMB/SocketClientBusInterface.h"
+#include "FrontEndAMB/ambCompletion.h"
+#include <boost/asio.hpp>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+using boost::asio::ip::tcp;
+using namespace std::chrono;
+
+const int roundTripUs = 500;    // simulated network round-trip
+const int busTimeUs = 50;       // simulated CAN transaction time
+const int messageCount = 2000;
+const int connectionCount = 8;  // one per runTest() call below, plus two for runResyncTest()
+
+int truncateAt = -1;            // if set, the server cuts short its response to this request on the next connection
+const AmbAddr errorAddress = createAMBAddr(0x14, 0x0001);  // the server answers requests to this with an error code
+
+// Stand-in server ------------------------------------------------------------
+
+struct PendingResponse {
+    steady_clock::time_point due;
+    std::array<char, 13> bytes;
+    bool truncate;
+};
+
+struct ServerConnection {
+    tcp::socket *sock;
+    std::deque<PendingResponse> pending;
+    pthread_mutex_t mutex;
+    bool done;
+};
+
+void *serverWriter(void *arg) {
+    ServerConnection *conn = static_cast<ServerConnection *>(arg);
+    while (true) {
+        pthread_mutex_lock(&conn -> mutex);
+        bool empty = conn -> pending.empty();
+        bool done = conn -> done;
+        PendingResponse next;
+        if (!empty) {
+            next = conn -> pending.front();
+            conn -> pending.pop_front();
+        }
+        pthread_mutex_unlock(&conn -> mutex);
+        if (empty) {
+            if (done)
+                break;
+            std::this_thread::sleep_for(microseconds(20));
+            continue;
+        }
+        std::this_thread::sleep_until(next.due);
+        boost::system::error_code err;
+        if (next.truncate) {
+            // send part of the response then drop the connection:
+            boost::asio::write(*conn -> sock, boost::asio::buffer(next.bytes, 6), err);
+            conn -> sock -> shutdown(tcp::socket::shutdown_both, err);
+            break;
+        }
+        boost::asio::write(*conn -> sock, boost::asio::buffer(next.bytes), err);
+        if (err)
+            break;
+    }
+    return NULL;
+}
+
+void *serverThread(void *arg) {
+    tcp::acceptor *acceptor = static_cast<tcp::acceptor *>(arg);
+    for (int connection = 0; connection < connectionCount; ++connection) {
+        tcp::socket *sock = new tcp::socket(acceptor -> get_executor());
+        boost::system::error_code err;
+        acceptor -> accept(*sock, err);
+        if (err) {
+            delete sock;
+            break;
+        }
+        sock -> set_option(tcp::no_delay(true));
+        ServerConnection conn;
+        conn.sock = sock;
+        conn.done = false;
+        pthread_mutex_init(&conn.mutex, NULL);
+        pthread_t writer;
+        pthread_create(&writer, NULL, serverWriter, &conn);
+
+        int truncateRequest = truncateAt;
+        truncateAt = -1;
+        int requestCount = 0;
+        steady_clock::time_point busFree = steady_clock::now();
+        std::array<char, 18> req;
+        while (true) {
+            boost::asio::read(*sock, boost::asio::buffer(req), err);
+            if (err)
+                break;
+            PendingResponse resp;
+            resp.bytes.fill(0);
+            resp.truncate = false;
+            steady_clock::time_point now = steady_clock::now();
+            if (req[8] == 2) {
+                // getNodes: report no nodes, immediately:
+                resp.due = now;
+            } else {
+                // the bus handles one transaction at a time:
+                if (busFree < now)
+                    busFree = now;
+                busFree += microseconds(busTimeUs);
+                resp.due = busFree + microseconds(roundTripUs);
+                resp.truncate = (requestCount++ == truncateRequest);
+                AmbAddr addr = ((AmbAddr) (unsigned char) req[4] << 24) | ((AmbAddr) (unsigned char) req[5] << 16)
+                             | ((AmbAddr) (unsigned char) req[6] << 8) | (unsigned char) req[7];
+                if (addr == errorAddress) {
+                    // error code -1 and no data:
+                    resp.bytes[0] = resp.bytes[1] = resp.bytes[2] = resp.bytes[3] = (char) 0xFF;
+                } else if (req[8] == 0) {
+                    // monitor: echo the request address as data:
+                    resp.bytes[4] = 4;
+                    memcpy(&resp.bytes[5], &req[4], 4);
+                }
+            }
+            pthread_mutex_lock(&conn.mutex);
+            conn.pending.push_back(resp);
+            pthread_mutex_unlock(&conn.mutex);
+        }
+        pthread_mutex_lock(&conn.mutex);
+        conn.done = true;
+        pthread_mutex_unlock(&conn.mutex);
+        pthread_join(writer, NULL);
+        pthread_mutex_destroy(&conn.mutex);
+        delete sock;
+    }
+    return NULL;
+}
+
+// Client ---------------------------------------------------------------------
+
+struct Result {
+    AmbDataLength_t dataLength;
+    AmbDataMem_t data[8];
+    AmbErrorCode_t status;
+    Time timestamp;
+};
+
+AmbAddr requestAddress(int index) {
+    return createAMBAddr(0x13, 0x0001 + (index % 0x1000));
+}
+
+void sendMonitor(SocketClientBusInterface &itf, AmbAddr address, Result &result, sem_t *synchLock) {
+    AmbMessage_t msg;
+    msg.requestType = AMB_MONITOR;
+    msg.channel = 0;
+    msg.address = address;
+    msg.dataLen = 0;
+    msg.targetTE = 0;
+    msg.priority = AMB_PRIORITY_CONTROL;
+    msg.deadline = 0;
+    msg.completion_p = AmbCompletionPool::allocate();
+    msg.completion_p -> dataLength_p = &result.dataLength;
+    msg.completion_p -> data_p = result.data;
+    msg.completion_p -> status_p = &result.status;
+    msg.completion_p -> timestamp_p = &result.timestamp;
+    msg.completion_p -> synchLock_p = synchLock;
+    itf.sendMessage(msg);
+}
+
+int checkResults(const std::vector<Result> &results) {
+    int errors = 0;
+    for (int index = 0; index < (int) results.size(); ++index) {
+        const Result &r = results[index];
+        unsigned long addr = ((unsigned long) r.data[0] << 24) | ((unsigned long) r.data[1] << 16)
+                           | ((unsigned long) r.data[2] << 8) | r.data[3];
+        if (r.status != AMBERR_NOERR || r.dataLength != 4 || addr != requestAddress(index))
+            ++errors;
+    }
+    return errors;
+}
+
+void runTest(int port, int depth, bool burst) {
+    SocketClientBusInterface::pipelineDepth_m = depth;
+    SocketClientBusInterface itf("127.0.0.1", port);
+    std::vector<Result> results(messageCount);
+    sem_t synchLock;
+    sem_init(&synchLock, 0, 0);
+
+    // open the channel outside the timed section:
+    sendMonitor(itf, requestAddress(0), results[0], &synchLock);
+    sem_wait(&synchLock);
+
+    steady_clock::time_point start = steady_clock::now();
+    if (burst) {
+        // queue all requests then wait for all:
+        for (int index = 0; index < messageCount; ++index)
+            sendMonitor(itf, requestAddress(index), results[index], &synchLock);
+        for (int index = 0; index < messageCount; ++index)
+            sem_wait(&synchLock);
+    } else {
+        // one synchronous request at a time:
+        for (int index = 0; index < messageCount; ++index) {
+            sendMonitor(itf, requestAddress(index), results[index], &synchLock);
+            sem_wait(&synchLock);
+        }
+    }
+    double elapsed = duration_cast<microseconds>(steady_clock::now() - start).count() / 1.0e6;
+    itf.shutdown();
+    sem_destroy(&synchLock);
+
+    printf("depth=%-3d %-5s %d messages in %.3f s = %8.0f msg/s, %d errors\n",
+           depth, burst ? "burst" : "sync", messageCount, elapsed, messageCount / elapsed, checkResults(results));
+}
+
+// Returns the number of errors found.
+int runResyncTest(int port) {
+    const int count = 200;
+    SocketClientBusInterface::pipelineDepth_m = 8;
+    // the server drops the connection part way through its response to the 50th request of the burst:
+    truncateAt = 51;
+    SocketClientBusInterface itf("127.0.0.1", port);
+    std::vector<Result> results(count);
+    sem_t synchLock;
+    sem_init(&synchLock, 0, 0);
+    sendMonitor(itf, requestAddress(0), results[0], &synchLock);
+    sem_wait(&synchLock);
+
+    for (int index = 0; index < count; ++index)
+        sendMonitor(itf, requestAddress(index), results[index], &synchLock);
+    for (int index = 0; index < count; ++index)
+        sem_wait(&synchLock);
+
+    // after reconnecting, an error code from the server is not reported as success:
+    Result rejected;
+    sendMonitor(itf, errorAddress, rejected, &synchLock);
+    sem_wait(&synchLock);
+    itf.shutdown();
+    sem_destroy(&synchLock);
+
+    int errors = 0;
+    int failed = 0;
+    for (int index = 0; index < count; ++index) {
+        const Result &r = results[index];
+        if (r.status != AMBERR_NOERR) {
+            ++failed;
+            continue;
+        }
+        unsigned long addr = ((unsigned long) r.data[0] << 24) | ((unsigned long) r.data[1] << 16)
+                           | ((unsigned long) r.data[2] << 8) | r.data[3];
+        if (r.dataLength != 4 || addr != requestAddress(index)) {
+            printf("resync: response %d does not match its request <-- ERROR\n", index);
+            ++errors;
+        }
+    }
+    if (failed == 0 || failed > count / 4) {
+        printf("resync: %d requests failed <-- ERROR\n", failed);
+        ++errors;
+    }
+    if (results[count - 1].status != AMBERR_NOERR) {
+        printf("resync: no good responses after reconnecting <-- ERROR\n");
+        ++errors;
+    }
+    if (rejected.status == AMBERR_NOERR) {
+        printf("resync: server error code reported as success <-- ERROR\n");
+        ++errors;
+    }
+    printf("resync: %d of %d requests failed after the connection dropped, %d errors\n", failed, count, errors);
+    return errors;
+}
+
+int main(int, char*[]) {
+    boost::asio::io_context io;
+    tcp::acceptor acceptor(io, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    int port = acceptor.local_endpoint().port();
+    pthread_t server;
+    pthread_create(&server, NULL, serverThread, &acceptor);
+
+    printf("stand-in server on port %d: round-trip %d us, bus time %d us\n", port, roundTripUs, busTimeUs);
+    runTest(port, 1, false);
+    runTest(port, 8, false);
+    runTest(port, 1, true);
+    runTest(port, 4, true);
+    runTest(port, 16, true);
+    runTest(port, 64, true);
+    int errors = runResyncTest(port);
+
+    pthread_join(server, NULL);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+// Record an SIS I-V sweep on the simulated bus to a trace file, then replay it
+// with the recorded timing and accelerated, checking that the responses match.
+
+#include "SimulatedBusInterface.h"
+#include "FrontEndAMB/ReplayBusInterface.h"
+#include "FrontEndAMB/ambCompletion.h"
+#include "FrontEndAMB/messagePackUnpack.h"
+#include <chrono>
+#include <vector>
+#include <stdio.h>
+#include <semaphore.h>
+
+using namespace std::chrono;
+
+const char *traceFileName = "t_TraceReplay.trace";
+const int sweepSteps = 200;
+
+MessagePackUnpack packer;
+
+struct Result {
+    AmbDataLength_t dataLength;
+    AmbDataMem_t data[8];
+    AmbErrorCode_t status;
+    Time timestamp;
+};
+
+void transact(CANBusInterface &itf, AmbTransaction_t type, AmbRelativeAddr RCA,
+              AmbDataLength_t dataLength, const AmbDataMem_t *data, Result &result, sem_t *synchLock)
+{
+    AmbMessage_t msg;
+    msg.requestType = type;
+    msg.channel = 0;
+    msg.address = createAMBAddr(SimulatedBusInterface::FE_NODE, RCA);
+    msg.dataLen = dataLength;
+    if (dataLength)
+        memcpy(msg.data, data, dataLength);
+    msg.targetTE = 0;
+    msg.priority = AMB_PRIORITY_CONTROL;
+    msg.deadline = 0;
+    msg.completion_p = AmbCompletionPool::allocate();
+    msg.completion_p -> dataLength_p = &result.dataLength;
+    msg.completion_p -> data_p = result.data;
+    msg.completion_p -> status_p = &result.status;
+    msg.completion_p -> timestamp_p = &result.timestamp;
+    msg.completion_p -> synchLock_p = synchLock;
+    itf.sendMessage(msg);
+    sem_wait(synchLock);
+}
+
+// Sweep the band 1 pol0 sb1 SIS junction voltage, reading back voltage and current at each step:
+double sweep(CANBusInterface &itf, std::vector<float> &readings) {
+    sem_t synchLock;
+    sem_init(&synchLock, 0, 0);
+    readings.clear();
+    steady_clock::time_point start = steady_clock::now();
+    for (int step = 0; step < sweepSteps; ++step) {
+        float voltage = -10.0 + 20.0 * step / sweepSteps;
+        AmbDataLength_t dataLength;
+        AmbDataMem_t data[8];
+        packer.pack(voltage, dataLength, data);
+        Result result;
+        transact(itf, AMB_CONTROL, 0x10008, dataLength, data, result, &synchLock);
+        for (AmbRelativeAddr RCA = 0x0008; RCA <= 0x0010; RCA += 8) {
+            transact(itf, AMB_MONITOR, RCA, 0, NULL, result, &synchLock);
+            float value = -999.0;
+            if (result.status == AMBERR_NOERR)
+                packer.unpack(value, result.dataLength, result.data);
+            readings.push_back(value);
+        }
+    }
+    double elapsed = duration_cast<microseconds>(steady_clock::now() - start).count() / 1.0e6;
+    sem_destroy(&synchLock);
+    return elapsed;
+}
+
+int replay(double speedup, const std::vector<float> &recorded, double recordedTime) {
+    ReplayBusInterface itf(speedup);
+    if (!itf.load(traceFileName)) {
+        printf("can't load %s\n", traceFileName);
+        return 1;
+    }
+    itf.findNodes(0);
+    std::vector<float> readings;
+    double elapsed = sweep(itf, readings);
+    itf.shutdown();
+
+    int errors = (readings != recorded) ? 1 : 0;
+    printf("replay speedup=%-4g %lu records, %lu matched, %lu unmatched, %.3f s (recorded %.3f s), responses %s\n",
+           speedup, itf.getNumRecords(), itf.getMatched(), itf.getUnmatched(), elapsed, recordedTime,
+           errors ? "DIFFER" : "match");
+    if (itf.getUnmatched())
+        ++errors;
+    return errors;
+}
+
+int main(int, char*[]) {
+    // Record:
+    std::vector<float> recorded;
+    double recordedTime;
+    {
+        SimulatedBusInterface::latency_m = 500;
+        SimulatedBusInterface::jitter_m = 100;
+        SimulatedBusInterface itf;
+        AmbTraceWriter trace;
+        if (!trace.open(traceFileName)) {
+            printf("can't create %s\n", traceFileName);
+            return 1;
+        }
+        itf.setTrace(&trace);
+        itf.findNodes(0);
+        recordedTime = sweep(itf, recorded);
+        itf.shutdown();
+        itf.setTrace(NULL);
+        printf("recorded %lu transactions in %.3f s\n", trace.getCount(), recordedTime);
+    }
+    // Replay:
+    int errors = 0;
+    errors += replay(1.0, recorded, recordedTime);
+    errors += replay(10.0, recorded, recordedTime);
+    errors += replay(0.0, recorded, recordedTime);
+    remove(traceFileName);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,136 @@
+// Log from several threads at once to a binary transaction log and read it back.  Check that every
+// entry arrives once and in order for its thread, that the text matches what is written to FELog,
+// and that a full ring drops or overwrites according to the policy.  Also time log() itself.
+
+#include "LOGGER/AmbTransactionLogger.h"
+#include "LOGGER/ambTransactionLogFile.h"
+#include "logger.h"
+#include <chrono>
+#include <vector>
+#include <stdio.h>
+#include <pthread.h>
+
+using namespace std::chrono;
+
+const int numThreads = 4;
+const int entriesPerThread = 20000;
+const char *fileName = "t_TransactionLogger.bin";
+
+AmbTransactionLogger *logger = NULL;
+
+/// Log entriesPerThread monitors with the thread number in fValue and a count in iValue.
+void *logLoop(void *arg) {
+    int thread = (int) (long) arg;
+    for (int index = 0; index < entriesPerThread; ++index) {
+        logger -> log(FEHardwareDevice::FEMC_LOG_MONITOR, (index & 1) ? "SIS_VOLTAGE" : "SIS_CURRENT",
+                      0x0008, 0, index, (float) thread);
+        if ((index & 1023) == 0)
+            SLEEP(1);
+    }
+    return NULL;
+}
+
+int check(bool ok, const char *what) {
+    if (ok)
+        return 0;
+    printf("%s <-- ERROR\n", what);
+    return 1;
+}
+
+int main(int, char*[]) {
+    int errors = 0;
+    StreamOutput::setStream(NULL);
+
+    // The text is the same as has always been written to FELog:
+    AmbTransactionLogEntry entry;
+    entry.set(FEHardwareDevice::FEMC_LOG_COMMAND, "SIS_VOLTAGE", 0x11008, -3, 7, 1.5);
+    std::string text = formatAmbTransaction(entry);
+    printf("format: %s\n", text.c_str());
+    errors += check(text == "CMD 0x011008 'SIS_VOLTAGE Ca=2' i=7 f=1.5 stat=-3", "text format changed");
+
+    // Many threads to a binary file, with rings big enough that nothing is dropped:
+    logger = new AmbTransactionLogger(false, entriesPerThread);
+    logger -> setInterval(20);
+    errors += check(logger -> open(fileName), "can't create log");
+    logger -> checkPoint("start of test");
+    pthread_t threads[numThreads];
+    for (long thread = 0; thread < numThreads; ++thread)
+        pthread_create(&threads[thread], NULL, logLoop, (void *) thread);
+    for (int thread = 0; thread < numThreads; ++thread)
+        pthread_join(threads[thread], NULL);
+    logger -> checkPoint("end of test");
+    AmbTransactionLoggerStats stats;
+    logger -> getStats(stats);
+    delete logger;
+    errors += check(stats.dropped == 0 && stats.rings == numThreads + 1, "wrong logger stats");
+
+    AmbTransactionLogReader reader;
+    errors += check(reader.open(fileName), "can't read log");
+    std::vector<int> next(numThreads, 0);
+    int checkPoints = 0, count = 0;
+    while (reader.next(entry)) {
+        if (entry.trans == FEHardwareDevice::FEMC_LOG_CHECKPOINT) {
+            ++checkPoints;
+            continue;
+        }
+        ++count;
+        int thread = (int) entry.fValue;
+        if (thread < 0 || thread >= numThreads || (int) entry.iValue != next[thread]
+            || strcmp(entry.text, (entry.iValue & 1) ? "SIS_VOLTAGE" : "SIS_CURRENT") != 0)
+        {
+            printf("bad entry thread=%d i=%lu text=%s\n", thread, entry.iValue, entry.text);
+            ++errors;
+            break;
+        }
+        ++next[thread];
+    }
+    reader.close();
+    remove(fileName);
+    printf("read back %d entries, %d checkpoints\n", count, checkPoints);
+    errors += check(count == numThreads * entriesPerThread && checkPoints == 2, "entries missing");
+
+    // A full ring with DROP_NEWEST keeps the oldest entries:
+    const int ringSize = 64;
+    logger = new AmbTransactionLogger(false, ringSize);
+    logger -> setInterval(10000);
+    for (int index = 0; index < 3 * ringSize; ++index)
+        logger -> log(FEHardwareDevice::FEMC_LOG_MONITOR, "X", 0, 0, index, 0);
+    logger -> getStats(stats);
+    printf("drop: logged %lu dropped %lu\n", stats.logged, stats.dropped);
+    errors += check(stats.logged == ringSize && stats.dropped == 2 * ringSize, "drop policy");
+    delete logger;
+
+    // A full ring with OVERWRITE_OLDEST keeps the newest:
+    logger = new AmbTransactionLogger(false, ringSize);
+    logger -> setInterval(10000);
+    logger -> setOverflowPolicy(AmbTransactionLogger::OVERWRITE_OLDEST);
+    errors += check(logger -> open(fileName), "can't create log");
+    for (int index = 0; index < 3 * ringSize; ++index)
+        logger -> log(FEHardwareDevice::FEMC_LOG_MONITOR, "X", 0, 0, index, 0);
+    delete logger;
+    errors += check(reader.open(fileName), "can't read log");
+    count = 0;
+    unsigned long first = 0;
+    while (reader.next(entry)) {
+        if (!count++)
+            first = entry.iValue;
+    }
+    reader.close();
+    remove(fileName);
+    printf("overwrite: %d entries starting at %lu\n", count, first);
+    errors += check(count == ringSize && first == 2 * ringSize, "overwrite policy");
+
+    // Cost of log() on the calling thread:
+    const int timed = 200000;
+    logger = new AmbTransactionLogger(false, 1 << 18);
+    logger -> setInterval(10000);
+    steady_clock::time_point start = steady_clock::now();
+    for (int index = 0; index < timed; ++index)
+        logger -> log(FEHardwareDevice::FEMC_LOG_MONITOR, "SIS_VOLTAGE", 0x0008, 0, index, 1.0);
+    double ns = duration<double, std::nano>(steady_clock::now() - start).count() / timed;
+    printf("log(): %.0f ns per entry\n", ns);
+    delete logger;
+
+    printf("%d errors\n", errors);
+    return errors ? 1 : 0;
+}
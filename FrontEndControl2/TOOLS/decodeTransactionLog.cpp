@@ -0,0 +1,47 @@
+// Decode a binary transaction log written by AmbTransactionLogger into the same text
+// that it writes to FELog when logTransactions is set.
+//
+// usage: decodeTransactionLog <log file> [<output file>]
+// Writes to stdout if no output file is given.
+
+#include "LOGGER/ambTransactionLogFile.h"
+#include "logger.h"
+#include <stdio.h>
+#include <string>
+using namespace std;
+
+int main(int argc, char *argv[]) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: decodeTransactionLog <log file> [<output file>]\n");
+        return 2;
+    }
+    AmbTransactionLogReader reader;
+    if (!reader.open(argv[1])) {
+        fprintf(stderr, "decodeTransactionLog: can't read %s or it is not a transaction log.\n", argv[1]);
+        return 1;
+    }
+    FILE *out = stdout;
+    if (argc == 3) {
+        out = fopen(argv[2], "w");
+        if (!out) {
+            fprintf(stderr, "decodeTransactionLog: can't create %s\n", argv[2]);
+            return 1;
+        }
+    }
+    StreamOutput::setStream(out);
+    StreamLogger::setReportingLevel(LM_INFO);
+
+    AmbTransactionLogEntry entry;
+    unsigned long count = 0;
+    while (reader.next(entry)) {
+        string text = formatAmbTransaction(entry);
+        if (!text.empty())
+            LOGT(LM_INFO, &entry.ts) << text << endl;
+        ++count;
+    }
+    reader.close();
+    if (out != stdout)
+        fclose(out);
+    fprintf(stderr, "decodeTransactionLog: %lu transactions.\n", count);
+    return 0;
+}
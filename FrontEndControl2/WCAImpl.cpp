@@ -351,32 +351,22 @@ void WCAImpl::photomixerEnable(bool val) {
 //-------------------------------------------------------------------------------------------------
 // retrieve monitor values:
 
-bool WCAImpl::getMonitorYTO(YTO_t &target) const {
-    memset(&target, 0, sizeof(target));
-    target.ytoCoarseTune_value = ytoCoarseTune_value;
+bool WCAImpl::getMonitorYTO(YTO_t &target, Time *timestamp_p, int *status_p) const {
+    readSnapshot(ytoSnapshot_m, target, timestamp_p, status_p, &WCAImpl::collectYTO);
     return true;
 }
-    
-bool WCAImpl::getMonitorPhotomixer(Photomixer_t &target) const {
-    memset(&target, 0, sizeof(target));
-    target.photomixerEnable_value = photomixerEnable_value;
-    target.photomixerVoltage_value = photomixerVoltage_value;
-    target.photomixerCurrent_value = photomixerCurrent_value;
+
+bool WCAImpl::getMonitorPhotomixer(Photomixer_t &target, Time *timestamp_p, int *status_p) const {
+    readSnapshot(photomixerSnapshot_m, target, timestamp_p, status_p, &WCAImpl::collectPhotomixer);
     return true;
-};
+}
 
-bool WCAImpl::getMonitorPLL(PLL_t &target) const {
-    memset(&target, 0, sizeof(target));
+bool WCAImpl::getMonitorPLL(PLL_t &target, Time *timestamp_p, int *status_p) const {
+    readSnapshot(pllSnapshot_m, target, timestamp_p, status_p, &WCAImpl::collectPLL);
     
-    if (minimalMonitoring_m) {
-        // if in minimal monitoring mode, just return the latest values.
-        target.pllLockDetectVoltage_value = pllLockDetectVoltage_value;
-        target.pllCorrectionVoltage_value = pllCorrectionVoltage_value;
-        target.pllRefTotalPower_value = pllRefTotalPower_value;
-        target.pllIfTotalPower_value = pllIfTotalPower_value;
-        target.pllUnlockDetectLatch_value = pllUnlockDetectLatch_value;
-    } else {
-        // else, make a non-const copy of this so we can call real-time monitors directly.
+    if (!isMinimalMonitoring()) {
+        // if not in minimal monitoring mode, replace the fast-changing values with real-time monitors.
+        // make a non-const copy of this so we can call them directly.
         // TODO: fix these constness hacks.
         WCAImpl *nonConstThis = const_cast<WCAImpl *>(this);    
         target.pllLockDetectVoltage_value = nonConstThis -> pllLockDetectVoltage();
@@ -386,16 +376,63 @@ bool WCAImpl::getMonitorPLL(PLL_t &target) const {
         target.pllUnlockDetectLatch_value = nonConstThis -> pllUnlockDetectLatch();
     }
     target.pllLock_value = monitorLockForDisplay();
+    return true;
+};
+
+bool WCAImpl::getMonitorAMC(AMC_t &target, Time *timestamp_p, int *status_p) const {
+    readSnapshot(amcSnapshot_m, target, timestamp_p, status_p, &WCAImpl::collectAMC);
+    return true;
+}
+
+bool WCAImpl::getMonitorPA(PA_t &target, Time *timestamp_p, int *status_p) const {
+    readSnapshot(paSnapshot_m, target, timestamp_p, status_p, &WCAImpl::collectPA);
+    return true;
+}
+
+void WCAImpl::collectYTO(YTO_t &target, int &status) const {
+    memset(&target, 0, sizeof(target));
+    target.ytoCoarseTune_value = ytoCoarseTune_value;
+    status = FEMC_NO_ERROR;
+    status = FEMonitorSnapshot<YTO_t>::combineStatus(status, ytoCoarseTune_status);
+}
 
+void WCAImpl::collectPhotomixer(Photomixer_t &target, int &status) const {
+    memset(&target, 0, sizeof(target));
+    target.photomixerEnable_value = photomixerEnable_value;
+    target.photomixerVoltage_value = photomixerVoltage_value;
+    target.photomixerCurrent_value = photomixerCurrent_value;
+    status = FEMC_NO_ERROR;
+    status = FEMonitorSnapshot<Photomixer_t>::combineStatus(status, photomixerEnable_status);
+    status = FEMonitorSnapshot<Photomixer_t>::combineStatus(status, photomixerVoltage_status);
+    status = FEMonitorSnapshot<Photomixer_t>::combineStatus(status, photomixerCurrent_status);
+}
+
+void WCAImpl::collectPLL(PLL_t &target, int &status) const {
+    memset(&target, 0, sizeof(target));
+    target.pllLockDetectVoltage_value = pllLockDetectVoltage_value;
+    target.pllCorrectionVoltage_value = pllCorrectionVoltage_value;
     target.pllAssemblyTemp_value = pllAssemblyTemp_value;
     target.pllYTOHeaterCurrent_value = pllYTOHeaterCurrent_value;
+    target.pllRefTotalPower_value = pllRefTotalPower_value;
+    target.pllIfTotalPower_value = pllIfTotalPower_value;
+    target.pllUnlockDetectLatch_value = pllUnlockDetectLatch_value;
     target.pllLoopBandwidthSelect_value = pllLoopBandwidthSelect_value;
     target.pllSidebandLockSelect_value = pllSidebandLockSelect_value;
     target.pllNullLoopIntegrator_value = pllNullLoopIntegrator_value;
-    return true;
-};
-    
-bool WCAImpl::getMonitorAMC(AMC_t &target) const {
+    status = FEMC_NO_ERROR;
+    status = FEMonitorSnapshot<PLL_t>::combineStatus(status, pllLockDetectVoltage_status);
+    status = FEMonitorSnapshot<PLL_t>::combineStatus(status, pllCorrectionVoltage_status);
+    status = FEMonitorSnapshot<PLL_t>::combineStatus(status, pllAssemblyTemp_status);
+    status = FEMonitorSnapshot<PLL_t>::combineStatus(status, pllYTOHeaterCurrent_status);
+    status = FEMonitorSnapshot<PLL_t>::combineStatus(status, pllRefTotalPower_status);
+    status = FEMonitorSnapshot<PLL_t>::combineStatus(status, pllIfTotalPower_status);
+    status = FEMonitorSnapshot<PLL_t>::combineStatus(status, pllUnlockDetectLatch_status);
+    status = FEMonitorSnapshot<PLL_t>::combineStatus(status, pllLoopBandwidthSelect_status);
+    status = FEMonitorSnapshot<PLL_t>::combineStatus(status, pllSidebandLockSelect_status);
+    status = FEMonitorSnapshot<PLL_t>::combineStatus(status, pllNullLoopIntegrator_status);
+}
+
+void WCAImpl::collectAMC(AMC_t &target, int &status) const {
     memset(&target, 0, sizeof(target));
     target.amcGateAVoltage_value = amcGateAVoltage_value;
     target.amcDrainAVoltage_value = amcDrainAVoltage_value;
@@ -409,10 +446,22 @@ bool WCAImpl::getMonitorAMC(AMC_t &target) const {
     target.amcMultiplierDCounts_value = amcMultiplierDCounts_value;
     target.amcMultiplierDCurrent_value = amcMultiplierDCurrent_value;
     target.amcSupplyVoltage5V_value = amcSupplyVoltage5V_value;
-    return true;
-};
+    status = FEMC_NO_ERROR;
+    status = FEMonitorSnapshot<AMC_t>::combineStatus(status, amcGateAVoltage_status);
+    status = FEMonitorSnapshot<AMC_t>::combineStatus(status, amcDrainAVoltage_status);
+    status = FEMonitorSnapshot<AMC_t>::combineStatus(status, amcDrainACurrent_status);
+    status = FEMonitorSnapshot<AMC_t>::combineStatus(status, amcGateBVoltage_status);
+    status = FEMonitorSnapshot<AMC_t>::combineStatus(status, amcDrainBVoltage_status);
+    status = FEMonitorSnapshot<AMC_t>::combineStatus(status, amcDrainBCurrent_status);
+    status = FEMonitorSnapshot<AMC_t>::combineStatus(status, amcGateEVoltage_status);
+    status = FEMonitorSnapshot<AMC_t>::combineStatus(status, amcDrainEVoltage_status);
+    status = FEMonitorSnapshot<AMC_t>::combineStatus(status, amcDrainECurrent_status);
+    status = FEMonitorSnapshot<AMC_t>::combineStatus(status, amcMultiplierDCounts_status);
+    status = FEMonitorSnapshot<AMC_t>::combineStatus(status, amcMultiplierDCurrent_status);
+    status = FEMonitorSnapshot<AMC_t>::combineStatus(status, amcSupplyVoltage5V_status);
+}
 
-bool WCAImpl::getMonitorPA(PA_t &target) const {
+void WCAImpl::collectPA(PA_t &target, int &status) const {
     memset(&target, 0, sizeof(target));
     target.paPol0GateVoltage_value = paPol0GateVoltage_value;
     target.paPol0DrainVoltage_value = paPol0DrainVoltage_value;
@@ -422,8 +471,56 @@ bool WCAImpl::getMonitorPA(PA_t &target) const {
     target.paPol1DrainCurrent_value = paPol1DrainCurrent_value;
     target.paSupplyVoltage3V_value = paSupplyVoltage3V_value;
     target.paSupplyVoltage5V_value = paSupplyVoltage5V_value;
-    return true;
-};
+    status = FEMC_NO_ERROR;
+    status = FEMonitorSnapshot<PA_t>::combineStatus(status, paPol0GateVoltage_status);
+    status = FEMonitorSnapshot<PA_t>::combineStatus(status, paPol0DrainVoltage_status);
+    status = FEMonitorSnapshot<PA_t>::combineStatus(status, paPol0DrainCurrent_status);
+    status = FEMonitorSnapshot<PA_t>::combineStatus(status, paPol1GateVoltage_status);
+    status = FEMonitorSnapshot<PA_t>::combineStatus(status, paPol1DrainVoltage_status);
+    status = FEMonitorSnapshot<PA_t>::combineStatus(status, paPol1DrainCurrent_status);
+    status = FEMonitorSnapshot<PA_t>::combineStatus(status, paSupplyVoltage3V_status);
+    status = FEMonitorSnapshot<PA_t>::combineStatus(status, paSupplyVoltage5V_status);
+}
+
+void WCAImpl::postRecordMonHook(const float *target, const FEMonitorDef *def_p, Time timestamp) {
+    // Find the group of the registry point just read:
+    if (target == &photomixerVoltage_value || target == &photomixerCurrent_value)
+        publishSnapshot(photomixerSnapshot_m, timestamp, &WCAImpl::collectPhotomixer);
+
+    else if (target == &pllLockDetectVoltage_value || target == &pllCorrectionVoltage_value ||
+             target == &pllRefTotalPower_value || target == &pllIfTotalPower_value ||
+             target == &pllAssemblyTemp_value || target == &pllYTOHeaterCurrent_value)
+        publishSnapshot(pllSnapshot_m, timestamp, &WCAImpl::collectPLL);
+
+    else if (target == &paPol0GateVoltage_value || target == &paPol0DrainVoltage_value ||
+             target == &paPol0DrainCurrent_value || target == &paPol1GateVoltage_value ||
+             target == &paPol1DrainVoltage_value || target == &paPol1DrainCurrent_value ||
+             target == &paSupplyVoltage3V_value || target == &paSupplyVoltage5V_value)
+        publishSnapshot(paSnapshot_m, timestamp, &WCAImpl::collectPA);
+
+    else
+        publishSnapshot(amcSnapshot_m, timestamp, &WCAImpl::collectAMC);
+}
+
+void WCAImpl::monitorAction(Time *timestamp_p) {
+    bool minimal = isMinimalMonitoring();
+    int phase = monitorPhase;
+    WCAImplBase::monitorAction(timestamp_p);
+
+    // The registry points publish their own groups.  Publish the groups of the points which
+    // WCAImplBase::monitorAction() read directly in this phase:
+    if (!minimal && phase != 1 && phase != 2)
+        return;
+    Time timestamp;
+    setTimeStamp(&timestamp);
+    publishSnapshot(pllSnapshot_m, timestamp, &WCAImpl::collectPLL);
+    if (minimal || phase == 2)
+        publishSnapshot(photomixerSnapshot_m, timestamp, &WCAImpl::collectPhotomixer);
+    if (!minimal && phase == 1)
+        publishSnapshot(ytoSnapshot_m, timestamp, &WCAImpl::collectYTO);
+    if (!minimal && phase == 2)
+        publishSnapshot(amcSnapshot_m, timestamp, &WCAImpl::collectAMC);
+}
 
 //-------------------------------------------------------------------------------------------------
 // Thermal Log interface:
@@ -29,6 +29,7 @@
 #include "FEBASE/WCAImplBase.h"
 #include "OPTIMIZE/ThermalLoggable.h"
 #include "CONFIG/CartConfig.h"
+#include "FEBASE/FEMonitorSnapshot.h"
 
 class WCAImpl : public WCAImplBase, public ThermalLoggable {
 public:
@@ -239,6 +240,9 @@ public:
 
 //-------------------------------------------------------------------------------------------------
 // retrieve monitor values:
+// Each getMonitorXXX() copies a consistent snapshot published by the monitor thread and never waits for it.
+// If timestamp_p is given it receives the time the snapshot was taken, 0 if monitoring hasn't started.
+// If status_p is given it receives the first FEMC_ERROR seen reading the group, FEMC_NO_ERROR if none.
     
     struct YTO_t {
         unsigned short ytoCoarseTune_value;
@@ -248,7 +252,7 @@ public:
             ytoFrequency_value = 0; }
     };
     ///< structure for returning YTO monitor data.
-    bool getMonitorYTO(YTO_t &target) const;
+    bool getMonitorYTO(YTO_t &target, Time *timestamp_p = NULL, int *status_p = NULL) const;
     ///< get the YTO monitor data.
     
     struct Photomixer_t {
@@ -257,7 +261,7 @@ public:
         float photomixerCurrent_value;
     };
     ///< structure for returning photomixer monitor data.
-    bool getMonitorPhotomixer(Photomixer_t &target) const;
+    bool getMonitorPhotomixer(Photomixer_t &target, Time *timestamp_p = NULL, int *status_p = NULL) const;
     ///< get the photomixer monitor data.
     
     struct PLL_t {
@@ -274,7 +278,7 @@ public:
         bool pllNullLoopIntegrator_value;
     };
     ///< structure for returning PLL monitor data.
-    bool getMonitorPLL(PLL_t &target) const;
+    bool getMonitorPLL(PLL_t &target, Time *timestamp_p = NULL, int *status_p = NULL) const;
     ///< get the PLL monitor data.
     
     struct AMC_t {
@@ -292,7 +296,7 @@ public:
         float amcSupplyVoltage5V_value;
     };
     ///< structure for returning AMC monitor data.
-    bool getMonitorAMC(AMC_t &target) const;
+    bool getMonitorAMC(AMC_t &target, Time *timestamp_p = NULL, int *status_p = NULL) const;
     ///< get the AMC monitor data.
     
     struct PA_t {
@@ -306,7 +310,7 @@ public:
         float paSupplyVoltage5V_value;
     };
     ///< structure for returning power amp monitor data.
-    bool getMonitorPA(PA_t &target) const;
+    bool getMonitorPA(PA_t &target, Time *timestamp_p = NULL, int *status_p = NULL) const;
     ///< get the power amp monitor data.
 
 //-------------------------------------------------------------------------------------------------
@@ -324,8 +328,52 @@ public:
 
     static void appendThermalLogPlaceholder(std::string &target);
     ///< append zero data to the thermal log so that columns will align.
+
+protected:
+    virtual void monitorAction(Time *timestamp_p);
+    ///< monitor as WCAImplBase does, then publish the snapshots of the groups it read.
+
+    virtual void postRecordMonHook(const float *target, const FEMonitorDef *def_p, Time timestamp);
+    ///< publish the group of a registry monitor point as soon as it is recorded.
     
 private:
+    // monitor snapshots for the getMonitorXXX() functions:
+    void collectYTO(YTO_t &target, int &status) const;
+    void collectPhotomixer(Photomixer_t &target, int &status) const;
+    void collectPLL(PLL_t &target, int &status) const;
+    void collectAMC(AMC_t &target, int &status) const;
+    void collectPA(PA_t &target, int &status) const;
+    ///< gather a monitor group and its status from the latest monitored values.
+
+    template<class T>
+    void publishSnapshot(FEMonitorSnapshot<T> &snapshot, Time timestamp, void (WCAImpl::*collect)(T &, int &) const) {
+        T data;
+        int status;
+        (this ->* collect)(data, status);
+        snapshot.publish(data, timestamp, status);
+    }
+    ///< publish one monitor group, stamped with the time it was acquired.  Called by the monitor thread.
+
+    template<class T>
+    void readSnapshot(const FEMonitorSnapshot<T> &snapshot, T &target, Time *timestamp_p, int *status_p,
+                      void (WCAImpl::*collect)(T &, int &) const) const
+    {
+        if (!snapshot.read(target, timestamp_p, status_p)) {
+            // Nothing published yet because monitoring hasn't started.  Return the values as they are:
+            int status;
+            (this ->* collect)(target, status);
+            if (status_p)
+                *status_p = status;
+        }
+    }
+    ///< copy out a snapshot, or collect the values directly if none has been published.
+
+    FEMonitorSnapshot<YTO_t> ytoSnapshot_m;                 ///< YTO.
+    FEMonitorSnapshot<Photomixer_t> photomixerSnapshot_m;   ///< photomixer.
+    FEMonitorSnapshot<PLL_t> pllSnapshot_m;                 ///< PLL.
+    FEMonitorSnapshot<AMC_t> amcSnapshot_m;                 ///< AMC.
+    FEMonitorSnapshot<PA_t> paSnapshot_m;                   ///< power amp.
+
     int band_m;                     ///< which cartridge band this is.
     unsigned short ytoCoarseTune_m; ///< caches the last set course tuning.       
     int pllSidebandLockSelect_m;    ///< caches the last set sideband lock value.